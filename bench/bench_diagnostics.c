@@ -0,0 +1,133 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: bench_diagnostics.c
+ * DESC.: diagnostics_parse() throughput on synthetic GCC and Clang output
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* GCC: "In function" headers, numbered source lines, carets and fix-its */
+static int append_gcc(FILE *out, unsigned i) {
+    return fprintf(out,
+                   "src/module_%u/file_%u.cplus: In function 'handler_%u':\n"
+                   "src/module_%u/file_%u.cplus:%u:%u: error: expected ';' before '}' token\n"
+                   "%5u |     return value_%u\n"
+                   "      |                     ^\n"
+                   "      |                     ;\n"
+                   "src/module_%u/include/util.hplus:%u:5: note: declared here\n"
+                   "%5u | int helper_%u(int a, int b);\n"
+                   "      |     ^~~~~~~~~~~\n"
+                   "src/module_%u/file_%u.cplus:%u:12: warning: unused variable 'tmp_%u'"
+                   " [-Wunused-variable]\n",
+                   i % 64U, i, i, i % 64U, i, 10U + (i % 900U), 5U + (i % 60U), 10U + (i % 900U), i,
+                   i % 64U, 1U + (i % 200U), 1U + (i % 200U), i, i % 64U, i, 11U + (i % 900U), i);
+}
+
+/* Clang: no line-number gutter, a summary line at the end of each file */
+static int append_clang(FILE *out, unsigned i) {
+    return fprintf(out,
+                   "src/module_%u/file_%u.cplus:%u:%u: error: use of undeclared identifier"
+                   " 'value_%u'\n"
+                   "    return value_%u + other;\n"
+                   "           ^\n"
+                   "src/module_%u/file_%u.cplus:%u:7: warning: unused variable 'tmp_%u'"
+                   " [-Wunused-variable]\n"
+                   "    int tmp_%u = 0;\n"
+                   "        ^\n"
+                   "%s",
+                   i % 64U, i, 10U + (i % 900U), 12U + (i % 60U), i, i, i % 64U, i,
+                   11U + (i % 900U), i, i,
+                   ((i % 16U) == 15U) ? "2 errors generated.\n" : "");
+}
+
+static char *make_corpus(size_t min_bytes, int (*append)(FILE *, unsigned), size_t *out_size) {
+    char *text = NULL;
+    FILE *out = open_memstream(&text, out_size);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    size_t written = 0U;
+    for (unsigned i = 0U; written < min_bytes; ++i) {
+        int n = append(out, i);
+        if (n < 0) {
+            break;
+        }
+        written += (size_t)n;
+    }
+
+    if (fclose(out) != 0) {
+        free(text);
+        return NULL;
+    }
+    return text;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+/* Best of `iterations` runs, in MB/s */
+static double measure(const char *corpus, size_t size, int iterations, size_t *out_count) {
+    double best = 0.0;
+    for (int it = 0; it < iterations; ++it) {
+        double start = now_seconds();
+        DiagnosticList list = diagnostics_parse(corpus);
+        double elapsed = now_seconds() - start;
+
+        *out_count = list.count;
+        diagnostics_free_list(&list);
+
+        double rate = ((double)size / (1024.0 * 1024.0)) / elapsed;
+        if (rate > best) {
+            best = rate;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes  = (argc > 1) ? strtoul(argv[1], NULL, 10) : 16U;
+    int    iterations = (argc > 2) ? atoi(argv[2]) : 5;
+    if ((megabytes == 0U) || (iterations <= 0)) {
+        fprintf(stderr, "Usage: %s [MB per corpus, default 16] [iterations, default 5]\n", argv[0]);
+        return 1;
+    }
+
+    static const struct {
+        const char* name;
+        int (*append)(FILE *, unsigned);
+    } k_corpora[] = {
+        {"gcc",   append_gcc},
+        {"clang", append_clang},
+    };
+
+    for (size_t c = 0U; c < sizeof(k_corpora) / sizeof(k_corpora[0]); ++c) {
+        size_t size = 0U;
+        char *corpus = make_corpus(megabytes * 1024U * 1024U, k_corpora[c].append, &size);
+        if (corpus == NULL) {
+            fprintf(stderr, "failed to build the %s corpus\n", k_corpora[c].name);
+            return 1;
+        }
+
+        size_t count = 0U;
+        double rate = measure(corpus, size, iterations, &count);
+        printf("%-6s %8.1f MB  %9zu diagnostics  %8.1f MB/s\n",
+               k_corpora[c].name, (double)size / (1024.0 * 1024.0), count, rate);
+        free(corpus);
+    }
+    return 0;
+}
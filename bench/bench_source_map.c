@@ -0,0 +1,114 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: bench_source_map.c
+ * DESC.: source map encode/decode and diagnostic remapping cost
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "source_map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_seconds(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+int main(int argc, char **argv) {
+    size_t lines = (argc > 1) ? strtoul(argv[1], NULL, 10) : 200000U;
+    size_t diags = (argc > 2) ? strtoul(argv[2], NULL, 10) : 100000U;
+    if ((lines == 0U) || (diags == 0U)) {
+        fprintf(stderr, "usage: %s [generated lines] [diagnostics]\n", argv[0]);
+        return 1;
+    }
+
+    /* A generated file whose lines came from 16 originals, two segments per line */
+    const char *line = "    value = helper(value, 42);\n";
+    size_t      len  = strlen(line);
+    char       *gen  = NULL;
+    size_t      gen_size = 0U;
+    FILE       *out  = open_memstream(&gen, &gen_size);
+    if (out == NULL) {
+        return 1;
+    }
+    for (size_t k = 0U; k < lines; ++k) {
+        (void)fputs(line, out);
+    }
+    if (fclose(out) != 0) {
+        return 1;
+    }
+
+    double     t0  = now_seconds();
+    SourceMap *map = source_map_create(gen, gen_size);
+    char       name[32];
+    for (size_t k = 0U; (map != NULL) && (k < lines); ++k) {
+        (void)snprintf(name, sizeof(name), "src/file_%zu.cplus", k % 16U);
+        (void)source_map_add(map, (uint32_t)(k * len), name, (int)(k / 16U) + 1, 1);
+        (void)source_map_add(map, (uint32_t)(k * len + 12U), "src/lowered.hplus",
+                             (int)(k % 977U) + 1, 5);
+    }
+    double t_build = now_seconds() - t0;
+    if (map == NULL) {
+        return 1;
+    }
+
+    unsigned char *data = NULL;
+    size_t         size = 0U;
+    t0 = now_seconds();
+    int encoded = source_map_encode(map, &data, &size);
+    double t_encode = now_seconds() - t0;
+    t0 = now_seconds();
+    SourceMap *decoded = (encoded != 0) ? source_map_decode(data, size) : NULL;
+    double t_decode = now_seconds() - t0;
+    if (decoded == NULL) {
+        return 1;
+    }
+
+    DiagnosticList list = {NULL, 0U, 0U, NULL};
+    list.items = (Diagnostic *)calloc(diags, sizeof(Diagnostic));
+    if (list.items == NULL) {
+        return 1;
+    }
+    list.count = diags;
+    char generated[] = "out.c";
+
+    double best = 1e9;
+    for (int round = 0; round < 5; ++round) {
+        for (size_t k = 0U; k < diags; ++k) {
+            size_t at = (k * 7919U) % lines;
+            list.items[k] = (Diagnostic){generated, (int)at + 1, 1 + (int)(k % 30U), DIAG_ERROR,
+                                         NULL, NULL, 0, 0, NULL};
+        }
+        t0 = now_seconds();
+        size_t remapped = source_map_remap_list(decoded, generated, &list);
+        double t = now_seconds() - t0;
+        if (remapped != diags) {
+            fprintf(stderr, "only %zu of %zu remapped\n", remapped, diags);
+            return 1;
+        }
+        best = (t < best) ? t : best;
+    }
+
+    size_t segments = source_map_segment_count(map);
+    printf("source map: %zu lines, %zu segments, %zu bytes encoded (%.2f bytes/segment)\n", lines,
+           segments, size, (double)size / (double)segments);
+    printf("  build  %8.2f ms\n  encode %8.2f ms\n  decode %8.2f ms\n", t_build * 1e3,
+           t_encode * 1e3, t_decode * 1e3);
+    printf("  remap  %8.2f ms for %zu diagnostics\n", best * 1e3, diags);
+
+    free(list.items);
+    free(data);
+    free(gen);
+    source_map_destroy(decoded);
+    source_map_destroy(map);
+    return 0;
+}
@@ -0,0 +1,540 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: cplus_bench.c
+ * DESC.: end-to-end pipeline throughput on synthetic corpora, with baselines
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "arena.h"
+#include "file_io.h"
+#include "job_pool.h"
+#include "json.h"
+#include "pipeline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#define BENCH_BATCH_SIZE 16U
+#define BENCH_MAX_CORPORA 4U
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+/* A generated corpus: every input of one shape, and what each must return */
+typedef struct {
+    const char* name;
+    char**      inputs;
+    char**      outputs;
+    size_t      count;
+    size_t      bytes;
+    int         expected_rc;
+} Corpus;
+
+/* Result of the best iteration over one corpus */
+typedef struct {
+    const char* name;
+    size_t      files;
+    size_t      bytes;
+    double      seconds;
+    double      files_per_s;
+    double      mb_per_s;
+} CorpusResult;
+
+/* One pipeline_run_batch() call, the unit of work on the pool */
+typedef struct {
+    const PipelineOptions* options;
+    int*                   rcs;
+    size_t                 count;
+} BenchBatch;
+
+typedef struct {
+    const char* compiler;
+    const char* std_name;
+    const char* only;          /* run a single corpus; NULL = all */
+    const char* json_path;     /* NULL = stdout */
+    const char* baseline_path;
+    double      scale;
+    double      tolerance;     /* fraction, 0.10 = 10% */
+    size_t      workers;
+    int         iterations;
+} BenchConfig;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static size_t scaled(size_t count, double scale) {
+    size_t n = (size_t)((double)count * scale);
+    return (n > 0U) ? n : 1U;
+}
+
+/* Write text[0..size) as the corpus' next input */
+static int corpus_add(Corpus *corpus, const char *dir, const char *name, const char *text,
+                      size_t size) {
+    char path[512];
+    char output[512];
+    int  n = snprintf(path, sizeof(path), "%s/%s.cplus", dir, name);
+    int  m = snprintf(output, sizeof(output), "%s/%s.c", dir, name);
+    if ((n <= 0) || ((size_t)n >= sizeof(path)) || (m <= 0) || ((size_t)m >= sizeof(output)) ||
+        (file_io_write_all(path, text, size) == 0)) {
+        return 0;
+    }
+
+    char **inputs  = (char **)realloc(corpus->inputs, (corpus->count + 1U) * sizeof(char *));
+    if (inputs != NULL) {
+        corpus->inputs = inputs;
+    }
+    char **outputs = (char **)realloc(corpus->outputs, (corpus->count + 1U) * sizeof(char *));
+    if (outputs != NULL) {
+        corpus->outputs = outputs;
+    }
+    if ((inputs == NULL) || (outputs == NULL)) {
+        return 0;
+    }
+
+    corpus->inputs[corpus->count]  = strdup(path);
+    corpus->outputs[corpus->count] = strdup(output);
+    if ((corpus->inputs[corpus->count] == NULL) || (corpus->outputs[corpus->count] == NULL)) {
+        free(corpus->inputs[corpus->count]);
+        free(corpus->outputs[corpus->count]);
+        return 0;
+    }
+    ++corpus->count;
+    corpus->bytes += size;
+    return 1;
+}
+
+static void corpus_free(Corpus *corpus) {
+    for (size_t i = 0U; i < corpus->count; ++i) {
+        free(corpus->inputs[i]);
+        free(corpus->outputs[i]);
+    }
+    free(corpus->inputs);
+    free(corpus->outputs);
+}
+
+/* Format one file into a memory stream and add it; fill writes the body */
+static int corpus_add_generated(Corpus *corpus, const char *dir, const char *name,
+                                void (*fill)(FILE *, unsigned, size_t), unsigned index,
+                                size_t amount) {
+    char  *text = NULL;
+    size_t size = 0U;
+    FILE  *out  = open_memstream(&text, &size);
+    if (out == NULL) {
+        return 0;
+    }
+    fill(out, index, amount);
+    int ok = (fclose(out) == 0) && (corpus_add(corpus, dir, name, text, size) != 0);
+    free(text);
+    return ok;
+}
+
+/* A handful of declarations: process startup dominates */
+static void fill_tiny(FILE *out, unsigned index, size_t amount) {
+    (void)amount;
+    (void)fprintf(out,
+                  "#include <stddef.h>\n\n"
+                  "typedef struct { int id; size_t len; } Tiny%u;\n\n"
+                  "int tiny_%u(const Tiny%u *t) {\n"
+                  "    return (t != NULL) ? t->id + (int)t->len : %u;\n"
+                  "}\n",
+                  index, index, index, index);
+}
+
+/* amount bytes of ordinary functions: the compiler front end dominates */
+static void fill_huge(FILE *out, unsigned index, size_t amount) {
+    long written = 0L;
+    for (unsigned f = 0U; (size_t)written < amount; ++f) {
+        int n = fprintf(out,
+                        "static int huge_%u_%u(const int *values, int count) {\n"
+                        "    int acc = %u;\n"
+                        "    for (int i = 0; i < count; ++i) {\n"
+                        "        if ((values[i] %% %u) == 0) {\n"
+                        "            acc += values[i] * %u;\n"
+                        "        } else {\n"
+                        "            acc ^= values[i] >> (i & 7);\n"
+                        "        }\n"
+                        "    }\n"
+                        "    return acc;\n"
+                        "}\n\n",
+                        index, f, f, 2U + (f % 13U), 1U + (f % 7U));
+        if (n < 0) {
+            return;
+        }
+        written += n;
+    }
+}
+
+/* amount errors, each with a context snippet: the diagnostics parser dominates */
+static void fill_errors(FILE *out, unsigned index, size_t amount) {
+    (void)fprintf(out, "int errors_%u(int x) {\n", index);
+    for (size_t e = 0U; e < amount; ++e) {
+        (void)fprintf(out, "    x += undeclared_%u_%zu * (x - %zu);\n", index, e, e);
+    }
+    (void)fprintf(out, "    return x;\n}\n");
+}
+
+/* Use the bottom of the include chain from the top */
+static void fill_includer(FILE *out, unsigned index, size_t amount) {
+    (void)fprintf(out,
+                  "#include \"chain_0.hplus\"\n\n"
+                  "int includer_%u(void) {\n"
+                  "    return chain_%zu(%u);\n"
+                  "}\n",
+                  index, amount - 1U, index);
+}
+
+/* chain_k.hplus includes chain_{k+1}.hplus, down to depth - 1 */
+static int write_include_chain(const char *dir, size_t depth) {
+    for (size_t k = 0U; k < depth; ++k) {
+        char path[512];
+        char text[512];
+        int  n = snprintf(path, sizeof(path), "%s/chain_%zu.hplus", dir, k);
+        int  m = (k + 1U < depth)
+                     ? snprintf(text, sizeof(text),
+                                "#ifndef CHAIN_%zu_HPLUS\n#define CHAIN_%zu_HPLUS\n"
+                                "#include \"chain_%zu.hplus\"\n"
+                                "static inline int chain_%zu(int x) { return x + %zu; }\n#endif\n",
+                                k, k, k + 1U, k, k)
+                     : snprintf(text, sizeof(text),
+                                "#ifndef CHAIN_%zu_HPLUS\n#define CHAIN_%zu_HPLUS\n"
+                                "static inline int chain_%zu(int x) { return x + %zu; }\n#endif\n",
+                                k, k, k, k);
+        if ((n <= 0) || ((size_t)n >= sizeof(path)) || (m <= 0) || ((size_t)m >= sizeof(text)) ||
+            (file_io_write_all(path, text, (size_t)m) == 0)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * The four corpora: many tiny files, a few huge ones, error-heavy files and
+ * files reaching the bottom of a deep .hplus include chain. Sizes are scaled.
+ */
+static int generate_corpus(Corpus *corpus, const char *root, const char *name, double scale) {
+    char dir[384];
+    int  n = snprintf(dir, sizeof(dir), "%s/%s", root, name);
+    if ((n <= 0) || ((size_t)n >= sizeof(dir)) || (mkdir(dir, 0700) != 0)) {
+        return 0;
+    }
+
+    corpus->name = name;
+    int ok = 1;
+    char file[64];
+    if (strcmp(name, "tiny") == 0) {
+        for (size_t i = 0U; (ok != 0) && (i < scaled(400U, scale)); ++i) {
+            (void)snprintf(file, sizeof(file), "tiny_%zu", i);
+            ok = corpus_add_generated(corpus, dir, file, fill_tiny, (unsigned)i, 0U);
+        }
+    } else if (strcmp(name, "huge") == 0) {
+        for (size_t i = 0U; (ok != 0) && (i < 4U); ++i) {
+            (void)snprintf(file, sizeof(file), "huge_%zu", i);
+            ok = corpus_add_generated(corpus, dir, file, fill_huge, (unsigned)i,
+                                      scaled(2U << 20, scale));
+        }
+    } else if (strcmp(name, "errors") == 0) {
+        corpus->expected_rc = 1;
+        for (size_t i = 0U; (ok != 0) && (i < scaled(48U, scale)); ++i) {
+            (void)snprintf(file, sizeof(file), "errors_%zu", i);
+            ok = corpus_add_generated(corpus, dir, file, fill_errors, (unsigned)i, 200U);
+        }
+    } else if (strcmp(name, "includes") == 0) {
+        size_t depth = 64U;
+        ok = write_include_chain(dir, depth);
+        for (size_t i = 0U; (ok != 0) && (i < scaled(64U, scale)); ++i) {
+            (void)snprintf(file, sizeof(file), "includer_%zu", i);
+            ok = corpus_add_generated(corpus, dir, file, fill_includer, (unsigned)i, depth);
+        }
+    } else {
+        ok = 0;
+    }
+    return ok;
+}
+
+static void run_bench_batch(void *arg) {
+    BenchBatch *batch = (BenchBatch *)arg;
+    pipeline_run_batch(batch->options, batch->count, batch->rcs);
+}
+
+/*
+ * Run the whole corpus through the pipeline the way the driver does: batches
+ * of at most BENCH_BATCH_SIZE, spread over the workers. Returns the wall time,
+ * or a negative value when an input did not end with the expected code.
+ */
+static double run_corpus(const Corpus *corpus, const BenchConfig *config, FILE *sink) {
+    PipelineOptions *options = (PipelineOptions *)calloc(corpus->count, sizeof(PipelineOptions));
+    int             *rcs     = (int *)calloc(corpus->count, sizeof(int));
+    BenchBatch      *batches = (BenchBatch *)calloc(corpus->count, sizeof(BenchBatch));
+    JobPool         *pool    = job_pool_create(config->workers);
+    double           elapsed = -1.0;
+
+    if ((options != NULL) && (rcs != NULL) && (batches != NULL) && (pool != NULL)) {
+        for (size_t i = 0U; i < corpus->count; ++i) {
+            options[i] = (PipelineOptions){
+                .input_path  = corpus->inputs[i],
+                .output_path = corpus->outputs[i],
+                .compiler    = config->compiler,
+                .std_name    = config->std_name,
+                .diag_stream = sink,
+            };
+        }
+
+        size_t batch_size = (corpus->count + config->workers - 1U) / config->workers;
+        batch_size = (batch_size < BENCH_BATCH_SIZE) ? batch_size : BENCH_BATCH_SIZE;
+
+        double start = now_seconds();
+        size_t n_batches = 0U;
+        for (size_t k = 0U; k < corpus->count; k += batch_size) {
+            BenchBatch *batch = &batches[n_batches++];
+            batch->options = &options[k];
+            batch->rcs     = &rcs[k];
+            batch->count   = ((corpus->count - k) < batch_size) ? (corpus->count - k) : batch_size;
+            if (job_pool_submit(pool, run_bench_batch, batch) == 0) {
+                run_bench_batch(batch);
+            }
+        }
+        job_pool_wait(pool);
+        elapsed = now_seconds() - start;
+
+        for (size_t i = 0U; i < corpus->count; ++i) {
+            if (rcs[i] != corpus->expected_rc) {
+                fprintf(stderr, "cplus_bench: %s returned %d, expected %d\n", corpus->inputs[i],
+                        rcs[i], corpus->expected_rc);
+                elapsed = -1.0;
+                break;
+            }
+        }
+    }
+
+    job_pool_destroy(pool);
+    free(options);
+    free(rcs);
+    free(batches);
+    return elapsed;
+}
+
+static void fprint_results(FILE *out, const BenchConfig *config, const CorpusResult results[],
+                           size_t count, long peak_rss_kb, long peak_child_rss_kb) {
+    (void)fprintf(out, "{\n  \"cplus_bench\": 1,\n  \"compiler\": \"%s\",\n  \"std\": \"%s\",\n"
+                       "  \"jobs\": %zu,\n  \"iterations\": %d,\n  \"scale\": %g,\n"
+                       "  \"corpora\": [\n",
+                  config->compiler, config->std_name, config->workers, config->iterations,
+                  config->scale);
+    for (size_t c = 0U; c < count; ++c) {
+        const CorpusResult *r = &results[c];
+        (void)fprintf(out,
+                      "    {\"name\": \"%s\", \"files\": %zu, \"bytes\": %zu, \"seconds\": %.6f, "
+                      "\"files_per_s\": %.3f, \"mb_per_s\": %.3f}%s\n",
+                      r->name, r->files, r->bytes, r->seconds, r->files_per_s, r->mb_per_s,
+                      (c + 1U < count) ? "," : "");
+    }
+    (void)fprintf(out, "  ],\n  \"peak_rss_kb\": %ld,\n  \"peak_child_rss_kb\": %ld\n}\n",
+                  peak_rss_kb, peak_child_rss_kb);
+}
+
+static double json_number(const JsonValue *value, double fallback) {
+    return ((value != NULL) && (value->type == JSON_NUMBER)) ? value->number : fallback;
+}
+
+/*
+ * Compare with a stored run: a corpus whose files/s dropped, or a peak RSS
+ * that grew, by more than the tolerance is a regression. Corpora missing on
+ * either side are skipped. Returns the number of regressions, or -1 when the
+ * baseline cannot be read.
+ */
+static int compare_baseline(const char *path, double tolerance, const CorpusResult results[],
+                            size_t count, long peak_rss_kb) {
+    size_t size = 0U;
+    char  *text = file_io_read_all(path, &size);
+    Arena *arena = arena_create(4096U);
+    const JsonValue *doc =
+        ((text != NULL) && (arena != NULL)) ? json_parse(arena, text, size, NULL) : NULL;
+    const JsonValue *corpora = json_get(doc, "corpora");
+    if ((corpora == NULL) || (corpora->type != JSON_ARRAY)) {
+        fprintf(stderr, "cplus_bench: cannot read baseline '%s'\n", path);
+        arena_destroy(arena);
+        free(text);
+        return -1;
+    }
+
+    int regressions = 0;
+    for (size_t c = 0U; c < count; ++c) {
+        for (size_t k = 0U; k < corpora->count; ++k) {
+            const char *name = json_string(json_get(&corpora->items[k], "name"));
+            double      base = json_number(json_get(&corpora->items[k], "files_per_s"), 0.0);
+            if ((name == NULL) || (strcmp(name, results[c].name) != 0) || (base <= 0.0)) {
+                continue;
+            }
+
+            double change = (results[c].files_per_s - base) / base;
+            int    worse  = (change < -tolerance);
+            regressions += worse;
+            fprintf(stderr, "  %-9s %10.1f files/s vs %10.1f  %+6.1f%%  %s\n", results[c].name,
+                    results[c].files_per_s, base, change * 100.0,
+                    (worse != 0) ? "REGRESSION" : "ok");
+        }
+    }
+
+    double base_rss = json_number(json_get(doc, "peak_rss_kb"), 0.0);
+    if (base_rss > 0.0) {
+        double change = ((double)peak_rss_kb - base_rss) / base_rss;
+        int    worse  = (change > tolerance);
+        regressions += worse;
+        fprintf(stderr, "  %-9s %10ld KB      vs %10.0f  %+6.1f%%  %s\n", "peak rss", peak_rss_kb,
+                base_rss, change * 100.0, (worse != 0) ? "REGRESSION" : "ok");
+    }
+
+    arena_destroy(arena);
+    free(text);
+    return regressions;
+}
+
+static void print_usage(const char *program_name) {
+    fprintf(stderr,
+            "Usage: %s [--cc gcc|clang] [--std c23] [-j N] [--iterations N] [--scale F]\n"
+            "          [--corpus tiny|huge|errors|includes] [--json FILE] [--baseline FILE]\n"
+            "          [--tolerance PCT]\n"
+            "  Runs the pipeline over synthetic corpora and prints files/s, MB/s and peak RSS\n"
+            "  as JSON (best of N iterations, default 3). With --baseline, exits 1 when a\n"
+            "  corpus is slower, or the peak RSS larger, by more than PCT%% (default 10).\n",
+            program_name);
+}
+
+/* -------------------------------------------------------------------------
+ * Entry point
+ * ---------------------------------------------------------------------- */
+
+int main(int argc, char **argv) {
+    BenchConfig config = {"gcc", "c23", NULL, NULL, NULL, 1.0, 0.10, 0U, 3};
+
+    for (int i = 1; i < argc; ++i) {
+        const char *value = ((i + 1) < argc) ? argv[i + 1] : NULL;
+        if ((strcmp(argv[i], "--cc") == 0) && (value != NULL)) {
+            config.compiler = value;
+        } else if ((strcmp(argv[i], "--std") == 0) && (value != NULL)) {
+            config.std_name = value;
+        } else if ((strcmp(argv[i], "-j") == 0) && (value != NULL)) {
+            config.workers = strtoul(value, NULL, 10);
+        } else if ((strcmp(argv[i], "--iterations") == 0) && (value != NULL)) {
+            config.iterations = atoi(value);
+        } else if ((strcmp(argv[i], "--scale") == 0) && (value != NULL)) {
+            config.scale = strtod(value, NULL);
+        } else if ((strcmp(argv[i], "--corpus") == 0) && (value != NULL)) {
+            config.only = value;
+        } else if ((strcmp(argv[i], "--json") == 0) && (value != NULL)) {
+            config.json_path = value;
+        } else if ((strcmp(argv[i], "--baseline") == 0) && (value != NULL)) {
+            config.baseline_path = value;
+        } else if ((strcmp(argv[i], "--tolerance") == 0) && (value != NULL)) {
+            config.tolerance = strtod(value, NULL) / 100.0;
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    if ((config.iterations <= 0) || (config.scale <= 0.0) || (config.tolerance < 0.0)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (config.workers == 0U) {
+        config.workers = job_pool_default_workers();
+    }
+
+    static const char *const k_corpora[BENCH_MAX_CORPORA] = {"tiny", "huge", "errors", "includes"};
+
+    char root[] = "/tmp/cplus_bench_XXXXXX";
+    FILE *sink  = fopen("/dev/null", "w");
+    if ((mkdtemp(root) == NULL) || (sink == NULL)) {
+        fprintf(stderr, "cplus_bench: cannot set up the work directory\n");
+        return 2;
+    }
+
+    CorpusResult results[BENCH_MAX_CORPORA];
+    size_t       n_results = 0U;
+    int          ok = 1;
+
+    for (size_t c = 0U; (ok != 0) && (c < BENCH_MAX_CORPORA); ++c) {
+        if ((config.only != NULL) && (strcmp(config.only, k_corpora[c]) != 0)) {
+            continue;
+        }
+
+        Corpus corpus = {NULL, NULL, NULL, 0U, 0U, 0};
+        ok = generate_corpus(&corpus, root, k_corpora[c], config.scale);
+
+        double best = -1.0;
+        for (int it = 0; (ok != 0) && (it < config.iterations); ++it) {
+            double t = run_corpus(&corpus, &config, sink);
+            ok   = (t >= 0.0);
+            best = ((best < 0.0) || (t < best)) ? t : best;
+        }
+
+        if (ok != 0) {
+            double seconds = (best > 0.0) ? best : 1e-9;
+            results[n_results++] = (CorpusResult){
+                k_corpora[c],
+                corpus.count,
+                corpus.bytes,
+                best,
+                (double)corpus.count / seconds,
+                ((double)corpus.bytes / (1024.0 * 1024.0)) / seconds,
+            };
+        } else {
+            fprintf(stderr, "cplus_bench: the %s corpus failed\n", k_corpora[c]);
+        }
+        corpus_free(&corpus);
+    }
+    (void)fclose(sink);
+
+    char cmd[64];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    if ((ok == 0) || (n_results == 0U)) {
+        return 2;
+    }
+
+    /* ru_maxrss is in KB on Linux; RUSAGE_CHILDREN reports the largest compiler */
+    struct rusage self;
+    struct rusage children;
+    (void)getrusage(RUSAGE_SELF, &self);
+    (void)getrusage(RUSAGE_CHILDREN, &children);
+
+    FILE *out = (config.json_path != NULL) ? fopen(config.json_path, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "cplus_bench: cannot write '%s'\n", config.json_path);
+        return 2;
+    }
+    fprint_results(out, &config, results, n_results, self.ru_maxrss, children.ru_maxrss);
+    if ((out != stdout) && (fclose(out) != 0)) {
+        return 2;
+    }
+
+    if (config.baseline_path != NULL) {
+        int regressions = compare_baseline(config.baseline_path, config.tolerance, results,
+                                           n_results, self.ru_maxrss);
+        if (regressions != 0) {
+            return (regressions < 0) ? 2 : 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * FILE: arena.c
+ * DESC.: bump-pointer memory arena
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "arena.h"
+
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t             capacity;
+    size_t             used;
+    alignas(max_align_t) unsigned char data[];
+} ArenaChunk;
+
+/* The arena header lives in the first chunk's allocation */
+struct Arena {
+    ArenaChunk* head;   /* chunk currently bumped */
+    ArenaChunk* first;  /* embedded chunk, freed together with the arena */
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static ArenaChunk *chunk_new(size_t capacity) {
+    ArenaChunk *chunk = (ArenaChunk *)malloc(sizeof(ArenaChunk) + capacity);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->next     = NULL;
+    chunk->capacity = capacity;
+    chunk->used     = 0U;
+    return chunk;
+}
+
+static void *chunk_take(ArenaChunk *chunk, size_t size, size_t align) {
+    uintptr_t base    = (uintptr_t)chunk->data;
+    uintptr_t aligned = (base + chunk->used + (align - 1U)) & ~(uintptr_t)(align - 1U);
+    size_t    offset  = (size_t)(aligned - base);
+
+    if ((offset > chunk->capacity) || (size > chunk->capacity - offset)) {
+        return NULL;
+    }
+    chunk->used = offset + size;
+    return chunk->data + offset;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+Arena *arena_create(size_t initial_capacity) {
+    if (initial_capacity < 64U) {
+        initial_capacity = 64U;
+    }
+
+    /* One allocation: the Arena header is carved from the first chunk */
+    ArenaChunk *first = chunk_new(initial_capacity + sizeof(Arena));
+    if (first == NULL) {
+        return NULL;
+    }
+
+    Arena *arena = (Arena *)chunk_take(first, sizeof(Arena), alignof(Arena));
+    arena->head  = first;
+    arena->first = first;
+    return arena;
+}
+
+void *arena_alloc(Arena *arena, size_t size, size_t align) {
+    if ((arena == NULL) || (align == 0U) || ((align & (align - 1U)) != 0U)) {
+        return NULL;
+    }
+
+    void *p = chunk_take(arena->head, size, align);
+    if (p != NULL) {
+        return p;
+    }
+
+    size_t capacity = arena->head->capacity * 2U;
+    if (capacity < size + align) {
+        capacity = size + align;
+    }
+
+    ArenaChunk *chunk = chunk_new(capacity);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->next = arena->head;
+    arena->head = chunk;
+    return chunk_take(chunk, size, align);
+}
+
+char *arena_strndup(Arena *arena, const char *text, size_t len) {
+    char *copy = (char *)arena_alloc(arena, len + 1U, 1U);
+    if (copy == NULL) {
+        return NULL;
+    }
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+void arena_reset(Arena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    /* Chunks double, so the newest one is the largest */
+    ArenaChunk *first = arena->first;
+    ArenaChunk *keep  = (arena->head != first) ? arena->head : NULL;
+    ArenaChunk *chunk = (keep != NULL) ? keep->next : first;
+    while (chunk != first) {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    /* The header stays where arena_create() carved it */
+    first->used = (size_t)((unsigned char *)(arena + 1) - first->data);
+    if (keep != NULL) {
+        keep->next  = first;
+        keep->used  = 0U;
+        arena->head = keep;
+    } else {
+        arena->head = first;
+    }
+}
+
+void arena_destroy(Arena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    ArenaChunk *first = arena->first;
+    ArenaChunk *chunk = arena->head;
+    while (chunk != first) {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(first); /* also releases the header */
+}
@@ -0,0 +1,41 @@
+/*
+ * FILE: arena.h
+ * DESC.: this file is the declaration of the bump-pointer memory arena
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_ARENA_H
+#define CPLUS_ARENA_H
+
+#include <stddef.h>
+
+/*
+ * Bump allocator for data that lives and dies together. Allocations are never
+ * freed one by one; arena_destroy() releases everything at once. Memory comes
+ * in chunks: the first one holds initial_capacity bytes (plus the arena
+ * header), later ones double, so a caller that knows an upper bound up front
+ * gets exactly one malloc()/free() pair. Not thread-safe.
+ */
+typedef struct Arena Arena;
+
+/* NULL on allocation failure */
+Arena* arena_create(size_t initial_capacity);
+
+/* size bytes aligned to align (a power of two); NULL on allocation failure */
+void* arena_alloc(Arena* arena, size_t size, size_t align);
+
+/* Copy text[0..len) plus a NUL terminator into the arena */
+char* arena_strndup(Arena* arena, const char* text, size_t len);
+
+/*
+ * Forget every allocation but keep the largest chunk, so an arena reused for
+ * data of similar size (one translation unit after another) stops calling
+ * malloc() once it has grown; the other chunks are released.
+ */
+void arena_reset(Arena* arena);
+
+void arena_destroy(Arena* arena);
+
+#endif // CPLUS_ARENA_H
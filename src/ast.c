@@ -0,0 +1,412 @@
+/*
+ * FILE: ast.c
+ * DESC.: arena-backed AST with paged node pools and contiguous child lists
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "ast.h"
+
+#include "arena.h"
+
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AST_NODE_PAGE_SHIFT  10U  /* 1024 nodes, 16 KiB */
+#define AST_CHILD_PAGE_SHIFT 12U  /* 4096 indices, 16 KiB */
+#define AST_PAGE_ALIGN       64U  /* pages start on a cache line */
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+/*
+ * Elements addressed by a 32-bit index through a page table. A run reserved
+ * in one call is contiguous: one that does not fit in the current page starts
+ * a new one, and one longer than a page gets consecutive table entries into a
+ * single block.
+ */
+typedef struct {
+    unsigned char** pages;
+    uint32_t        n_pages;
+    uint32_t        cap_pages;
+    uint32_t        count;
+    uint32_t        shift;
+    uint32_t        elem_size;
+} AstPages;
+
+/* A node opened by ast_begin() */
+typedef struct {
+    AstKind  kind;
+    uint32_t token;
+    size_t   base;  /* first of its children on the finished stack */
+} AstFrame;
+
+struct Ast {
+    Arena*    arena;
+    AstPages  nodes;
+    AstPages  kids;   /* child lists: a count, then that many AstIndex */
+    AstIndex  root;
+    int       failed;
+
+    /* Builder state, kept (like the arena memory) across ast_reset() */
+    AstIndex* finished;
+    size_t    n_finished;
+    size_t    finished_cap;
+    AstFrame* frames;
+    size_t    n_frames;
+    size_t    frames_cap;
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static void pages_clear(AstPages *pages) {
+    pages->pages     = NULL;
+    pages->n_pages   = 0U;
+    pages->cap_pages = 0U;
+    pages->count     = 0U;
+}
+
+static void *pages_at(const AstPages *pages, uint32_t index) {
+    uint32_t mask = (1U << pages->shift) - 1U;
+    return pages->pages[index >> pages->shift] + (size_t)(index & mask) * pages->elem_size;
+}
+
+/* First index of n contiguous new elements; AST_NONE on failure */
+static uint32_t pages_reserve(AstPages *pages, Arena *arena, uint32_t n) {
+    uint32_t per   = 1U << pages->shift;
+    uint64_t end   = (uint64_t)pages->n_pages << pages->shift;
+    uint64_t start = pages->count;
+
+    if ((uint64_t)pages->count + n > end) {
+        /* Start a fresh page; the tail of the current one stays unused */
+        start = end;
+        uint32_t n_new = (n + per - 1U) >> pages->shift;
+        if (start + ((uint64_t)n_new << pages->shift) > (uint64_t)AST_NONE) {
+            return AST_NONE;
+        }
+
+        if (pages->n_pages + n_new > pages->cap_pages) {
+            uint32_t new_cap = (pages->cap_pages == 0U) ? 16U : pages->cap_pages * 2U;
+            while (new_cap < pages->n_pages + n_new) {
+                new_cap *= 2U;
+            }
+            unsigned char **table = (unsigned char **)arena_alloc(
+                arena, new_cap * sizeof(unsigned char *), alignof(unsigned char *));
+            if (table == NULL) {
+                return AST_NONE;
+            }
+            if (pages->n_pages > 0U) {
+                memcpy(table, pages->pages, pages->n_pages * sizeof(unsigned char *));
+            }
+            pages->pages     = table;
+            pages->cap_pages = new_cap;
+        }
+
+        size_t page_bytes = (size_t)per * pages->elem_size;
+        unsigned char *block =
+            (unsigned char *)arena_alloc(arena, (size_t)n_new * page_bytes, AST_PAGE_ALIGN);
+        if (block == NULL) {
+            return AST_NONE;
+        }
+        for (uint32_t k = 0U; k < n_new; ++k) {
+            pages->pages[pages->n_pages++] = block + (size_t)k * page_bytes;
+        }
+    }
+
+    pages->count = (uint32_t)(start + n);
+    return (uint32_t)start;
+}
+
+static int push_finished(Ast *ast, AstIndex index) {
+    if (ast->n_finished >= ast->finished_cap) {
+        size_t new_cap = (ast->finished_cap == 0U) ? 256U : ast->finished_cap * 2U;
+        AstIndex *finished = (AstIndex *)realloc(ast->finished, new_cap * sizeof(AstIndex));
+        if (finished == NULL) {
+            return 0;
+        }
+        ast->finished     = finished;
+        ast->finished_cap = new_cap;
+    }
+    ast->finished[ast->n_finished++] = index;
+    return 1;
+}
+
+static AstIndex add_node(Ast *ast, AstKind kind, uint32_t token, uint32_t token_end,
+                         uint32_t children) {
+    AstIndex index = pages_reserve(&ast->nodes, ast->arena, 1U);
+    if (index == AST_NONE) {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+
+    AstNode *node = (AstNode *)pages_at(&ast->nodes, index);
+    *node = (AstNode){(uint16_t)kind, 0U, token, token_end, children};
+
+    if (push_finished(ast, index) == 0) {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+    return index;
+}
+
+/* Kind of the group a delimiter opens, AST_TOKEN for anything else */
+static AstKind group_opened(const char *text, uint32_t len) {
+    if (len == 1U) {
+        return (text[0] == '(') ? AST_PARENS : ((text[0] == '[') ? AST_BRACKETS
+                                               : ((text[0] == '{') ? AST_BRACES : AST_TOKEN));
+    }
+    if (len == 2U) {
+        if (memcmp(text, "<:", 2U) == 0) { return AST_BRACKETS; }
+        if (memcmp(text, "<%", 2U) == 0) { return AST_BRACES; }
+    }
+    return AST_TOKEN;
+}
+
+static AstKind group_closed(const char *text, uint32_t len) {
+    if (len == 1U) {
+        return (text[0] == ')') ? AST_PARENS : ((text[0] == ']') ? AST_BRACKETS
+                                               : ((text[0] == '}') ? AST_BRACES : AST_TOKEN));
+    }
+    if (len == 2U) {
+        if (memcmp(text, ":>", 2U) == 0) { return AST_BRACKETS; }
+        if (memcmp(text, "%>", 2U) == 0) { return AST_BRACES; }
+    }
+    return AST_TOKEN;
+}
+
+static int is_punct(const char *source, const TokenBuffer *tokens, size_t i, const char *text) {
+    size_t len = strlen(text);
+    return (tokens->kinds[i] == TOK_PUNCT) && (tokens->lengths[i] == len) &&
+           (memcmp(source + tokens->offsets[i], text, len) == 0);
+}
+
+static AstKind top_kind(const Ast *ast) {
+    return (ast->n_frames > 0U) ? ast->frames[ast->n_frames - 1U].kind : AST_KIND_COUNT;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+Ast *ast_create(size_t initial_capacity) {
+    Ast *ast = (Ast *)calloc(1U, sizeof(Ast));
+    if (ast == NULL) {
+        return NULL;
+    }
+
+    ast->arena = arena_create(initial_capacity);
+    if (ast->arena == NULL) {
+        free(ast);
+        return NULL;
+    }
+
+    ast->nodes.shift     = AST_NODE_PAGE_SHIFT;
+    ast->nodes.elem_size = (uint32_t)sizeof(AstNode);
+    ast->kids.shift      = AST_CHILD_PAGE_SHIFT;
+    ast->kids.elem_size  = (uint32_t)sizeof(AstIndex);
+    ast->root            = AST_NONE;
+    return ast;
+}
+
+void ast_reset(Ast *ast) {
+    if (ast == NULL) {
+        return;
+    }
+
+    arena_reset(ast->arena);
+    pages_clear(&ast->nodes);
+    pages_clear(&ast->kids);
+    ast->root       = AST_NONE;
+    ast->failed     = 0;
+    ast->n_finished = 0U;
+    ast->n_frames   = 0U;
+}
+
+void ast_destroy(Ast *ast) {
+    if (ast == NULL) {
+        return;
+    }
+
+    arena_destroy(ast->arena);
+    free(ast->finished);
+    free(ast->frames);
+    free(ast);
+}
+
+void ast_begin(Ast *ast, AstKind kind, uint32_t token) {
+    if ((ast == NULL) || (ast->failed != 0)) {
+        return;
+    }
+
+    if (ast->n_frames >= ast->frames_cap) {
+        size_t new_cap = (ast->frames_cap == 0U) ? 64U : ast->frames_cap * 2U;
+        AstFrame *frames = (AstFrame *)realloc(ast->frames, new_cap * sizeof(AstFrame));
+        if (frames == NULL) {
+            ast->failed = 1;
+            return;
+        }
+        ast->frames     = frames;
+        ast->frames_cap = new_cap;
+    }
+    ast->frames[ast->n_frames++] = (AstFrame){kind, token, ast->n_finished};
+}
+
+AstIndex ast_end(Ast *ast, uint32_t token_end) {
+    if ((ast == NULL) || (ast->failed != 0)) {
+        return AST_NONE;
+    }
+    if (ast->n_frames == 0U) {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+
+    AstFrame frame = ast->frames[--ast->n_frames];
+    size_t   count = ast->n_finished - frame.base;
+    if (count >= (size_t)AST_NONE) {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+
+    /* The children leave the finished stack as one contiguous list */
+    uint32_t list = pages_reserve(&ast->kids, ast->arena, (uint32_t)count + 1U);
+    if (list == AST_NONE) {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+    AstIndex *slots = (AstIndex *)pages_at(&ast->kids, list);
+    slots[0] = (AstIndex)count;
+    if (count > 0U) {
+        memcpy(slots + 1, ast->finished + frame.base, count * sizeof(AstIndex));
+    }
+    ast->n_finished = frame.base;
+
+    return add_node(ast, frame.kind, frame.token, token_end, list);
+}
+
+AstIndex ast_leaf(Ast *ast, AstKind kind, uint32_t token) {
+    if ((ast == NULL) || (ast->failed != 0)) {
+        return AST_NONE;
+    }
+    return add_node(ast, kind, token, token + 1U, AST_NONE);
+}
+
+AstIndex ast_finish(Ast *ast) {
+    if (ast == NULL) {
+        return AST_NONE;
+    }
+    if ((ast->failed != 0) || (ast->n_frames != 0U) || (ast->n_finished != 1U)) {
+        ast->failed = 1;
+        return AST_NONE;
+    }
+
+    ast->root       = ast->finished[0];
+    ast->n_finished = 0U;
+    return ast->root;
+}
+
+AstIndex ast_build_token_tree(Ast *ast, const char *source, const TokenBuffer *tokens) {
+    if ((ast == NULL) || (source == NULL) || (tokens == NULL) || (tokens->count == 0U)) {
+        return AST_NONE;
+    }
+
+    ast_reset(ast);
+    ast_begin(ast, AST_TRANSLATION_UNIT, 0U);
+
+    size_t i = 0U;
+    while ((tokens->kinds[i] != TOK_EOF) && (ast->failed == 0)) {
+        uint32_t    t    = (uint32_t)i;
+        const char *text = source + tokens->offsets[i];
+        uint32_t    len  = tokens->lengths[i];
+
+        if (((tokens->flags[i] & TOKF_LINE_START) != 0U) &&
+            (is_punct(source, tokens, i, "#") || is_punct(source, tokens, i, "%:"))) {
+            ast_begin(ast, AST_DIRECTIVE, t);
+            do {
+                (void)ast_leaf(ast, AST_TOKEN, (uint32_t)i);
+                ++i;
+            } while ((tokens->kinds[i] != TOK_EOF) && ((tokens->flags[i] & TOKF_LINE_START) == 0U));
+            (void)ast_end(ast, (uint32_t)i);
+            continue;
+        }
+
+        if (top_kind(ast) == AST_TRANSLATION_UNIT) {
+            ast_begin(ast, AST_ITEM, t);
+        }
+
+        AstKind opened = group_opened(text, len);
+        AstKind closed = (opened == AST_TOKEN) ? group_closed(text, len) : AST_TOKEN;
+        if (opened != AST_TOKEN) {
+            ast_begin(ast, opened, t);
+        } else if (closed != AST_TOKEN) {
+            if (top_kind(ast) != closed) {
+                ast->failed = 1;
+                break;
+            }
+            uint32_t opener = ast->frames[ast->n_frames - 1U].token;
+            (void)ast_end(ast, t + 1U);
+
+            /* A body right after ')' at file scope ends a function definition */
+            if ((closed == AST_BRACES) && (top_kind(ast) == AST_ITEM) && (opener > 0U) &&
+                is_punct(source, tokens, opener - 1U, ")")) {
+                (void)ast_end(ast, t + 1U);
+            }
+        } else {
+            (void)ast_leaf(ast, AST_TOKEN, t);
+            if ((top_kind(ast) == AST_ITEM) && is_punct(source, tokens, i, ";")) {
+                (void)ast_end(ast, t + 1U);
+            }
+        }
+        ++i;
+    }
+
+    /* A file may end inside a declaration, but not inside a group */
+    if ((ast->failed == 0) && (top_kind(ast) == AST_ITEM)) {
+        (void)ast_end(ast, (uint32_t)i);
+    }
+    if (top_kind(ast) == AST_TRANSLATION_UNIT) {
+        (void)ast_end(ast, (uint32_t)i);
+    }
+    return ast_finish(ast);
+}
+
+AstIndex ast_root(const Ast *ast) {
+    return (ast != NULL) ? ast->root : AST_NONE;
+}
+
+size_t ast_node_count(const Ast *ast) {
+    return (ast != NULL) ? ast->nodes.count : 0U;
+}
+
+const AstNode *ast_node(const Ast *ast, AstIndex index) {
+    return (const AstNode *)pages_at(&ast->nodes, index);
+}
+
+const AstIndex *ast_children(const Ast *ast, AstIndex index, uint32_t *out_count) {
+    const AstNode *node = ast_node(ast, index);
+    if (node->children == AST_NONE) {
+        *out_count = 0U;
+        return NULL;
+    }
+
+    const AstIndex *list = (const AstIndex *)pages_at(&ast->kids, node->children);
+    *out_count = list[0];
+    return list + 1;
+}
+
+const char *ast_kind_name(AstKind kind) {
+    static const char *const names[AST_KIND_COUNT] = {
+        [AST_TRANSLATION_UNIT] = "translation unit",
+        [AST_DIRECTIVE]        = "directive",
+        [AST_ITEM]             = "item",
+        [AST_PARENS]           = "parentheses",
+        [AST_BRACKETS]         = "brackets",
+        [AST_BRACES]           = "braces",
+        [AST_TOKEN]            = "token",
+    };
+    return ((unsigned)kind < (unsigned)AST_KIND_COUNT) ? names[kind] : "unknown";
+}
@@ -0,0 +1,102 @@
+/*
+ * FILE: ast.h
+ * DESC.: this file is the declaration of the arena-backed, index-linked AST
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_AST_H
+#define CPLUS_AST_H
+
+#include "lexer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Nodes refer to each other by 32-bit index, never by pointer */
+typedef uint32_t AstIndex;
+
+#define AST_NONE UINT32_MAX
+
+typedef enum {
+    AST_TRANSLATION_UNIT, // children: directives and file-scope items
+    AST_DIRECTIVE,        // one preprocessing directive line; children: its tokens
+    AST_ITEM,             // a file-scope declaration or function definition
+    AST_PARENS,           // ( ... ); token is the opener, token_end is past the closer
+    AST_BRACKETS,         // [ ... ] or <: ... :>
+    AST_BRACES,           // { ... } or <% ... %>
+    AST_TOKEN,            // leaf: one token
+    AST_KIND_COUNT
+} AstKind;
+
+/*
+ * 16 bytes, four to a cache line. Token positions index the TokenBuffer the
+ * tree was built from, so spellings stay in the source.
+ */
+typedef struct {
+    uint16_t kind;      // AstKind
+    uint16_t flags;     // free for lowering passes; 0 when built
+    uint32_t token;     // first token
+    uint32_t token_end; // one past the last token
+    uint32_t children;  // start of the child list, AST_NONE for a leaf
+} AstNode;
+
+/*
+ * A tree owned by one translation unit. Nodes and child lists live in pages
+ * carved from a single arena: node i is found through a page table, and the
+ * children of a node are one contiguous run of AstIndex. Nodes are numbered
+ * in post-order (children before their parent, the root last), so a loop over
+ * 0..ast_node_count() is a bottom-up pass over dense memory. ast_reset()
+ * drops a whole tree with one arena reset. Not thread-safe.
+ */
+typedef struct Ast Ast;
+
+/* initial_capacity sizes the first arena chunk; NULL on allocation failure */
+Ast* ast_create(size_t initial_capacity);
+
+/* Drop every node; the memory is kept for the next tree */
+void ast_reset(Ast* ast);
+
+void ast_destroy(Ast* ast);
+
+/*
+ * Builder. ast_begin() opens a node; every node finished until the matching
+ * ast_end() becomes one of its children, in order. Failures (allocation, more
+ * than 2^32 - 1 nodes) are sticky and reported by ast_finish().
+ */
+void ast_begin(Ast* ast, AstKind kind, uint32_t token);
+
+/* Close the innermost open node, spanning tokens up to token_end (exclusive) */
+AstIndex ast_end(Ast* ast, uint32_t token_end);
+
+AstIndex ast_leaf(Ast* ast, AstKind kind, uint32_t token);
+
+/*
+ * Make the single finished top-level node the root. AST_NONE when a node is
+ * still open, there is not exactly one top-level node, or building failed.
+ */
+AstIndex ast_finish(Ast* ast);
+
+/*
+ * Replace the tree with a token tree of tokens: a translation unit of
+ * directives and file-scope items (ending at ';' or at the body of a function
+ * definition), with every (), [] and {} group a node and every other token a
+ * leaf. Tokens of a directive line are all leaves. Returns the root, or
+ * AST_NONE when the delimiters do not balance or building failed.
+ */
+AstIndex ast_build_token_tree(Ast* ast, const char* source, const TokenBuffer* tokens);
+
+AstIndex ast_root(const Ast* ast);
+
+size_t ast_node_count(const Ast* ast);
+
+/* Node at index; index must be below ast_node_count() */
+const AstNode* ast_node(const Ast* ast, AstIndex index);
+
+/* The children of node index, contiguous; *out_count is 0 (and NULL returned) for a leaf */
+const AstIndex* ast_children(const Ast* ast, AstIndex index, uint32_t* out_count);
+
+const char* ast_kind_name(AstKind kind);
+
+#endif // CPLUS_AST_H
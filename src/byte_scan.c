@@ -0,0 +1,73 @@
+/*
+ * FILE: byte_scan.c
+ * DESC.: vectorised search for the first of two bytes
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "byte_scan.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+#define ONES  UINT64_C(0x0101010101010101)
+#define HIGHS UINT64_C(0x8080808080808080)
+
+/* Non-zero when some byte of v is zero (Mycroft's test) */
+static uint64_t has_zero_byte(uint64_t v) {
+    return (v - ONES) & ~v & HIGHS;
+}
+
+static const char *scan_bytes(const char *p, const char *end, char a, char b) {
+    while ((p < end) && (*p != a) && (*p != b)) {
+        ++p;
+    }
+    return p;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+const char *byte_scan_either(const char *p, const char *end, char a, char b) {
+#if defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(const void *)p);
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb));
+        int     mask = _mm_movemask_epi8(hits);
+        if (mask != 0) {
+#if defined(__GNUC__)
+            return p + __builtin_ctz((unsigned)mask);
+#else
+            return scan_bytes(p, p + 16, a, b);
+#endif
+        }
+        p += 16;
+    }
+#endif
+
+    /* Word-at-a-time: a byte equals a (or b) when it is zero after XOR */
+    const uint64_t wa = ONES * (unsigned char)a;
+    const uint64_t wb = ONES * (unsigned char)b;
+    while (end - p >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        if ((has_zero_byte(word ^ wa) | has_zero_byte(word ^ wb)) != 0U) {
+            return scan_bytes(p, p + 8, a, b);
+        }
+        p += 8;
+    }
+
+    return scan_bytes(p, end, a, b);
+}
@@ -0,0 +1,19 @@
+/*
+ * FILE: byte_scan.h
+ * DESC.: this file is the declaration of the vectorised byte scanner
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_BYTE_SCAN_H
+#define CPLUS_BYTE_SCAN_H
+
+/*
+ * First byte of [p, end) equal to a or b, or end when there is none. Looks
+ * at 16 bytes per step with SSE2 when the target has it and 8 bytes per step
+ * (word-at-a-time) otherwise; never reads outside [p, end).
+ */
+const char* byte_scan_either(const char* p, const char* end, char a, char b);
+
+#endif // CPLUS_BYTE_SCAN_H
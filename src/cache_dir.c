@@ -0,0 +1,131 @@
+/*
+ * FILE: cache_dir.c
+ * DESC.: resolution of the on-disk cache root shared by all cplus caches
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "cache_dir.h"
+
+#include "file_io.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+typedef enum {
+    ROOT_UNRESOLVED,
+    ROOT_RESOLVED,   /* g_root is valid (may still be NULL if nothing fits) */
+    ROOT_DISABLED
+} RootState;
+
+static pthread_mutex_t g_root_lock  = PTHREAD_MUTEX_INITIALIZER;
+static RootState       g_root_state = ROOT_UNRESOLVED;
+static char*           g_root       = NULL;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static char *join_path(const char *base, const char *suffix) {
+    size_t base_len   = strlen(base);
+    size_t suffix_len = strlen(suffix);
+    char *joined = (char *)malloc(base_len + suffix_len + 2U);
+    if (joined == NULL) {
+        return NULL;
+    }
+
+    memcpy(joined, base, base_len);
+    joined[base_len] = '/';
+    memcpy(joined + base_len + 1U, suffix, suffix_len + 1U);
+    return joined;
+}
+
+static char *default_root(void) {
+    const char *explicit_dir = getenv("CPLUS_CACHE_DIR");
+    if ((explicit_dir != NULL) && (explicit_dir[0] != '\0')) {
+        return strdup(explicit_dir);
+    }
+
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    if ((xdg != NULL) && (xdg[0] == '/')) {
+        return join_path(xdg, "cplus");
+    }
+
+    const char *home = getenv("HOME");
+    if ((home != NULL) && (home[0] != '\0')) {
+        return join_path(home, ".cache/cplus");
+    }
+
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+void cache_dir_set_root(const char *path) {
+    (void)pthread_mutex_lock(&g_root_lock);
+    free(g_root);
+    g_root       = (path != NULL) ? strdup(path) : NULL;
+    g_root_state = (path != NULL) ? ROOT_RESOLVED : ROOT_DISABLED;
+    (void)pthread_mutex_unlock(&g_root_lock);
+}
+
+void cache_dir_reset(void) {
+    (void)pthread_mutex_lock(&g_root_lock);
+    free(g_root);
+    g_root       = NULL;
+    g_root_state = ROOT_UNRESOLVED;
+    (void)pthread_mutex_unlock(&g_root_lock);
+}
+
+const char *cache_dir_root(void) {
+    (void)pthread_mutex_lock(&g_root_lock);
+    if (g_root_state == ROOT_UNRESOLVED) {
+        g_root       = default_root();
+        g_root_state = ROOT_RESOLVED;
+    }
+    const char *root = g_root;
+    (void)pthread_mutex_unlock(&g_root_lock);
+    return root;
+}
+
+char *cache_dir_subdir(const char *subdir) {
+    const char *root = cache_dir_root();
+    if (root == NULL) {
+        return NULL;
+    }
+
+    char *dir = join_path(root, subdir);
+    if (dir == NULL) {
+        return NULL;
+    }
+
+    if (file_io_make_dirs(dir) == 0) {
+        free(dir);
+        return NULL;
+    }
+
+    return dir;
+}
+
+char *cache_dir_entry_path(const char *subdir, const char *name) {
+    char *dir = cache_dir_subdir(subdir);
+    if (dir == NULL) {
+        return NULL;
+    }
+
+    char *entry = join_path(dir, name);
+    free(dir);
+    return entry;
+}
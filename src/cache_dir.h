@@ -0,0 +1,42 @@
+/*
+ * FILE: cache_dir.h
+ * DESC.: this file is the declaration of the on-disk cache location helpers
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_CACHE_DIR_H
+#define CPLUS_CACHE_DIR_H
+
+/*
+ * Override the cache root (e.g. from --cache-dir). NULL disables every
+ * on-disk cache for the rest of the process. Call before starting workers.
+ */
+void cache_dir_set_root(const char* path);
+
+/* Drop any override: the next cache_dir_root() resolves the default again */
+void cache_dir_reset(void);
+
+/*
+ * Cache root: the override if set, else $CPLUS_CACHE_DIR, else
+ * $XDG_CACHE_HOME/cplus, else $HOME/.cache/cplus. NULL when disabled or
+ * when none of those can be determined.
+ */
+const char* cache_dir_root(void);
+
+/*
+ * Build "<root>/<subdir>", creating it if needed.
+ * Returns NULL when the cache is disabled or the directory cannot be created.
+ * Caller must free().
+ */
+char* cache_dir_subdir(const char* subdir);
+
+/*
+ * Build "<root>/<subdir>/<name>", creating <root>/<subdir> if needed.
+ * Returns NULL when the cache is disabled or the directory cannot be created.
+ * Caller must free().
+ */
+char* cache_dir_entry_path(const char* subdir, const char* name);
+
+#endif // CPLUS_CACHE_DIR_H
@@ -0,0 +1,378 @@
+/*
+ * FILE: compiler_probe.c
+ * DESC.: compiler capability probe, memoized in memory and on disk
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 700 /* realpath() */
+#endif
+
+#include "compiler_probe.h"
+
+#include "cache_dir.h"
+#include "file_io.h"
+#include "hash.h"
+#include "subprocess.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+#define PROBE_FORMAT_TAG "cplus-probe 1"
+
+typedef struct ProbeEntry {
+    CompilerCaps       caps;
+    char*              compiler_copy;
+    char*              path_copy;
+    struct ProbeEntry* next;
+} ProbeEntry;
+
+/* Held for the whole probe, so a compiler is never probed twice concurrently */
+static pthread_mutex_t g_probe_lock = PTHREAD_MUTEX_INITIALIZER;
+static ProbeEntry*     g_entries    = NULL;
+
+static const char *const k_std_names[] = {
+    "c99", "c11", "c17", "c18", "c2x", "c23", "c2y"
+};
+
+#define STD_NAME_COUNT (sizeof(k_std_names) / sizeof(k_std_names[0]))
+
+/* Pairs of -std= spellings that name the same language revision */
+static const char *const k_std_aliases[][2] = {
+    {"c23", "c2x"},
+    {"c17", "c18"},
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/* Resolve a --cc value to the absolute path of the binary exec would run */
+static char *resolve_binary(const char *compiler) {
+    if (strchr(compiler, '/') != NULL) {
+        return realpath(compiler, NULL);
+    }
+
+    const char *path_env = getenv("PATH");
+    if (path_env == NULL) {
+        return NULL;
+    }
+
+    size_t name_len = strlen(compiler);
+    const char *dir = path_env;
+
+    for (;;) {
+        const char *sep     = strchr(dir, ':');
+        size_t      dir_len = (sep != NULL) ? (size_t)(sep - dir) : strlen(dir);
+
+        char candidate[PATH_MAX];
+        if (dir_len + name_len + 2U <= sizeof(candidate)) {
+            if (dir_len == 0U) {
+                memcpy(candidate, ".", 2U); /* empty PATH entry means cwd */
+                dir_len = 1U;
+            } else {
+                memcpy(candidate, dir, dir_len);
+            }
+            candidate[dir_len] = '/';
+            memcpy(candidate + dir_len + 1U, compiler, name_len + 1U);
+
+            struct stat st;
+            if ((stat(candidate, &st) == 0) && S_ISREG(st.st_mode) &&
+                (access(candidate, X_OK) == 0)) {
+                return realpath(candidate, NULL);
+            }
+        }
+
+        if (sep == NULL) {
+            return NULL;
+        }
+        dir = sep + 1;
+    }
+}
+
+/* Run `compiler args... /dev/null`; 1 if it exits with status 0 */
+static int compiler_accepts(const char *compiler, const char *flag) {
+    const char *const argv[] = {compiler, "-x", "c", flag, "-fsyntax-only", "/dev/null", NULL};
+
+    SubprocessResult run;
+    if (subprocess_run(argv, &run) != 0) {
+        return 0;
+    }
+
+    int ok = WIFEXITED(run.status) && (WEXITSTATUS(run.status) == 0);
+    subprocess_free_result(&run);
+    return ok;
+}
+
+/* Read `#define <name> <int>` out of a -dM -E macro dump */
+static int find_macro_int(const char *dump, const char *name, int *out_value) {
+    size_t name_len = strlen(name);
+
+    for (const char *p = strstr(dump, "#define "); p != NULL; p = strstr(p + 1, "#define ")) {
+        const char *macro = p + 8;
+        if ((strncmp(macro, name, name_len) == 0) && (macro[name_len] == ' ')) {
+            return sscanf(macro + name_len + 1U, "%d", out_value) == 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Family and major version from the predefined macros, in one spawn */
+static void probe_identity(CompilerCaps *caps) {
+    const char *const argv[] = {caps->compiler, "-x", "c", "-dM", "-E", "/dev/null", NULL};
+
+    SubprocessResult run;
+    if (subprocess_run(argv, &run) != 0) {
+        return;
+    }
+
+    int value = 0;
+    if (find_macro_int(run.output, "__clang__", &value) != 0) {
+        caps->family = COMPILER_FAMILY_CLANG;
+        (void)find_macro_int(run.output, "__clang_major__", &caps->major_version);
+    } else if (find_macro_int(run.output, "__GNUC__", &caps->major_version) != 0) {
+        caps->family = COMPILER_FAMILY_GCC;
+    }
+
+    subprocess_free_result(&run);
+}
+
+static void probe_live(CompilerCaps *caps) {
+    probe_identity(caps);
+
+    for (unsigned i = 0U; i < STD_NAME_COUNT; ++i) {
+        char flag[16];
+        (void)snprintf(flag, sizeof(flag), "-std=%s", k_std_names[i]);
+        if (compiler_accepts(caps->compiler, flag) != 0) {
+            caps->std_mask |= 1U << i;
+        }
+    }
+
+    if (caps->family == COMPILER_FAMILY_GCC) {
+        if (compiler_accepts(caps->compiler, "-fdiagnostics-format=json") != 0) {
+            caps->diag_formats |= PROBE_DIAG_JSON;
+        }
+        if (compiler_accepts(caps->compiler, "-fdiagnostics-format=sarif-stderr") != 0) {
+            caps->diag_formats |= PROBE_DIAG_SARIF;
+        }
+    } else if (caps->family == COMPILER_FAMILY_CLANG) {
+        if (compiler_accepts(caps->compiler, "-fdiagnostics-format=sarif") != 0) {
+            caps->diag_formats |= PROBE_DIAG_SARIF;
+        }
+    }
+}
+
+/* "<cache root>/probe/<xxh64 of resolved path>", or NULL if caching is off */
+static char *disk_record_path(const CompilerCaps *caps) {
+    char name[17];
+    hash_to_hex(hash_bytes(caps->resolved_path, strlen(caps->resolved_path), 0U), name);
+    return cache_dir_entry_path("probe", name);
+}
+
+/* Fill caps from the on-disk record if it matches path, size and mtime */
+static int load_disk_record(CompilerCaps *caps, const char *record_path) {
+    char *text = file_io_read_all(record_path, NULL);
+    if (text == NULL) {
+        return 0;
+    }
+
+    char      path[PATH_MAX];
+    long long size   = -1;
+    long long mtime  = -1;
+    int       family = 0;
+    int       major  = 0;
+    unsigned  stds   = 0U;
+    unsigned  diags  = 0U;
+
+    int fields = sscanf(
+        text,
+        PROBE_FORMAT_TAG "\npath %4095[^\n]\nsize %lld\nmtime %lld\nfamily %d\nmajor %d"
+                         "\nstd %x\ndiag %x",
+        path, &size, &mtime, &family, &major, &stds, &diags
+    );
+    free(text);
+
+    if ((fields != 7) || (strcmp(path, caps->resolved_path) != 0) ||
+        (size != caps->binary_size) || (mtime != caps->binary_mtime_ns) ||
+        (family < (int)COMPILER_FAMILY_UNKNOWN) || (family > (int)COMPILER_FAMILY_CLANG)) {
+        return 0;
+    }
+
+    caps->family        = (CompilerFamily)family;
+    caps->major_version = major;
+    caps->std_mask      = stds;
+    caps->diag_formats  = diags;
+    return 1;
+}
+
+static void store_disk_record(const CompilerCaps *caps, const char *record_path) {
+    char text[PATH_MAX + 256];
+    int len = snprintf(
+        text, sizeof(text),
+        PROBE_FORMAT_TAG "\npath %s\nsize %lld\nmtime %lld\nfamily %d\nmajor %d\nstd %x\ndiag %x\n",
+        caps->resolved_path, caps->binary_size, caps->binary_mtime_ns,
+        (int)caps->family, caps->major_version, caps->std_mask, caps->diag_formats
+    );
+
+    if ((len > 0) && ((size_t)len < sizeof(text))) {
+        (void)file_io_write_atomic(record_path, text, (size_t)len);
+    }
+}
+
+static ProbeEntry *create_entry(const char *compiler) {
+    ProbeEntry *entry = (ProbeEntry *)calloc(1U, sizeof(ProbeEntry));
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    entry->compiler_copy = strdup(compiler);
+    if (entry->compiler_copy == NULL) {
+        free(entry);
+        return NULL;
+    }
+
+    CompilerCaps *caps = &entry->caps;
+    caps->compiler = entry->compiler_copy;
+
+    entry->path_copy = resolve_binary(compiler);
+    if (entry->path_copy == NULL) {
+        return entry; /* unknown compiler: spawning it will fail later anyway */
+    }
+
+    struct stat st;
+    if (stat(entry->path_copy, &st) != 0) {
+        return entry;
+    }
+
+    caps->resolved_path   = entry->path_copy;
+    caps->binary_size     = (long long)st.st_size;
+    caps->binary_mtime_ns = (long long)st.st_mtim.tv_sec * 1000000000LL +
+                            (long long)st.st_mtim.tv_nsec;
+
+    char *record_path = disk_record_path(caps);
+    if ((record_path == NULL) || (load_disk_record(caps, record_path) == 0)) {
+        probe_live(caps);
+        if ((record_path != NULL) && (caps->family != COMPILER_FAMILY_UNKNOWN)) {
+            store_disk_record(caps, record_path);
+        }
+    }
+    free(record_path);
+
+    return entry;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+const CompilerCaps *compiler_probe(const char *compiler) {
+    static const CompilerCaps unknown_caps = {
+        "", NULL, 0, 0, COMPILER_FAMILY_UNKNOWN, 0, 0U, 0U
+    };
+
+    if (compiler == NULL) {
+        return &unknown_caps;
+    }
+
+    (void)pthread_mutex_lock(&g_probe_lock);
+
+    ProbeEntry *entry = g_entries;
+    while ((entry != NULL) && (strcmp(entry->caps.compiler, compiler) != 0)) {
+        entry = entry->next;
+    }
+
+    if (entry == NULL) {
+        entry = create_entry(compiler);
+        if (entry != NULL) {
+            entry->next = g_entries;
+            g_entries   = entry;
+        }
+    }
+
+    (void)pthread_mutex_unlock(&g_probe_lock);
+
+    return (entry != NULL) ? &entry->caps : &unknown_caps;
+}
+
+void compiler_probe_revalidate(void) {
+    (void)pthread_mutex_lock(&g_probe_lock);
+
+    ProbeEntry **link = &g_entries;
+    while (*link != NULL) {
+        ProbeEntry *entry = *link;
+        char       *path  = resolve_binary(entry->compiler_copy);
+        struct stat st;
+        int         same  = 0;
+        if ((path != NULL) && (entry->caps.resolved_path != NULL) &&
+            (strcmp(path, entry->caps.resolved_path) == 0) && (stat(path, &st) == 0)) {
+            long long mtime = (long long)st.st_mtim.tv_sec * 1000000000LL +
+                              (long long)st.st_mtim.tv_nsec;
+            same = ((long long)st.st_size == entry->caps.binary_size) &&
+                   (mtime == entry->caps.binary_mtime_ns);
+        }
+        free(path);
+
+        if (same != 0) {
+            link = &entry->next;
+            continue;
+        }
+        *link = entry->next;
+        free(entry->compiler_copy);
+        free(entry->path_copy);
+        free(entry);
+    }
+
+    (void)pthread_mutex_unlock(&g_probe_lock);
+}
+
+const char *compiler_probe_std_name(unsigned index) {
+    return (index < STD_NAME_COUNT) ? k_std_names[index] : NULL;
+}
+
+const char *compiler_probe_std_flag(const CompilerCaps *caps, const char *std_name) {
+    if ((caps == NULL) || (std_name == NULL) || (caps->std_mask == 0U)) {
+        return std_name;
+    }
+
+    int std_index = -1;
+    for (unsigned i = 0U; i < STD_NAME_COUNT; ++i) {
+        if (strcmp(k_std_names[i], std_name) == 0) {
+            std_index = (int)i;
+            break;
+        }
+    }
+
+    if ((std_index < 0) || ((caps->std_mask & (1U << std_index)) != 0U)) {
+        return std_name; /* not a spelling we probe, or directly supported */
+    }
+
+    for (size_t a = 0U; a < sizeof(k_std_aliases) / sizeof(k_std_aliases[0]); ++a) {
+        for (int side = 0; side < 2; ++side) {
+            if (strcmp(k_std_aliases[a][side], std_name) != 0) {
+                continue;
+            }
+            const char *alias = k_std_aliases[a][1 - side];
+            for (unsigned i = 0U; i < STD_NAME_COUNT; ++i) {
+                if ((strcmp(k_std_names[i], alias) == 0) && ((caps->std_mask & (1U << i)) != 0U)) {
+                    return k_std_names[i];
+                }
+            }
+        }
+    }
+
+    return std_name;
+}
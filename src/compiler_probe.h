@@ -0,0 +1,63 @@
+/*
+ * FILE: compiler_probe.h
+ * DESC.: this file is the declaration of the memoized compiler capability probe
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_COMPILER_PROBE_H
+#define CPLUS_COMPILER_PROBE_H
+
+typedef enum {
+    COMPILER_FAMILY_UNKNOWN,
+    COMPILER_FAMILY_GCC,
+    COMPILER_FAMILY_CLANG
+} CompilerFamily;
+
+/* Machine-readable diagnostics formats accepted via -fdiagnostics-format= */
+enum {
+    PROBE_DIAG_JSON  = 1U << 0, // GCC "json" (GCC 9..14)
+    PROBE_DIAG_SARIF = 1U << 1  // GCC "sarif-stderr" (13+), Clang "sarif"
+};
+
+/*
+ * What a compiler binary supports. Probed once per process per compiler name
+ * and persisted under <cache root>/probe, keyed by the binary's resolved path,
+ * size and mtime, so a compiler upgrade invalidates the record.
+ */
+typedef struct {
+    const char*    compiler;       // name as passed to --cc
+    const char*    resolved_path;  // absolute path of the binary, NULL if not found
+    long long      binary_size;
+    long long      binary_mtime_ns;
+    CompilerFamily family;
+    int            major_version;  // 0 if unknown
+    unsigned       std_mask;       // bit i set: compiler_probe_std_name(i) is accepted
+    unsigned       diag_formats;   // PROBE_DIAG_* bitmask
+} CompilerCaps;
+
+/*
+ * Capabilities of `compiler`. Thread-safe; concurrent callers for the same
+ * compiler wait for a single probe. The record lives until process exit.
+ * Never returns NULL: an unusable compiler yields an all-unknown record.
+ */
+const CompilerCaps* compiler_probe(const char* compiler);
+
+/*
+ * Forget the records whose compiler now resolves to another binary, or whose
+ * binary changed size or mtime, so the next compiler_probe() probes again.
+ * For long-lived processes, between two runs: no record may be in use.
+ */
+void compiler_probe_revalidate(void);
+
+/* Spellings checked for std_mask, in bit order; NULL past the end */
+const char* compiler_probe_std_name(unsigned index);
+
+/*
+ * The -std= value to pass for std_name: std_name itself when accepted,
+ * otherwise an accepted alias (c23 <-> c2x, c17 <-> c18), otherwise std_name.
+ */
+const char* compiler_probe_std_flag(const CompilerCaps* caps, const char* std_name);
+
+#endif // CPLUS_COMPILER_PROBE_H
@@ -12,111 +12,177 @@
 
 #include "compiler_validator.h"
 
+#include "compiler_probe.h"
+#include "diagnostics.h"
+#include "subprocess.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <sys/wait.h>
-#include <unistd.h>
-
-static char *shell_quote(const char *text);
-static char *read_stream_output(FILE *fp);
-static const char *resolve_std_flag(const char *compiler, const char *std_name);
 
 /*
- * GCC < 14 does not recognise -std=c23; it uses -std=c2x instead.
- * Query the compiler major version at runtime and remap accordingly.
+ * Spawn `<compiler> -x c -std=<std> -fsyntax-only [<limit flag>] [<format flag>]
+ * [-include <pch header>] <input>...`
+ * directly (no shell) and capture its combined stdout/stderr through a pipe,
+ * streaming it to on_chunk when given (see subprocess_run_streaming). With a
+ * trace, the run is recorded as a spawn span followed by a compile span.
+ * limits (NULL = none) go to subprocess_run_limited(); *out_timed_out tells
+ * whether the timeout stopped the run.
+ * Returns the raw wait status, or -1 if the compiler could not be run.
  */
-static const char *resolve_std_flag(const char *compiler, const char *std_name) {
-    if ((strcmp(std_name, "c23") != 0) || (strcmp(compiler, "gcc") != 0)) {
-        return std_name;
-    }
-
-    /* Run: gcc -dumpversion  → prints "13.3.0\n" or similar */
-    size_t cmd_size = strlen(compiler) + 16U;
-    char *cmd = (char *)malloc(cmd_size);
-    if (cmd == NULL) {
-        return std_name;
-    }
-    (void)snprintf(cmd, cmd_size, "%s -dumpversion", compiler);
-
-    FILE *fp = popen(cmd, "r");
-    free(cmd);
-    if (fp == NULL) {
-        return std_name;
-    }
-
-    char version_buf[64];
-    version_buf[0] = '\0';
-    (void)fgets(version_buf, (int)sizeof(version_buf), fp);
-    (void)pclose(fp);
-
-    int major = 0;
-    (void)sscanf(version_buf, "%d", &major);
-
-    /* -std=c23 is only recognised from GCC 14 onwards */
-    return (major > 0 && major < 14) ? "c2x" : std_name;
-}
-
 static int run_compiler_and_capture(
     const char *compiler,
     const char *std_name,
-    const char *quoted_input,
-    char **out_captured
+    const char *limit_flag,
+    const char *format_flag,
+    const char *pch_header,
+    const char *const input_paths[],
+    size_t count,
+    Trace *trace,
+    const SubprocessLimits *limits,
+    SubprocessChunkFn on_chunk,
+    void *user,
+    char **out_captured,
+    int *out_timed_out
 ) {
-    char temp_template[] = "/tmp/cplus_diag_XXXXXX";
-    int temp_fd = mkstemp(temp_template);
-    if (temp_fd < 0) {
+    size_t std_len = strlen(std_name);
+    char *std_flag = (char *)malloc(std_len + 6U); /* "-std=" + NUL */
+    const char **argv = (const char **)malloc((count + 10U) * sizeof(const char *));
+    if ((std_flag == NULL) || (argv == NULL)) {
+        free(std_flag);
+        free(argv);
         return -1;
     }
-    close(temp_fd);
+    memcpy(std_flag, "-std=", 5U);
+    memcpy(std_flag + 5U, std_name, std_len + 1U);
+
+    size_t argc = 0U;
+    argv[argc++] = compiler;
+    argv[argc++] = "-x";
+    argv[argc++] = "c";
+    argv[argc++] = std_flag;
+    argv[argc++] = "-fsyntax-only";
+    if (limit_flag != NULL) {
+        argv[argc++] = limit_flag;
+    }
+    if (format_flag != NULL) {
+        argv[argc++] = format_flag;
+    }
+    if (pch_header != NULL) {
+        argv[argc++] = "-include";
+        argv[argc++] = pch_header;
+    }
+    for (size_t i = 0U; i < count; ++i) {
+        argv[argc++] = input_paths[i];
+    }
+    argv[argc] = NULL;
+
+    uint64_t started = trace_now(trace);
+    SubprocessResult run;
+    int spawn_rc = subprocess_run_limited(argv, on_chunk, user, limits, &run);
+    free(std_flag);
+    free(argv);
 
-    char *quoted_temp = shell_quote(temp_template);
-    if (quoted_temp == NULL) {
-        unlink(temp_template);
+    if (spawn_rc != 0) {
         return -1;
     }
 
-    size_t command_size = strlen(compiler) + strlen(std_name) + strlen(quoted_input) +
-                          strlen(quoted_temp) + 64U;
-    char *command = (char *)malloc(command_size);
-    if (command == NULL) {
-        free(quoted_temp);
-        unlink(temp_template);
-        return -1;
+    /* The spawn span ends where the compile span starts */
+    if (trace != NULL) {
+        uint64_t spawned = started + (uint64_t)run.spawn_ns;
+        trace_span(trace, TRACE_SPAWN, input_paths[0], (unsigned)count, started, spawned);
+        trace_end(trace, TRACE_COMPILE, input_paths[0], (unsigned)count, spawned);
+    }
+
+    *out_captured  = run.output; /* ownership moves to the caller */
+    *out_timed_out = run.timed_out;
+    return run.status;
+}
+
+/*
+ * "-fmax-errors=N" (GCC) or "-ferror-limit=N" (Clang) into buf, or NULL when
+ * there is no limit or the compiler family is unknown.
+ */
+static const char *error_limit_flag(const CompilerCaps *caps, int max_errors, char *buf,
+                                    size_t buf_size) {
+    if (max_errors <= 0) {
+        return NULL;
     }
 
-    (void)snprintf(
-        command,
-        command_size,
-        "%s -x c -std=%s -fsyntax-only %s > %s 2>&1",
-        compiler,
-        std_name,
-        quoted_input,
-        quoted_temp
-    );
+    const char *prefix = NULL;
+    if (caps->family == COMPILER_FAMILY_GCC) {
+        prefix = "-fmax-errors=";
+    } else if (caps->family == COMPILER_FAMILY_CLANG) {
+        prefix = "-ferror-limit=";
+    } else {
+        return NULL;
+    }
 
-    free(quoted_temp);
+    int written = snprintf(buf, buf_size, "%s%d", prefix, max_errors);
+    return ((written > 0) && ((size_t)written < buf_size)) ? buf : NULL;
+}
 
-    int sys_status = system(command);
-    free(command);
+/*
+ * The format actually requested from the compiler: a structured one only
+ * when the probe saw the compiler accept it, text otherwise.
+ */
+static DiagnosticFormat resolve_format(const CompilerCaps *caps, DiagnosticFormat requested) {
+    int json  = ((caps->diag_formats & PROBE_DIAG_JSON) != 0U);
+    int sarif = ((caps->diag_formats & PROBE_DIAG_SARIF) != 0U);
+
+    switch (requested) {
+    case DIAG_FORMAT_AUTO:
+        return json ? DIAG_FORMAT_JSON : (sarif ? DIAG_FORMAT_SARIF : DIAG_FORMAT_TEXT);
+    case DIAG_FORMAT_JSON:
+        return json ? DIAG_FORMAT_JSON : DIAG_FORMAT_TEXT;
+    case DIAG_FORMAT_SARIF:
+        return sarif ? DIAG_FORMAT_SARIF : DIAG_FORMAT_TEXT;
+    default:
+        return DIAG_FORMAT_TEXT;
+    }
+}
 
-    FILE *diag_fp = fopen(temp_template, "rb");
-    if (diag_fp == NULL) {
-        unlink(temp_template);
-        return -1;
+static const char *format_flag(const CompilerCaps *caps, DiagnosticFormat format) {
+    if (format == DIAG_FORMAT_JSON) {
+        return "-fdiagnostics-format=json";
     }
+    if (format == DIAG_FORMAT_SARIF) {
+        return (caps->family == COMPILER_FAMILY_GCC) ? "-fdiagnostics-format=sarif-stderr"
+                                                     : "-fdiagnostics-format=sarif";
+    }
+    return NULL;
+}
 
-    char *captured = read_stream_output(diag_fp);
-    (void)fclose(diag_fp);
-    (void)unlink(temp_template);
+/* State of one streamed validation: parser plus the --max-errors cut-off */
+typedef struct {
+    DiagnosticParser*       parser;
+    const ValidatorOptions* options;
+    int                     errors;
+    int                     stop;      /* limit reached: drop everything after */
+} StreamState;
+
+static void stream_diagnostic(void *user, const Diagnostic *diag) {
+    StreamState *state = (StreamState *)user;
+    if (state->stop != 0) {
+        return;
+    }
 
-    if (captured == NULL) {
-        return -1;
+    state->options->on_diagnostic(state->options->user, diag);
+
+    if (diag->severity == DIAG_ERROR) {
+        ++state->errors;
+        if ((state->options->max_errors > 0) && (state->errors >= state->options->max_errors)) {
+            state->stop = 1;
+        }
     }
+}
 
-    *out_captured = captured;
-    return sys_status;
+static int stream_chunk(void *user, const char *data, size_t len) {
+    StreamState *state = (StreamState *)user;
+    diagnostics_parser_feed(state->parser, data, len);
+    return (state->stop == 0) ? 1 : 0;
 }
 
 static char *duplicate_string(const char *text) {
@@ -130,115 +196,399 @@ static char *duplicate_string(const char *text) {
     return copy;
 }
 
-static char *shell_quote(const char *text) {
-    size_t extra = 0U;
+/*
+ * Whether a failed run under a memory limit died of it. Compilers do not
+ * agree on one report: GCC prints "out of memory" or "virtual memory
+ * exhausted", or cc1 crashes and the driver reports the signal; Clang says
+ * "out of memory" or crashes itself.
+ */
+static int looks_out_of_memory(const SubprocessLimits *limits, int wait_status,
+                               const char *output) {
+    if ((limits == NULL) || (limits->memory_bytes == 0ULL)) {
+        return 0;
+    }
+    if (WIFSIGNALED(wait_status) != 0) {
+        return 1;
+    }
+    if ((WIFEXITED(wait_status) == 0) || (WEXITSTATUS(wait_status) == 0) || (output == NULL)) {
+        return 0;
+    }
+    return (strstr(output, "out of memory") != NULL) ||
+           (strstr(output, "memory exhausted") != NULL) ||
+           (strstr(output, "signal terminated program") != NULL);
+}
+
+/* The one error reported for a run the limits cut short (exit_code says which) */
+static char *limit_report(const char *input_path, int exit_code, const SubprocessLimits *limits) {
+    char message[96];
+    if (exit_code == VALIDATION_TIMED_OUT) {
+        (void)snprintf(message, sizeof(message), "validation stopped after the %llu ms job timeout",
+                       limits->timeout_ms);
+    } else {
+        (void)snprintf(message, sizeof(message), "the compiler ran out of its %llu KiB job memory",
+                       limits->memory_bytes / 1024ULL);
+    }
 
-    for (const char *p = text; *p != '\0'; ++p) {
-        if (*p == '\'') {
-            extra += 3U;
+    size_t size   = strlen(input_path) + strlen(message) + 16U; /* ":1:1: error: ", '\n', NUL */
+    char  *report = (char *)malloc(size);
+    if (report != NULL) {
+        (void)snprintf(report, size, "%s:1:1: error: %s\n", input_path, message);
+    }
+    return report;
+}
+
+/* -------------------------------------------------------------------------
+ * Batch demultiplexing
+ * ---------------------------------------------------------------------- */
+
+/* Index of the input whose "<path>:" starts the line, or count if none */
+static size_t owner_of_line(const char *line, size_t line_len,
+                            const char *const input_paths[], size_t count) {
+    for (size_t i = 0U; i < count; ++i) {
+        size_t len = strlen(input_paths[i]);
+        if ((line_len > len) && (line[len] == ':') && (memcmp(line, input_paths[i], len) == 0)) {
+            return i;
         }
     }
+    return count;
+}
 
-    size_t len = strlen(text);
-    char *quoted = (char *)malloc(len + extra + 3U);
-    if (quoted == NULL) {
-        return NULL;
+/* Clang's per-file count, "N warning(s) [and M error(s)] generated.", with no location */
+static int is_clang_summary(const char *line, size_t line_len) {
+    static const char suffix[] = " generated.";
+    size_t            len      = line_len;
+    if ((len > 0U) && (line[len - 1U] == '\n')) {
+        --len;
+    }
+    size_t n = 0U;
+    while ((n < len) && (line[n] >= '0') && (line[n] <= '9')) {
+        ++n;
+    }
+    return (n > 0U) && (len > n + sizeof(suffix) - 1U) && (line[n] == ' ') &&
+           (memcmp(line + len - (sizeof(suffix) - 1U), suffix, sizeof(suffix) - 1U) == 0) &&
+           ((strncmp(line + n + 1U, "error", 5U) == 0) ||
+            (strncmp(line + n + 1U, "warning", 7U) == 0));
+}
+
+/* A caret line ("    ^~~~"): blanks, then '^' and '~' only */
+static int is_caret_line(const char *line) {
+    size_t n = strspn(line, " \t");
+    return (n > 0U) && ((line[n] == '^') || (line[n] == '~')) &&
+           (line[n + strspn(line + n, "^~")] == '\n');
+}
+
+/*
+ * Split the output of one run over all inputs into per-file segments.
+ * GCC and Clang print each diagnostic line as "<path>:..." using the path as
+ * given, followed by indented source/caret lines; "compilation terminated."
+ * closes a fatal error. Clang's "N errors generated." counts are dropped, and
+ * a source line Clang <= 16 prints unindented goes with the diagnostic above
+ * it when a caret line follows. Anything else (e.g. "In file included from",
+ * a diagnostic located in a .hplus, a driver error) cannot be attributed and
+ * makes the split fail. Returns 1 with segments[i] malloc'd (maybe ""), or 0.
+ */
+static int split_output(const char *output, const char *const input_paths[],
+                        size_t count, char *segments[]) {
+    size_t *lens = (size_t *)calloc(count, sizeof(size_t));
+    FILE  **streams = (FILE **)calloc(count, sizeof(FILE *));
+    int ok = (lens != NULL) && (streams != NULL);
+
+    for (size_t i = 0U; (ok != 0) && (i < count); ++i) {
+        segments[i] = NULL;
+        streams[i] = open_memstream(&segments[i], &lens[i]);
+        ok = (streams[i] != NULL);
     }
 
-    char *out = quoted;
-    *out++ = '\'';
+    size_t current = count;
+    for (const char *p = output; (ok != 0) && (*p != '\0');) {
+        const char *nl = strchr(p, '\n');
+        size_t line_len = (nl != NULL) ? (size_t)(nl - p) + 1U : strlen(p);
+
+        size_t owner = owner_of_line(p, line_len, input_paths, count);
+        if (owner < count) {
+            current = owner;
+        } else if (is_clang_summary(p, line_len) != 0) {
+            p += line_len;
+            continue;
+        } else if ((p[0] != ' ') && (strncmp(p, "compilation terminated.", 23U) != 0) &&
+                   ((nl == NULL) || (is_caret_line(nl + 1) == 0))) {
+            ok = 0;
+        }
 
-    for (const char *p = text; *p != '\0'; ++p) {
-        if (*p == '\'') {
-            *out++ = '\'';
-            *out++ = '\\';
-            *out++ = '\'';
-            *out++ = '\'';
+        if ((ok != 0) && (current < count)) {
+            ok = (fwrite(p, 1U, line_len, streams[current]) == line_len);
         } else {
-            *out++ = *p;
+            ok = 0;
+        }
+        p += line_len;
+    }
+
+    for (size_t i = 0U; (streams != NULL) && (i < count); ++i) {
+        if ((streams[i] != NULL) && (fclose(streams[i]) != 0)) {
+            ok = 0;
         }
     }
 
-    *out++ = '\'';
-    *out = '\0';
+    if (ok == 0) {
+        for (size_t i = 0U; (streams != NULL) && (i < count); ++i) {
+            free(segments[i]);
+            segments[i] = NULL;
+        }
+    }
 
-    return quoted;
+    free(lens);
+    free(streams);
+    return ok;
 }
 
-static char *read_stream_output(FILE *fp) {
-    size_t capacity = 4096U;
-    size_t length = 0U;
-    char *buffer = (char *)malloc(capacity);
+/*
+ * GCC prints one JSON array per translation unit, in command-line order (a
+ * file without diagnostics still gets "[]"), so segment i is the i-th array.
+ * "compilation terminated." may follow a fatal error; any other line or a
+ * different number of arrays makes the split fail.
+ */
+static int split_json_output(const char *output, size_t count, char *segments[]) {
+    size_t n = 0U;
+    int ok = 1;
+
+    for (const char *p = output; (ok != 0) && (*p != '\0');) {
+        const char *nl = strchr(p, '\n');
+        size_t line_len = (nl != NULL) ? (size_t)(nl - p) + 1U : strlen(p);
+
+        if (p[0] == '[') {
+            ok = (n < count) && ((segments[n] = (char *)malloc(line_len + 1U)) != NULL);
+            if (ok != 0) {
+                memcpy(segments[n], p, line_len);
+                segments[n][line_len] = '\0';
+                ++n;
+            }
+        } else if (strncmp(p, "compilation terminated.", 23U) != 0) {
+            ok = 0;
+        }
+        p += line_len;
+    }
 
-    if (buffer == NULL) {
-        return NULL;
+    if ((ok == 0) || (n != count)) {
+        for (size_t i = 0U; i < n; ++i) {
+            free(segments[i]);
+            segments[i] = NULL;
+        }
+        return 0;
     }
+    return 1;
+}
 
-    for (;;) {
-        if (length + 1024U + 1U > capacity) {
-            size_t new_capacity = capacity * 2U;
-            char *new_buffer = (char *)realloc(buffer, new_capacity);
-            if (new_buffer == NULL) {
-                free(buffer);
-                return NULL;
-            }
-            buffer = new_buffer;
-            capacity = new_capacity;
+/*
+ * 1 if the segment holds an error, 0 if not, -1 if one of its diagnostics
+ * names a file other than input_path (the split cannot be trusted).
+ */
+static int segment_has_error(const char *segment, const char *input_path, DiagnosticFormat format) {
+    DiagnosticList diags = (format == DIAG_FORMAT_TEXT) ? diagnostics_parse(segment)
+                                                        : diagnostics_parse_structured(segment);
+    int has_error = (strstr(segment, ": fatal error: ") != NULL) ? 1 : 0;
+
+    for (size_t i = 0U; i < diags.count; ++i) {
+        if ((diags.items[i].file == NULL) || (strcmp(diags.items[i].file, input_path) != 0)) {
+            has_error = -1;
+            break;
+        }
+        if (diags.items[i].severity == DIAG_ERROR) {
+            has_error = 1;
         }
+    }
 
-        size_t bytes_read = fread(buffer + length, 1U, 1024U, fp);
-        length += bytes_read;
+    diagnostics_free_list(&diags);
+    return has_error;
+}
 
-        if (bytes_read < 1024U) {
-            if (feof(fp) != 0) {
-                break;
+/*
+ * One compiler run over every input, then per-file results. Returns 0 (and
+ * leaves results untouched) whenever the output cannot be attributed
+ * unambiguously, so the caller falls back to validating file by file.
+ */
+static int split_batch(const char *compiler, const char *std_name, const ValidatorOptions *options,
+                       const char *const input_paths[], size_t count,
+                       ValidationResult results[]) {
+    /* The same path twice would make every line ambiguous */
+    for (size_t i = 0U; i < count; ++i) {
+        for (size_t k = i + 1U; k < count; ++k) {
+            if (strcmp(input_paths[i], input_paths[k]) == 0) {
+                return 0;
             }
+        }
+    }
 
-            if (ferror(fp) != 0) {
-                free(buffer);
-                return NULL;
-            }
+    /* GCC and Clang count -fmax-errors/-ferror-limit per translation unit */
+    const CompilerCaps *caps = compiler_probe(compiler);
+    const char *effective_std = compiler_probe_std_flag(caps, std_name);
+
+    /* SARIF logs of several files cannot be cut apart without re-encoding */
+    DiagnosticFormat format = resolve_format(caps, options->format);
+    if (format == DIAG_FORMAT_SARIF) {
+        return 0;
+    }
+
+    char limit_buf[32];
+    int  max_errors = (format == DIAG_FORMAT_TEXT) ? options->max_errors : 0;
+    const char *limit_flag = error_limit_flag(caps, max_errors, limit_buf, sizeof(limit_buf));
+
+    char *captured  = NULL;
+    int   timed_out = 0;
+    int wait_status = run_compiler_and_capture(compiler, effective_std, limit_flag,
+                                               format_flag(caps, format), options->pch_header,
+                                               input_paths, count, options->trace, &options->limits,
+                                               NULL, NULL, &captured, &timed_out);
+    if ((wait_status < 0) || (captured == NULL) || (WIFEXITED(wait_status) == 0) ||
+        (timed_out != 0) || (looks_out_of_memory(&options->limits, wait_status, captured) != 0)) {
+        free(captured);
+        return 0;
+    }
+
+    char **segments = (char **)calloc(count, sizeof(char *));
+    int   *failed   = (int *)calloc(count, sizeof(int));
+    int ok = (segments != NULL) && (failed != NULL);
+    if (ok != 0) {
+        ok = (format == DIAG_FORMAT_JSON) ? split_json_output(captured, count, segments)
+                                          : split_output(captured, input_paths, count, segments);
+    }
+    free(captured);
+
+    size_t n_failed = 0U;
+    for (size_t i = 0U; (ok != 0) && (i < count); ++i) {
+        failed[i] = segment_has_error(segments[i], input_paths[i], format);
+        ok = (failed[i] >= 0);
+        n_failed += (size_t)(failed[i] > 0);
+    }
+
+    /* The per-file verdicts must agree with the compiler's overall status */
+    int exit_code = WEXITSTATUS(wait_status);
+    if ((ok != 0) &&
+        (((exit_code == 0) && (n_failed > 0U)) || ((exit_code != 0) && (n_failed == 0U)))) {
+        ok = 0;
+    }
+
+    for (size_t i = 0U; (segments != NULL) && (i < count); ++i) {
+        if (ok != 0) {
+            results[i].success    = (failed[i] == 0) ? 1 : 0;
+            results[i].exit_code  = (failed[i] == 0) ? 0 : exit_code;
+            results[i].raw_output = segments[i];
+        } else {
+            free(segments[i]);
         }
     }
 
-    buffer[length] = '\0';
-    return buffer;
+    free(segments);
+    free(failed);
+    return ok;
 }
 
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
 ValidationResult validator_check_syntax(
     const char *compiler,
     const char *std_name,
     const char *input_path
 ) {
-    ValidationResult result = {0, NULL};
+    return validator_check_syntax_ex(compiler, std_name, input_path, NULL);
+}
+
+ValidationResult validator_check_syntax_ex(
+    const char *compiler,
+    const char *std_name,
+    const char *input_path,
+    const ValidatorOptions *options
+) {
+    ValidationResult result = {0, NULL, -1};
 
     if ((compiler == NULL) || (std_name == NULL) || (input_path == NULL)) {
         result.raw_output = duplicate_string("error: invalid validation arguments\n");
         return result;
     }
 
-    const char *effective_std = resolve_std_flag(compiler, std_name);
+    /*
+     * GCC < 14 does not recognise -std=c23 (it wants c2x); the memoized probe
+     * knows which spellings this compiler accepts and remaps accordingly.
+     */
+    const CompilerCaps *caps = compiler_probe(compiler);
+    const char *effective_std = compiler_probe_std_flag(caps, std_name);
+
+    DiagnosticFormat format =
+        resolve_format(caps, (options != NULL) ? options->format : DIAG_FORMAT_TEXT);
+    int listening = (options != NULL) && (options->on_diagnostic != NULL);
+
+    /* Structured output comes in one piece at exit; the limit is applied on delivery */
+    char limit_buf[32];
+    int  max_errors = ((options != NULL) && (format == DIAG_FORMAT_TEXT)) ? options->max_errors : 0;
+    const char *limit_flag = error_limit_flag(caps, max_errors, limit_buf, sizeof(limit_buf));
+
+    /* Stream only when someone listens; the cut-off needs the parser as well */
+    StreamState stream = {NULL, options, 0, 0};
+    if ((listening != 0) && (format == DIAG_FORMAT_TEXT)) {
+        stream.parser = diagnostics_parser_create(stream_diagnostic, &stream);
+    }
 
-    char *quoted_input = shell_quote(input_path);
-    if (quoted_input == NULL) {
-        result.raw_output = duplicate_string("error: internal runtime error (allocation failure)\n");
-        return result;
+    const char *const inputs[] = {input_path};
+    const SubprocessLimits *limits = (options != NULL) ? &options->limits : NULL;
+    char *captured  = NULL;
+    int   timed_out = 0;
+    int wait_status = run_compiler_and_capture(compiler, effective_std, limit_flag,
+                                               format_flag(caps, format),
+                                               (options != NULL) ? options->pch_header : NULL,
+                                               inputs, 1U,
+                                               (options != NULL) ? options->trace : NULL, limits,
+                                               (stream.parser != NULL) ? stream_chunk : NULL,
+                                               &stream, &captured, &timed_out);
+
+    int cut_short = 0;
+    if ((wait_status >= 0) && (timed_out != 0)) {
+        cut_short = VALIDATION_TIMED_OUT;
+    } else if ((wait_status >= 0) && (looks_out_of_memory(limits, wait_status, captured) != 0)) {
+        cut_short = VALIDATION_OUT_OF_MEMORY;
     }
 
-    char *captured = NULL;
-    int sys_status = run_compiler_and_capture(compiler, effective_std, quoted_input, &captured);
+    /* A run cut short leaves no trustworthy tail, only what was streamed already */
+    if ((stream.parser != NULL) && (stream.stop == 0) && (wait_status >= 0) && (cut_short == 0)) {
+        diagnostics_parser_finish(stream.parser);
+    }
+    diagnostics_parser_destroy(stream.parser);
 
-    if ((sys_status < 0) || (captured == NULL)) {
+    if ((wait_status < 0) || (captured == NULL)) {
         result.raw_output = duplicate_string("error: failed to run compiler validation\n");
         return result;
     }
 
-    int success = 0;
-    if (WIFEXITED(sys_status) != 0) {
-        success = (WEXITSTATUS(sys_status) == 0) ? 1 : 0;
+    if (cut_short != 0) {
+        free(captured);
+        result.exit_code  = cut_short;
+        result.raw_output = limit_report(input_path, cut_short, limits);
+        if ((listening != 0) && (result.raw_output != NULL)) {
+            DiagnosticList report = diagnostics_parse(result.raw_output);
+            for (size_t i = 0U; i < report.count; ++i) {
+                options->on_diagnostic(options->user, &report.items[i]);
+            }
+            diagnostics_free_list(&report);
+        }
+        return result;
     }
 
-    free(quoted_input);
+    /* The compiler ran to completion here, so stream.stop only cuts the delivery */
+    int killed = stream.stop;
+    if ((listening != 0) && (format != DIAG_FORMAT_TEXT)) {
+        DiagnosticList diags = diagnostics_parse_structured(captured);
+        for (size_t i = 0U; i < diags.count; ++i) {
+            stream_diagnostic(&stream, &diags.items[i]);
+        }
+        diagnostics_free_list(&diags);
+    }
+
+    /* A compiler stopped at the limit keeps exit_code -1, so it is never cached */
+    int success = 0;
+    if ((WIFEXITED(wait_status) != 0) && (killed == 0)) {
+        result.exit_code = WEXITSTATUS(wait_status);
+        success = (result.exit_code == 0) ? 1 : 0;
+    }
 
     result.success = success;
 
@@ -252,6 +602,40 @@ ValidationResult validator_check_syntax(
     return result;
 }
 
+size_t validator_check_syntax_batch(
+    const char *compiler,
+    const char *std_name,
+    const ValidatorOptions *options,
+    const char *const input_paths[],
+    size_t count,
+    ValidationResult results[]
+) {
+    if ((input_paths == NULL) || (results == NULL) || (count == 0U)) {
+        return 0U;
+    }
+
+    /* Batches print after the split: nobody listens while the compiler runs */
+    ValidatorOptions quiet = {0, NULL, NULL, DIAG_FORMAT_TEXT, NULL, NULL, {0ULL, 0ULL}};
+    if (options != NULL) {
+        quiet.max_errors = options->max_errors;
+        quiet.format     = options->format;
+        quiet.pch_header = options->pch_header;
+        quiet.trace      = options->trace;
+        quiet.limits     = options->limits;
+    }
+
+    int batched = (count > 1U) && (compiler != NULL) && (std_name != NULL) &&
+                  (split_batch(compiler, std_name, &quiet, input_paths, count, results) != 0);
+    if (batched != 0) {
+        return 1U;
+    }
+
+    for (size_t i = 0U; i < count; ++i) {
+        results[i] = validator_check_syntax_ex(compiler, std_name, input_paths[i], &quiet);
+    }
+    return count;
+}
+
 void validator_free_result(ValidationResult *result) {
     if (result == NULL) {
         return;
@@ -260,4 +644,5 @@ void validator_free_result(ValidationResult *result) {
     free(result->raw_output);
     result->raw_output = NULL;
     result->success = 0;
+    result->exit_code = -1;
 }
@@ -9,17 +9,88 @@
 #ifndef CPLUS_COMPILER_VALIDATOR_H
 #define CPLUS_COMPILER_VALIDATOR_H
 
+#include "diagnostics.h"
+#include "subprocess.h"
+#include "trace.h"
+
+#include <stddef.h>
+
 typedef struct {
     int success;      // 1 if syntax is valid, 0 otherwise
     char* raw_output; // compiler stderr/stdout capture
+    int exit_code;    // compiler exit status, -1 if it could not be run
 } ValidationResult;
 
+/* exit_code of a run that ValidatorOptions.limits cut short; never cached, like -1 */
+#define VALIDATION_TIMED_OUT     (-2)
+#define VALIDATION_OUT_OF_MEMORY (-3)
+
+/* Optional knobs of validator_check_syntax_ex() */
+typedef struct {
+    int              max_errors;     // stop after this many errors; 0 = no limit
+    DiagnosticFn     on_diagnostic;  // called as each diagnostic completes; NULL = none
+    void*            user;           // passed to on_diagnostic
+    DiagnosticFormat format;         // output requested from the compiler
+    const char*      pch_header;     // passed with -include (see pch.h); NULL = none
+    Trace*           trace;          // spawn and compile spans of every run; NULL = off
+    SubprocessLimits limits;         // time and memory of every compiler run; zero = none
+} ValidatorOptions;
+
 ValidationResult validator_check_syntax(
     const char* compiler,
     const char* std_name,
     const char* input_path
 );
 
+/*
+ * validator_check_syntax() with options (NULL = none). max_errors is
+ * forwarded as -fmax-errors (GCC) or -ferror-limit (Clang). With
+ * on_diagnostic the output is parsed while the compiler runs and every
+ * diagnostic is delivered as soon as it is complete; once max_errors errors
+ * were delivered the compiler is killed, later output is dropped, and the
+ * result has success 0 and exit_code -1 (so it is never cached).
+ *
+ * A structured format (JSON/SARIF, when the compiler supports it; otherwise
+ * text is used) leaves raw_output in that format, for
+ * diagnostics_parse_structured(). The compiler prints it only when it exits,
+ * so diagnostics are delivered after the run and max_errors only limits the
+ * delivery: GCC drops its JSON entirely when -fmax-errors fires.
+ *
+ * A run stopped by limits.timeout_ms, or failing under limits.memory_bytes
+ * with the signs of an allocation failure (a crash, "out of memory", "memory
+ * exhausted"), ends with success 0, exit_code VALIDATION_TIMED_OUT or
+ * VALIDATION_OUT_OF_MEMORY, and instead of the compiler output one error at
+ * <input>:1:1 naming the limit (also delivered to on_diagnostic).
+ */
+ValidationResult validator_check_syntax_ex(
+    const char*             compiler,
+    const char*             std_name,
+    const char*             input_path,
+    const ValidatorOptions* options
+);
+
+/*
+ * Validate count inputs with a single compiler run and split its output back
+ * per file by the diagnostic file names; a file with no error attributed to it
+ * is valid. When the output cannot be attributed unambiguously (diagnostics in
+ * an included .hplus, driver errors, verdicts that disagree with the exit
+ * status, a run cut short by the limits) every input is validated on its own
+ * instead, so one pathological file cannot fail the others. results[i] has
+ * the same meaning as validator_check_syntax(input_paths[i]); a file's
+ * raw_output is its own share of the output. max_errors and format (options may be NULL) work
+ * as in validator_check_syntax_ex(); on_diagnostic is not used. GCC JSON is
+ * split by translation unit; SARIF output is always validated file by file.
+ * Returns the number of compiler runs made.
+ */
+size_t validator_check_syntax_batch(
+    const char*             compiler,
+    const char*             std_name,
+    const ValidatorOptions* options,
+    const char* const       input_paths[],
+    size_t                  count,
+    ValidationResult        results[]
+);
+
 void validator_free_result(ValidationResult* result);
 
 #endif // CPLUS_COMPILER_VALIDATOR_H
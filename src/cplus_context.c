@@ -0,0 +1,270 @@
+/*
+ * FILE: cplus_context.c
+ * DESC.: embeddable cplus library API over the pipeline
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "cplus_context.h"
+
+#include "cache_dir.h"
+#include "pipeline.h"
+#include "validation_cache.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+struct CplusContext {
+    CplusContextOptions options;
+    ValidationCache*    cache;        /* NULL without use_cache */
+    pthread_mutex_t     lock;         /* idle scratches and stderr */
+    PipelineScratch**   idle;         /* scratches no call is using */
+    size_t              n_idle;
+    size_t              idle_cap;
+};
+
+/* One job while it runs: what the pipeline's diagnostics are routed through */
+typedef struct {
+    CplusContext*   ctx;
+    const CplusJob* job;
+    CplusResult*    result;
+    FILE*           block;   /* without a sink: the job's stderr block */
+} JobSink;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static void count_and_forward(void *user, const Diagnostic *diag) {
+    JobSink *sink = (JobSink *)user;
+    switch (diag->severity) {
+    case DIAG_ERROR:
+        ++sink->result->errors;
+        break;
+    case DIAG_WARNING:
+        ++sink->result->warnings;
+        break;
+    case DIAG_NOTE:
+        ++sink->result->notes;
+        break;
+    }
+
+    if (sink->ctx->options.diag_sink != NULL) {
+        sink->ctx->options.diag_sink(sink->ctx->options.diag_user, sink->job, diag);
+    } else {
+        diagnostics_fprint_one((sink->block != NULL) ? sink->block : stderr, diag);
+    }
+}
+
+/* A scratch nobody else is using, from the idle pool or new; NULL on allocation failure */
+static PipelineScratch *acquire_scratch(CplusContext *ctx) {
+    PipelineScratch *scratch = NULL;
+    (void)pthread_mutex_lock(&ctx->lock);
+    if (ctx->n_idle > 0U) {
+        scratch = ctx->idle[--ctx->n_idle];
+    }
+    (void)pthread_mutex_unlock(&ctx->lock);
+    return (scratch != NULL) ? scratch : pipeline_scratch_create();
+}
+
+/* Back to the pool, which grows to the number of concurrent calls */
+static void release_scratch(CplusContext *ctx, PipelineScratch *scratch) {
+    if (scratch == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&ctx->lock);
+    if (ctx->n_idle == ctx->idle_cap) {
+        size_t            new_cap = (ctx->idle_cap == 0U) ? 4U : ctx->idle_cap * 2U;
+        PipelineScratch **resized =
+            (PipelineScratch **)realloc(ctx->idle, new_cap * sizeof(PipelineScratch *));
+        if (resized != NULL) {
+            ctx->idle     = resized;
+            ctx->idle_cap = new_cap;
+        }
+    }
+    if (ctx->n_idle < ctx->idle_cap) {
+        ctx->idle[ctx->n_idle++] = scratch;
+        scratch = NULL;
+    }
+    (void)pthread_mutex_unlock(&ctx->lock);
+    pipeline_scratch_destroy(scratch);
+}
+
+/* Without a sink, print each job's block in one piece so concurrent calls never interleave */
+static void flush_block(CplusContext *ctx, JobSink *sink, char *text, size_t size) {
+    if (sink->block == NULL) {
+        return;
+    }
+    (void)fclose(sink->block);
+    if ((text != NULL) && (size > 0U)) {
+        (void)pthread_mutex_lock(&ctx->lock);
+        (void)fwrite(text, 1U, size, stderr);
+        (void)fflush(stderr);
+        (void)pthread_mutex_unlock(&ctx->lock);
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+CplusContext *cplus_context_create(const CplusContextOptions *options) {
+    CplusContext *ctx = (CplusContext *)calloc(1U, sizeof(CplusContext));
+    if (ctx == NULL) {
+        return NULL;
+    }
+    if (options != NULL) {
+        ctx->options = *options;
+    }
+    if (ctx->options.compiler == NULL) {
+        ctx->options.compiler = "gcc";
+    }
+    if (ctx->options.std_name == NULL) {
+        ctx->options.std_name = "c23";
+    }
+    if (ctx->options.cache_max_bytes == 0ULL) {
+        ctx->options.cache_max_bytes = VALIDATION_CACHE_DEFAULT_MAX_BYTES;
+    }
+    if ((ctx->options.max_errors < 0) || (ctx->options.diag_format > DIAG_FORMAT_AUTO) ||
+        (pthread_mutex_init(&ctx->lock, NULL) != 0)) {
+        free(ctx);
+        return NULL;
+    }
+
+    if (ctx->options.cache_dir != NULL) {
+        cache_dir_set_root(ctx->options.cache_dir);
+    }
+    ctx->options.cache_dir = NULL; /* not ours to keep */
+    if (ctx->options.use_cache != 0) {
+        ctx->cache = validation_cache_open(ctx->options.cache_max_bytes);
+    }
+    return ctx;
+}
+
+void cplus_context_destroy(CplusContext *ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+    for (size_t i = 0U; i < ctx->n_idle; ++i) {
+        pipeline_scratch_destroy(ctx->idle[i]);
+    }
+    free(ctx->idle);
+    validation_cache_close(ctx->cache);
+    (void)pthread_mutex_destroy(&ctx->lock);
+    free(ctx);
+}
+
+int cplus_transpile(CplusContext *ctx, const CplusJob *job, CplusResult *result) {
+    CplusResult local;
+    CplusResult *out = (result != NULL) ? result : &local;
+    cplus_transpile_batch(ctx, job, 1U, out);
+    return out->rc;
+}
+
+void cplus_transpile_batch(CplusContext *ctx, const CplusJob jobs[], size_t count,
+                           CplusResult results[]) {
+    if ((results == NULL) || (count == 0U)) {
+        return;
+    }
+    for (size_t i = 0U; i < count; ++i) {
+        results[i] = (CplusResult){1, 0U, 0U, 0U, 0};
+    }
+    if ((ctx == NULL) || (jobs == NULL)) {
+        return;
+    }
+
+    PipelineOptions *options = (PipelineOptions *)calloc(count, sizeof(PipelineOptions));
+    PipelineStats   *stats   = (PipelineStats *)calloc(count, sizeof(PipelineStats));
+    JobSink         *sinks   = (JobSink *)calloc(count, sizeof(JobSink));
+    char           **owned   = (char **)calloc(count, sizeof(char *));
+    char           **blocks  = (char **)calloc(count, sizeof(char *));
+    size_t          *sizes   = (size_t *)calloc(count, sizeof(size_t));
+    int             *rcs     = (int *)calloc(count, sizeof(int));
+    PipelineScratch *scratch = acquire_scratch(ctx);
+
+    int ok = (options != NULL) && (stats != NULL) && (sinks != NULL) && (owned != NULL) &&
+             (blocks != NULL) && (sizes != NULL) && (rcs != NULL) && (scratch != NULL);
+    for (size_t i = 0U; (ok != 0) && (i < count); ++i) {
+        const char *output_path = jobs[i].output_path;
+        if ((output_path == NULL) && (jobs[i].input_path != NULL)) {
+            owned[i]    = pipeline_default_output_path(jobs[i].input_path);
+            output_path = owned[i];
+            ok          = (owned[i] != NULL);
+        }
+
+        sinks[i] = (JobSink){ctx, &jobs[i], &results[i], NULL};
+        if (ctx->options.diag_sink == NULL) {
+            sinks[i].block = open_memstream(&blocks[i], &sizes[i]);
+        }
+        options[i] = (PipelineOptions){
+            .input_path  = jobs[i].input_path,
+            .output_path = output_path,
+            .compiler    = ctx->options.compiler,
+            .std_name    = ctx->options.std_name,
+            .cache       = ctx->cache,
+            .stats       = &stats[i],
+            .max_errors  = ctx->options.max_errors,
+            .diag_format = ctx->options.diag_format,
+            .precheck    = ctx->options.precheck,
+            .source_map  = ctx->options.source_map,
+            .diag_sink   = count_and_forward,
+            .diag_user   = &sinks[i],
+            .scratch     = scratch,
+            .limits      = ctx->options.limits,
+        };
+    }
+
+    if (ok != 0) {
+        pipeline_run_batch(options, count, rcs);
+        for (size_t i = 0U; i < count; ++i) {
+            results[i].rc               = rcs[i];
+            results[i].output_unchanged = (atomic_load(&stats[i].outputs_unchanged) > 0U);
+        }
+    } else if (ctx->options.diag_sink == NULL) {
+        fprintf(stderr, "internal runtime error: failed to allocate transpile jobs\n");
+    }
+
+    for (size_t i = 0U; (sinks != NULL) && (i < count); ++i) {
+        flush_block(ctx, &sinks[i], (blocks != NULL) ? blocks[i] : NULL,
+                    (sizes != NULL) ? sizes[i] : 0U);
+        if (blocks != NULL) {
+            free(blocks[i]);
+        }
+        if (owned != NULL) {
+            free(owned[i]);
+        }
+    }
+    release_scratch(ctx, scratch);
+    free(options);
+    free(stats);
+    free(sinks);
+    free(owned);
+    free(blocks);
+    free(sizes);
+    free(rcs);
+}
+
+void cplus_context_counters(CplusContext *ctx, size_t *out_hits, size_t *out_misses) {
+    size_t hits   = 0U;
+    size_t misses = 0U;
+    if ((ctx != NULL) && (ctx->cache != NULL)) {
+        validation_cache_counters(ctx->cache, &hits, &misses);
+    }
+    if (out_hits != NULL) {
+        *out_hits = hits;
+    }
+    if (out_misses != NULL) {
+        *out_misses = misses;
+    }
+}
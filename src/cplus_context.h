@@ -0,0 +1,84 @@
+/*
+ * FILE: cplus_context.h
+ * DESC.: this file is the declaration of the embeddable cplus library API
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_CPLUS_CONTEXT_H
+#define CPLUS_CPLUS_CONTEXT_H
+
+#include "diagnostics.h"
+#include "subprocess.h"
+
+#include <stddef.h>
+
+/*
+ * Entry point for programs that link cplus_core and transpile many files
+ * in-process. A context holds what the CLI sets up once per run — settings,
+ * the validation cache, a diagnostics sink — plus pools of buffers that
+ * successive calls reuse, so a long-lived build tool pays for them once.
+ * cplus_transpile() and cplus_transpile_batch() may be called from any number
+ * of threads on the same context.
+ */
+typedef struct CplusContext CplusContext;
+
+/* One file to transpile; user is not touched and reaches the sink with it */
+typedef struct {
+    const char* input_path;
+    const char* output_path; // NULL = pipeline_default_output_path()
+    void*       user;
+} CplusJob;
+
+/*
+ * Receives every diagnostic of job, in order, on the thread transpiling it;
+ * diag and its strings are only valid during the call. Calls for different
+ * jobs may run concurrently.
+ */
+typedef void (*CplusDiagnosticFn)(void* user, const CplusJob* job, const Diagnostic* diag);
+
+typedef struct {
+    const char* compiler;    // NULL = "gcc"
+    const char* std_name;    // NULL = "c23"
+    int         max_errors;  // 0 = no limit
+    DiagnosticFormat diag_format;
+    int         precheck;    // see precheck.h
+    int         source_map;  // see source_map.h
+    int         use_cache;   // reuse validation results from the on-disk cache
+    const char* cache_dir;   // process-wide cache root to set; NULL = leave it (see cache_dir.h)
+    unsigned long long cache_max_bytes; // 0 = VALIDATION_CACHE_DEFAULT_MAX_BYTES
+    CplusDiagnosticFn diag_sink; // NULL = print each job's diagnostics to stderr as one block
+    void*       diag_user;   // passed to diag_sink
+    SubprocessLimits limits; // per compiler run; zero fields = unlimited
+} CplusContextOptions;
+
+typedef struct {
+    int    rc;                // 0 ok, 1 on validation or I/O failure, 3 when cut short by limits
+    size_t errors;            // diagnostics of each severity reported for the job
+    size_t warnings;
+    size_t notes;
+    int    output_unchanged;  // success left an identical output untouched
+} CplusResult;
+
+/* NULL on allocation failure or invalid options; options may be NULL for the defaults */
+CplusContext* cplus_context_create(const CplusContextOptions* options);
+
+/* No call may still be running; trims the validation cache to its bound */
+void cplus_context_destroy(CplusContext* ctx);
+
+/* Transpile one file; returns result->rc (result may be NULL) */
+int cplus_transpile(CplusContext* ctx, const CplusJob* job, CplusResult* result);
+
+/*
+ * Transpile count files, validating the cache misses with one compiler
+ * invocation (see pipeline_run_batch). results[i] is what
+ * cplus_transpile(ctx, &jobs[i], ...) would give.
+ */
+void cplus_transpile_batch(CplusContext* ctx, const CplusJob jobs[], size_t count,
+                           CplusResult results[]);
+
+/* Validation cache lookups of the context's calls so far (0/0 without the cache) */
+void cplus_context_counters(CplusContext* ctx, size_t* out_hits, size_t* out_misses);
+
+#endif // CPLUS_CPLUS_CONTEXT_H
@@ -0,0 +1,653 @@
+/*
+ * FILE: dep_graph.c
+ * DESC.: include dependency graph and manifest for incremental project runs
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "dep_graph.h"
+
+#include "file_io.h"
+#include "hash.h"
+#include "include_scan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+#define MANIFEST_FORMAT_TAG "cplus-manifest 1"
+#define NO_NODE             UINT32_MAX
+#define RACY_WINDOW_NS      1000000000LL
+
+typedef struct {
+    char*     path;       /* lexically normalised */
+    long long size;       /* -1 when the file does not exist */
+    long long mtime_ns;
+    uint64_t  hash;
+    uint32_t* deps;       /* node indices this file includes */
+    size_t    n_deps;
+    char*     output;     /* inputs only */
+    int       is_input;
+    int       ok;         /* inputs only: last transpilation succeeded */
+    int       scanned;    /* current run: hash and deps are known */
+    int       changed;    /* current run: content differs from the manifest */
+} DepNode;
+
+/* Nodes plus an open-addressing index path -> node (slot = index + 1, 0 = empty) */
+typedef struct {
+    DepNode*  nodes;
+    size_t    count;
+    size_t    capacity;
+    uint32_t* slots;
+    size_t    n_slots;    /* power of two, kept at most half full */
+} NodeTable;
+
+struct DepGraph {
+    char*     manifest_path;
+    uint64_t  config_hash;
+    int       config_matches;
+    long long saved_ns;   /* mtime of the loaded manifest, 0 without one */
+    NodeTable previous;   /* as loaded from the manifest */
+    NodeTable current;    /* this run */
+    uint32_t* inputs;     /* current-node index of each input */
+    size_t    n_inputs;
+    size_t    cap_inputs;
+};
+
+/* Context for include_scan() callbacks while scanning one node */
+typedef struct {
+    DepGraph* graph;
+    uint32_t  node;
+    int       failed;
+} ScanContext;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/*
+ * Lexical normalisation so "./a/../b.hplus" and "b.hplus" are one node:
+ * drops "." segments and empty segments, folds "x/.." pairs.
+ */
+static char *normalize_path(const char *path) {
+    size_t len = strlen(path);
+    char *out = (char *)malloc(len + 2U);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    int    absolute = (path[0] == '/');
+    size_t out_len  = 0U;
+    size_t kept     = 0U; /* segments that a ".." may fold */
+
+    if (absolute != 0) {
+        out[out_len++] = '/';
+    }
+
+    const char *p = path;
+    while (*p != '\0') {
+        while (*p == '/') {
+            ++p;
+        }
+        const char *seg = p;
+        while ((*p != '/') && (*p != '\0')) {
+            ++p;
+        }
+        size_t seg_len = (size_t)(p - seg);
+
+        if ((seg_len == 0U) || ((seg_len == 1U) && (seg[0] == '.'))) {
+            continue;
+        }
+
+        if ((seg_len == 2U) && (seg[0] == '.') && (seg[1] == '.') && (kept > 0U)) {
+            /* drop the previous segment and its separator */
+            while ((out_len > (size_t)absolute) && (out[out_len - 1U] != '/')) {
+                --out_len;
+            }
+            if (out_len > (size_t)absolute) {
+                --out_len;
+            }
+            --kept;
+            continue;
+        }
+
+        if ((out_len > 0U) && (out[out_len - 1U] != '/')) {
+            out[out_len++] = '/';
+        }
+        memcpy(out + out_len, seg, seg_len);
+        out_len += seg_len;
+
+        int is_dotdot = (seg_len == 2U) && (seg[0] == '.') && (seg[1] == '.');
+        kept = (is_dotdot != 0) ? 0U : kept + 1U;
+    }
+
+    if (out_len == 0U) {
+        out[out_len++] = '.';
+    }
+    out[out_len] = '\0';
+    return out;
+}
+
+static size_t slot_of(const NodeTable *table, const char *path) {
+    return (size_t)hash_bytes(path, strlen(path), 0U) & (table->n_slots - 1U);
+}
+
+static uint32_t table_find(const NodeTable *table, const char *path) {
+    if (table->n_slots == 0U) {
+        return NO_NODE;
+    }
+
+    size_t mask = table->n_slots - 1U;
+    for (size_t s = slot_of(table, path); table->slots[s] != 0U; s = (s + 1U) & mask) {
+        uint32_t index = table->slots[s] - 1U;
+        if (strcmp(table->nodes[index].path, path) == 0) {
+            return index;
+        }
+    }
+    return NO_NODE;
+}
+
+static int table_rehash(NodeTable *table) {
+    size_t new_slots = (table->n_slots == 0U) ? 64U : table->n_slots * 2U;
+    uint32_t *slots = (uint32_t *)calloc(new_slots, sizeof(uint32_t));
+    if (slots == NULL) {
+        return 0;
+    }
+
+    free(table->slots);
+    table->slots   = slots;
+    table->n_slots = new_slots;
+
+    for (size_t i = 0U; i < table->count; ++i) {
+        size_t s = slot_of(table, table->nodes[i].path);
+        while (table->slots[s] != 0U) {
+            s = (s + 1U) & (table->n_slots - 1U);
+        }
+        table->slots[s] = (uint32_t)i + 1U;
+    }
+    return 1;
+}
+
+/* Find or insert a node for an already-normalised path (ownership taken) */
+static uint32_t table_intern(NodeTable *table, char *path) {
+    uint32_t existing = table_find(table, path);
+    if (existing != NO_NODE) {
+        free(path);
+        return existing;
+    }
+
+    if (((table->count + 1U) * 2U > table->n_slots) && (table_rehash(table) == 0)) {
+        free(path);
+        return NO_NODE;
+    }
+
+    if (table->count == table->capacity) {
+        size_t new_cap = (table->capacity == 0U) ? 64U : table->capacity * 2U;
+        DepNode *resized = (DepNode *)realloc(table->nodes, new_cap * sizeof(DepNode));
+        if (resized == NULL) {
+            free(path);
+            return NO_NODE;
+        }
+        table->nodes    = resized;
+        table->capacity = new_cap;
+    }
+
+    uint32_t index = (uint32_t)table->count++;
+    table->nodes[index] = (DepNode){path, -1, 0, 0U, NULL, 0U, NULL, 0, 0, 0, 0};
+
+    size_t s = slot_of(table, path);
+    while (table->slots[s] != 0U) {
+        s = (s + 1U) & (table->n_slots - 1U);
+    }
+    table->slots[s] = index + 1U;
+    return index;
+}
+
+static int node_add_dep(DepNode *node, uint32_t dep) {
+    for (size_t i = 0U; i < node->n_deps; ++i) {
+        if (node->deps[i] == dep) {
+            return 1;
+        }
+    }
+
+    uint32_t *resized = (uint32_t *)realloc(node->deps, (node->n_deps + 1U) * sizeof(uint32_t));
+    if (resized == NULL) {
+        return 0;
+    }
+    node->deps = resized;
+    node->deps[node->n_deps++] = dep;
+    return 1;
+}
+
+static void table_free(NodeTable *table) {
+    for (size_t i = 0U; i < table->count; ++i) {
+        free(table->nodes[i].path);
+        free(table->nodes[i].deps);
+        free(table->nodes[i].output);
+    }
+    free(table->nodes);
+    free(table->slots);
+    *table = (NodeTable){NULL, 0U, 0U, NULL, 0U};
+}
+
+/* Line "<tag> <fields...>"; returns a pointer past the line or NULL at the end */
+static const char *next_line(const char *p, const char *end, const char **line_end) {
+    if (p >= end) {
+        return NULL;
+    }
+    const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+    *line_end = (nl != NULL) ? nl : end;
+    return (nl != NULL) ? nl + 1 : end;
+}
+
+static char *copy_span(const char *start, const char *end) {
+    size_t len = (size_t)(end - start);
+    char *copy = (char *)malloc(len + 1U);
+    if (copy != NULL) {
+        memcpy(copy, start, len);
+        copy[len] = '\0';
+    }
+    return copy;
+}
+
+/*
+ * Manifest grammar, one record per line, paths last so they may hold spaces:
+ *   cplus-manifest 1
+ *   config <hex>
+ *   N <size> <mtime_ns> <hash hex> <path>      node, indices implicit from 0
+ *   E <from> <to>                              from includes to
+ *   I <node> <ok> <output path>                input record
+ * Any malformed line discards the whole manifest (everything becomes dirty).
+ */
+static void load_manifest(DepGraph *graph) {
+    struct stat st;
+    if (stat(graph->manifest_path, &st) == 0) {
+        graph->saved_ns = (long long)st.st_mtim.tv_sec * 1000000000LL +
+                          (long long)st.st_mtim.tv_nsec;
+    }
+
+    size_t size = 0U;
+    char *text = file_io_read_all(graph->manifest_path, &size);
+    if (text == NULL) {
+        return;
+    }
+
+    const char *end = text + size;
+    const char *line_end = NULL;
+    const char *p = text;
+    const char *next = next_line(p, end, &line_end);
+    int valid = (next != NULL) &&
+                ((size_t)(line_end - p) == strlen(MANIFEST_FORMAT_TAG)) &&
+                (memcmp(p, MANIFEST_FORMAT_TAG, strlen(MANIFEST_FORMAT_TAG)) == 0);
+    int have_config = 0;
+
+    NodeTable *prev = &graph->previous;
+
+    for (p = next; (valid != 0) && (p != NULL) && (p < end); p = next) {
+        next = next_line(p, end, &line_end);
+        char *line = copy_span(p, line_end);
+        if (line == NULL) {
+            valid = 0;
+            break;
+        }
+
+        unsigned long long hash = 0ULL;
+        long long size_field = 0;
+        long long mtime = 0;
+        unsigned long from = 0UL;
+        unsigned long to = 0UL;
+        int ok = 0;
+        int consumed = 0;
+
+        if (sscanf(line, "config %llx%n", &hash, &consumed) == 1) {
+            graph->config_matches = ((uint64_t)hash == graph->config_hash);
+            have_config = 1;
+        } else if ((sscanf(line, "N %lld %lld %llx %n", &size_field, &mtime, &hash,
+                           &consumed) == 3) &&
+                   (consumed > 0) && (line[consumed] != '\0')) {
+            char *path = strdup(line + consumed);
+            uint32_t index = (path != NULL) ? table_intern(prev, path) : NO_NODE;
+            if (index == NO_NODE) {
+                valid = 0;
+            } else {
+                prev->nodes[index].size     = size_field;
+                prev->nodes[index].mtime_ns = mtime;
+                prev->nodes[index].hash     = (uint64_t)hash;
+            }
+        } else if (sscanf(line, "E %lu %lu", &from, &to) == 2) {
+            valid = (from < prev->count) && (to < prev->count) &&
+                    (node_add_dep(&prev->nodes[from], (uint32_t)to) != 0);
+        } else if ((sscanf(line, "I %lu %d %n", &from, &ok, &consumed) == 2) &&
+                   (consumed > 0) && (from < prev->count) && (line[consumed] != '\0')) {
+            prev->nodes[from].is_input = 1;
+            prev->nodes[from].ok       = ok;
+            free(prev->nodes[from].output);
+            prev->nodes[from].output   = strdup(line + consumed);
+        } else {
+            valid = 0;
+        }
+
+        free(line);
+    }
+
+    free(text);
+
+    if ((valid == 0) || (have_config == 0)) {
+        table_free(prev);
+        graph->config_matches = 0;
+    }
+}
+
+static int scan_visit(void *user, const char *name, size_t name_len) {
+    ScanContext *ctx = (ScanContext *)user;
+    NodeTable *cur = &ctx->graph->current;
+
+    char *raw = include_resolve(cur->nodes[ctx->node].path, name, name_len);
+    char *normalized = (raw != NULL) ? normalize_path(raw) : NULL;
+    free(raw);
+
+    uint32_t dep = (normalized != NULL) ? table_intern(cur, normalized) : NO_NODE;
+    if ((dep == NO_NODE) || (node_add_dep(&cur->nodes[ctx->node], dep) == 0)) {
+        ctx->failed = 1;
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Establish hash and deps of one current node. When size and mtime match the
+ * manifest, both are taken from it without opening the file.
+ */
+static int scan_node(DepGraph *graph, uint32_t index) {
+    NodeTable *cur  = &graph->current;
+    NodeTable *prev = &graph->previous;
+
+    cur->nodes[index].scanned = 1;
+
+    uint32_t old = table_find(prev, cur->nodes[index].path);
+
+    struct stat st;
+    if (stat(cur->nodes[index].path, &st) != 0) {
+        cur->nodes[index].size    = -1;
+        cur->nodes[index].changed = (old == NO_NODE) || (prev->nodes[old].size != -1);
+        return 1;
+    }
+
+    long long mtime = (long long)st.st_mtim.tv_sec * 1000000000LL + (long long)st.st_mtim.tv_nsec;
+    cur->nodes[index].size     = (long long)st.st_size;
+    cur->nodes[index].mtime_ns = mtime;
+
+    /*
+     * Same size and mtime means unchanged, unless the file was modified within
+     * a timestamp tick of the manifest write: a same-size edit right after it
+     * could keep the recorded mtime, so such a file is hashed again.
+     */
+    if ((old != NO_NODE) && (prev->nodes[old].size == (long long)st.st_size) &&
+        (prev->nodes[old].mtime_ns == mtime) && (mtime < (graph->saved_ns - RACY_WINDOW_NS))) {
+        cur->nodes[index].hash = prev->nodes[old].hash;
+        for (size_t i = 0U; i < prev->nodes[old].n_deps; ++i) {
+            char *dep_path = strdup(prev->nodes[prev->nodes[old].deps[i]].path);
+            uint32_t dep = (dep_path != NULL) ? table_intern(cur, dep_path) : NO_NODE;
+            if ((dep == NO_NODE) || (node_add_dep(&cur->nodes[index], dep) == 0)) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    size_t size = 0U;
+    char *content = file_io_read_all(cur->nodes[index].path, &size);
+    if (content == NULL) {
+        cur->nodes[index].size    = -1;
+        cur->nodes[index].changed = 1;
+        return 1;
+    }
+
+    uint64_t hash = hash_bytes(content, size, 0U);
+    cur->nodes[index].hash    = hash;
+    cur->nodes[index].changed = (old == NO_NODE) || (prev->nodes[old].size == -1) ||
+                                (prev->nodes[old].hash != hash);
+
+    ScanContext ctx = {graph, index, 0};
+    (void)include_scan(content, size, scan_visit, &ctx);
+    free(content);
+
+    return (ctx.failed == 0);
+}
+
+/*
+ * Mark every node that is changed or transitively includes a changed node,
+ * walking reverse edges breadth-first from the changed set.
+ */
+static unsigned char *mark_affected(const NodeTable *cur) {
+    size_t n = cur->count;
+    unsigned char *affected = (unsigned char *)calloc(n + 1U, 1U);
+    size_t *rev_start = (size_t *)calloc(n + 1U, sizeof(size_t));
+    size_t n_edges = 0U;
+
+    for (size_t i = 0U; i < n; ++i) {
+        n_edges += cur->nodes[i].n_deps;
+    }
+
+    uint32_t *rev = (uint32_t *)malloc((n_edges + 1U) * sizeof(uint32_t));
+    uint32_t *queue = (uint32_t *)malloc((n + 1U) * sizeof(uint32_t));
+    size_t *fill = (size_t *)calloc(n + 1U, sizeof(size_t));
+
+    if ((affected == NULL) || (rev_start == NULL) || (rev == NULL) || (queue == NULL) ||
+        (fill == NULL)) {
+        free(rev_start);
+        free(rev);
+        free(queue);
+        free(fill);
+        if (affected != NULL) {
+            memset(affected, 1, n + 1U); /* out of memory: everything is dirty */
+        }
+        return affected;
+    }
+
+    /* Compressed reverse adjacency: rev[rev_start[d] .. rev_start[d+1]) include d */
+    for (size_t i = 0U; i < n; ++i) {
+        for (size_t k = 0U; k < cur->nodes[i].n_deps; ++k) {
+            rev_start[cur->nodes[i].deps[k] + 1U]++;
+        }
+    }
+    for (size_t i = 0U; i < n; ++i) {
+        rev_start[i + 1U] += rev_start[i];
+    }
+    for (size_t i = 0U; i < n; ++i) {
+        for (size_t k = 0U; k < cur->nodes[i].n_deps; ++k) {
+            uint32_t d = cur->nodes[i].deps[k];
+            rev[rev_start[d] + fill[d]++] = (uint32_t)i;
+        }
+    }
+
+    size_t head = 0U;
+    size_t tail = 0U;
+    for (size_t i = 0U; i < n; ++i) {
+        if (cur->nodes[i].changed != 0) {
+            affected[i] = 1U;
+            queue[tail++] = (uint32_t)i;
+        }
+    }
+
+    while (head < tail) {
+        uint32_t d = queue[head++];
+        for (size_t k = rev_start[d]; k < rev_start[d + 1U]; ++k) {
+            if (affected[rev[k]] == 0U) {
+                affected[rev[k]] = 1U;
+                queue[tail++] = rev[k];
+            }
+        }
+    }
+
+    free(rev_start);
+    free(rev);
+    free(queue);
+    free(fill);
+    return affected;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+DepGraph *dep_graph_open(const char *manifest_path, uint64_t config_hash) {
+    if (manifest_path == NULL) {
+        return NULL;
+    }
+
+    DepGraph *graph = (DepGraph *)calloc(1U, sizeof(DepGraph));
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    graph->manifest_path = strdup(manifest_path);
+    if (graph->manifest_path == NULL) {
+        free(graph);
+        return NULL;
+    }
+
+    graph->config_hash = config_hash;
+    load_manifest(graph);
+    return graph;
+}
+
+long dep_graph_add_input(DepGraph *graph, const char *input_path, const char *output_path) {
+    if ((graph == NULL) || (input_path == NULL) || (output_path == NULL)) {
+        return -1L;
+    }
+
+    char *normalized = normalize_path(input_path);
+    uint32_t node = (normalized != NULL) ? table_intern(&graph->current, normalized) : NO_NODE;
+    if (node == NO_NODE) {
+        return -1L;
+    }
+
+    if (graph->n_inputs == graph->cap_inputs) {
+        size_t new_cap = (graph->cap_inputs == 0U) ? 64U : graph->cap_inputs * 2U;
+        uint32_t *resized = (uint32_t *)realloc(graph->inputs, new_cap * sizeof(uint32_t));
+        if (resized == NULL) {
+            return -1L;
+        }
+        graph->inputs     = resized;
+        graph->cap_inputs = new_cap;
+    }
+
+    DepNode *n = &graph->current.nodes[node];
+    free(n->output);
+    n->output   = strdup(output_path);
+    n->is_input = 1;
+
+    graph->inputs[graph->n_inputs] = node;
+    return (long)graph->n_inputs++;
+}
+
+size_t dep_graph_plan(DepGraph *graph, unsigned char *dirty) {
+    if ((graph == NULL) || (dirty == NULL)) {
+        return 0U;
+    }
+
+    NodeTable *cur  = &graph->current;
+    NodeTable *prev = &graph->previous;
+    int scan_ok = 1;
+
+    /* Nodes appended while scanning are scanned by the same loop */
+    for (size_t i = 0U; (i < cur->count) && (scan_ok != 0); ++i) {
+        if (cur->nodes[i].scanned == 0) {
+            scan_ok = scan_node(graph, (uint32_t)i);
+        }
+    }
+
+    unsigned char *affected = (scan_ok != 0) ? mark_affected(cur) : NULL;
+    size_t n_dirty = 0U;
+
+    for (size_t k = 0U; k < graph->n_inputs; ++k) {
+        const DepNode *node = &cur->nodes[graph->inputs[k]];
+        uint32_t old = table_find(prev, node->path);
+
+        int is_dirty = (affected == NULL) || (affected[graph->inputs[k]] != 0U) ||
+                       (graph->config_matches == 0) || (old == NO_NODE) ||
+                       (prev->nodes[old].is_input == 0) || (prev->nodes[old].ok == 0) ||
+                       (prev->nodes[old].output == NULL) || (node->output == NULL) ||
+                       (strcmp(prev->nodes[old].output, node->output) != 0) ||
+                       (access(node->output, F_OK) != 0);
+
+        dirty[k] = (unsigned char)is_dirty;
+        /* clean inputs keep their previous (successful) result */
+        cur->nodes[graph->inputs[k]].ok = (is_dirty == 0) ? 1 : 0;
+        n_dirty += (size_t)is_dirty;
+    }
+
+    free(affected);
+    return n_dirty;
+}
+
+void dep_graph_set_result(DepGraph *graph, long input_index, int ok) {
+    if ((graph == NULL) || (input_index < 0L) || ((size_t)input_index >= graph->n_inputs)) {
+        return;
+    }
+    graph->current.nodes[graph->inputs[input_index]].ok = (ok != 0) ? 1 : 0;
+}
+
+int dep_graph_save(DepGraph *graph) {
+    if (graph == NULL) {
+        return 0;
+    }
+
+    char  *text = NULL;
+    size_t size = 0U;
+    FILE  *out  = open_memstream(&text, &size);
+    if (out == NULL) {
+        return 0;
+    }
+
+    const NodeTable *cur = &graph->current;
+
+    fprintf(out, MANIFEST_FORMAT_TAG "\nconfig %016llx\n", (unsigned long long)graph->config_hash);
+
+    for (size_t i = 0U; i < cur->count; ++i) {
+        const DepNode *n = &cur->nodes[i];
+        fprintf(out, "N %lld %lld %016llx %s\n", n->size, n->mtime_ns, (unsigned long long)n->hash,
+                n->path);
+    }
+    for (size_t i = 0U; i < cur->count; ++i) {
+        for (size_t k = 0U; k < cur->nodes[i].n_deps; ++k) {
+            fprintf(out, "E %zu %u\n", i, (unsigned)cur->nodes[i].deps[k]);
+        }
+    }
+    for (size_t k = 0U; k < graph->n_inputs; ++k) {
+        const DepNode *n = &cur->nodes[graph->inputs[k]];
+        if (n->output != NULL) {
+            fprintf(out, "I %u %d %s\n", (unsigned)graph->inputs[k], n->ok, n->output);
+        }
+    }
+
+    int ok = (fclose(out) == 0);
+    ok = ok && (file_io_write_atomic(graph->manifest_path, text, size) != 0);
+    free(text);
+    return ok;
+}
+
+void dep_graph_close(DepGraph *graph) {
+    if (graph == NULL) {
+        return;
+    }
+
+    table_free(&graph->previous);
+    table_free(&graph->current);
+    free(graph->inputs);
+    free(graph->manifest_path);
+    free(graph);
+}
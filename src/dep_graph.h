@@ -0,0 +1,54 @@
+/*
+ * FILE: dep_graph.h
+ * DESC.: this file is the declaration of the .hplus include graph and manifest
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_DEP_GRAPH_H
+#define CPLUS_DEP_GRAPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Include graph of one incremental run plus the manifest of the previous one.
+ * Nodes are files (inputs and every reachable "*.hplus"), edges are
+ * `#include "x.hplus"` directives. The manifest stores each node's size, mtime
+ * and content hash, its edges, and for inputs the output path and last result.
+ *
+ * Usage: open, add every input, plan, transpile the dirty ones, set results,
+ * save, close. Not thread-safe; drive it from one thread.
+ */
+typedef struct DepGraph DepGraph;
+
+/*
+ * Load the manifest at manifest_path (a missing or unreadable manifest is an
+ * empty one). config_hash identifies compiler + std + cplus settings; if it
+ * differs from the stored one, every input is dirty. NULL on allocation failure.
+ */
+DepGraph* dep_graph_open(const char* manifest_path, uint64_t config_hash);
+
+/* Register an input and its output path; returns the input index or -1 */
+long dep_graph_add_input(DepGraph* graph, const char* input_path, const char* output_path);
+
+/*
+ * Scan the graph and decide which inputs must be transpiled: the ones whose
+ * own content changed, whose transitive .hplus dependencies changed (reverse
+ * dependents of any changed node), that failed last time, or whose output is
+ * missing. Unchanged files (same size and mtime, last modified over a second
+ * before the manifest was written) are not read at all.
+ * dirty[i] is set to 0/1 per input index. Returns the number of dirty inputs.
+ */
+size_t dep_graph_plan(DepGraph* graph, unsigned char* dirty);
+
+/* Record the outcome for a transpiled input (ok = 1 on success) */
+void dep_graph_set_result(DepGraph* graph, long input_index, int ok);
+
+/* Atomically rewrite the manifest. Returns 1 on success. */
+int dep_graph_save(DepGraph* graph);
+
+void dep_graph_close(DepGraph* graph);
+
+#endif // CPLUS_DEP_GRAPH_H
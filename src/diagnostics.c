@@ -5,12 +5,24 @@
  * LICENSE: GPL-v3
  * DATE: March, 2026
  *
- * NOTE: strdup / strndup are standard C23 (ISO/IEC 9899:2024 §7.27.6).
- *       No POSIX feature-test macro is required when building with -std=c23.
+ * NOTE: every string of a DiagnosticList lives in one arena sized from the
+ *       raw output, so parsing costs a couple of allocations in total.
+ *       Structured output is decoded from a JSON tree in a scratch arena.
  */
 
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "diagnostics.h"
 
+#include "arena.h"
+#include "byte_scan.h"
+#include "file_io.h"
+#include "hash.h"
+#include "json.h"
+
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,136 +31,686 @@
  * Internal helpers
  * ---------------------------------------------------------------------- */
 
+/* Distinct file names seen while parsing; each is copied to the arena once */
+typedef struct {
+    const char** names;  /* arena strings, NULL = empty slot */
+    size_t*      lens;
+    size_t       n_slots; /* power of two, kept at most half full */
+    size_t       count;
+    const char*  last;    /* most recent name: runs of one file skip the hash */
+    size_t       last_len;
+} FileInterner;
+
+static int interner_grow(FileInterner *in) {
+    size_t new_slots = (in->n_slots == 0U) ? 16U : in->n_slots * 2U;
+    const char **names = (const char **)calloc(new_slots, sizeof(const char *));
+    size_t *lens = (size_t *)calloc(new_slots, sizeof(size_t));
+    if ((names == NULL) || (lens == NULL)) {
+        free(names);
+        free(lens);
+        return 0;
+    }
+
+    for (size_t i = 0U; i < in->n_slots; ++i) {
+        if (in->names[i] == NULL) {
+            continue;
+        }
+        size_t s = (size_t)hash_bytes(in->names[i], in->lens[i], 0U) & (new_slots - 1U);
+        while (names[s] != NULL) {
+            s = (s + 1U) & (new_slots - 1U);
+        }
+        names[s] = in->names[i];
+        lens[s]  = in->lens[i];
+    }
+
+    free(in->names);
+    free(in->lens);
+    in->names   = names;
+    in->lens    = lens;
+    in->n_slots = new_slots;
+    return 1;
+}
+
+/* The arena copy of name[0..len), created on first sight; NULL on OOM */
+static char *interner_get(FileInterner *in, Arena *arena, const char *name, size_t len) {
+    if ((in->last != NULL) && (in->last_len == len) && (memcmp(in->last, name, len) == 0)) {
+        return (char *)in->last;
+    }
+    if (((in->count + 1U) * 2U > in->n_slots) && (interner_grow(in) == 0)) {
+        return NULL;
+    }
+
+    size_t s = (size_t)hash_bytes(name, len, 0U) & (in->n_slots - 1U);
+    for (; in->names[s] != NULL; s = (s + 1U) & (in->n_slots - 1U)) {
+        if ((in->lens[s] == len) && (memcmp(in->names[s], name, len) == 0)) {
+            in->last     = in->names[s];
+            in->last_len = len;
+            return (char *)in->names[s];
+        }
+    }
+
+    char *copy = arena_strndup(arena, name, len);
+    if (copy != NULL) {
+        in->names[s] = copy;
+        in->lens[s]  = len;
+        ++in->count;
+        in->last     = copy;
+        in->last_len = len;
+    }
+    return copy;
+}
+
+/*
+ * The arena a text parse needs is bounded by raw_len + 2: a primary line
+ * holds its file and message plus at least ":1:1: note: " (more than the two
+ * NULs they need, which also pays for its diagnostic's context NUL), a
+ * context line is copied with its own '\n', and only the last line may lack
+ * the '\n' it gets in the copy. No pass over the output is needed for it.
+ */
+#define ARENA_SLACK 2U
+
+static int is_digit(char c) {
+    return (c >= '0') && (c <= '9');
+}
+
+/*
+ * A line/column number starting at p. Plain digit runs are read inline; the
+ * rare rest (sign, leading blanks, huge values) goes through strtol() so the
+ * result is what the grammar has always accepted. *num_end is where it stops.
+ */
+static int parse_number(const char *p, const char *end, const char **num_end) {
+    const char *q = p;
+    long value = 0;
+    while ((q < end) && is_digit(*q) && (q - p < 18)) {
+        value = (value * 10) + (*q - '0');
+        ++q;
+    }
+    if ((q > p) && ((q == end) || !is_digit(*q))) {
+        *num_end = q;
+        return (int)value;
+    }
+
+    char *stop = NULL;
+    value = strtol(p, &stop, 10);
+    *num_end = stop;
+    return (int)value;
+}
+
+/* A matched primary line, as spans into the raw output */
+typedef struct {
+    const char*        file;
+    size_t             file_len;
+    const char*        message;
+    size_t             message_len;
+    int                line;
+    int                column;
+    DiagnosticSeverity severity;
+    const char*        after;    /* start of the following line */
+} PrimaryLine;
+
+static const char *line_end_from(const char *p, const char *end) {
+    const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+    return (nl != NULL) ? nl : end;
+}
+
+/*
+ * Read the line starting at pos (ending at the next '\n' or at end, which is
+ * followed by '\n' or NUL in memory) in one forward pass. Returns the line
+ * end; *matched is 1 when it is a primary diagnostic line:
+ *   <file>:<line>:<col>: <severity>: <message>
+ * where <file> runs up to the first ':' followed by a digit and <message> is
+ * not empty. On a match *primary points into the raw output (no copies).
+ */
+static const char *scan_line(const char *pos, const char *end, PrimaryLine *primary, int *matched) {
+    *matched = 0;
+
+    /* --- file: up to the first ':' followed by a digit, found with the colons --- */
+    const char *q = byte_scan_either(pos, end, ':', '\n');
+    while ((q < end) && (*q == ':') && ((q + 1 >= end) || !is_digit(q[1]))) {
+        q = byte_scan_either(q + 1, end, ':', '\n');
+    }
+    if ((q >= end) || (*q == '\n')) {
+        return q;
+    }
+    const char *colon1 = q;
+    if (colon1 == pos) {
+        return line_end_from(colon1, end);
+    }
+
+    /* --- line number: digits up to ':' --- */
+    const char *end_ln = NULL;
+    int line = parse_number(colon1 + 1, end, &end_ln);
+    if ((end_ln >= end) || (*end_ln != ':')) {
+        return line_end_from(colon1, end);
+    }
+
+    /* --- column number, then ": " --- */
+    const char *end_col = NULL;
+    int column = parse_number(end_ln + 1, end, &end_col);
+    if ((end_col == end_ln + 1) || (end_col + 1 >= end) || (end_col[0] != ':') ||
+        (end_col[1] != ' ')) {
+        return line_end_from(end_ln, end);
+    }
+    if (memchr(end_ln, '\n', (size_t)(end_col - end_ln)) != NULL) {
+        /* strtol() skipped a line break: the number is not on this line */
+        return line_end_from(end_ln, end);
+    }
+
+    /* --- severity: one of the known tokens followed by ": " --- */
+    static const struct {
+        const char*        text;
+        size_t             len;
+        DiagnosticSeverity severity;
+    } k_severities[] = {
+        {"error: ",   7U, DIAG_ERROR},
+        {"warning: ", 9U, DIAG_WARNING},
+        {"note: ",    6U, DIAG_NOTE},
+    };
+
+    const char *sev_start = end_col + 2;
+    size_t      room      = (size_t)(end - sev_start);
+    for (size_t i = 0U; i < sizeof(k_severities) / sizeof(k_severities[0]); ++i) {
+        if ((room < k_severities[i].len) ||
+            (memcmp(sev_start, k_severities[i].text, k_severities[i].len) != 0)) {
+            continue;
+        }
+
+        /* --- message: the rest of the line, not empty --- */
+        const char *msg_start = sev_start + k_severities[i].len;
+        const char *line_end  = line_end_from(msg_start, end);
+        if (msg_start >= line_end) {
+            return line_end;
+        }
+
+        primary->file        = pos;
+        primary->file_len    = (size_t)(colon1 - pos);
+        primary->line        = line;
+        primary->column      = column;
+        primary->severity    = k_severities[i].severity;
+        primary->message     = msg_start;
+        primary->message_len = (size_t)(line_end - msg_start);
+        primary->after       = (line_end < end) ? line_end + 1 : line_end;
+        *matched = 1;
+        return line_end;
+    }
+    return line_end_from(sev_start, end);
+}
+
 /*
- * Append src[0..src_len) + '\n' to *buf, growing the allocation as needed.
- * *buf may be NULL on entry (treated as empty string).
- * Returns 1 on success, 0 on allocation failure.
+ * Scan from pos to the next primary line. Returns its start (or end) and
+ * fills *primary; *skipped receives the bytes the non-empty lines in between
+ * need as context ("line\n" each) and *sparse is set if an empty line was
+ * among them (so they cannot be copied as one block).
  */
-static int append_line(char **buf, size_t *buf_len, size_t *buf_cap,
-                       const char *src, size_t src_len) {
-    size_t needed = *buf_len + src_len + 2U; /* +1 '\n', +1 NUL */
+static const char *scan_to_primary(const char *pos, const char *end, PrimaryLine *primary,
+                                   size_t *skipped, int *sparse) {
+    *skipped = 0U;
+    *sparse  = 0;
+
+    while (pos < end) {
+        int matched = 0;
+        const char *line_end = scan_line(pos, end, primary, &matched);
+        if (matched != 0) {
+            return pos;
+        }
+
+        if (line_end > pos) {
+            *skipped += (size_t)(line_end - pos) + 1U;
+        } else {
+            *sparse = 1;
+        }
+        pos = (line_end < end) ? line_end + 1 : end;
+    }
+    return pos;
+}
+
+/*
+ * Copy the non-empty lines of [start, end) into out, each ending in '\n'.
+ * Without empty lines that is the span itself plus, at the very end of the
+ * output, a missing final '\n'.
+ */
+static void copy_context(char *out, const char *start, const char *end, size_t size, int sparse) {
+    if (sparse == 0) {
+        size_t span = (size_t)(end - start);
+        memcpy(out, start, span);
+        if (span < size) {
+            out[span] = '\n';
+        }
+        out[size] = '\0';
+        return;
+    }
+
+    for (const char *q = start; q < end;) {
+        const char *q_end = line_end_from(q, end);
+        size_t      len   = (size_t)(q_end - q);
+        if (len > 0U) {
+            memcpy(out, q, len);
+            out[len] = '\n';
+            out += len + 1U;
+        }
+        q = (q_end < end) ? q_end + 1 : end;
+    }
+    *out = '\0';
+}
+
+/* Add a completed Diagnostic to the list, growing as needed. */
+static int list_push(DiagnosticList *list, Diagnostic *diag) {
+    if (list->count >= list->capacity) {
+        size_t new_cap = (list->capacity == 0U) ? 8U : list->capacity * 2U;
+        Diagnostic *resized =
+            (Diagnostic *)realloc(list->items, new_cap * sizeof(Diagnostic));
+        if (resized == NULL) {
+            return 0;
+        }
+        list->items    = resized;
+        list->capacity = new_cap;
+    }
+    list->items[list->count++] = *diag;
+    return 1;
+}
+
+/* -------------------------------------------------------------------------
+ * Streaming parser
+ * ---------------------------------------------------------------------- */
+
+/* Growable NUL-terminated text buffer, reused across diagnostics */
+typedef struct {
+    char*  data;
+    size_t len;
+    size_t cap;
+} TextBuf;
 
-    if (needed > *buf_cap) {
-        size_t new_cap = (*buf_cap == 0U) ? 256U : *buf_cap * 2U;
+struct DiagnosticParser {
+    DiagnosticFn on_diagnostic;
+    void*        user;
+    TextBuf      carry;        /* partial line from the previous chunk */
+    int          pending;      /* a primary line was seen, context still open */
+    Diagnostic   current;      /* line/column/severity of the pending one */
+    TextBuf      file;
+    TextBuf      message;
+    TextBuf      context;
+    int          failed;       /* out of memory: ignore the rest */
+};
+
+static int text_append(TextBuf *buf, const char *src, size_t len, int newline) {
+    size_t needed = buf->len + len + 2U; /* optional '\n' + NUL */
+
+    if (needed > buf->cap) {
+        size_t new_cap = (buf->cap == 0U) ? 256U : buf->cap * 2U;
         while (new_cap < needed) {
             new_cap *= 2U;
         }
-        char *resized = (char *)realloc(*buf, new_cap);
+        char *resized = (char *)realloc(buf->data, new_cap);
         if (resized == NULL) {
             return 0;
         }
-        *buf = resized;
-        *buf_cap = new_cap;
+        buf->data = resized;
+        buf->cap  = new_cap;
     }
 
-    memcpy(*buf + *buf_len, src, src_len);
-    (*buf)[*buf_len + src_len]      = '\n';
-    (*buf)[*buf_len + src_len + 1U] = '\0';
-    *buf_len += src_len + 1U;
+    memcpy(buf->data + buf->len, src, len);
+    buf->len += len;
+    if (newline != 0) {
+        buf->data[buf->len++] = '\n';
+    }
+    buf->data[buf->len] = '\0';
     return 1;
 }
 
+static void parser_emit(DiagnosticParser *parser) {
+    if (parser->pending == 0) {
+        return;
+    }
+
+    Diagnostic diag = parser->current;
+    diag.file    = parser->file.data;
+    diag.message = parser->message.data;
+    diag.context = (parser->context.len > 0U) ? parser->context.data : NULL;
+
+    parser->pending = 0;
+    parser->on_diagnostic(parser->user, &diag);
+}
+
 /*
- * Try to parse a primary diagnostic line of the form:
- *   <file>:<line>:<col>: <severity>: <message>
- *
- * line_start / line_end delimit the line slice (line_end is exclusive,
- * no NUL assumed at line_end). No intermediate copies are made — on
- * success the out-pointers point directly into raw_output and the caller
- * uses strndup (C23) to build owned strings.
- *
- * Returns 1 on match, 0 otherwise.
+ * One complete line [start, end), followed in memory by '\n' or NUL as
+ * scan_line() expects. Same grammar as diagnostics_parse().
  */
-static int try_parse_primary(
-    const char *line_start, const char *line_end,
-    const char **file_p,  size_t *file_sz,
-    int         *out_line, int   *out_col,
-    DiagnosticSeverity    *out_sev,
-    const char **msg_p,   size_t *msg_sz
-) {
-    const char *p = line_start;
-
-    /* --- file: up to the first ':' followed by a digit --- */
-    const char *colon1 = NULL;
-    for (const char *q = p; q + 1 < line_end; ++q) {
-        if (*q == ':' && q[1] >= '0' && q[1] <= '9') {
-            colon1 = q;
-            break;
+static void parser_line(DiagnosticParser *parser, const char *start, const char *end) {
+    PrimaryLine primary;
+    int         matched = 0;
+
+    (void)scan_line(start, end, &primary, &matched);
+    if (matched != 0) {
+        parser_emit(parser);
+
+        parser->file.len    = 0U;
+        parser->message.len = 0U;
+        parser->context.len = 0U;
+        if ((text_append(&parser->file, primary.file, primary.file_len, 0) == 0) ||
+            (text_append(&parser->message, primary.message, primary.message_len, 0) == 0)) {
+            parser->failed = 1;
+            return;
         }
+        parser->current = (Diagnostic){NULL, primary.line, primary.column, primary.severity,
+                                       NULL, NULL, 0, 0, NULL};
+        parser->pending = 1;
+    } else if ((parser->pending != 0) && (end > start)) {
+        if (text_append(&parser->context, start, (size_t)(end - start), 1) == 0) {
+            parser->failed = 1;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Structured (JSON/SARIF) decoding
+ * ---------------------------------------------------------------------- */
+
+/* The source file of the last rendered diagnostic, read once */
+typedef struct {
+    const char* file;   /* interned name, compared by pointer */
+    char*       data;
+    size_t      size;
+} SourceCache;
+
+/* Where a diagnostic points, in the units both formats share */
+typedef struct {
+    const char* file;
+    int         line;
+    int         column;      /* reported column */
+    int         byte_column; /* column used to place the caret, 1-based */
+    int         end_line;
+    int         end_column;  /* inclusive */
+    const char* fixit;
+    int         fixit_line;
+    int         fixit_column;
+} StructuredLocation;
+
+typedef struct {
+    DiagnosticList* list;
+    FileInterner*   files;
+    SourceCache     source;
+} StructuredDecoder;
+
+/* Line `line` (1-based) of file as [*start, *start + *len), without '\n' */
+static int source_line(SourceCache *cache, const char *file, int line, const char **start,
+                       size_t *len) {
+    if (cache->file != file) {
+        free(cache->data);
+        cache->file = file;
+        cache->data = file_io_read_all(file, &cache->size);
     }
-    if (colon1 == NULL || colon1 == p) {
+    if ((cache->data == NULL) || (line <= 0)) {
         return 0;
     }
 
-    /* --- line number --- */
-    char *end_ln = NULL;
-    long parsed_ln = strtol(colon1 + 1, &end_ln, 10);
-    if (end_ln == colon1 + 1 || end_ln >= line_end || *end_ln != ':') {
-        return 0;
+    const char *p   = cache->data;
+    const char *end = cache->data + cache->size;
+    for (int n = 1; n < line; ++n) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        if (nl == NULL) {
+            return 0;
+        }
+        p = nl + 1;
     }
 
-    /* --- column number --- */
-    char *end_col = NULL;
-    long parsed_col = strtol(end_ln + 1, &end_col, 10);
-    if (end_col == end_ln + 1 || end_col + 1 >= line_end ||
-        end_col[0] != ':' || end_col[1] != ' ') {
-        return 0;
+    const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+    *start = p;
+    *len   = (size_t)(((nl != NULL) ? nl : end) - p);
+    return 1;
+}
+
+/* Spaces up to byte column col (1-based), keeping the tabs of the source line */
+static void put_padding(FILE *out, const char *text, size_t text_len, int col) {
+    for (size_t i = 0U; (int)i + 1 < col; ++i) {
+        fputc(((i < text_len) && (text[i] == '\t')) ? '\t' : ' ', out);
     }
+}
 
-    /* --- severity: known token before ": " --- */
-    const char *sev_start = end_col + 2;
-    const char *sev_colon = NULL;
-    for (const char *q = sev_start; q + 1 < line_end; ++q) {
-        if (*q == ':' && q[1] == ' ') {
-            sev_colon = q;
-            break;
+/*
+ * GCC's text layout for one location:
+ *     3 |   return 1
+ *       |           ^~~
+ *       |           ;
+ */
+static char *render_context(StructuredDecoder *dec, const StructuredLocation *loc) {
+    const char *text = NULL;
+    size_t      text_len = 0U;
+    if ((loc->file[0] == '\0') ||
+        (source_line(&dec->source, loc->file, loc->line, &text, &text_len) == 0)) {
+        return NULL;
+    }
+
+    char  *rendered = NULL;
+    size_t rendered_len = 0U;
+    FILE  *out = open_memstream(&rendered, &rendered_len);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    fprintf(out, "%5d | ", loc->line);
+    (void)fwrite(text, 1U, text_len, out);
+    fputs("\n      | ", out);
+    put_padding(out, text, text_len, loc->byte_column);
+    fputc('^', out);
+    if ((loc->end_line == loc->line) && (loc->end_column > loc->column)) {
+        for (int i = loc->column; i < loc->end_column; ++i) {
+            fputc('~', out);
         }
     }
-    if (sev_colon == NULL) {
+    fputc('\n', out);
+    if ((loc->fixit != NULL) && (loc->fixit_line == loc->line) &&
+        (strchr(loc->fixit, '\n') == NULL)) {
+        fputs("      | ", out);
+        put_padding(out, text, text_len, loc->fixit_column);
+        fprintf(out, "%s\n", loc->fixit);
+    }
+
+    if (fclose(out) != 0) {
+        free(rendered);
+        return NULL;
+    }
+
+    char *copy = arena_strndup(dec->list->arena, rendered, rendered_len);
+    free(rendered);
+    return copy;
+}
+
+static int structured_push(StructuredDecoder *dec, DiagnosticSeverity severity, const char *message,
+                           const char *option, const StructuredLocation *loc) {
+    size_t msg_len = strlen(message);
+    size_t opt_len = (option != NULL) ? strlen(option) : 0U;
+
+    /* "message [-Wxxx]", as the text format prints it */
+    char *full = (char *)arena_alloc(dec->list->arena, msg_len + opt_len + 4U, 1U);
+    if (full == NULL) {
         return 0;
     }
+    memcpy(full, message, msg_len);
+    if (opt_len > 0U) {
+        full[msg_len] = ' ';
+        full[msg_len + 1U] = '[';
+        memcpy(full + msg_len + 2U, option, opt_len);
+        full[msg_len + opt_len + 2U] = ']';
+        msg_len += opt_len + 3U;
+    }
+    full[msg_len] = '\0';
 
-    size_t sev_len = (size_t)(sev_colon - sev_start);
-    DiagnosticSeverity sev;
-    if        (sev_len == 5U && memcmp(sev_start, "error",   5U) == 0) {
-        sev = DIAG_ERROR;
-    } else if (sev_len == 7U && memcmp(sev_start, "warning", 7U) == 0) {
-        sev = DIAG_WARNING;
-    } else if (sev_len == 4U && memcmp(sev_start, "note",    4U) == 0) {
-        sev = DIAG_NOTE;
-    } else {
+    Diagnostic diag = {
+        .file       = interner_get(dec->files, dec->list->arena, loc->file, strlen(loc->file)),
+        .line       = loc->line,
+        .column     = loc->column,
+        .severity   = severity,
+        .message    = full,
+        .context    = NULL,
+        .end_line   = loc->end_line,
+        .end_column = loc->end_column,
+        .fixit      = NULL,
+    };
+    if (diag.file == NULL) {
         return 0;
     }
+    if (loc->fixit != NULL) {
+        diag.fixit = arena_strndup(dec->list->arena, loc->fixit, strlen(loc->fixit));
+    }
+
+    StructuredLocation interned = *loc;
+    interned.file = diag.file;
+    diag.context  = render_context(dec, &interned);
+    return list_push(dec->list, &diag);
+}
+
+/* "error", "fatal error", "sorry", ... all stop the build */
+static DiagnosticSeverity severity_from_name(const char *name) {
+    if (name == NULL) {
+        return DIAG_ERROR;
+    }
+    if (strcmp(name, "warning") == 0) {
+        return DIAG_WARNING;
+    }
+    if ((strcmp(name, "note") == 0) || (strcmp(name, "none") == 0)) {
+        return DIAG_NOTE;
+    }
+    return DIAG_ERROR;
+}
+
+/* Element count of a JSON array; 0 for anything else, NULL included */
+static size_t array_count(const JsonValue *value) {
+    return ((value != NULL) && (value->type == JSON_ARRAY)) ? value->count : 0U;
+}
+
+/* GCC: {"kind", "message", "option", "locations": [{"caret", "finish"}], "fixits", "children"} */
+static int decode_gcc_diagnostic(StructuredDecoder *dec, const JsonValue *diag, int depth) {
+    const char *message = json_string(json_get(diag, "message"));
+    if ((message == NULL) || (depth > 8)) {
+        return 1;
+    }
+
+    StructuredLocation loc = {"", 0, 0, 0, 0, 0, NULL, 0, 0};
+    const JsonValue *locations = json_get(diag, "locations");
+    if ((locations != NULL) && (locations->type == JSON_ARRAY) && (locations->count > 0U)) {
+        const JsonValue *caret  = json_get(&locations->items[0], "caret");
+        const JsonValue *finish = json_get(&locations->items[0], "finish");
+        const char *file = json_string(json_get(caret, "file"));
+        if (file != NULL) {
+            loc.file        = file;
+            loc.line        = json_int(json_get(caret, "line"), 0);
+            loc.column      = json_int(json_get(caret, "column"), 0);
+            loc.byte_column = json_int(json_get(caret, "byte-column"), loc.column);
+            loc.end_line    = json_int(json_get(finish, "line"), 0);
+            loc.end_column  = json_int(json_get(finish, "column"), 0);
+        }
+    }
 
-    /* --- message: everything after "severity: " --- */
-    const char *msg_start = sev_colon + 2;
-    if (msg_start >= line_end) {
+    const JsonValue *fixits = json_get(diag, "fixits");
+    if ((fixits != NULL) && (fixits->type == JSON_ARRAY) && (fixits->count > 0U)) {
+        const JsonValue *start = json_get(&fixits->items[0], "start");
+        loc.fixit        = json_string(json_get(&fixits->items[0], "string"));
+        loc.fixit_line   = json_int(json_get(start, "line"), 0);
+        loc.fixit_column = json_int(json_get(start, "byte-column"), 0);
+    }
+
+    const char *option = json_string(json_get(diag, "option"));
+    if (structured_push(dec, severity_from_name(json_string(json_get(diag, "kind"))),
+                        message, option, &loc) == 0) {
         return 0;
     }
 
-    *file_p   = p;
-    *file_sz  = (size_t)(colon1 - p);
-    *out_line = (int)parsed_ln;
-    *out_col  = (int)parsed_col;
-    *out_sev  = sev;
-    *msg_p    = msg_start;
-    *msg_sz   = (size_t)(line_end - msg_start);
+    const JsonValue *children = json_get(diag, "children");
+    for (size_t i = 0U; i < array_count(children); ++i) {
+        if (decode_gcc_diagnostic(dec, &children->items[i], depth + 1) == 0) {
+            return 0;
+        }
+    }
     return 1;
 }
 
-/* Add a completed Diagnostic to the list, growing as needed. */
-static int list_push(DiagnosticList *list, Diagnostic *diag) {
-    if (list->count >= list->capacity) {
-        size_t new_cap = (list->capacity == 0U) ? 8U : list->capacity * 2U;
-        Diagnostic *resized =
-            (Diagnostic *)realloc(list->items, new_cap * sizeof(Diagnostic));
-        if (resized == NULL) {
+/* SARIF physicalLocation: {"artifactLocation": {"uri"}, "region": {...}} */
+static void sarif_location(const JsonValue *location, StructuredLocation *loc) {
+    const JsonValue *physical = json_get(location, "physicalLocation");
+    const char *uri = json_string(json_get(json_get(physical, "artifactLocation"), "uri"));
+    if (uri == NULL) {
+        return;
+    }
+    if (strncmp(uri, "file://", 7U) == 0) {
+        uri += 7;
+    }
+
+    const JsonValue *region = json_get(physical, "region");
+    loc->file        = uri;
+    loc->line        = json_int(json_get(region, "startLine"), 0);
+    loc->column      = json_int(json_get(region, "startColumn"), 0);
+    loc->byte_column = loc->column;
+    loc->end_line    = json_int(json_get(region, "endLine"), loc->line);
+    /* SARIF end columns are exclusive */
+    loc->end_column  = json_int(json_get(region, "endColumn"), 1) - 1;
+}
+
+/* SARIF result: {"level", "message": {"text"}, "locations", "relatedLocations", "fixes"} */
+static int decode_sarif_result(StructuredDecoder *dec, const JsonValue *result) {
+    const char *message = json_string(json_get(json_get(result, "message"), "text"));
+    if (message == NULL) {
+        return 1;
+    }
+
+    StructuredLocation loc = {"", 0, 0, 0, 0, 0, NULL, 0, 0};
+    const JsonValue *locations = json_get(result, "locations");
+    if ((locations != NULL) && (locations->type == JSON_ARRAY) && (locations->count > 0U)) {
+        sarif_location(&locations->items[0], &loc);
+    }
+
+    const JsonValue *fixes = json_get(result, "fixes");
+    if ((fixes != NULL) && (fixes->type == JSON_ARRAY) && (fixes->count > 0U)) {
+        const JsonValue *changes = json_get(&fixes->items[0], "artifactChanges");
+        const JsonValue *replacements =
+            (array_count(changes) > 0U) ? json_get(&changes->items[0], "replacements") : NULL;
+        if (array_count(replacements) > 0U) {
+            const JsonValue *deleted  = json_get(&replacements->items[0], "deletedRegion");
+            const JsonValue *inserted = json_get(&replacements->items[0], "insertedContent");
+            loc.fixit        = json_string(json_get(inserted, "text"));
+            loc.fixit_line   = json_int(json_get(deleted, "startLine"), 0);
+            loc.fixit_column = json_int(json_get(deleted, "startColumn"), 0);
+        }
+    }
+
+    /* GCC names the warning option in ruleId; Clang uses opaque ids */
+    const char *rule = json_string(json_get(result, "ruleId"));
+    const char *option = ((rule != NULL) && (strncmp(rule, "-W", 2U) == 0)) ? rule : NULL;
+    if (structured_push(dec, severity_from_name(json_string(json_get(result, "level"))),
+                        message, option, &loc) == 0) {
+        return 0;
+    }
+
+    const JsonValue *related = json_get(result, "relatedLocations");
+    for (size_t i = 0U; i < array_count(related); ++i) {
+        const char *text = json_string(json_get(json_get(&related->items[i], "message"), "text"));
+        StructuredLocation note = {"", 0, 0, 0, 0, 0, NULL, 0, 0};
+        sarif_location(&related->items[i], &note);
+        if ((text != NULL) && (structured_push(dec, DIAG_NOTE, text, NULL, &note) == 0)) {
             return 0;
         }
-        list->items    = resized;
-        list->capacity = new_cap;
     }
-    list->items[list->count++] = *diag;
+    return 1;
+}
+
+/* One top-level document: a GCC array or a SARIF log. 0 if it is neither */
+static int decode_document(StructuredDecoder *dec, const JsonValue *doc) {
+    if (doc->type == JSON_ARRAY) {
+        for (size_t i = 0U; i < doc->count; ++i) {
+            (void)decode_gcc_diagnostic(dec, &doc->items[i], 0);
+        }
+        return 1;
+    }
+
+    const JsonValue *runs = json_get(doc, "runs");
+    if ((runs == NULL) || (runs->type != JSON_ARRAY)) {
+        return 0;
+    }
+    for (size_t r = 0U; r < runs->count; ++r) {
+        const JsonValue *results = json_get(&runs->items[r], "results");
+        for (size_t i = 0U; i < array_count(results); ++i) {
+            (void)decode_sarif_result(dec, &results->items[i]);
+        }
+    }
     return 1;
 }
 
@@ -157,92 +719,289 @@ static int list_push(DiagnosticList *list, Diagnostic *diag) {
  * ---------------------------------------------------------------------- */
 
 DiagnosticList diagnostics_parse(const char *raw_output) {
-    DiagnosticList list = {NULL, 0U, 0U};
+    DiagnosticList list = {NULL, 0U, 0U, NULL};
 
     if (raw_output == NULL || raw_output[0] == '\0') {
         return list;
     }
 
+    size_t raw_len = strlen(raw_output);
+    list.arena = arena_create(raw_len + ARENA_SLACK);
+    if (list.arena == NULL) {
+        return list;
+    }
+
+    FileInterner files = {NULL, NULL, 0U, 0U, NULL, 0U};
+
     /*
-     * State machine — walk raw_output line by line without copying it.
-     *
-     *   current.file != NULL  → inside a diagnostic, accumulating context
-     *   current.file == NULL  → idle, waiting for a primary line
+     * Walk raw_output once without copying it. A primary line starts a
+     * diagnostic; the non-empty lines up to the next primary line (caret,
+     * source snippet, "In function" header) are its context, copied into one
+     * arena string. Lines before the first diagnostic are dropped.
      */
-    Diagnostic current = {NULL, 0, 0, DIAG_ERROR, NULL, NULL};
-    char  *ctx_buf = NULL;
-    size_t ctx_len = 0U;
-    size_t ctx_cap = 0U;
-
-    const char *pos = raw_output;
-
-    while (*pos != '\0') {
-        const char *nl       = strchr(pos, '\n');
-        const char *line_end = (nl != NULL) ? nl : (pos + strlen(pos));
-        size_t      line_len = (size_t)(line_end - pos);
-
-        const char        *file_p  = NULL;
-        const char        *msg_p   = NULL;
-        size_t             file_sz = 0U;
-        size_t             msg_sz  = 0U;
-        int                ln_num  = 0;
-        int                col_num = 0;
-        DiagnosticSeverity sev     = DIAG_ERROR;
-
-        int matched = try_parse_primary(
-            pos, line_end,
-            &file_p, &file_sz,
-            &ln_num, &col_num, &sev,
-            &msg_p,  &msg_sz
-        );
+    const char *end     = raw_output + raw_len;
+    PrimaryLine primary;
+    size_t      skipped = 0U;
+    int         sparse  = 0;
+    const char *pos     = scan_to_primary(raw_output, end, &primary, &skipped, &sparse);
 
-        if (matched != 0) {
-            /* Flush previous diagnostic */
-            if (current.file != NULL) {
-                current.context = ctx_buf;
-                (void)list_push(&list, &current);
-                current = (Diagnostic){NULL, 0, 0, DIAG_ERROR, NULL, NULL};
-                ctx_buf = NULL;
-                ctx_len = 0U;
-                ctx_cap = 0U;
+    while (pos < end) {
+        PrimaryLine next_primary;
+        size_t      ctx_size = 0U;
+        const char *ctx_end  = scan_to_primary(primary.after, end, &next_primary, &ctx_size,
+                                               &sparse);
+
+        Diagnostic current = {
+            .file     = interner_get(&files, list.arena, primary.file, primary.file_len),
+            .line     = primary.line,
+            .column   = primary.column,
+            .severity = primary.severity,
+            .message  = arena_strndup(list.arena, primary.message, primary.message_len),
+            .context  = (ctx_size > 0U) ? (char *)arena_alloc(list.arena, ctx_size + 1U, 1U) : NULL,
+        };
+
+        if ((current.file == NULL) || (current.message == NULL) ||
+            ((ctx_size > 0U) && (current.context == NULL))) {
+            break;
+        }
+        if (current.context != NULL) {
+            copy_context(current.context, primary.after, ctx_end, ctx_size, sparse);
+        }
+        if (list_push(&list, &current) == 0) {
+            break;
+        }
+
+        primary = next_primary;
+        pos     = ctx_end;
+    }
+
+    free(files.names);
+    free(files.lens);
+    return list;
+}
+
+DiagnosticList diagnostics_parse_structured(const char *raw_output) {
+    DiagnosticList list = {NULL, 0U, 0U, NULL};
+
+    if ((raw_output == NULL) || (raw_output[0] == '\0')) {
+        return list;
+    }
+
+    size_t raw_len = strlen(raw_output);
+    Arena *scratch = arena_create(raw_len * 2U);
+    list.arena = arena_create(raw_len / 2U);
+    if ((scratch == NULL) || (list.arena == NULL)) {
+        arena_destroy(scratch);
+        diagnostics_free_list(&list);
+        return list;
+    }
+
+    FileInterner      files = {NULL, NULL, 0U, 0U, NULL, 0U};
+    StructuredDecoder dec   = {&list, &files, {NULL, NULL, 0U}};
+    int               documents = 0;
+
+    /* A document starts at the beginning of a line; other lines are skipped */
+    const char *end = raw_output + raw_len;
+    for (const char *p = raw_output; p < end;) {
+        size_t consumed = 0U;
+        const JsonValue *doc = NULL;
+        if ((*p == '[') || (*p == '{')) {
+            doc = json_parse(scratch, p, (size_t)(end - p), &consumed);
+        }
+        if ((doc != NULL) && (decode_document(&dec, doc) != 0)) {
+            ++documents;
+            p += consumed;
+            continue;
+        }
+
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        p = (nl != NULL) ? nl + 1 : end;
+    }
+
+    free(dec.source.data);
+    free(files.names);
+    free(files.lens);
+    arena_destroy(scratch);
+
+    if (documents == 0) {
+        diagnostics_free_list(&list);
+        return diagnostics_parse(raw_output);
+    }
+    return list;
+}
+
+/* -------------------------------------------------------------------------
+ * Merging
+ * ---------------------------------------------------------------------- */
+
+/* A diagnostic and its trailing notes, as found in one of the merged lists */
+typedef struct {
+    uint64_t key;     /* hash of the first entry's identity */
+    size_t   list;
+    size_t   start;
+    size_t   len;
+    uint32_t oracles; /* bit k: lists[k] reported it */
+} MergeGroup;
+
+static uint64_t group_key(const Diagnostic *diag) {
+    HashState state;
+    hash_init(&state, 0U);
+    hash_update_str(&state, (diag->file != NULL) ? diag->file : "");
+    hash_update(&state, &diag->line, sizeof(diag->line));
+    hash_update(&state, &diag->column, sizeof(diag->column));
+    hash_update(&state, &diag->severity, sizeof(diag->severity));
+    hash_update_str(&state, (diag->message != NULL) ? diag->message : "");
+    return hash_final(&state);
+}
+
+static int same_identity(const Diagnostic *a, const Diagnostic *b) {
+    return (a->line == b->line) && (a->column == b->column) && (a->severity == b->severity) &&
+           (strcmp((a->file != NULL) ? a->file : "", (b->file != NULL) ? b->file : "") == 0) &&
+           (strcmp((a->message != NULL) ? a->message : "",
+                   (b->message != NULL) ? b->message : "") == 0);
+}
+
+static char *arena_copy(Arena *arena, const char *text) {
+    return (text != NULL) ? arena_strndup(arena, text, strlen(text)) : NULL;
+}
+
+/* Copy diag into the merged list; suffix (may be NULL) is appended to the message */
+static int merge_push(DiagnosticList *merged, const Diagnostic *diag, const char *suffix) {
+    size_t msg_len = (diag->message != NULL) ? strlen(diag->message) : 0U;
+    size_t suf_len = (suffix != NULL) ? strlen(suffix) : 0U;
+    char  *message = (char *)arena_alloc(merged->arena, msg_len + suf_len + 1U, 1U);
+    if (message == NULL) {
+        return 0;
+    }
+    if (msg_len > 0U) {
+        memcpy(message, diag->message, msg_len);
+    }
+    if (suf_len > 0U) {
+        memcpy(message + msg_len, suffix, suf_len);
+    }
+    message[msg_len + suf_len] = '\0';
+
+    Diagnostic copy = *diag;
+    copy.file    = arena_copy(merged->arena, (diag->file != NULL) ? diag->file : "");
+    copy.message = message;
+    copy.context = arena_copy(merged->arena, diag->context);
+    copy.fixit   = arena_copy(merged->arena, diag->fixit);
+    return (copy.file != NULL) && list_push(merged, &copy);
+}
+
+/* " [a, b]" for the oracles set in mask, or "" when none of them has a tag */
+static void tag_suffix(char *out, size_t size, const char *const tags[], size_t count,
+                       uint32_t mask) {
+    size_t used = 0U;
+    out[0] = '\0';
+    for (size_t k = 0U; (tags != NULL) && (k < count); ++k) {
+        if ((((mask >> k) & 1U) == 0U) || (tags[k] == NULL)) {
+            continue;
+        }
+        int n = snprintf(out + used, size - used, "%s%s", (used == 0U) ? " [" : ", ", tags[k]);
+        if ((n < 0) || ((size_t)n >= size - used - 1U)) {
+            break;
+        }
+        used += (size_t)n;
+    }
+    if (used > 0U) {
+        out[used]      = ']';
+        out[used + 1U] = '\0';
+    }
+}
+
+DiagnosticList diagnostics_merge(const DiagnosticList lists[], const char *const tags[],
+                                 size_t count) {
+    DiagnosticList merged = {NULL, 0U, 0U, NULL};
+    if ((lists == NULL) || (count == 0U) || (count > 32U)) {
+        return merged;
+    }
+
+    size_t total = 0U;
+    size_t bytes = 0U;
+    for (size_t k = 0U; k < count; ++k) {
+        total += lists[k].count;
+        for (size_t i = 0U; i < lists[k].count; ++i) {
+            const Diagnostic *d = &lists[k].items[i];
+            bytes += ((d->file != NULL) ? strlen(d->file) : 0U) +
+                     ((d->message != NULL) ? strlen(d->message) : 0U) +
+                     ((d->context != NULL) ? strlen(d->context) : 0U) +
+                     ((d->fixit != NULL) ? strlen(d->fixit) : 0U) + 64U;
+        }
+    }
+
+    MergeGroup *groups = (MergeGroup *)calloc((total > 0U) ? total : 1U, sizeof(MergeGroup));
+    merged.arena = arena_create(bytes + 256U);
+    if ((groups == NULL) || (merged.arena == NULL)) {
+        free(groups);
+        diagnostics_free_list(&merged);
+        return merged;
+    }
+
+    /* Group every list, folding groups already reported by an earlier list */
+    size_t n_groups = 0U;
+    for (size_t k = 0U; k < count; ++k) {
+        const DiagnosticList *list = &lists[k];
+        for (size_t i = 0U; i < list->count;) {
+            size_t len = 1U;
+            while ((i + len < list->count) && (list->items[i + len].severity == DIAG_NOTE)) {
+                ++len;
             }
 
-            /* strndup: C23 standard (§7.27.6) — no copy into fixed buffer */
-            current.file     = strndup(file_p, file_sz);
-            current.message  = strndup(msg_p,  msg_sz);
-            current.line     = ln_num;
-            current.column   = col_num;
-            current.severity = sev;
-
-            if (current.file == NULL || current.message == NULL) {
-                free(current.file);
-                free(current.message);
-                break;
+            uint64_t key  = group_key(&list->items[i]);
+            size_t   seen = n_groups;
+            for (size_t g = 0U; g < n_groups; ++g) {
+                if ((groups[g].key == key) && (groups[g].list != k) &&
+                    (same_identity(&lists[groups[g].list].items[groups[g].start],
+                                   &list->items[i]) != 0)) {
+                    seen = g;
+                    break;
+                }
             }
-        } else {
-            /* Context line (caret, source snippet, or "In function" header) */
-            if (current.file != NULL && line_len > 0U) {
-                (void)append_line(&ctx_buf, &ctx_len, &ctx_cap, pos, line_len);
+
+            if (seen < n_groups) {
+                groups[seen].oracles |= (uint32_t)1U << k;
+            } else {
+                groups[n_groups++] = (MergeGroup){key, k, i, len, (uint32_t)1U << k};
             }
-            /* Lines before the first diagnostic are dropped */
+            i += len;
         }
-
-        pos = (nl != NULL) ? nl + 1 : line_end;
     }
 
-    /* Flush last pending diagnostic */
-    if (current.file != NULL) {
-        current.context = ctx_buf;
-        (void)list_push(&list, &current);
-    } else {
-        free(ctx_buf);
+    char suffix[256];
+    int  ok = 1;
+    for (size_t g = 0U; (ok != 0) && (g < n_groups); ++g) {
+        const Diagnostic *items = &lists[groups[g].list].items[groups[g].start];
+        tag_suffix(suffix, sizeof(suffix), tags, count, groups[g].oracles);
+        ok = merge_push(&merged, &items[0], suffix);
+        for (size_t n = 1U; (ok != 0) && (n < groups[g].len); ++n) {
+            ok = merge_push(&merged, &items[n], NULL);
+        }
     }
 
-    return list;
+    free(groups);
+    if (ok == 0) {
+        diagnostics_free_list(&merged);
+    }
+    return merged;
 }
 
 void diagnostics_print_list(const DiagnosticList *list) {
-    if (list == NULL) {
+    diagnostics_fprint_list(stderr, list);
+}
+
+void diagnostics_fprint_list(FILE *stream, const DiagnosticList *list) {
+    if ((stream == NULL) || (list == NULL)) {
+        return;
+    }
+
+    for (size_t i = 0U; i < list->count; ++i) {
+        diagnostics_fprint_one(stream, &list->items[i]);
+    }
+}
+
+void diagnostics_fprint_one(FILE *stream, const Diagnostic *diag) {
+    if ((stream == NULL) || (diag == NULL)) {
         return;
     }
 
@@ -252,15 +1011,16 @@ void diagnostics_print_list(const DiagnosticList *list) {
         [DIAG_NOTE]    = "note",
     };
 
-    for (size_t i = 0U; i < list->count; ++i) {
-        const Diagnostic *d = &list->items[i];
-        fprintf(stderr, "%s:%d:%d: %s: %s\n",
-                d->file, d->line, d->column,
-                severity_names[d->severity],
-                d->message);
-        if (d->context != NULL) {
-            fputs(d->context, stderr);
-        }
+    if ((diag->file == NULL) || (diag->file[0] == '\0')) {
+        fprintf(stream, "%s: %s\n", severity_names[diag->severity], diag->message);
+    } else {
+        fprintf(stream, "%s:%d:%d: %s: %s\n",
+                diag->file, diag->line, diag->column,
+                severity_names[diag->severity],
+                diag->message);
+    }
+    if (diag->context != NULL) {
+        fputs(diag->context, stream);
     }
 }
 
@@ -269,22 +1029,95 @@ void diagnostics_free_list(DiagnosticList *list) {
         return;
     }
 
-    for (size_t i = 0U; i < list->count; ++i) {
-        free(list->items[i].file);
-        free(list->items[i].message);
-        free(list->items[i].context);
-    }
-
+    /* Strings are all in the arena: two free() calls whatever the count */
+    arena_destroy(list->arena);
     free(list->items);
     list->items    = NULL;
     list->count    = 0U;
     list->capacity = 0U;
+    list->arena    = NULL;
+}
+
+DiagnosticParser *diagnostics_parser_create(DiagnosticFn on_diagnostic, void *user) {
+    if (on_diagnostic == NULL) {
+        return NULL;
+    }
+
+    DiagnosticParser *parser = (DiagnosticParser *)calloc(1U, sizeof(DiagnosticParser));
+    if (parser != NULL) {
+        parser->on_diagnostic = on_diagnostic;
+        parser->user          = user;
+    }
+    return parser;
+}
+
+void diagnostics_parser_feed(DiagnosticParser *parser, const char *data, size_t len) {
+    if ((parser == NULL) || (data == NULL)) {
+        return;
+    }
+
+    const char *end = data + len;
+    const char *pos = data;
+
+    while ((parser->failed == 0) && (pos < end)) {
+        const char *nl = (const char *)memchr(pos, '\n', (size_t)(end - pos));
+        if (nl == NULL) {
+            /* Partial line: keep it until the rest arrives */
+            if (text_append(&parser->carry, pos, (size_t)(end - pos), 0) == 0) {
+                parser->failed = 1;
+            }
+            return;
+        }
+
+        if (parser->carry.len > 0U) {
+            if (text_append(&parser->carry, pos, (size_t)(nl - pos), 0) == 0) {
+                parser->failed = 1;
+                return;
+            }
+            parser_line(parser, parser->carry.data, parser->carry.data + parser->carry.len);
+            parser->carry.len = 0U;
+        } else {
+            parser_line(parser, pos, nl);
+        }
+        pos = nl + 1;
+    }
+}
+
+void diagnostics_parser_finish(DiagnosticParser *parser) {
+    if ((parser == NULL) || (parser->failed != 0)) {
+        return;
+    }
+
+    /* Output that does not end in '\n' still has a last line */
+    if (parser->carry.len > 0U) {
+        parser_line(parser, parser->carry.data, parser->carry.data + parser->carry.len);
+        parser->carry.len = 0U;
+    }
+    if (parser->failed == 0) {
+        parser_emit(parser);
+    }
+}
+
+void diagnostics_parser_destroy(DiagnosticParser *parser) {
+    if (parser == NULL) {
+        return;
+    }
+
+    free(parser->carry.data);
+    free(parser->file.data);
+    free(parser->message.data);
+    free(parser->context.data);
+    free(parser);
 }
 
 void diagnostics_print_raw(const char *text) {
-    if (text == NULL) {
+    diagnostics_fprint_raw(stderr, text);
+}
+
+void diagnostics_fprint_raw(FILE *stream, const char *text) {
+    if ((stream == NULL) || (text == NULL)) {
         return;
     }
 
-    fputs(text, stderr);
+    fputs(text, stream);
 }
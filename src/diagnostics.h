@@ -9,7 +9,10 @@
 #ifndef CPLUS_DIAGNOSTICS_H
 #define CPLUS_DIAGNOSTICS_H
 
+#include "arena.h"
+
 #include <stddef.h>
+#include <stdio.h>
 
 /* Severity levels as emitted by GCC/Clang */
 typedef enum {
@@ -20,10 +23,14 @@ typedef enum {
 
 /*
  * A single diagnostic entry.
- * All char* fields are owned by the struct — freed by diagnostics_free_list().
+ * All char* fields live in the owning list's arena — released together by
+ * diagnostics_free_list(). Entries with the same file share one file string.
  *
  * context: the raw caret/source lines that follow the primary line, or NULL.
  *          Kept verbatim so it can be replaced in v2+ when file/line is remapped.
+ * end_line/end_column and fixit are only known for structured (JSON/SARIF)
+ * output; text output leaves them 0/NULL. A diagnostic without a location
+ * (e.g. a missing input file) has an empty file and line 0.
  */
 typedef struct {
     char*              file;
@@ -31,25 +38,95 @@ typedef struct {
     int                column;
     DiagnosticSeverity severity;
     char*              message;
-    char*              context;  /* caret + source snippet, or NULL */
+    char*              context;    /* caret + source snippet, or NULL */
+    int                end_line;   /* last line of the highlighted range, or 0 */
+    int                end_column; /* last column of that range (inclusive), or 0 */
+    char*              fixit;      /* text of the first suggested fix, or NULL */
 } Diagnostic;
 
 typedef struct {
     Diagnostic* items;
     size_t      count;
     size_t      capacity;
+    Arena*      arena;     /* backing store of every string in items */
 } DiagnosticList;
 
 /* Parse raw compiler output (GCC/Clang) into a structured list */
 DiagnosticList diagnostics_parse(const char* raw_output);
 
+/*
+ * Output formats a compiler can be asked for. DIAG_FORMAT_AUTO picks the best
+ * structured format the compiler supports (GCC JSON, then SARIF), else text.
+ */
+typedef enum {
+    DIAG_FORMAT_TEXT,
+    DIAG_FORMAT_JSON,   /* GCC -fdiagnostics-format=json */
+    DIAG_FORMAT_SARIF,  /* GCC -fdiagnostics-format=sarif-stderr, Clang =sarif */
+    DIAG_FORMAT_AUTO
+} DiagnosticFormat;
+
+/*
+ * Decode machine-readable compiler output: GCC JSON (one array per
+ * translation unit) or SARIF 2.1. Text lines around the JSON documents are
+ * ignored; output without any JSON document is handed to diagnostics_parse(),
+ * so text output is accepted as well. Children and related locations become
+ * notes after their diagnostic, a warning option is appended as " [-Wxxx]",
+ * and context is rendered from the source file in GCC's layout (source line,
+ * caret with range, fix-it) when the file can be read.
+ */
+DiagnosticList diagnostics_parse_structured(const char* raw_output);
+
+/*
+ * Merge the lists several oracles (compiler/std pairs) produced for one file.
+ * A diagnostic and the notes that follow it form a group; a group whose first
+ * entry (file, line, column, severity, message) was already seen in another
+ * list is kept once. The first entry of every group gets " [tag, tag]" added
+ * to its message, naming the oracles that reported it (tags may be NULL, as
+ * may any entry). The first list's groups come first, then those only later
+ * lists have, each in its own order. At most 32 lists; the result owns its
+ * strings.
+ */
+DiagnosticList diagnostics_merge(const DiagnosticList lists[], const char* const tags[],
+                                 size_t count);
+
 /* Print all diagnostics (with context) to stderr */
 void diagnostics_print_list(const DiagnosticList* list);
 
+/* Same as diagnostics_print_list(), writing to `stream` */
+void diagnostics_fprint_list(FILE* stream, const DiagnosticList* list);
+
+/* Print one diagnostic exactly as diagnostics_fprint_list() does */
+void diagnostics_fprint_one(FILE* stream, const Diagnostic* diag);
+
+/*
+ * Incremental parser for output that arrives in chunks (e.g. from a pipe).
+ * Chunks may split lines anywhere; partial lines are carried over. A
+ * diagnostic is complete when the next primary line starts or at
+ * diagnostics_parser_finish(), and is then passed to on_diagnostic. The
+ * Diagnostic and its strings are only valid during the callback. The grammar
+ * and the resulting diagnostics are the same as diagnostics_parse().
+ */
+typedef void (*DiagnosticFn)(void* user, const Diagnostic* diag);
+
+typedef struct DiagnosticParser DiagnosticParser;
+
+/* NULL on allocation failure or without a callback */
+DiagnosticParser* diagnostics_parser_create(DiagnosticFn on_diagnostic, void* user);
+
+void diagnostics_parser_feed(DiagnosticParser* parser, const char* data, size_t len);
+
+/* Flush the trailing partial line and the last pending diagnostic */
+void diagnostics_parser_finish(DiagnosticParser* parser);
+
+void diagnostics_parser_destroy(DiagnosticParser* parser);
+
 /* Free all memory owned by the list */
 void diagnostics_free_list(DiagnosticList* list);
 
 /* Print a raw string to stderr — used for internal/runtime messages */
 void diagnostics_print_raw(const char* text);
 
+/* Same as diagnostics_print_raw(), writing to `stream` */
+void diagnostics_fprint_raw(FILE* stream, const char* text);
+
 #endif // CPLUS_DIAGNOSTICS_H
@@ -0,0 +1,453 @@
+/*
+ * FILE: dir_walk.c
+ * DESC.: parallel directory walk feeding .cplus/.hplus paths to the driver
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+/* getdents64() and d_type are GNU extensions */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "dir_walk.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DIR_WALK_MAX_THREADS 64U
+#define DENTS_BUFFER_BYTES   32768U
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+/* A directory still to be listed; root_len is the length of its root's path */
+typedef struct {
+    char*  path;
+    size_t root_len;
+} PendingDir;
+
+/*
+ * Pending directories are a stack (depth-first keeps it short); found files
+ * are a ring of DIR_WALK_QUEUE paths [head, head + count). busy counts the
+ * walkers listing a directory: the walk is over when no directory is pending
+ * and none is busy.
+ */
+struct DirWalk {
+    pthread_mutex_t     lock;
+    pthread_cond_t      work;   /* a directory was pushed, or the walk ended */
+    pthread_cond_t      found;  /* a file was pushed, or the walk ended */
+    pthread_cond_t      room;   /* the consumer took a file, or the walk is stopping */
+    PendingDir*         dirs;
+    size_t              n_dirs;
+    size_t              cap_dirs;
+    size_t              busy;
+    char*               files[DIR_WALK_QUEUE];
+    size_t              head;
+    size_t              count;
+    const char* const*  ignores;
+    size_t              n_ignores;
+    char*               first_failed;
+    size_t              n_failed;
+    int                 stop;
+    pthread_t           threads[DIR_WALK_MAX_THREADS];
+    size_t              n_threads;
+};
+
+/* The entry kinds a walk tells apart */
+typedef enum {
+    ENTRY_OTHER,
+    ENTRY_DIR,
+    ENTRY_FILE
+} EntryKind;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/* Same rule as the driver's output naming: a non-empty stem plus .cplus/.hplus */
+static int is_source_name(const char *name, size_t len) {
+    return (len > 6U) && ((memcmp(name + len - 6U, ".cplus", 6U) == 0) ||
+                          (memcmp(name + len - 6U, ".hplus", 6U) == 0));
+}
+
+static int is_ignored(const DirWalk *walk, const char *name, const char *relative) {
+    for (size_t i = 0U; i < walk->n_ignores; ++i) {
+        const char *glob = walk->ignores[i];
+        if (strchr(glob, '/') != NULL) {
+            if (fnmatch(glob, relative, FNM_PATHNAME) == 0) {
+                return 1;
+            }
+        } else if (fnmatch(glob, name, 0) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Kind of name in dir_fd, from the directory entry type when it is known */
+static EntryKind entry_kind(int dir_fd, const char *name, unsigned char type) {
+#ifdef DT_DIR
+    switch (type) {
+    case DT_DIR:
+        return ENTRY_DIR;
+    case DT_REG:
+    case DT_LNK:
+        return ENTRY_FILE;
+    case DT_UNKNOWN:
+        break;
+    default:
+        return ENTRY_OTHER;
+    }
+#else
+    (void)type;
+#endif
+
+    struct stat st;
+    if (fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        return ENTRY_OTHER;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        return ENTRY_DIR;
+    }
+    return (S_ISREG(st.st_mode) || S_ISLNK(st.st_mode)) ? ENTRY_FILE : ENTRY_OTHER;
+}
+
+/* Push directories under the lock; 0 when out of memory (they are dropped) */
+static int push_dirs(DirWalk *walk, PendingDir *dirs, size_t count) {
+    if (count == 0U) {
+        return 1;
+    }
+
+    (void)pthread_mutex_lock(&walk->lock);
+    int ok = 1;
+    if ((walk->n_dirs + count) > walk->cap_dirs) {
+        size_t new_cap = (walk->cap_dirs == 0U) ? 64U : walk->cap_dirs;
+        while (new_cap < (walk->n_dirs + count)) {
+            new_cap *= 2U;
+        }
+        PendingDir *resized = (PendingDir *)realloc(walk->dirs, new_cap * sizeof(PendingDir));
+        if (resized != NULL) {
+            walk->dirs     = resized;
+            walk->cap_dirs = new_cap;
+        } else {
+            ok = 0;
+        }
+    }
+    if (ok != 0) {
+        memcpy(walk->dirs + walk->n_dirs, dirs, count * sizeof(PendingDir));
+        walk->n_dirs += count;
+        (void)pthread_cond_broadcast(&walk->work);
+    }
+    (void)pthread_mutex_unlock(&walk->lock);
+
+    if (ok == 0) {
+        for (size_t i = 0U; i < count; ++i) {
+            free(dirs[i].path);
+        }
+    }
+    return ok;
+}
+
+/* Hand a found file to the consumer, waiting for room; frees it when stopping */
+static void push_file(DirWalk *walk, char *path) {
+    (void)pthread_mutex_lock(&walk->lock);
+    while ((walk->count == DIR_WALK_QUEUE) && (walk->stop == 0)) {
+        (void)pthread_cond_wait(&walk->room, &walk->lock);
+    }
+    if (walk->stop == 0) {
+        walk->files[(walk->head + walk->count) % DIR_WALK_QUEUE] = path;
+        ++walk->count;
+        (void)pthread_cond_signal(&walk->found);
+        path = NULL;
+    }
+    (void)pthread_mutex_unlock(&walk->lock);
+    free(path);
+}
+
+static void record_failure(DirWalk *walk, const char *path) {
+    (void)pthread_mutex_lock(&walk->lock);
+    if (walk->first_failed == NULL) {
+        walk->first_failed = strdup(path);
+    }
+    ++walk->n_failed;
+    (void)pthread_mutex_unlock(&walk->lock);
+}
+
+/*
+ * Per-directory state while listing it: the entry paths are built in one
+ * growing buffer, subdirectories are collected and pushed together at the end.
+ */
+typedef struct {
+    DirWalk*    walk;
+    PendingDir  dir;
+    int         fd;
+    char*       path;
+    size_t      path_cap;
+    size_t      dir_len;
+    PendingDir* subdirs;
+    size_t      n_subdirs;
+    size_t      cap_subdirs;
+} Listing;
+
+/* Handle one entry of the directory being listed; 0 when out of memory */
+static int visit_entry(Listing *listing, const char *name, unsigned char type) {
+    if ((name[0] == '.') && ((name[1] == '\0') || ((name[1] == '.') && (name[2] == '\0')))) {
+        return 1;
+    }
+
+    size_t name_len = strlen(name);
+    size_t need     = listing->dir_len + 1U + name_len + 1U;
+    if (need > listing->path_cap) {
+        size_t new_cap = (need < 256U) ? 256U : need * 2U;
+        char  *resized = (char *)realloc(listing->path, new_cap);
+        if (resized == NULL) {
+            return 0;
+        }
+        if (listing->path == NULL) {
+            memcpy(resized, listing->dir.path, listing->dir_len);
+            resized[listing->dir_len] = '/';
+        }
+        listing->path     = resized;
+        listing->path_cap = new_cap;
+    }
+    memcpy(listing->path + listing->dir_len + 1U, name, name_len + 1U);
+
+    EntryKind kind = entry_kind(listing->fd, name, type);
+    if ((kind == ENTRY_OTHER) || ((kind == ENTRY_FILE) && (is_source_name(name, name_len) == 0))) {
+        return 1;
+    }
+    const char *relative = listing->path + listing->dir.root_len + 1U;
+    if ((listing->walk->n_ignores > 0U) && (is_ignored(listing->walk, name, relative) != 0)) {
+        return 1;
+    }
+
+    char *copy = strdup(listing->path);
+    if (copy == NULL) {
+        return 0;
+    }
+    if (kind == ENTRY_FILE) {
+        push_file(listing->walk, copy);
+        return 1;
+    }
+
+    if (listing->n_subdirs == listing->cap_subdirs) {
+        size_t      new_cap = (listing->cap_subdirs == 0U) ? 16U : listing->cap_subdirs * 2U;
+        PendingDir *resized = (PendingDir *)realloc(listing->subdirs, new_cap * sizeof(PendingDir));
+        if (resized == NULL) {
+            free(copy);
+            return 0;
+        }
+        listing->subdirs     = resized;
+        listing->cap_subdirs = new_cap;
+    }
+    listing->subdirs[listing->n_subdirs++] = (PendingDir){copy, listing->dir.root_len};
+    return 1;
+}
+
+/* List one directory: files go to the consumer, subdirectories to the stack */
+static void list_dir(DirWalk *walk, PendingDir dir) {
+    Listing listing = {walk, dir, -1, NULL, 0U, strlen(dir.path), NULL, 0U, 0U};
+    /* "/" as a root would give "//name" */
+    if ((listing.dir_len > 0U) && (dir.path[listing.dir_len - 1U] == '/')) {
+        --listing.dir_len;
+    }
+
+    listing.fd = openat(AT_FDCWD, dir.path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    int ok = (listing.fd >= 0);
+
+#ifdef __linux__
+    alignas(struct dirent64) char buffer[DENTS_BUFFER_BYTES];
+    while (ok != 0) {
+        ssize_t n = getdents64(listing.fd, buffer, sizeof(buffer));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = 0;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        for (ssize_t offset = 0; (ok != 0) && (offset < n);) {
+            const struct dirent64 *entry = (const struct dirent64 *)(const void *)(buffer + offset);
+            offset += entry->d_reclen;
+            ok = visit_entry(&listing, entry->d_name, entry->d_type);
+        }
+    }
+    if (listing.fd >= 0) {
+        (void)close(listing.fd);
+    }
+#else
+    DIR *stream = (ok != 0) ? fdopendir(listing.fd) : NULL;
+    if ((stream == NULL) && (listing.fd >= 0)) {
+        (void)close(listing.fd);
+    }
+    ok = (stream != NULL);
+    for (struct dirent *entry = NULL; (ok != 0) && ((entry = readdir(stream)) != NULL);) {
+#ifdef DT_DIR
+        ok = visit_entry(&listing, entry->d_name, entry->d_type);
+#else
+        ok = visit_entry(&listing, entry->d_name, 0U);
+#endif
+    }
+    if (stream != NULL) {
+        (void)closedir(stream);
+    }
+#endif
+
+    if (ok == 0) {
+        record_failure(walk, dir.path);
+    }
+    (void)push_dirs(walk, listing.subdirs, listing.n_subdirs);
+    free(listing.subdirs);
+    free(listing.path);
+    free(dir.path);
+}
+
+static void *walker_main(void *arg) {
+    DirWalk *walk = (DirWalk *)arg;
+
+    (void)pthread_mutex_lock(&walk->lock);
+    for (;;) {
+        while ((walk->n_dirs == 0U) && (walk->busy > 0U) && (walk->stop == 0)) {
+            (void)pthread_cond_wait(&walk->work, &walk->lock);
+        }
+        if ((walk->stop != 0) || (walk->n_dirs == 0U)) {
+            break;
+        }
+
+        PendingDir dir = walk->dirs[--walk->n_dirs];
+        ++walk->busy;
+        (void)pthread_mutex_unlock(&walk->lock);
+
+        list_dir(walk, dir);
+
+        (void)pthread_mutex_lock(&walk->lock);
+        --walk->busy;
+        if ((walk->busy == 0U) && (walk->n_dirs == 0U)) {
+            /* Nothing left anywhere: wake the idle walkers and the consumer */
+            (void)pthread_cond_broadcast(&walk->work);
+            (void)pthread_cond_broadcast(&walk->found);
+        }
+    }
+    (void)pthread_mutex_unlock(&walk->lock);
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+DirWalk *dir_walk_start(const char *const roots[], size_t n_roots, const char *const ignores[],
+                        size_t n_ignores, size_t n_threads) {
+    DirWalk *walk = (DirWalk *)calloc(1U, sizeof(DirWalk));
+    if (walk == NULL) {
+        return NULL;
+    }
+    (void)pthread_mutex_init(&walk->lock, NULL);
+    (void)pthread_cond_init(&walk->work, NULL);
+    (void)pthread_cond_init(&walk->found, NULL);
+    (void)pthread_cond_init(&walk->room, NULL);
+    walk->ignores   = ignores;
+    walk->n_ignores = n_ignores;
+
+    /* Roots are walked in command-line order: the stack pops the last pushed first */
+    PendingDir *pending = (PendingDir *)calloc((n_roots > 0U) ? n_roots : 1U, sizeof(PendingDir));
+    int         ok      = (pending != NULL);
+    for (size_t i = 0U; (ok != 0) && (i < n_roots); ++i) {
+        size_t k   = n_roots - 1U - i;
+        size_t len = strlen(roots[k]);
+        size_t end = ((len > 0U) && (roots[k][len - 1U] == '/')) ? len - 1U : len;
+        pending[i] = (PendingDir){strdup(roots[k]), end};
+        ok         = (pending[i].path != NULL);
+    }
+    ok = ok && (push_dirs(walk, pending, n_roots) != 0);
+    free(pending);
+
+    if (n_threads == 0U) {
+        n_threads = DIR_WALK_DEFAULT_THREADS;
+    }
+    if (n_threads > DIR_WALK_MAX_THREADS) {
+        n_threads = DIR_WALK_MAX_THREADS;
+    }
+    for (size_t i = 0U; (ok != 0) && (i < n_threads); ++i) {
+        if (pthread_create(&walk->threads[walk->n_threads], NULL, walker_main, walk) != 0) {
+            break;
+        }
+        ++walk->n_threads;
+    }
+
+    if ((ok == 0) || (walk->n_threads == 0U)) {
+        dir_walk_destroy(walk);
+        return NULL;
+    }
+    return walk;
+}
+
+int dir_walk_next(DirWalk *walk, char **out_path) {
+    *out_path = NULL;
+
+    (void)pthread_mutex_lock(&walk->lock);
+    while ((walk->count == 0U) && ((walk->n_dirs > 0U) || (walk->busy > 0U))) {
+        (void)pthread_cond_wait(&walk->found, &walk->lock);
+    }
+    if (walk->count > 0U) {
+        *out_path  = walk->files[walk->head];
+        walk->head = (walk->head + 1U) % DIR_WALK_QUEUE;
+        --walk->count;
+        (void)pthread_cond_signal(&walk->room);
+    }
+    (void)pthread_mutex_unlock(&walk->lock);
+
+    return (*out_path != NULL) ? 1 : 0;
+}
+
+size_t dir_walk_failures(const DirWalk *walk, const char **out_first) {
+    if (out_first != NULL) {
+        *out_first = walk->first_failed;
+    }
+    return walk->n_failed;
+}
+
+void dir_walk_destroy(DirWalk *walk) {
+    if (walk == NULL) {
+        return;
+    }
+
+    (void)pthread_mutex_lock(&walk->lock);
+    walk->stop = 1;
+    (void)pthread_cond_broadcast(&walk->work);
+    (void)pthread_cond_broadcast(&walk->room);
+    (void)pthread_mutex_unlock(&walk->lock);
+
+    for (size_t i = 0U; i < walk->n_threads; ++i) {
+        (void)pthread_join(walk->threads[i], NULL);
+    }
+
+    for (size_t i = 0U; i < walk->n_dirs; ++i) {
+        free(walk->dirs[i].path);
+    }
+    for (size_t i = 0U; i < walk->count; ++i) {
+        free(walk->files[(walk->head + i) % DIR_WALK_QUEUE]);
+    }
+    free(walk->dirs);
+    free(walk->first_failed);
+    (void)pthread_cond_destroy(&walk->room);
+    (void)pthread_cond_destroy(&walk->found);
+    (void)pthread_cond_destroy(&walk->work);
+    (void)pthread_mutex_destroy(&walk->lock);
+    free(walk);
+}
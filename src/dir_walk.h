@@ -0,0 +1,51 @@
+/*
+ * FILE: dir_walk.h
+ * DESC.: this file is the declaration of the parallel source tree walker
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_DIR_WALK_H
+#define CPLUS_DIR_WALK_H
+
+#include <stddef.h>
+
+/* Walker threads used when dir_walk_start() is given 0 */
+#define DIR_WALK_DEFAULT_THREADS 4U
+
+/* Found paths buffered before the walkers wait for the consumer */
+#define DIR_WALK_QUEUE 1024U
+
+/*
+ * A walk of one or more directory trees for .cplus/.hplus files, run by its
+ * own threads while the consumer takes paths with dir_walk_next(). Directories
+ * are listed with getdents64() on Linux (readdir() elsewhere); the entry type
+ * decides what to descend into, with fstatat() only when the file system does
+ * not report it. Symbolic links to directories are not followed.
+ */
+typedef struct DirWalk DirWalk;
+
+/*
+ * Start walking roots. An entry whose name matches one of the ignore globs
+ * (fnmatch(); a glob with a '/' is matched against the path below its root
+ * instead) is skipped, and so is everything under an ignored directory.
+ * The globs must outlive the walk. NULL when no thread can be started.
+ */
+DirWalk* dir_walk_start(const char* const roots[], size_t n_roots, const char* const ignores[],
+                        size_t n_ignores, size_t n_threads);
+
+/*
+ * Next file found, malloc'd into *out_path (caller must free()), in no
+ * particular order; blocks while the walkers are still looking. Returns 1,
+ * or 0 once every tree has been walked.
+ */
+int dir_walk_next(DirWalk* walk, char** out_path);
+
+/* Directories that could not be read, and the first of them (NULL if none) */
+size_t dir_walk_failures(const DirWalk* walk, const char** out_first);
+
+/* Stop the walkers (a walk may be abandoned early) and free the walk */
+void dir_walk_destroy(DirWalk* walk);
+
+#endif // CPLUS_DIR_WALK_H
@@ -0,0 +1,439 @@
+/*
+ * FILE: file_io.c
+ * DESC.: file read/write helpers shared by the pipeline and the caches
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+/* copy_file_range() is a GNU extension */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "file_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+
+#define COPY_CHUNK_BYTES (1U << 20) /* per copy_file_range()/sendfile() call */
+#define COPY_BUFFER_BYTES 65536U
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static atomic_uint g_temp_counter;
+
+static int write_fully(int fd, const char *data, size_t size) {
+    while (size > 0U) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+/* errno values meaning "this copy method does not apply here, try the next" */
+static int copy_unsupported(int err) {
+    return (err == EXDEV) || (err == EINVAL) || (err == ENOSYS) || (err == EOPNOTSUPP) ||
+           (err == ENOTTY) || (err == EBADF) || (err == EPERM);
+}
+
+/*
+ * Copy in_fd to out_fd from their current offsets to EOF, cheapest method
+ * first: FICLONE (shared extents on Btrfs/XFS), copy_file_range() (in-kernel,
+ * may reflink or offload), sendfile(), then a read()/write() loop. Every
+ * method advances both offsets, so a later one resumes where an earlier one
+ * gave up. Returns 1 on success.
+ */
+static int copy_fd(int in_fd, int out_fd) {
+#ifdef __linux__
+#ifdef FICLONE
+    if (ioctl(out_fd, FICLONE, in_fd) == 0) {
+        return 1;
+    }
+#endif
+
+    for (;;) {
+        ssize_t n = copy_file_range(in_fd, NULL, out_fd, NULL, COPY_CHUNK_BYTES, 0U);
+        if (n == 0) {
+            return 1;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (copy_unsupported(errno) != 0) {
+                break;
+            }
+            return 0;
+        }
+    }
+
+    for (;;) {
+        ssize_t n = sendfile(out_fd, in_fd, NULL, COPY_CHUNK_BYTES);
+        if (n == 0) {
+            return 1;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (copy_unsupported(errno) != 0) {
+                break;
+            }
+            return 0;
+        }
+    }
+#endif
+
+    char *buffer = (char *)malloc(COPY_BUFFER_BYTES);
+    if (buffer == NULL) {
+        return 0;
+    }
+
+    int ok = 1;
+    for (;;) {
+        ssize_t n = read(in_fd, buffer, COPY_BUFFER_BYTES);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = 0;
+            break;
+        }
+        if (write_fully(out_fd, buffer, (size_t)n) == 0) {
+            ok = 0;
+            break;
+        }
+    }
+
+    free(buffer);
+    return ok;
+}
+
+/*
+ * Create "<path>.<pid>.<n>.tmp" exclusively. Mode 0666 lets the process umask
+ * decide the final permissions, exactly as fopen(path, "wb") would.
+ * Returns the fd, or -1; *out_temp receives the malloc'd name on success.
+ */
+static int create_sibling_temp(const char *path, char **out_temp) {
+    size_t temp_size = strlen(path) + 48U;
+    char *temp = (char *)malloc(temp_size);
+    if (temp == NULL) {
+        return -1;
+    }
+
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        unsigned n = atomic_fetch_add(&g_temp_counter, 1U);
+        (void)snprintf(temp, temp_size, "%s.%ld.%u.tmp", path, (long)getpid(), n);
+
+        int fd = open(temp, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (fd >= 0) {
+            *out_temp = temp;
+            return fd;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+
+    free(temp);
+    return -1;
+}
+
+/* 1 if both fds (at offset 0, same size) hold identical bytes, 0 otherwise */
+static int same_content(int a_fd, int b_fd) {
+    char *a = (char *)malloc(2U * COPY_BUFFER_BYTES);
+    if (a == NULL) {
+        return 0;
+    }
+    char *b = a + COPY_BUFFER_BYTES;
+
+    int same = 1;
+    for (off_t offset = 0;;) {
+        ssize_t na = pread(a_fd, a, COPY_BUFFER_BYTES, offset);
+        ssize_t nb = pread(b_fd, b, COPY_BUFFER_BYTES, offset);
+        if ((na < 0) && (errno == EINTR)) {
+            continue;
+        }
+        if ((na < 0) || (na != nb) || (memcmp(a, b, (size_t)na) != 0)) {
+            same = 0;
+            break;
+        }
+        if (na == 0) {
+            break;
+        }
+        offset += (off_t)na;
+    }
+
+    free(a);
+    return same;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+char *file_io_read_all(const char *path, size_t *out_size) {
+    char  *buffer   = NULL;
+    size_t capacity = 0U;
+    if (file_io_read_into(path, &buffer, &capacity, out_size) == 0) {
+        free(buffer);
+        return NULL;
+    }
+    return buffer;
+}
+
+int file_io_read_into(const char *path, char **buffer, size_t *capacity, size_t *out_size) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    if (fseek(fp, 0L, SEEK_END) != 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    long file_size = ftell(fp);
+    if (file_size < 0L) {
+        fclose(fp);
+        return 0;
+    }
+
+    if (fseek(fp, 0L, SEEK_SET) != 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    size_t size = (size_t)file_size;
+    if ((*buffer == NULL) || (*capacity < (size + 1U))) {
+        char *grown = (char *)realloc(*buffer, size + 1U);
+        if (grown == NULL) {
+            fclose(fp);
+            return 0;
+        }
+        *buffer   = grown;
+        *capacity = size + 1U;
+    }
+
+    size_t read_bytes = fread(*buffer, 1U, size, fp);
+    fclose(fp);
+
+    if (read_bytes != size) {
+        return 0;
+    }
+
+    (*buffer)[size] = '\0';
+    if (out_size != NULL) {
+        *out_size = size;
+    }
+
+    return 1;
+}
+
+int file_io_write_all(const char *path, const void *data, size_t size) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    size_t written = fwrite(data, 1U, size, fp);
+    int close_rc = fclose(fp);
+
+    if ((written != size) || (close_rc != 0)) {
+        return 0;
+    }
+
+    return 1;
+}
+
+int file_io_copy_file(const char *src_path, const char *dst_path) {
+    int in_fd = open(src_path, O_RDONLY | O_CLOEXEC);
+    if (in_fd < 0) {
+        return 0;
+    }
+
+    /* Truncate only after ruling out dst being src itself (e.g. -o <input>) */
+    int out_fd = open(dst_path, O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+    if (out_fd < 0) {
+        (void)close(in_fd);
+        return 0;
+    }
+
+    struct stat in_st;
+    struct stat out_st;
+    int ok = (fstat(in_fd, &in_st) == 0) && (fstat(out_fd, &out_st) == 0);
+    int same_file = (ok != 0) && (in_st.st_dev == out_st.st_dev) && (in_st.st_ino == out_st.st_ino);
+
+    if ((ok != 0) && (same_file == 0)) {
+        ok = (ftruncate(out_fd, 0) == 0) && (copy_fd(in_fd, out_fd) != 0);
+    }
+    if (close(out_fd) != 0) {
+        ok = 0;
+    }
+    (void)close(in_fd);
+    return ok;
+}
+
+FileEmitStatus file_io_emit_copy(const char *src_path, const char *dst_path) {
+    int in_fd = open(src_path, O_RDONLY | O_CLOEXEC);
+    if (in_fd < 0) {
+        return FILE_EMIT_FAILED;
+    }
+
+    struct stat in_st;
+    if (fstat(in_fd, &in_st) != 0) {
+        (void)close(in_fd);
+        return FILE_EMIT_FAILED;
+    }
+
+    /* Size first; only equal sizes pay for the byte comparison */
+    int dst_fd = open(dst_path, O_RDONLY | O_CLOEXEC);
+    if (dst_fd >= 0) {
+        struct stat dst_st;
+        int unchanged = (fstat(dst_fd, &dst_st) == 0) && S_ISREG(dst_st.st_mode) &&
+                        (dst_st.st_size == in_st.st_size) &&
+                        (((dst_st.st_dev == in_st.st_dev) && (dst_st.st_ino == in_st.st_ino)) ||
+                         (same_content(in_fd, dst_fd) != 0));
+        (void)close(dst_fd);
+        if (unchanged != 0) {
+            (void)close(in_fd);
+            return FILE_EMIT_UNCHANGED;
+        }
+    }
+
+    /* A symlink is written through: the file it points to is the one replaced */
+    struct stat link_st;
+    int         is_link  = (lstat(dst_path, &link_st) == 0) && S_ISLNK(link_st.st_mode);
+    char       *resolved = (is_link != 0) ? realpath(dst_path, NULL) : NULL;
+    const char *target   = (resolved != NULL) ? resolved : dst_path;
+
+    /*
+     * A dangling symlink, or a file with other hard links, cannot be replaced
+     * by rename() without breaking the link: rewrite it in place, as
+     * fopen(path, "wb") would.
+     */
+    struct stat old_st;
+    int has_old = (stat(target, &old_st) == 0) && S_ISREG(old_st.st_mode);
+    if (((is_link != 0) && (resolved == NULL)) || ((has_old != 0) && (old_st.st_nlink > 1U))) {
+        (void)close(in_fd);
+        int ok = file_io_copy_file(src_path, target);
+        free(resolved);
+        return (ok != 0) ? FILE_EMIT_WRITTEN : FILE_EMIT_FAILED;
+    }
+
+    char *temp = NULL;
+    int out_fd = create_sibling_temp(target, &temp);
+    if (out_fd < 0) {
+        (void)close(in_fd);
+        free(resolved);
+        return FILE_EMIT_FAILED;
+    }
+
+    /* The replacement keeps the permissions of the file it replaces */
+    int ok = copy_fd(in_fd, out_fd);
+    if ((ok != 0) && (has_old != 0) && (fchmod(out_fd, old_st.st_mode & 07777) != 0)) {
+        ok = 0;
+    }
+    if (close(out_fd) != 0) {
+        ok = 0;
+    }
+    (void)close(in_fd);
+
+    if ((ok != 0) && (rename(temp, target) != 0)) {
+        ok = 0;
+    }
+    if (ok == 0) {
+        (void)unlink(temp);
+    }
+
+    free(temp);
+    free(resolved);
+    return (ok != 0) ? FILE_EMIT_WRITTEN : FILE_EMIT_FAILED;
+}
+
+int file_io_write_atomic(const char *path, const void *data, size_t size) {
+    char *temp = NULL;
+    int fd = create_sibling_temp(path, &temp);
+    if (fd < 0) {
+        return 0;
+    }
+
+    int ok = write_fully(fd, (const char *)data, size);
+    if (close(fd) != 0) {
+        ok = 0;
+    }
+
+    if ((ok != 0) && (rename(temp, path) != 0)) {
+        ok = 0;
+    }
+
+    if (ok == 0) {
+        (void)unlink(temp);
+    }
+
+    free(temp);
+    return ok;
+}
+
+int file_io_make_dirs(const char *path) {
+    size_t len = strlen(path);
+    if (len == 0U) {
+        return 0;
+    }
+
+    char *work = (char *)malloc(len + 1U);
+    if (work == NULL) {
+        return 0;
+    }
+    memcpy(work, path, len + 1U);
+
+    /* Create every intermediate component, tolerating ones that already exist */
+    for (char *p = work + 1; ; ++p) {
+        if ((*p != '/') && (*p != '\0')) {
+            continue;
+        }
+
+        char saved = *p;
+        *p = '\0';
+        if ((mkdir(work, 0777) != 0) && (errno != EEXIST)) {
+            free(work);
+            return 0;
+        }
+        *p = saved;
+
+        if (saved == '\0') {
+            break;
+        }
+    }
+
+    struct stat st;
+    int ok = (stat(work, &st) == 0) && S_ISDIR(st.st_mode);
+    free(work);
+    return ok;
+}
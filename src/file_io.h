@@ -0,0 +1,65 @@
+/*
+ * FILE: file_io.h
+ * DESC.: this file is the declaration of the file read/write helpers
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_FILE_IO_H
+#define CPLUS_FILE_IO_H
+
+#include <stddef.h>
+
+/*
+ * Read a whole file into a NUL-terminated heap buffer.
+ * Returns NULL on failure; caller must free().
+ */
+char* file_io_read_all(const char* path, size_t* out_size);
+
+/*
+ * Same, into *buffer of *capacity bytes, grown with realloc() when the file
+ * does not fit, so a caller reading file after file stops allocating once the
+ * buffer has reached the largest size. Returns 1 on success, 0 on failure;
+ * either way *buffer stays the caller's to free().
+ */
+int file_io_read_into(const char* path, char** buffer, size_t* capacity, size_t* out_size);
+
+/* Truncate and write path. Returns 1 on success, 0 on failure. */
+int file_io_write_all(const char* path, const void* data, size_t size);
+
+/*
+ * Truncate dst_path and fill it with the bytes of src_path without staging them
+ * in user space where possible: FICLONE reflink, then copy_file_range(), then
+ * sendfile(), then a buffered read/write loop. Returns 1 on success.
+ */
+int file_io_copy_file(const char* src_path, const char* dst_path);
+
+typedef enum {
+    FILE_EMIT_FAILED,
+    FILE_EMIT_WRITTEN,
+    FILE_EMIT_UNCHANGED
+} FileEmitStatus;
+
+/*
+ * Make dst_path hold the bytes of src_path, touching it only if they differ:
+ * an existing dst of the same size is compared chunk by chunk and left alone
+ * (mtime included) when equal. Otherwise the bytes are copied as in
+ * file_io_copy_file() into a sibling temp file that takes the old file's mode
+ * and is rename()d over dst_path, or over the file it links to when dst_path
+ * is a symlink. A dangling symlink or a file with other hard links is
+ * rewritten in place instead, so the links keep pointing at the output.
+ */
+FileEmitStatus file_io_emit_copy(const char* src_path, const char* dst_path);
+
+/*
+ * Write data to a unique temp file next to path, then rename() it over path,
+ * so concurrent readers see either the old or the new content, never a mix.
+ * Returns 1 on success, 0 on failure (the temp file is removed).
+ */
+int file_io_write_atomic(const char* path, const void* data, size_t size);
+
+/* mkdir -p. Returns 1 if path exists as a directory afterwards, 0 otherwise. */
+int file_io_make_dirs(const char* path);
+
+#endif // CPLUS_FILE_IO_H
@@ -0,0 +1,264 @@
+/*
+ * FILE: file_memo.c
+ * DESC.: stat-validated memo of header hashes and resolved includes
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "file_memo.h"
+
+#include "file_io.h"
+#include "hash.h"
+#include "include_scan.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/stat.h>
+
+#define MEMO_BUCKETS 4096U
+#define RACY_WINDOW_NS 1000000000LL
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+/* The stat fields that tell whether a file may have changed */
+typedef struct {
+    unsigned long long dev;
+    unsigned long long ino;
+    long long          size;
+    long long          mtime_ns;
+    long long          ctime_ns;
+} FileIdentity;
+
+typedef struct MemoEntry {
+    char*             path;
+    uint64_t          path_hash;
+    FileIdentity      identity;
+    FileFacts         facts;
+    struct MemoEntry* next;
+} MemoEntry;
+
+static pthread_mutex_t g_memo_lock = PTHREAD_MUTEX_INITIALIZER;
+static MemoEntry*      g_buckets[MEMO_BUCKETS];
+static size_t          g_count;
+static size_t          g_hits;
+static size_t          g_misses;
+
+/* Resolved includes of one file while it is scanned */
+typedef struct {
+    const char* includer;
+    char*       data;
+    size_t      len;
+    size_t      cap;
+    int         failed;
+} IncludeList;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static FileIdentity identity_of(const struct stat *st) {
+    return (FileIdentity){
+        (unsigned long long)st->st_dev,
+        (unsigned long long)st->st_ino,
+        (long long)st->st_size,
+        (long long)st->st_mtim.tv_sec * 1000000000LL + (long long)st->st_mtim.tv_nsec,
+        (long long)st->st_ctim.tv_sec * 1000000000LL + (long long)st->st_ctim.tv_nsec,
+    };
+}
+
+static int same_identity(const FileIdentity *a, const FileIdentity *b) {
+    return (a->dev == b->dev) && (a->ino == b->ino) && (a->size == b->size) &&
+           (a->mtime_ns == b->mtime_ns) && (a->ctime_ns == b->ctime_ns);
+}
+
+static int copy_facts(const FileFacts *from, FileFacts *to) {
+    *to = *from;
+    to->includes = NULL;
+    if (from->includes_len > 0U) {
+        to->includes = (char *)malloc(from->includes_len);
+        if (to->includes == NULL) {
+            return 0;
+        }
+        memcpy(to->includes, from->includes, from->includes_len);
+    }
+    return 1;
+}
+
+static int collect_include(void *user, const char *name, size_t name_len) {
+    IncludeList *list     = (IncludeList *)user;
+    char        *resolved = include_resolve(list->includer, name, name_len);
+    if (resolved == NULL) {
+        list->failed = 1;
+        return 0;
+    }
+
+    size_t len = strlen(resolved) + 1U;
+    if ((list->len + len) > list->cap) {
+        size_t new_cap = (list->cap == 0U) ? 256U : list->cap * 2U;
+        while (new_cap < (list->len + len)) {
+            new_cap *= 2U;
+        }
+        char *resized = (char *)realloc(list->data, new_cap);
+        if (resized == NULL) {
+            free(resolved);
+            list->failed = 1;
+            return 0;
+        }
+        list->data = resized;
+        list->cap  = new_cap;
+    }
+    memcpy(list->data + list->len, resolved, len);
+    list->len += len;
+    free(resolved);
+    return 1;
+}
+
+/* Read, hash and scan path; 0 when it cannot be read */
+static int read_facts(const char *path, FileFacts *out) {
+    size_t size    = 0U;
+    char  *content = file_io_read_all(path, &size);
+    if (content == NULL) {
+        return 0;
+    }
+
+    IncludeList list = {path, NULL, 0U, 0U, 0};
+    (void)include_scan_quoted(content, size, collect_include, &list);
+    out->size         = size;
+    out->hash         = hash_bytes(content, size, 0U);
+    out->includes     = list.data;
+    out->includes_len = list.len;
+    free(content);
+
+    if (list.failed != 0) {
+        free(list.data);
+        return 0;
+    }
+    return 1;
+}
+
+/* Caller holds g_memo_lock */
+static void clear_locked(void) {
+    for (size_t b = 0U; b < MEMO_BUCKETS; ++b) {
+        MemoEntry *entry = g_buckets[b];
+        while (entry != NULL) {
+            MemoEntry *next = entry->next;
+            free(entry->path);
+            free(entry->facts.includes);
+            free(entry);
+            entry = next;
+        }
+        g_buckets[b] = NULL;
+    }
+    g_count = 0U;
+}
+
+/* Caller holds g_memo_lock; the entry takes a copy of facts */
+static void store_locked(const char *path, uint64_t path_hash, const FileIdentity *identity,
+                         const FileFacts *facts) {
+    MemoEntry **slot = &g_buckets[path_hash % MEMO_BUCKETS];
+    for (MemoEntry *entry = *slot; entry != NULL; entry = entry->next) {
+        if ((entry->path_hash == path_hash) && (strcmp(entry->path, path) == 0)) {
+            FileFacts copy;
+            if (copy_facts(facts, &copy) != 0) {
+                free(entry->facts.includes);
+                entry->facts    = copy;
+                entry->identity = *identity;
+            }
+            return;
+        }
+    }
+
+    if (g_count >= FILE_MEMO_MAX_ENTRIES) {
+        clear_locked();
+    }
+    MemoEntry *entry = (MemoEntry *)calloc(1U, sizeof(MemoEntry));
+    char      *copy  = strdup(path);
+    if ((entry == NULL) || (copy == NULL) || (copy_facts(facts, &entry->facts) == 0)) {
+        free(entry);
+        free(copy);
+        return;
+    }
+    entry->path      = copy;
+    entry->path_hash = path_hash;
+    entry->identity  = *identity;
+    entry->next      = *slot;
+    *slot            = entry;
+    ++g_count;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+int file_memo_get(const char *path, FileFacts *out) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return 0;
+    }
+    FileIdentity identity  = identity_of(&st);
+    uint64_t     path_hash = hash_bytes(path, strlen(path), 0U);
+
+    (void)pthread_mutex_lock(&g_memo_lock);
+    for (MemoEntry *entry = g_buckets[path_hash % MEMO_BUCKETS]; entry != NULL;
+         entry = entry->next) {
+        if ((entry->path_hash == path_hash) && (strcmp(entry->path, path) == 0) &&
+            (same_identity(&entry->identity, &identity) != 0)) {
+            int ok = copy_facts(&entry->facts, out);
+            g_hits += (size_t)ok;
+            (void)pthread_mutex_unlock(&g_memo_lock);
+            return ok;
+        }
+    }
+    ++g_misses;
+    (void)pthread_mutex_unlock(&g_memo_lock);
+
+    struct timespec now;
+    (void)clock_gettime(CLOCK_REALTIME, &now);
+    long long now_ns = (long long)now.tv_sec * 1000000000LL + (long long)now.tv_nsec;
+
+    if (read_facts(path, out) == 0) {
+        return 0;
+    }
+
+    /* Keep it only if the file did not change while it was read, and is not racy */
+    struct stat after;
+    if (stat(path, &after) == 0) {
+        FileIdentity checked = identity_of(&after);
+        if ((same_identity(&identity, &checked) != 0) &&
+            (identity.mtime_ns < (now_ns - RACY_WINDOW_NS))) {
+            (void)pthread_mutex_lock(&g_memo_lock);
+            store_locked(path, path_hash, &identity, out);
+            (void)pthread_mutex_unlock(&g_memo_lock);
+        }
+    }
+    return 1;
+}
+
+void file_memo_counters(size_t *out_hits, size_t *out_misses) {
+    (void)pthread_mutex_lock(&g_memo_lock);
+    if (out_hits != NULL) {
+        *out_hits = g_hits;
+    }
+    if (out_misses != NULL) {
+        *out_misses = g_misses;
+    }
+    (void)pthread_mutex_unlock(&g_memo_lock);
+}
+
+void file_memo_clear(void) {
+    (void)pthread_mutex_lock(&g_memo_lock);
+    clear_locked();
+    g_hits   = 0U;
+    g_misses = 0U;
+    (void)pthread_mutex_unlock(&g_memo_lock);
+}
@@ -0,0 +1,46 @@
+/*
+ * FILE: file_memo.h
+ * DESC.: this file is the declaration of the in-memory header hash and include memo
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_FILE_MEMO_H
+#define CPLUS_FILE_MEMO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Entries kept before the memo starts over */
+#define FILE_MEMO_MAX_ENTRIES 65536U
+
+/*
+ * What the validation cache key needs from a header: its size and content
+ * hash, and the quoted `#include "..."` it names, resolved against its directory
+ * (each NUL-terminated, back to back in includes[0..includes_len)).
+ */
+typedef struct {
+    size_t   size;
+    uint64_t hash;
+    char*    includes;
+    size_t   includes_len;
+} FileFacts;
+
+/*
+ * Facts of the file at path, read and scanned once per process and reused
+ * while its device, inode, size, mtime and ctime stay the same — so a
+ * long-lived process (cplus --serve) re-reads only the headers that changed.
+ * A file modified less than a second before it is read is not memoized, as
+ * a write within the same timestamp tick could go unnoticed. Thread-safe.
+ * Returns 1 and fills *out (free out->includes), or 0 when path cannot be read.
+ */
+int file_memo_get(const char* path, FileFacts* out);
+
+/* Lookups answered from memory and lookups that read the file */
+void file_memo_counters(size_t* out_hits, size_t* out_misses);
+
+/* Drop every entry */
+void file_memo_clear(void);
+
+#endif // CPLUS_FILE_MEMO_H
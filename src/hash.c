@@ -0,0 +1,185 @@
+/*
+ * FILE: hash.c
+ * DESC.: XXH64 implementation used for cache keys and content comparison
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ *
+ * NOTE: this is the reference XXH64 algorithm (Yann Collet, BSD-2), written
+ *       from the specification so results match other XXH64 implementations.
+ */
+
+#include "hash.h"
+
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/* Little-endian loads; memcpy keeps them alignment-safe */
+static uint64_t read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static uint32_t read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+static uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc  = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static uint64_t merge_round(uint64_t acc, uint64_t val) {
+    acc ^= round64(0U, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+/* Consume the <32-byte tail and mix the final value */
+static uint64_t finalize(uint64_t h, const unsigned char *p, size_t len) {
+    while (len >= 8U) {
+        h ^= round64(0U, read64(p));
+        h  = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p   += 8;
+        len -= 8U;
+    }
+
+    if (len >= 4U) {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h  = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p   += 4;
+        len -= 4U;
+    }
+
+    while (len > 0U) {
+        h ^= (uint64_t)(*p) * PRIME64_5;
+        h  = rotl64(h, 11) * PRIME64_1;
+        ++p;
+        --len;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+/* Process as many whole 32-byte stripes as possible; returns bytes consumed */
+static size_t consume_stripes(uint64_t v[4], const unsigned char *p, size_t len) {
+    size_t done = 0U;
+
+    while (len - done >= 32U) {
+        v[0] = round64(v[0], read64(p + done));
+        v[1] = round64(v[1], read64(p + done + 8U));
+        v[2] = round64(v[2], read64(p + done + 16U));
+        v[3] = round64(v[3], read64(p + done + 24U));
+        done += 32U;
+    }
+
+    return done;
+}
+
+static uint64_t converge(const uint64_t v[4]) {
+    uint64_t h = rotl64(v[0], 1) + rotl64(v[1], 7) + rotl64(v[2], 12) + rotl64(v[3], 18);
+    h = merge_round(h, v[0]);
+    h = merge_round(h, v[1]);
+    h = merge_round(h, v[2]);
+    h = merge_round(h, v[3]);
+    return h;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed) {
+    HashState state;
+    hash_init(&state, seed);
+    hash_update(&state, data, size);
+    return hash_final(&state);
+}
+
+void hash_init(HashState *state, uint64_t seed) {
+    memset(state, 0, sizeof(*state));
+    state->seed = seed;
+    state->v[0] = seed + PRIME64_1 + PRIME64_2;
+    state->v[1] = seed + PRIME64_2;
+    state->v[2] = seed;
+    state->v[3] = seed - PRIME64_1;
+}
+
+void hash_update(HashState *state, const void *data, size_t size) {
+    const unsigned char *p = (const unsigned char *)data;
+
+    if ((p == NULL) || (size == 0U)) {
+        return;
+    }
+
+    state->total_len += size;
+
+    /* Top up a partially filled stripe first */
+    if (state->mem_size > 0U) {
+        size_t fill = 32U - state->mem_size;
+        if (size < fill) {
+            memcpy(state->mem + state->mem_size, p, size);
+            state->mem_size += size;
+            return;
+        }
+        memcpy(state->mem + state->mem_size, p, fill);
+        (void)consume_stripes(state->v, state->mem, 32U);
+        state->mem_size = 0U;
+        p    += fill;
+        size -= fill;
+    }
+
+    size_t done = consume_stripes(state->v, p, size);
+    memcpy(state->mem, p + done, size - done);
+    state->mem_size = size - done;
+}
+
+uint64_t hash_final(const HashState *state) {
+    uint64_t h = (state->total_len >= 32U) ? converge(state->v) : (state->seed + PRIME64_5);
+    h += state->total_len;
+    return finalize(h, state->mem, state->mem_size);
+}
+
+void hash_update_str(HashState *state, const char *text) {
+    if (text == NULL) {
+        text = "";
+    }
+    hash_update(state, text, strlen(text) + 1U);
+}
+
+void hash_to_hex(uint64_t hash, char out[17]) {
+    static const char digits[] = "0123456789abcdef";
+
+    for (int i = 15; i >= 0; --i) {
+        out[i] = digits[hash & 0xFU];
+        hash >>= 4;
+    }
+    out[16] = '\0';
+}
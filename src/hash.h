@@ -0,0 +1,37 @@
+/*
+ * FILE: hash.h
+ * DESC.: this file is the declaration of the 64-bit content hash (XXH64)
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_HASH_H
+#define CPLUS_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Streaming XXH64 state; initialise with hash_init() before use */
+typedef struct {
+    uint64_t      total_len;
+    uint64_t      v[4];
+    unsigned char mem[32];
+    size_t        mem_size;
+    uint64_t      seed;
+} HashState;
+
+/* One-shot XXH64 of data[0..size) */
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed);
+
+void     hash_init(HashState* state, uint64_t seed);
+void     hash_update(HashState* state, const void* data, size_t size);
+uint64_t hash_final(const HashState* state);
+
+/* Feed a NUL-terminated string including its terminator, so "ab","c" != "a","bc" */
+void hash_update_str(HashState* state, const char* text);
+
+/* Write the hash as 16 lowercase hex digits + NUL into out[17] */
+void hash_to_hex(uint64_t hash, char out[17]);
+
+#endif // CPLUS_HASH_H
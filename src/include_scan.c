@@ -0,0 +1,145 @@
+/*
+ * FILE: include_scan.c
+ * DESC.: single-pass scanner for #include "*.hplus" (or any quoted) dependency edges
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "include_scan.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static const char *skip_blanks(const char *p, const char *end) {
+    while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+        ++p;
+    }
+    return p;
+}
+
+/* 1 if '#' at hash_pos is the first non-blank character of its line */
+static int starts_line(const char *source, const char *hash_pos) {
+    for (const char *p = hash_pos; p > source; --p) {
+        char c = p[-1];
+        if (c == '\n') {
+            return 1;
+        }
+        if ((c != ' ') && (c != '\t')) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Match `include "name.hplus"` (any quoted name unless hplus_only) right after
+ * a line-leading '#'. On success *name / *name_len delimit the quoted name.
+ */
+static int match_directive(const char *p, const char *end, int hplus_only, const char **name,
+                           size_t *name_len) {
+    static const char  keyword[]     = "include";
+    static const char  hplus_ext[]   = ".hplus";
+    const size_t       keyword_len   = sizeof(keyword) - 1U;
+    const size_t       hplus_ext_len = sizeof(hplus_ext) - 1U;
+
+    p = skip_blanks(p, end);
+    if (((size_t)(end - p) < keyword_len) || (memcmp(p, keyword, keyword_len) != 0)) {
+        return 0;
+    }
+
+    p = skip_blanks(p + keyword_len, end);
+    if ((p >= end) || (*p != '"')) {
+        return 0;
+    }
+
+    const char *start = p + 1;
+    const char *close = (const char *)memchr(start, '"', (size_t)(end - start));
+    if (close == NULL) {
+        return 0;
+    }
+
+    /* A quoted include name cannot span lines */
+    if (memchr(start, '\n', (size_t)(close - start)) != NULL) {
+        return 0;
+    }
+
+    size_t len = (size_t)(close - start);
+    if (len == 0U) {
+        return 0;
+    }
+    if ((hplus_only != 0) &&
+        ((len <= hplus_ext_len) ||
+         (memcmp(close - hplus_ext_len, hplus_ext, hplus_ext_len) != 0))) {
+        return 0;
+    }
+
+    *name     = start;
+    *name_len = len;
+    return 1;
+}
+
+static size_t scan(const char *source, size_t size, int hplus_only, IncludeVisitor visit,
+                   void *user) {
+    if ((source == NULL) || (visit == NULL)) {
+        return 0U;
+    }
+
+    const char *end     = source + size;
+    const char *p       = source;
+    size_t      visited = 0U;
+
+    /* memchr jumps straight between '#' characters; everything else is skipped */
+    while ((p = (const char *)memchr(p, '#', (size_t)(end - p))) != NULL) {
+        const char *name     = NULL;
+        size_t      name_len = 0U;
+
+        if ((starts_line(source, p) != 0) &&
+            (match_directive(p + 1, end, hplus_only, &name, &name_len) != 0)) {
+            ++visited;
+            if (visit(user, name, name_len) == 0) {
+                break;
+            }
+            p = name + name_len;
+        } else {
+            ++p;
+        }
+    }
+
+    return visited;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+size_t include_scan(const char *source, size_t size, IncludeVisitor visit, void *user) {
+    return scan(source, size, 1, visit, user);
+}
+
+size_t include_scan_quoted(const char *source, size_t size, IncludeVisitor visit, void *user) {
+    return scan(source, size, 0, visit, user);
+}
+
+char *include_resolve(const char *includer_path, const char *name, size_t name_len) {
+    size_t dir_len = 0U;
+
+    if ((name_len == 0U) || (name[0] != '/')) {
+        const char *slash = strrchr(includer_path, '/');
+        dir_len = (slash != NULL) ? (size_t)(slash - includer_path) + 1U : 0U;
+    }
+
+    char *resolved = (char *)malloc(dir_len + name_len + 1U);
+    if (resolved == NULL) {
+        return NULL;
+    }
+
+    memcpy(resolved, includer_path, dir_len);
+    memcpy(resolved + dir_len, name, name_len);
+    resolved[dir_len + name_len] = '\0';
+    return resolved;
+}
@@ -0,0 +1,41 @@
+/*
+ * FILE: include_scan.h
+ * DESC.: this file is the declaration of the native #include "*.hplus" scanner
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_INCLUDE_SCAN_H
+#define CPLUS_INCLUDE_SCAN_H
+
+#include <stddef.h>
+
+/*
+ * Called for every `#include "name.hplus"` directive, in source order.
+ * `name` is not NUL-terminated. Return 0 to stop scanning early.
+ */
+typedef int (*IncludeVisitor)(void* user, const char* name, size_t name_len);
+
+/*
+ * Scan source[0..size) for quoted includes of cplus interfaces (.hplus).
+ * Only the `#include` line shape is recognised — no preprocessing is done,
+ * so includes inside #if 0 or comments are reported too (a superset is safe
+ * for dependency tracking). Returns the number of includes visited.
+ */
+size_t include_scan(const char* source, size_t size, IncludeVisitor visit, void* user);
+
+/*
+ * Same as include_scan(), but visits every quoted include whatever its
+ * extension — `#include "vendor.h"` as well as `#include "api.hplus"`.
+ */
+size_t include_scan_quoted(const char* source, size_t size, IncludeVisitor visit, void* user);
+
+/*
+ * Resolve an include name the way the preprocessor does for quoted includes:
+ * relative to the directory of includer_path (absolute names kept as-is).
+ * Returns a malloc'd path; caller must free().
+ */
+char* include_resolve(const char* includer_path, const char* name, size_t name_len);
+
+#endif // CPLUS_INCLUDE_SCAN_H
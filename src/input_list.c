@@ -0,0 +1,318 @@
+/*
+ * FILE: input_list.c
+ * DESC.: command-line inputs and NUL/newline-delimited input lists, read lazily
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "input_list.h"
+
+#include "byte_scan.h"
+#include "dir_walk.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define INPUT_LIST_CHUNK (64U * 1024U)
+#define DELIM_UNDECIDED  '\1'
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+typedef enum {
+    SOURCE_PATH,
+    SOURCE_LIST,
+    SOURCE_DIR
+} InputSourceKind;
+
+/* A literal path, an open list file or a directory tree, named by text */
+typedef struct {
+    const char*     text;
+    int             fd;     /* list files only, else -1 */
+    InputSourceKind kind;
+} InputSource;
+
+/*
+ * Unconsumed bytes of the current list are buf[start, end). delim is
+ * DELIM_UNDECIDED until the list's first delimiter is seen, then '\n' or '\0'.
+ */
+struct InputList {
+    InputSource* sources;
+    size_t       count;
+    size_t       capacity;
+    size_t       current;
+    char*        buf;
+    size_t       buf_cap;
+    size_t       start;
+    size_t       end;
+    char         delim;
+    int          eof;
+    const char*  failed;
+    char*        failed_dir;
+    DirWalk*     walk;     /* over the run of directory sources from current */
+    size_t       walk_end; /* first source after that run */
+    const char** ignores;
+    size_t       n_ignores;
+    size_t       cap_ignores;
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static int add_source(InputList *list, const char *text, int fd, InputSourceKind kind) {
+    if (list->count == list->capacity) {
+        size_t       new_cap = (list->capacity == 0U) ? 8U : list->capacity * 2U;
+        InputSource *resized = (InputSource *)realloc(list->sources, new_cap * sizeof(InputSource));
+        if (resized == NULL) {
+            return 0;
+        }
+        list->sources  = resized;
+        list->capacity = new_cap;
+    }
+    list->sources[list->count++] = (InputSource){text, fd, kind};
+    return 1;
+}
+
+static void close_source(InputSource *source) {
+    if (source->fd > STDIN_FILENO) {
+        (void)close(source->fd);
+    }
+    source->fd = -1;
+}
+
+/*
+ * Next file of the walk over the directory sources starting at current,
+ * walked together; 0 at its end, -1 when a directory could not be read.
+ */
+static int next_walked(InputList *list, char **out_path) {
+    if (list->walk == NULL) {
+        size_t end = list->current;
+        while ((end < list->count) && (list->sources[end].kind == SOURCE_DIR)) {
+            ++end;
+        }
+        const char **roots = (const char **)malloc((end - list->current) * sizeof(const char *));
+        for (size_t i = list->current; (roots != NULL) && (i < end); ++i) {
+            roots[i - list->current] = list->sources[i].text;
+        }
+        list->walk = (roots != NULL) ? dir_walk_start(roots, end - list->current, list->ignores,
+                                                      list->n_ignores, 0U)
+                                     : NULL;
+        free(roots);
+        if (list->walk == NULL) {
+            return -1;
+        }
+        list->walk_end = end;
+    }
+
+    if (dir_walk_next(list->walk, out_path) != 0) {
+        return 1;
+    }
+
+    const char *first = NULL;
+    int         got   = 0;
+    if (dir_walk_failures(list->walk, &first) > 0U) {
+        list->failed_dir = strdup(first);
+        got              = -1;
+    }
+    dir_walk_destroy(list->walk);
+    list->walk = NULL;
+    return got;
+}
+
+/* Copy one entry out of the buffer; 0 for an empty one, -1 when out of memory */
+static int take_entry(InputList *list, const char *entry, size_t len, char **out_path) {
+    if ((list->delim != '\0') && (len > 0U) && (entry[len - 1U] == '\r')) {
+        --len;
+    }
+    if (len == 0U) {
+        return 0;
+    }
+    *out_path = strndup(entry, len);
+    return (*out_path != NULL) ? 1 : -1;
+}
+
+/* Next entry of the list file source; 1, 0 at its end, or -1 on error */
+static int next_entry(InputList *list, const InputSource *source, char **out_path) {
+    for (;;) {
+        const char *p    = list->buf + list->start;
+        const char *end  = list->buf + list->end;
+        const char *stop = end;
+        if (list->start < list->end) {
+            if (list->delim == DELIM_UNDECIDED) {
+                stop = byte_scan_either(p, end, '\n', '\0');
+                if (stop < end) {
+                    list->delim = *stop;
+                }
+            } else {
+                stop = (const char *)memchr(p, list->delim, (size_t)(end - p));
+                stop = (stop != NULL) ? stop : end;
+            }
+        }
+
+        if ((stop < end) || ((list->eof != 0) && (p < end))) {
+            list->start += (size_t)(stop - p) + ((stop < end) ? 1U : 0U);
+            int got = take_entry(list, p, (size_t)(stop - p), out_path);
+            if (got != 0) {
+                return got;
+            }
+            continue;
+        }
+        if (list->eof != 0) {
+            return 0;
+        }
+
+        /* Keep the partial entry, make room after it and read the next chunk */
+        if (list->start > 0U) {
+            memmove(list->buf, list->buf + list->start, list->end - list->start);
+            list->end  -= list->start;
+            list->start = 0U;
+        }
+        if ((list->buf_cap - list->end) < INPUT_LIST_CHUNK) {
+            size_t new_cap = (list->buf_cap == 0U) ? INPUT_LIST_CHUNK : list->buf_cap * 2U;
+            char  *resized = (char *)realloc(list->buf, new_cap);
+            if (resized == NULL) {
+                return -1;
+            }
+            list->buf     = resized;
+            list->buf_cap = new_cap;
+        }
+
+        ssize_t n = read(source->fd, list->buf + list->end, list->buf_cap - list->end);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            list->eof = 1;
+        }
+        list->end += (size_t)n;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+InputList *input_list_create(void) {
+    InputList *list = (InputList *)calloc(1U, sizeof(InputList));
+    if (list != NULL) {
+        list->delim = DELIM_UNDECIDED;
+    }
+    return list;
+}
+
+int input_list_add_path(InputList *list, const char *path) {
+    return add_source(list, path, -1, SOURCE_PATH);
+}
+
+int input_list_add_dir(InputList *list, const char *dir_path) {
+    struct stat st;
+    if ((stat(dir_path, &st) != 0) || !S_ISDIR(st.st_mode)) {
+        return 0;
+    }
+    return add_source(list, dir_path, -1, SOURCE_DIR);
+}
+
+int input_list_add_ignore(InputList *list, const char *glob) {
+    if (list->n_ignores == list->cap_ignores) {
+        size_t       new_cap = (list->cap_ignores == 0U) ? 8U : list->cap_ignores * 2U;
+        const char **resized =
+            (const char **)realloc((void *)list->ignores, new_cap * sizeof(const char *));
+        if (resized == NULL) {
+            return 0;
+        }
+        list->ignores     = resized;
+        list->cap_ignores = new_cap;
+    }
+    list->ignores[list->n_ignores++] = glob;
+    return 1;
+}
+
+int input_list_add_file(InputList *list, const char *list_path) {
+    int fd = (strcmp(list_path, "-") == 0) ? STDIN_FILENO : open(list_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+    if (add_source(list, list_path, fd, SOURCE_LIST) == 0) {
+        if (fd != STDIN_FILENO) {
+            (void)close(fd);
+        }
+        return 0;
+    }
+    return 1;
+}
+
+int input_list_next(InputList *list, char **out_path) {
+    *out_path = NULL;
+    if (list->failed != NULL) {
+        return -1;
+    }
+
+    while (list->current < list->count) {
+        InputSource *source = &list->sources[list->current];
+        if (source->kind == SOURCE_PATH) {
+            ++list->current;
+            *out_path = strdup(source->text);
+            return (*out_path != NULL) ? 1 : -1;
+        }
+        if (source->kind == SOURCE_DIR) {
+            int got = next_walked(list, out_path);
+            if (got == 0) {
+                list->current = list->walk_end;
+                continue;
+            }
+            if (got < 0) {
+                list->failed = (list->failed_dir != NULL) ? list->failed_dir : source->text;
+            }
+            return got;
+        }
+
+        int got = next_entry(list, source, out_path);
+        if (got != 0) {
+            if (got < 0) {
+                list->failed = source->text;
+            }
+            return got;
+        }
+
+        close_source(source);
+        ++list->current;
+        list->start = 0U;
+        list->end   = 0U;
+        list->eof   = 0;
+        list->delim = DELIM_UNDECIDED;
+    }
+    return 0;
+}
+
+const char *input_list_error(const InputList *list) {
+    return list->failed;
+}
+
+void input_list_destroy(InputList *list) {
+    if (list == NULL) {
+        return;
+    }
+    dir_walk_destroy(list->walk);
+    for (size_t i = list->current; i < list->count; ++i) {
+        close_source(&list->sources[i]);
+    }
+    free((void *)list->ignores);
+    free(list->failed_dir);
+    free(list->sources);
+    free(list->buf);
+    free(list);
+}
@@ -0,0 +1,60 @@
+/*
+ * FILE: input_list.h
+ * DESC.: this file is the declaration of the streaming input path reader
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_INPUT_LIST_H
+#define CPLUS_INPUT_LIST_H
+
+#include <stddef.h>
+
+/*
+ * The inputs of a run in command-line order: literal paths, list files
+ * (`@FILE`, `--files-from FILE`, `-` for stdin) and directory trees (`-r DIR`,
+ * walked by a dir_walk; adjacent trees share one walk). A list holds one path
+ * per entry, delimited by NUL or newline — whichever comes first in that list
+ * decides — and is read in 64 KiB chunks as entries are asked for, so a list
+ * of any length costs one buffer no matter how much of it is still unread.
+ */
+typedef struct InputList InputList;
+
+/* NULL on allocation failure */
+InputList* input_list_create(void);
+
+/* Append a literal input path; it must outlive the list. Returns 1, or 0 on allocation failure. */
+int input_list_add_path(InputList* list, const char* path);
+
+/* Append a directory tree to walk; it must outlive the list. 0 when it is not a directory. */
+int input_list_add_dir(InputList* list, const char* dir_path);
+
+/*
+ * Skip walked entries matching glob (see dir_walk_start()); it must outlive
+ * the list. 0 on allocation failure.
+ */
+int input_list_add_ignore(InputList* list, const char* glob);
+
+/*
+ * Append a list file ("-" = stdin), opened right away so a missing one is
+ * reported before any input runs. Returns 1, or 0 when it cannot be opened.
+ */
+int input_list_add_file(InputList* list, const char* list_path);
+
+/*
+ * Next input path, malloc'd into *out_path (caller must free()). Empty
+ * entries and a trailing '\r' in newline-delimited lists are skipped.
+ * Returns 1, 0 at the end of the inputs, or -1 on a read or allocation
+ * error (input_list_error() names the list, or the first directory of a
+ * walk that could not be read — reported once the rest of the walk is done).
+ */
+int input_list_next(InputList* list, char** out_path);
+
+/* List file or directory whose read failed, or NULL */
+const char* input_list_error(const InputList* list);
+
+/* Close the list files not read to the end and free the list */
+void input_list_destroy(InputList* list);
+
+#endif // CPLUS_INPUT_LIST_H
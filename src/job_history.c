@@ -0,0 +1,379 @@
+/*
+ * FILE: job_history.c
+ * DESC.: per-file duration history and longest-first planner for parallel runs
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "job_history.h"
+
+#include "file_io.h"
+#include "hash.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTORY_FORMAT_TAG "cplus-history 1"
+#define HISTORY_BUCKETS    4096U
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+typedef struct HistoryEntry {
+    char*                path;
+    uint64_t             path_hash;
+    unsigned long long   size;
+    uint64_t             duration_ns;
+    int                  recorded;   /* measured by the current run */
+    struct HistoryEntry* next;
+} HistoryEntry;
+
+struct JobHistory {
+    char*           path;            /* NULL = in memory only */
+    pthread_mutex_t lock;
+    HistoryEntry*   buckets[HISTORY_BUCKETS];
+    size_t          count;
+    double          ns_per_byte;     /* over the loaded entries; 0 = unknown */
+};
+
+/* A group of the plan while items are dealt */
+typedef struct {
+    uint64_t load;
+    size_t   len;
+    size_t   id;
+} PlanGroup;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/* Caller holds the lock (or owns the history) */
+static HistoryEntry *find_entry(const JobHistory *history, const char *path, uint64_t path_hash) {
+    for (HistoryEntry *entry = history->buckets[path_hash % HISTORY_BUCKETS]; entry != NULL;
+         entry = entry->next) {
+        if ((entry->path_hash == path_hash) && (strcmp(entry->path, path) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/* Caller holds the lock (or owns the history); NULL on allocation failure */
+static HistoryEntry *add_entry(JobHistory *history, const char *path, uint64_t path_hash) {
+    HistoryEntry *entry = (HistoryEntry *)calloc(1U, sizeof(HistoryEntry));
+    char         *copy  = strdup(path);
+    if ((entry == NULL) || (copy == NULL)) {
+        free(entry);
+        free(copy);
+        return NULL;
+    }
+    HistoryEntry **slot = &history->buckets[path_hash % HISTORY_BUCKETS];
+    entry->path      = copy;
+    entry->path_hash = path_hash;
+    entry->next      = *slot;
+    *slot            = entry;
+    ++history->count;
+    return entry;
+}
+
+static void clear_entries(JobHistory *history) {
+    for (size_t b = 0U; b < HISTORY_BUCKETS; ++b) {
+        HistoryEntry *entry = history->buckets[b];
+        while (entry != NULL) {
+            HistoryEntry *next = entry->next;
+            free(entry->path);
+            free(entry);
+            entry = next;
+        }
+        history->buckets[b] = NULL;
+    }
+    history->count = 0U;
+}
+
+/*
+ * File format (text, one record per line):
+ *   cplus-history 1
+ *   D <duration ns> <size> <path>
+ * Any malformed line discards the whole file.
+ */
+static void load_history(JobHistory *history) {
+    size_t size = 0U;
+    char  *text = file_io_read_all(history->path, &size);
+    if (text == NULL) {
+        return;
+    }
+
+    double total_ns    = 0.0;
+    double total_bytes = 0.0;
+    char  *end         = text + size;
+    char  *p           = text;
+    int    valid       = 0;
+    while ((p < end) && ((valid != 0) || (p == text))) {
+        char *nl = (char *)memchr(p, '\n', (size_t)(end - p));
+        if (nl == NULL) {
+            valid = 0;
+            break;
+        }
+        *nl = '\0';
+
+        unsigned long long duration = 0ULL;
+        unsigned long long bytes    = 0ULL;
+        int                consumed = 0;
+        if (p == text) {
+            valid = (strcmp(p, HISTORY_FORMAT_TAG) == 0);
+        } else if ((sscanf(p, "D %llu %llu %n", &duration, &bytes, &consumed) == 2) &&
+                   (consumed > 0) && (p[consumed] != '\0')) {
+            const char   *path      = p + consumed;
+            uint64_t      path_hash = hash_bytes(path, strlen(path), 0U);
+            HistoryEntry *entry     = find_entry(history, path, path_hash);
+            if (entry == NULL) {
+                entry = add_entry(history, path, path_hash);
+            }
+            if (entry == NULL) {
+                valid = 0;
+            } else {
+                entry->size        = bytes;
+                entry->duration_ns = (uint64_t)duration;
+                total_ns += (double)duration;
+                total_bytes += (double)bytes;
+            }
+        } else {
+            valid = 0;
+        }
+        p = nl + 1;
+    }
+    free(text);
+
+    if (valid == 0) {
+        clear_entries(history);
+    } else if ((total_ns > 0.0) && (total_bytes > 0.0)) {
+        history->ns_per_byte = total_ns / total_bytes;
+    }
+}
+
+/* Orders (cost, index) pairs costliest first, ties by index so plans are reproducible */
+static int compare_cost_desc(const void *a, const void *b) {
+    const uint64_t *x = (const uint64_t *)a;
+    const uint64_t *y = (const uint64_t *)b;
+    if (x[0] != y[0]) {
+        return (x[0] > y[0]) ? -1 : 1;
+    }
+    return (x[1] < y[1]) ? -1 : (x[1] > y[1]) ? 1 : 0;
+}
+
+static int group_before(const PlanGroup *a, const PlanGroup *b) {
+    return (a->load < b->load) || ((a->load == b->load) && (a->id < b->id));
+}
+
+/* Restore the min-heap order from slot i downwards */
+static void heap_sift_down(PlanGroup heap[], size_t n, size_t i) {
+    for (;;) {
+        size_t smallest = i;
+        size_t left     = 2U * i + 1U;
+        size_t right    = left + 1U;
+        if ((left < n) && (group_before(&heap[left], &heap[smallest]) != 0)) {
+            smallest = left;
+        }
+        if ((right < n) && (group_before(&heap[right], &heap[smallest]) != 0)) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+        PlanGroup tmp  = heap[i];
+        heap[i]        = heap[smallest];
+        heap[smallest] = tmp;
+        i              = smallest;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+JobHistory *job_history_open(const char *path) {
+    JobHistory *history = (JobHistory *)calloc(1U, sizeof(JobHistory));
+    if (history == NULL) {
+        return NULL;
+    }
+    if (path != NULL) {
+        history->path = strdup(path);
+        if (history->path == NULL) {
+            free(history);
+            return NULL;
+        }
+    }
+    if (pthread_mutex_init(&history->lock, NULL) != 0) {
+        free(history->path);
+        free(history);
+        return NULL;
+    }
+    if (history->path != NULL) {
+        load_history(history);
+    }
+    return history;
+}
+
+uint64_t job_history_estimate(const JobHistory *history, const char *input_path,
+                              unsigned long long size) {
+    double rate = (double)JOB_HISTORY_DEFAULT_NS_PER_BYTE;
+    if ((history != NULL) && (input_path != NULL)) {
+        JobHistory *locked    = (JobHistory *)history;
+        uint64_t    path_hash = hash_bytes(input_path, strlen(input_path), 0U);
+        (void)pthread_mutex_lock(&locked->lock);
+        const HistoryEntry *entry = find_entry(history, input_path, path_hash);
+        uint64_t            known = (entry != NULL) ? entry->duration_ns : 0U;
+        int                 seen  = (entry != NULL);
+        if (history->ns_per_byte > 0.0) {
+            rate = history->ns_per_byte;
+        }
+        (void)pthread_mutex_unlock(&locked->lock);
+        if (seen != 0) {
+            return known;
+        }
+    }
+    return (uint64_t)((double)size * rate);
+}
+
+void job_history_record(JobHistory *history, const char *input_path, unsigned long long size,
+                        uint64_t duration_ns) {
+    if ((history == NULL) || (input_path == NULL)) {
+        return;
+    }
+    uint64_t path_hash = hash_bytes(input_path, strlen(input_path), 0U);
+    (void)pthread_mutex_lock(&history->lock);
+    HistoryEntry *entry = find_entry(history, input_path, path_hash);
+    if (entry == NULL) {
+        entry = add_entry(history, input_path, path_hash);
+    }
+    if (entry != NULL) {
+        entry->size        = size;
+        entry->duration_ns = duration_ns;
+        entry->recorded    = 1;
+    }
+    (void)pthread_mutex_unlock(&history->lock);
+}
+
+int job_history_save(JobHistory *history) {
+    if (history == NULL) {
+        return 0;
+    }
+    if (history->path == NULL) {
+        return 1;
+    }
+
+    char  *text = NULL;
+    size_t size = 0U;
+    FILE  *out  = open_memstream(&text, &size);
+    if (out == NULL) {
+        return 0;
+    }
+
+    (void)pthread_mutex_lock(&history->lock);
+    fprintf(out, HISTORY_FORMAT_TAG "\n");
+    size_t written = 0U;
+    for (int pass = 1; pass >= 0; --pass) {
+        for (size_t b = 0U; (b < HISTORY_BUCKETS) && (written < JOB_HISTORY_MAX_ENTRIES); ++b) {
+            for (const HistoryEntry *entry = history->buckets[b];
+                 (entry != NULL) && (written < JOB_HISTORY_MAX_ENTRIES); entry = entry->next) {
+                /* a path with a newline cannot be a line of its own */
+                if ((entry->recorded == pass) && (strchr(entry->path, '\n') == NULL)) {
+                    fprintf(out, "D %llu %llu %s\n", (unsigned long long)entry->duration_ns,
+                            entry->size, entry->path);
+                    ++written;
+                }
+            }
+        }
+    }
+    (void)pthread_mutex_unlock(&history->lock);
+
+    int ok = (fclose(out) == 0);
+    ok = ok && (file_io_write_atomic(history->path, text, size) != 0);
+    free(text);
+    return ok;
+}
+
+void job_history_close(JobHistory *history) {
+    if (history == NULL) {
+        return;
+    }
+    clear_entries(history);
+    (void)pthread_mutex_destroy(&history->lock);
+    free(history->path);
+    free(history);
+}
+
+int job_history_plan(const uint64_t cost[], size_t count, size_t n_groups, size_t group_cap,
+                     size_t order[], size_t group_len[]) {
+    if ((n_groups == 0U) || (group_cap == 0U) || (count > n_groups * group_cap)) {
+        return 0;
+    }
+
+    size_t     n_items = (count > n_groups) ? count : n_groups;
+    uint64_t  *items   = (uint64_t *)malloc(n_items * 2U * sizeof(uint64_t));
+    size_t    *members = (size_t *)malloc((n_groups * group_cap) * sizeof(size_t));
+    PlanGroup *heap    = (PlanGroup *)malloc(n_groups * sizeof(PlanGroup));
+    PlanGroup *done    = (PlanGroup *)malloc(n_groups * sizeof(PlanGroup));
+    if ((items == NULL) || (members == NULL) || (heap == NULL) || (done == NULL)) {
+        free(items);
+        free(members);
+        free(heap);
+        free(done);
+        return 0;
+    }
+
+    for (size_t i = 0U; i < count; ++i) {
+        items[2U * i]      = cost[i];
+        items[2U * i + 1U] = (uint64_t)i;
+    }
+    qsort(items, count, 2U * sizeof(uint64_t), compare_cost_desc);
+
+    /* Every group starts empty, so the heap is ordered by id alone */
+    for (size_t g = 0U; g < n_groups; ++g) {
+        heap[g] = (PlanGroup){0U, 0U, g};
+    }
+    size_t n_open = n_groups;
+    size_t n_done = 0U;
+    for (size_t i = 0U; i < count; ++i) {
+        PlanGroup *cheapest = &heap[0];
+        members[cheapest->id * group_cap + cheapest->len++] = (size_t)items[2U * i + 1U];
+        cheapest->load += items[2U * i];
+        if (cheapest->len == group_cap) {
+            done[n_done++] = *cheapest;
+            heap[0]        = heap[--n_open];
+        }
+        heap_sift_down(heap, n_open, 0U);
+    }
+    for (size_t g = 0U; g < n_open; ++g) {
+        done[n_done++] = heap[g];
+    }
+
+    /* Costliest group first; reuse items as (load, id) pairs */
+    for (size_t g = 0U; g < n_groups; ++g) {
+        items[2U * g]      = done[g].load;
+        items[2U * g + 1U] = (uint64_t)g;
+    }
+    qsort(items, n_groups, 2U * sizeof(uint64_t), compare_cost_desc);
+
+    size_t k = 0U;
+    for (size_t g = 0U; g < n_groups; ++g) {
+        const PlanGroup *group = &done[items[2U * g + 1U]];
+        memcpy(&order[k], &members[group->id * group_cap], group->len * sizeof(size_t));
+        group_len[g] = group->len;
+        k += group->len;
+    }
+
+    free(items);
+    free(members);
+    free(heap);
+    free(done);
+    return 1;
+}
@@ -0,0 +1,62 @@
+/*
+ * FILE: job_history.h
+ * DESC.: this file is the declaration of the per-file duration history and longest-first planner
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_JOB_HISTORY_H
+#define CPLUS_JOB_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Entries written back; the ones recorded by the current run come first */
+#define JOB_HISTORY_MAX_ENTRIES 65536U
+
+/* Cost of one byte of an unseen input while the history knows no rate */
+#define JOB_HISTORY_DEFAULT_NS_PER_BYTE 1000ULL
+
+/*
+ * How long each input of earlier runs took to transpile, kept in a file (one
+ * per working directory, like the incremental manifest) so the next run can
+ * start the costliest inputs first. Thread-safe.
+ */
+typedef struct JobHistory JobHistory;
+
+/*
+ * Load the history at path; a missing or malformed file is an empty history,
+ * and a NULL path keeps it in memory only. NULL on allocation failure.
+ */
+JobHistory* job_history_open(const char* path);
+
+/*
+ * Expected duration of input_path in nanoseconds: the last one recorded for
+ * it, or size times the rate the history has seen over all its inputs
+ * (JOB_HISTORY_DEFAULT_NS_PER_BYTE while it has none). history may be NULL.
+ */
+uint64_t job_history_estimate(const JobHistory* history, const char* input_path,
+                              unsigned long long size);
+
+/* Remember the duration of input_path (size bytes) for the next run */
+void job_history_record(JobHistory* history, const char* input_path, unsigned long long size,
+                        uint64_t duration_ns);
+
+/* Atomically rewrite the file; 1 on success, and for an in-memory history */
+int job_history_save(JobHistory* history);
+
+void job_history_close(JobHistory* history);
+
+/*
+ * Longest-processing-time-first grouping: deals count items, costliest first,
+ * each into the cheapest of n_groups groups that still has room for it
+ * (group_cap each, n_groups x group_cap >= count). Writes the item indices to
+ * order[] one group after the other, the costliest group first, and each
+ * group's length to group_len[]. Returns 0 on allocation failure or when the
+ * items do not fit.
+ */
+int job_history_plan(const uint64_t cost[], size_t count, size_t n_groups, size_t group_cap,
+                     size_t order[], size_t group_len[]);
+
+#endif // CPLUS_JOB_HISTORY_H
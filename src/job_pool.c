@@ -0,0 +1,235 @@
+/*
+ * FILE: job_pool.c
+ * DESC.: fixed-size worker thread pool used to run pipeline jobs concurrently
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "job_pool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    JobFn fn;
+    void* arg;
+} Job;
+
+/*
+ * Jobs live in a ring buffer [head, head + count) modulo capacity.
+ * All fields are protected by `lock`.
+ */
+struct JobPool {
+    pthread_mutex_t lock;
+    pthread_cond_t  has_work;   /* signalled on submit and on shutdown */
+    pthread_cond_t  idle;       /* signalled when count == 0 && active == 0 */
+    Job*            queue;
+    size_t          head;
+    size_t          count;
+    size_t          capacity;
+    size_t          active;     /* jobs currently executing */
+    int             shutting_down;
+    pthread_t*      workers;
+    size_t          n_workers;
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/* Double the ring buffer, unrolling it so the oldest job lands at index 0 */
+static int queue_grow(JobPool *pool) {
+    size_t new_cap = (pool->capacity == 0U) ? 64U : pool->capacity * 2U;
+    Job *resized = (Job *)malloc(new_cap * sizeof(Job));
+    if (resized == NULL) {
+        return 0;
+    }
+
+    for (size_t i = 0U; i < pool->count; ++i) {
+        resized[i] = pool->queue[(pool->head + i) % pool->capacity];
+    }
+
+    free(pool->queue);
+    pool->queue    = resized;
+    pool->head     = 0U;
+    pool->capacity = new_cap;
+    return 1;
+}
+
+static void *worker_main(void *arg) {
+    JobPool *pool = (JobPool *)arg;
+
+    (void)pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while ((pool->count == 0U) && (pool->shutting_down == 0)) {
+            (void)pthread_cond_wait(&pool->has_work, &pool->lock);
+        }
+
+        if (pool->count == 0U) {
+            break; /* shutting down and nothing left to do */
+        }
+
+        Job job = pool->queue[pool->head];
+        pool->head = (pool->head + 1U) % pool->capacity;
+        pool->count--;
+        pool->active++;
+        (void)pthread_mutex_unlock(&pool->lock);
+
+        job.fn(job.arg);
+
+        (void)pthread_mutex_lock(&pool->lock);
+        pool->active--;
+        if ((pool->count == 0U) && (pool->active == 0U)) {
+            (void)pthread_cond_broadcast(&pool->idle);
+        }
+    }
+    (void)pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+size_t job_pool_default_workers(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return (online > 0L) ? (size_t)online : 1U;
+}
+
+unsigned long long job_pool_available_memory(void) {
+    FILE *fp = fopen("/proc/meminfo", "r");
+    if (fp == NULL) {
+        return 0ULL;
+    }
+
+    /* "MemAvailable:   12345678 kB"; older kernels lack it and give 0 */
+    char               line[128];
+    unsigned long long kib = 0ULL;
+    while (fgets(line, (int)sizeof(line), fp) != NULL) {
+        if (strncmp(line, "MemAvailable:", 13U) == 0) {
+            if (sscanf(line + 13, "%llu", &kib) != 1) {
+                kib = 0ULL;
+            }
+            break;
+        }
+    }
+    (void)fclose(fp);
+    return kib * 1024ULL;
+}
+
+size_t job_pool_memory_workers(size_t n_workers, unsigned long long bytes_per_worker) {
+    unsigned long long available = (bytes_per_worker > 0ULL) ? job_pool_available_memory() : 0ULL;
+    if (available == 0ULL) {
+        return n_workers;
+    }
+    unsigned long long fit = available / bytes_per_worker;
+    if (fit < 1ULL) {
+        fit = 1ULL;
+    }
+    return ((unsigned long long)n_workers > fit) ? (size_t)fit : n_workers;
+}
+
+JobPool *job_pool_create(size_t n_workers) {
+    if (n_workers == 0U) {
+        n_workers = job_pool_default_workers();
+    }
+
+    JobPool *pool = (JobPool *)calloc(1U, sizeof(JobPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->workers = (pthread_t *)calloc(n_workers, sizeof(pthread_t));
+    if (pool->workers == NULL) {
+        free(pool);
+        return NULL;
+    }
+
+    (void)pthread_mutex_init(&pool->lock, NULL);
+    (void)pthread_cond_init(&pool->has_work, NULL);
+    (void)pthread_cond_init(&pool->idle, NULL);
+
+    for (size_t i = 0U; i < n_workers; ++i) {
+        if (pthread_create(&pool->workers[i], NULL, worker_main, pool) != 0) {
+            break;
+        }
+        pool->n_workers++;
+    }
+
+    /* A pool with fewer threads than requested still works; none at all does not */
+    if (pool->n_workers == 0U) {
+        job_pool_destroy(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+int job_pool_submit(JobPool *pool, JobFn fn, void *arg) {
+    if ((pool == NULL) || (fn == NULL)) {
+        return 0;
+    }
+
+    (void)pthread_mutex_lock(&pool->lock);
+
+    if ((pool->count == pool->capacity) && (queue_grow(pool) == 0)) {
+        (void)pthread_mutex_unlock(&pool->lock);
+        return 0;
+    }
+
+    pool->queue[(pool->head + pool->count) % pool->capacity] = (Job){fn, arg};
+    pool->count++;
+    (void)pthread_cond_signal(&pool->has_work);
+
+    (void)pthread_mutex_unlock(&pool->lock);
+    return 1;
+}
+
+void job_pool_wait(JobPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    (void)pthread_mutex_lock(&pool->lock);
+    while ((pool->count > 0U) || (pool->active > 0U)) {
+        (void)pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    (void)pthread_mutex_unlock(&pool->lock);
+}
+
+void job_pool_destroy(JobPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    (void)pthread_mutex_lock(&pool->lock);
+    pool->shutting_down = 1;
+    (void)pthread_cond_broadcast(&pool->has_work);
+    (void)pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0U; i < pool->n_workers; ++i) {
+        (void)pthread_join(pool->workers[i], NULL);
+    }
+
+    (void)pthread_cond_destroy(&pool->idle);
+    (void)pthread_cond_destroy(&pool->has_work);
+    (void)pthread_mutex_destroy(&pool->lock);
+
+    free(pool->workers);
+    free(pool->queue);
+    free(pool);
+}
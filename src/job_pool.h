@@ -0,0 +1,44 @@
+/*
+ * FILE: job_pool.h
+ * DESC.: this file is the declaration of the fixed-size worker thread pool
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_JOB_POOL_H
+#define CPLUS_JOB_POOL_H
+
+#include <stddef.h>
+
+typedef void (*JobFn)(void* arg);
+
+/* Opaque pool of worker threads consuming a FIFO job queue */
+typedef struct JobPool JobPool;
+
+/* Number of online CPUs, never less than 1 */
+size_t job_pool_default_workers(void);
+
+/* MemAvailable from /proc/meminfo in bytes, or 0 when it cannot be read */
+unsigned long long job_pool_available_memory(void);
+
+/*
+ * n_workers lowered so that n_workers x bytes_per_worker fits in the
+ * available memory (never below 1); unchanged when that is unknown or
+ * bytes_per_worker is 0.
+ */
+size_t job_pool_memory_workers(size_t n_workers, unsigned long long bytes_per_worker);
+
+/* Start n_workers threads (0 selects job_pool_default_workers()); NULL on failure */
+JobPool* job_pool_create(size_t n_workers);
+
+/* Queue fn(arg) for execution. Returns 1 on success, 0 on allocation failure. */
+int job_pool_submit(JobPool* pool, JobFn fn, void* arg);
+
+/* Block until the queue is empty and no job is running */
+void job_pool_wait(JobPool* pool);
+
+/* Drain pending jobs, join every worker and free the pool */
+void job_pool_destroy(JobPool* pool);
+
+#endif // CPLUS_JOB_POOL_H
@@ -0,0 +1,388 @@
+/*
+ * FILE: json.c
+ * DESC.: small recursive-descent JSON reader for compiler diagnostics
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "json.h"
+
+#include <limits.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_MAX_DEPTH 64
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    const char* p;
+    const char* end;
+    Arena*      arena;
+    int         depth;
+} JsonReader;
+
+/* Members collected while an array or object is open, moved to the arena at ']'/'}' */
+typedef struct {
+    JsonValue*   items;
+    const char** keys;
+    size_t       count;
+    size_t       capacity;
+} JsonMembers;
+
+static int parse_value(JsonReader *r, JsonValue *out);
+
+static void skip_ws(JsonReader *r) {
+    while ((r->p < r->end) &&
+           ((*r->p == ' ') || (*r->p == '\t') || (*r->p == '\n') || (*r->p == '\r'))) {
+        ++r->p;
+    }
+}
+
+static int expect_literal(JsonReader *r, const char *word, size_t len) {
+    if (((size_t)(r->end - r->p) < len) || (memcmp(r->p, word, len) != 0)) {
+        return 0;
+    }
+    r->p += len;
+    return 1;
+}
+
+static int hex4(const char *p, unsigned *out) {
+    unsigned v = 0U;
+    for (int i = 0; i < 4; ++i) {
+        char c = p[i];
+        v <<= 4U;
+        if ((c >= '0') && (c <= '9')) {
+            v |= (unsigned)(c - '0');
+        } else if ((c >= 'a') && (c <= 'f')) {
+            v |= (unsigned)(c - 'a' + 10);
+        } else if ((c >= 'A') && (c <= 'F')) {
+            v |= (unsigned)(c - 'A' + 10);
+        } else {
+            return 0;
+        }
+    }
+    *out = v;
+    return 1;
+}
+
+static char *put_utf8(char *out, unsigned cp) {
+    if (cp < 0x80U) {
+        *out++ = (char)cp;
+    } else if (cp < 0x800U) {
+        *out++ = (char)(0xC0U | (cp >> 6U));
+        *out++ = (char)(0x80U | (cp & 0x3FU));
+    } else if (cp < 0x10000U) {
+        *out++ = (char)(0xE0U | (cp >> 12U));
+        *out++ = (char)(0x80U | ((cp >> 6U) & 0x3FU));
+        *out++ = (char)(0x80U | (cp & 0x3FU));
+    } else {
+        *out++ = (char)(0xF0U | (cp >> 18U));
+        *out++ = (char)(0x80U | ((cp >> 12U) & 0x3FU));
+        *out++ = (char)(0x80U | ((cp >> 6U) & 0x3FU));
+        *out++ = (char)(0x80U | (cp & 0x3FU));
+    }
+    return out;
+}
+
+/* r->p is on the opening quote; the decoded text is never longer than the raw one */
+static const char *parse_string(JsonReader *r) {
+    const char *start = ++r->p;
+    const char *close = start;
+    while ((close < r->end) && (*close != '"')) {
+        close += ((*close == '\\') && (close + 1 < r->end)) ? 2 : 1;
+    }
+    if (close >= r->end) {
+        return NULL;
+    }
+
+    char *copy = (char *)arena_alloc(r->arena, (size_t)(close - start) + 1U, 1U);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    char *out = copy;
+    for (const char *p = start; p < close;) {
+        if ((unsigned char)*p < 0x20U) {
+            return NULL;
+        }
+        if (*p != '\\') {
+            *out++ = *p++;
+            continue;
+        }
+
+        char esc = p[1];
+        p += 2;
+        switch (esc) {
+        case '"':  *out++ = '"';  break;
+        case '\\': *out++ = '\\'; break;
+        case '/':  *out++ = '/';  break;
+        case 'b':  *out++ = '\b'; break;
+        case 'f':  *out++ = '\f'; break;
+        case 'n':  *out++ = '\n'; break;
+        case 'r':  *out++ = '\r'; break;
+        case 't':  *out++ = '\t'; break;
+        case 'u': {
+            unsigned cp = 0U;
+            if ((close - p < 4) || (hex4(p, &cp) == 0)) {
+                return NULL;
+            }
+            p += 4;
+            /* A high surrogate followed by "\uDC00".."\uDFFF" is one code point */
+            unsigned low = 0U;
+            if ((cp >= 0xD800U) && (cp <= 0xDBFFU) && (close - p >= 6) &&
+                (p[0] == '\\') && (p[1] == 'u') && (hex4(p + 2, &low) != 0) &&
+                (low >= 0xDC00U) && (low <= 0xDFFFU)) {
+                cp = 0x10000U + ((cp - 0xD800U) << 10U) + (low - 0xDC00U);
+                p += 6;
+            }
+            out = put_utf8(out, cp);
+            break;
+        }
+        default:
+            return NULL;
+        }
+    }
+    *out = '\0';
+
+    r->p = close + 1;
+    return copy;
+}
+
+static int parse_number(JsonReader *r, double *out) {
+    const char *start = r->p;
+    const char *p = start;
+
+    if ((p < r->end) && (*p == '-')) {
+        ++p;
+    }
+    const char *digits = p;
+    while ((p < r->end) && (*p >= '0') && (*p <= '9')) {
+        ++p;
+    }
+    if (p == digits) {
+        return 0;
+    }
+    if ((p < r->end) && (*p == '.')) {
+        const char *frac = ++p;
+        while ((p < r->end) && (*p >= '0') && (*p <= '9')) {
+            ++p;
+        }
+        if (p == frac) {
+            return 0;
+        }
+    }
+    if ((p < r->end) && ((*p == 'e') || (*p == 'E'))) {
+        ++p;
+        if ((p < r->end) && ((*p == '+') || (*p == '-'))) {
+            ++p;
+        }
+        const char *exp = p;
+        while ((p < r->end) && (*p >= '0') && (*p <= '9')) {
+            ++p;
+        }
+        if (p == exp) {
+            return 0;
+        }
+    }
+
+    /* strtod() needs a terminator the input does not promise */
+    char   buf[64];
+    size_t len = (size_t)(p - start);
+    if (len >= sizeof(buf)) {
+        return 0;
+    }
+    memcpy(buf, start, len);
+    buf[len] = '\0';
+
+    *out = strtod(buf, NULL);
+    r->p = p;
+    return 1;
+}
+
+static int members_push(JsonMembers *m, const char *key, const JsonValue *value) {
+    if (m->count >= m->capacity) {
+        size_t new_cap = (m->capacity == 0U) ? 8U : m->capacity * 2U;
+        JsonValue *items = (JsonValue *)realloc(m->items, new_cap * sizeof(JsonValue));
+        if (items == NULL) {
+            return 0;
+        }
+        m->items = items;
+        const char **keys = (const char **)realloc(m->keys, new_cap * sizeof(const char *));
+        if (keys == NULL) {
+            return 0;
+        }
+        m->keys = keys;
+        m->capacity = new_cap;
+    }
+    m->items[m->count] = *value;
+    m->keys[m->count]  = key;
+    ++m->count;
+    return 1;
+}
+
+/* Move the collected members into the arena-owned value */
+static int members_finish(JsonReader *r, JsonMembers *m, JsonValue *out) {
+    out->count = m->count;
+    if (m->count == 0U) {
+        return 1;
+    }
+
+    JsonValue *items =
+        (JsonValue *)arena_alloc(r->arena, m->count * sizeof(JsonValue), alignof(JsonValue));
+    if (items == NULL) {
+        return 0;
+    }
+    memcpy(items, m->items, m->count * sizeof(JsonValue));
+    out->items = items;
+
+    if (out->type == JSON_OBJECT) {
+        const char **keys = (const char **)arena_alloc(r->arena, m->count * sizeof(const char *),
+                                                       alignof(const char *));
+        if (keys == NULL) {
+            return 0;
+        }
+        memcpy(keys, m->keys, m->count * sizeof(const char *));
+        out->keys = keys;
+    }
+    return 1;
+}
+
+/* r->p is on '[' or '{' */
+static int parse_container(JsonReader *r, JsonValue *out) {
+    int  is_object = (*r->p == '{');
+    char close     = is_object ? '}' : ']';
+
+    if (++r->depth > JSON_MAX_DEPTH) {
+        return 0;
+    }
+    ++r->p;
+    out->type = is_object ? JSON_OBJECT : JSON_ARRAY;
+
+    JsonMembers m  = {NULL, NULL, 0U, 0U};
+    int         ok = 1;
+
+    skip_ws(r);
+    if ((r->p < r->end) && (*r->p == close)) {
+        ++r->p;
+    } else {
+        for (;;) {
+            const char *key = NULL;
+            if (is_object) {
+                skip_ws(r);
+                ok = (r->p < r->end) && (*r->p == '"') && ((key = parse_string(r)) != NULL);
+                if (ok != 0) {
+                    skip_ws(r);
+                    ok = (r->p < r->end) && (*r->p == ':');
+                    r->p += (ok != 0) ? 1 : 0;
+                }
+            }
+
+            JsonValue value;
+            ok = (ok != 0) && (parse_value(r, &value) != 0) && (members_push(&m, key, &value) != 0);
+            if (ok == 0) {
+                break;
+            }
+
+            skip_ws(r);
+            if ((r->p < r->end) && (*r->p == ',')) {
+                ++r->p;
+                continue;
+            }
+            ok = (r->p < r->end) && (*r->p == close);
+            r->p += (ok != 0) ? 1 : 0;
+            break;
+        }
+    }
+
+    ok = (ok != 0) && (members_finish(r, &m, out) != 0);
+    free(m.items);
+    free(m.keys);
+    --r->depth;
+    return ok;
+}
+
+static int parse_value(JsonReader *r, JsonValue *out) {
+    *out = (JsonValue){JSON_NULL, 0U, 0.0, NULL, NULL, NULL};
+
+    skip_ws(r);
+    if (r->p >= r->end) {
+        return 0;
+    }
+
+    switch (*r->p) {
+    case '{':
+    case '[':
+        return parse_container(r, out);
+    case '"':
+        out->type   = JSON_STRING;
+        out->string = parse_string(r);
+        return (out->string != NULL);
+    case 't':
+        out->type   = JSON_BOOL;
+        out->number = 1.0;
+        return expect_literal(r, "true", 4U);
+    case 'f':
+        out->type = JSON_BOOL;
+        return expect_literal(r, "false", 5U);
+    case 'n':
+        return expect_literal(r, "null", 4U);
+    default:
+        out->type = JSON_NUMBER;
+        return parse_number(r, &out->number);
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+const JsonValue *json_parse(Arena *arena, const char *text, size_t len, size_t *consumed) {
+    if ((arena == NULL) || (text == NULL)) {
+        return NULL;
+    }
+
+    JsonValue *root = (JsonValue *)arena_alloc(arena, sizeof(JsonValue), alignof(JsonValue));
+    if (root == NULL) {
+        return NULL;
+    }
+
+    JsonReader r = {text, text + len, arena, 0};
+    if (parse_value(&r, root) == 0) {
+        return NULL;
+    }
+
+    if (consumed != NULL) {
+        *consumed = (size_t)(r.p - text);
+    }
+    return root;
+}
+
+const JsonValue *json_get(const JsonValue *object, const char *key) {
+    if ((object == NULL) || (object->type != JSON_OBJECT) || (key == NULL)) {
+        return NULL;
+    }
+
+    for (size_t i = 0U; i < object->count; ++i) {
+        if (strcmp(object->keys[i], key) == 0) {
+            return &object->items[i];
+        }
+    }
+    return NULL;
+}
+
+const char *json_string(const JsonValue *value) {
+    return ((value != NULL) && (value->type == JSON_STRING)) ? value->string : NULL;
+}
+
+int json_int(const JsonValue *value, int fallback) {
+    if ((value == NULL) || (value->type != JSON_NUMBER) ||
+        (value->number < (double)INT_MIN) || (value->number > (double)INT_MAX)) {
+        return fallback;
+    }
+    return (int)value->number;
+}
@@ -0,0 +1,55 @@
+/*
+ * FILE: json.h
+ * DESC.: this file is the declaration of the arena-backed JSON reader
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_JSON_H
+#define CPLUS_JSON_H
+
+#include "arena.h"
+
+#include <stddef.h>
+
+typedef enum {
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+} JsonType;
+
+/*
+ * A parsed JSON value. Everything, including decoded strings, lives in the
+ * arena passed to json_parse(); nothing is freed one by one.
+ */
+typedef struct JsonValue {
+    JsonType                type;
+    size_t                  count;   // members of an array or object
+    double                  number;  // JSON_NUMBER; 0/1 for JSON_BOOL
+    const char*             string;  // JSON_STRING, UTF-8 and NUL-terminated
+    const char**            keys;    // JSON_OBJECT: count keys, in input order
+    const struct JsonValue* items;   // JSON_ARRAY/JSON_OBJECT: count values
+} JsonValue;
+
+/*
+ * Parse one JSON value (RFC 8259) from text[0..len), skipping leading
+ * whitespace. *consumed receives the bytes used, so several documents can be
+ * read back to back. NULL on a syntax error, nesting deeper than 64 levels or
+ * allocation failure.
+ */
+const JsonValue* json_parse(Arena* arena, const char* text, size_t len, size_t* consumed);
+
+/* Member `key` of an object, or NULL when absent or value is not an object */
+const JsonValue* json_get(const JsonValue* object, const char* key);
+
+/* The string of a JSON_STRING value, or NULL for anything else */
+const char* json_string(const JsonValue* value);
+
+/* A JSON_NUMBER as int, or fallback for anything else */
+int json_int(const JsonValue* value, int fallback);
+
+#endif // CPLUS_JSON_H
@@ -0,0 +1,467 @@
+/*
+ * FILE: lexer.c
+ * DESC.: single-pass C23 lexer into a struct-of-arrays token buffer
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "lexer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Keyword perfect hash
+ * ---------------------------------------------------------------------- */
+
+static const char *const k_kind_names[TOK_KIND_COUNT] = {
+    [TOK_EOF]                  = "end of file",
+    [TOK_IDENTIFIER]           = "identifier",
+    [TOK_NUMBER]               = "number",
+    [TOK_CHAR]                 = "character constant",
+    [TOK_STRING]               = "string literal",
+    [TOK_PUNCT]                = "punctuator",
+    [TOK_OTHER]                = "stray character",
+    [TOK_UNTERMINATED_CHAR]    = "unterminated character constant",
+    [TOK_UNTERMINATED_STRING]  = "unterminated string literal",
+    [TOK_UNTERMINATED_COMMENT] = "unterminated comment",
+    [TOK_KW_ALIGNAS] = "alignas",
+    [TOK_KW_ALIGNOF] = "alignof",
+    [TOK_KW_AUTO] = "auto",
+    [TOK_KW_BOOL] = "bool",
+    [TOK_KW_BREAK] = "break",
+    [TOK_KW_CASE] = "case",
+    [TOK_KW_CHAR] = "char",
+    [TOK_KW_CONST] = "const",
+    [TOK_KW_CONSTEXPR] = "constexpr",
+    [TOK_KW_CONTINUE] = "continue",
+    [TOK_KW_DEFAULT] = "default",
+    [TOK_KW_DO] = "do",
+    [TOK_KW_DOUBLE] = "double",
+    [TOK_KW_ELSE] = "else",
+    [TOK_KW_ENUM] = "enum",
+    [TOK_KW_EXTERN] = "extern",
+    [TOK_KW_FALSE] = "false",
+    [TOK_KW_FLOAT] = "float",
+    [TOK_KW_FOR] = "for",
+    [TOK_KW_GOTO] = "goto",
+    [TOK_KW_IF] = "if",
+    [TOK_KW_INLINE] = "inline",
+    [TOK_KW_INT] = "int",
+    [TOK_KW_LONG] = "long",
+    [TOK_KW_NULLPTR] = "nullptr",
+    [TOK_KW_REGISTER] = "register",
+    [TOK_KW_RESTRICT] = "restrict",
+    [TOK_KW_RETURN] = "return",
+    [TOK_KW_SHORT] = "short",
+    [TOK_KW_SIGNED] = "signed",
+    [TOK_KW_SIZEOF] = "sizeof",
+    [TOK_KW_STATIC] = "static",
+    [TOK_KW_STATIC_ASSERT] = "static_assert",
+    [TOK_KW_STRUCT] = "struct",
+    [TOK_KW_SWITCH] = "switch",
+    [TOK_KW_THREAD_LOCAL] = "thread_local",
+    [TOK_KW_TRUE] = "true",
+    [TOK_KW_TYPEDEF] = "typedef",
+    [TOK_KW_TYPEOF] = "typeof",
+    [TOK_KW_TYPEOF_UNQUAL] = "typeof_unqual",
+    [TOK_KW_UNION] = "union",
+    [TOK_KW_UNSIGNED] = "unsigned",
+    [TOK_KW_VOID] = "void",
+    [TOK_KW_VOLATILE] = "volatile",
+    [TOK_KW_WHILE] = "while",
+    [TOK_KW__ALIGNAS] = "_Alignas",
+    [TOK_KW__ALIGNOF] = "_Alignof",
+    [TOK_KW__ATOMIC] = "_Atomic",
+    [TOK_KW__BITINT] = "_BitInt",
+    [TOK_KW__BOOL] = "_Bool",
+    [TOK_KW__COMPLEX] = "_Complex",
+    [TOK_KW__DECIMAL128] = "_Decimal128",
+    [TOK_KW__DECIMAL32] = "_Decimal32",
+    [TOK_KW__DECIMAL64] = "_Decimal64",
+    [TOK_KW__GENERIC] = "_Generic",
+    [TOK_KW__IMAGINARY] = "_Imaginary",
+    [TOK_KW__NORETURN] = "_Noreturn",
+    [TOK_KW__STATIC_ASSERT] = "_Static_assert",
+    [TOK_KW__THREAD_LOCAL] = "_Thread_local",
+};
+
+/*
+ * (first byte, second byte, last byte, length) packed into 32 bits is unique
+ * among the C23 keywords, and multiplying by KEYWORD_HASH_MUL keeps the top
+ * 7 bits unique too, so one probe of a 128-slot table and one memcmp() decide.
+ * Regenerate the table when the keyword set changes.
+ */
+#define KEYWORD_HASH_MUL   0x28E21BDFU
+#define KEYWORD_HASH_SHIFT 25U
+#define KEYWORD_MAX_LEN    14U
+
+static const uint8_t k_keyword_slots[1U << (32U - KEYWORD_HASH_SHIFT)] = {
+    [1] = TOK_KW_RESTRICT,
+    [2] = TOK_KW_SWITCH,
+    [7] = TOK_KW_GOTO,
+    [9] = TOK_KW__ALIGNAS,
+    [10] = TOK_KW_ALIGNOF,
+    [12] = TOK_KW_CONSTEXPR,
+    [18] = TOK_KW_INLINE,
+    [21] = TOK_KW_INT,
+    [22] = TOK_KW_UNION,
+    [24] = TOK_KW__BITINT,
+    [26] = TOK_KW_SHORT,
+    [27] = TOK_KW_WHILE,
+    [28] = TOK_KW_SIGNED,
+    [29] = TOK_KW_DOUBLE,
+    [32] = TOK_KW_VOID,
+    [38] = TOK_KW__STATIC_ASSERT,
+    [40] = TOK_KW_FALSE,
+    [41] = TOK_KW_EXTERN,
+    [44] = TOK_KW_BREAK,
+    [45] = TOK_KW_FOR,
+    [48] = TOK_KW__COMPLEX,
+    [49] = TOK_KW__DECIMAL32,
+    [51] = TOK_KW_AUTO,
+    [53] = TOK_KW_NULLPTR,
+    [55] = TOK_KW_SIZEOF,
+    [57] = TOK_KW__THREAD_LOCAL,
+    [58] = TOK_KW__ATOMIC,
+    [61] = TOK_KW_TYPEOF_UNQUAL,
+    [63] = TOK_KW_ALIGNAS,
+    [68] = TOK_KW__IMAGINARY,
+    [72] = TOK_KW_CHAR,
+    [74] = TOK_KW__BOOL,
+    [75] = TOK_KW_THREAD_LOCAL,
+    [76] = TOK_KW_TYPEDEF,
+    [77] = TOK_KW__DECIMAL64,
+    [78] = TOK_KW_RETURN,
+    [80] = TOK_KW__GENERIC,
+    [81] = TOK_KW_ENUM,
+    [83] = TOK_KW__ALIGNOF,
+    [84] = TOK_KW_FLOAT,
+    [86] = TOK_KW_STRUCT,
+    [88] = TOK_KW_TRUE,
+    [89] = TOK_KW_UNSIGNED,
+    [90] = TOK_KW_IF,
+    [93] = TOK_KW_TYPEOF,
+    [99] = TOK_KW_STATIC_ASSERT,
+    [101] = TOK_KW_REGISTER,
+    [104] = TOK_KW_CONTINUE,
+    [105] = TOK_KW_STATIC,
+    [106] = TOK_KW_CONST,
+    [107] = TOK_KW_DO,
+    [108] = TOK_KW_VOLATILE,
+    [112] = TOK_KW__NORETURN,
+    [115] = TOK_KW_DEFAULT,
+    [116] = TOK_KW__DECIMAL128,
+    [119] = TOK_KW_BOOL,
+    [123] = TOK_KW_CASE,
+    [126] = TOK_KW_LONG,
+    [127] = TOK_KW_ELSE,
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static int is_ident_start(unsigned char c) {
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || (c == '_') || (c == '$') ||
+           (c >= 0x80U);
+}
+
+static int is_ident_char(unsigned char c) {
+    return is_ident_start(c) || ((c >= '0') && (c <= '9'));
+}
+
+static int is_digit(unsigned char c) {
+    return (c >= '0') && (c <= '9');
+}
+
+static int token_push(TokenBuffer *tokens, TokenKind kind, uint8_t flags, size_t offset,
+                      size_t length) {
+    if (tokens->count >= tokens->capacity) {
+        size_t new_cap = (tokens->capacity < 256U) ? 256U : tokens->capacity * 2U;
+        uint8_t  *kinds   = (uint8_t *)realloc(tokens->kinds, new_cap);
+        uint8_t  *flagv   = (kinds != NULL) ? (uint8_t *)realloc(tokens->flags, new_cap) : NULL;
+        size_t    words   = new_cap * sizeof(uint32_t);
+        uint32_t *offsets = (flagv != NULL) ? (uint32_t *)realloc(tokens->offsets, words) : NULL;
+        uint32_t *lengths = (offsets != NULL) ? (uint32_t *)realloc(tokens->lengths, words) : NULL;
+
+        /* Keep whatever was resized so token_buffer_free() sees valid pointers */
+        tokens->kinds   = (kinds != NULL) ? kinds : tokens->kinds;
+        tokens->flags   = (flagv != NULL) ? flagv : tokens->flags;
+        tokens->offsets = (offsets != NULL) ? offsets : tokens->offsets;
+        tokens->lengths = (lengths != NULL) ? lengths : tokens->lengths;
+        if (lengths == NULL) {
+            return 0;
+        }
+        tokens->capacity = new_cap;
+    }
+
+    size_t i = tokens->count++;
+    tokens->kinds[i]   = (uint8_t)kind;
+    tokens->flags[i]   = flags;
+    tokens->offsets[i] = (uint32_t)offset;
+    tokens->lengths[i] = (uint32_t)length;
+    return 1;
+}
+
+/* Bytes of the backslash-newline at p ("\\\n" or "\\\r\n"), or 0 */
+static size_t splice_length(const char *p, const char *end) {
+    if ((p[0] != '\\') || (p + 1 >= end)) {
+        return 0U;
+    }
+    if (p[1] == '\n') {
+        return 2U;
+    }
+    return ((p[1] == '\r') && (p + 2 < end) && (p[2] == '\n')) ? 3U : 0U;
+}
+
+/* The newline ending a // comment that starts at p: the first one not spliced away */
+static const char *line_comment_end(const char *p, const char *end) {
+    const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+    while (nl != NULL) {
+        const char *before = nl - 1;
+        if ((before > p) && (*before == '\r')) {
+            --before;
+        }
+        if ((before <= p) || (*before != '\\')) {
+            return nl;
+        }
+        nl = (const char *)memchr(nl + 1, '\n', (size_t)(end - nl - 1));
+    }
+    return end;
+}
+
+/* After the opening quote: the closing quote, or the line end / end of input */
+static const char *scan_literal(const char *p, const char *end, char quote, int *terminated) {
+    while (p < end) {
+        char c = *p;
+        if (c == quote) {
+            *terminated = 1;
+            return p + 1;
+        }
+        if (c == '\n') {
+            break;
+        }
+        /* A line splice or an escape takes the following byte(s) along */
+        size_t splice = splice_length(p, end);
+        if (splice > 0U) {
+            p += splice;
+        } else {
+            p += ((c == '\\') && (p + 1 < end)) ? 2 : 1;
+        }
+    }
+    *terminated = 0;
+    return p;
+}
+
+/* pp-number: digits, letters, '.', signed exponents and C23 digit separators */
+static const char *scan_number(const char *p, const char *end) {
+    while (p < end) {
+        unsigned char c = (unsigned char)*p;
+        if (is_ident_char(c) || (c == '.')) {
+            ++p;
+        } else if (((c == '+') || (c == '-')) &&
+                   ((p[-1] == 'e') || (p[-1] == 'E') || (p[-1] == 'p') || (p[-1] == 'P'))) {
+            ++p;
+        } else if ((c == '\'') && (p + 1 < end) && is_ident_char((unsigned char)p[1])) {
+            p += 2;
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+/* Length of the longest punctuator at p, or 0 */
+static size_t punct_length(const char *p, const char *end) {
+    size_t room = (size_t)(end - p);
+    char   c0   = p[0];
+    char   c1   = (room > 1U) ? p[1] : '\0';
+    char   c2   = (room > 2U) ? p[2] : '\0';
+
+    switch (c0) {
+    case '[': case ']': case '(': case ')': case '{': case '}':
+    case '~': case '?': case ';': case ',':
+        return 1U;
+    case '.':
+        return ((c1 == '.') && (c2 == '.')) ? 3U : 1U;
+    case '-':
+        return ((c1 == '>') || (c1 == '-') || (c1 == '=')) ? 2U : 1U;
+    case '+':
+        return ((c1 == '+') || (c1 == '=')) ? 2U : 1U;
+    case '&':
+        return ((c1 == '&') || (c1 == '=')) ? 2U : 1U;
+    case '|':
+        return ((c1 == '|') || (c1 == '=')) ? 2U : 1U;
+    case '*': case '/': case '!': case '^': case '=':
+        return (c1 == '=') ? 2U : 1U;
+    case '#':
+        return (c1 == '#') ? 2U : 1U;
+    case ':':
+        return ((c1 == ':') || (c1 == '>')) ? 2U : 1U;
+    case '<':
+        if (c1 == '<') {
+            return (c2 == '=') ? 3U : 2U;
+        }
+        return ((c1 == '=') || (c1 == ':') || (c1 == '%')) ? 2U : 1U;
+    case '>':
+        if (c1 == '>') {
+            return (c2 == '=') ? 3U : 2U;
+        }
+        return (c1 == '=') ? 2U : 1U;
+    case '%':
+        if ((c1 == ':') && (c2 == '%') && (room > 3U) && (p[3] == ':')) {
+            return 4U; /* %:%: is ## */
+        }
+        return ((c1 == '=') || (c1 == '>') || (c1 == ':')) ? 2U : 1U;
+    default:
+        return 0U;
+    }
+}
+
+/* An identifier that prefixes a character constant or string literal */
+static int is_literal_prefix(const char *p, size_t len) {
+    return ((len == 1U) && ((p[0] == 'u') || (p[0] == 'U') || (p[0] == 'L'))) ||
+           ((len == 2U) && (p[0] == 'u') && (p[1] == '8'));
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+int lexer_tokenize(const char *source, size_t size, TokenBuffer *tokens) {
+    if ((tokens == NULL) || ((source == NULL) && (size > 0U)) || (size >= UINT32_MAX)) {
+        return 0;
+    }
+    tokens->count = 0U;
+
+    const char *p     = source;
+    const char *end   = source + size;
+    uint8_t     flags = TOKF_LINE_START;
+
+    while (p < end) {
+        unsigned char c = (unsigned char)*p;
+
+        /* --- whitespace, splices and comments: no tokens --- */
+        if (c == '\n') {
+            flags |= TOKF_LINE_START | TOKF_SPACE;
+            ++p;
+            continue;
+        }
+        if ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\f') || (c == '\v')) {
+            flags |= TOKF_SPACE;
+            ++p;
+            continue;
+        }
+        size_t splice = splice_length(p, end);
+        if (splice > 0U) {
+            p += splice;
+            continue;
+        }
+        if ((c == '/') && (p + 1 < end) && (p[1] == '/')) {
+            p = line_comment_end(p, end);
+            flags |= TOKF_SPACE;
+            continue;
+        }
+        if ((c == '/') && (p + 1 < end) && (p[1] == '*')) {
+            const char *q = p + 2;
+            const char *close = NULL;
+            while ((q < end) && ((q = (const char *)memchr(q, '*', (size_t)(end - q))) != NULL)) {
+                if ((q + 1 < end) && (q[1] == '/')) {
+                    close = q + 2;
+                    break;
+                }
+                ++q;
+            }
+            if (close == NULL) {
+                if (token_push(tokens, TOK_UNTERMINATED_COMMENT, flags, (size_t)(p - source),
+                               (size_t)(end - p)) == 0) {
+                    return 0;
+                }
+                flags = 0U;
+                p = end;
+                break;
+            }
+            p = close;
+            flags |= TOKF_SPACE;
+            continue;
+        }
+
+        /* --- tokens --- */
+        const char *start = p;
+        TokenKind   kind  = TOK_OTHER;
+
+        if (is_ident_start(c)) {
+            ++p;
+            while ((p < end) && is_ident_char((unsigned char)*p)) {
+                ++p;
+            }
+            size_t len = (size_t)(p - start);
+            if ((p < end) && ((*p == '\'') || (*p == '"')) && is_literal_prefix(start, len)) {
+                char quote = *p;
+                int  terminated = 0;
+                p = scan_literal(p + 1, end, quote, &terminated);
+                kind = (quote == '"') ? (terminated ? TOK_STRING : TOK_UNTERMINATED_STRING)
+                                      : (terminated ? TOK_CHAR : TOK_UNTERMINATED_CHAR);
+            } else {
+                kind = lexer_keyword(start, len);
+            }
+        } else if (is_digit(c) || ((c == '.') && (p + 1 < end) && is_digit((unsigned char)p[1]))) {
+            p = scan_number(p + 1, end);
+            kind = TOK_NUMBER;
+        } else if ((c == '"') || (c == '\'')) {
+            int terminated = 0;
+            p = scan_literal(p + 1, end, (char)c, &terminated);
+            kind = (c == '"') ? (terminated ? TOK_STRING : TOK_UNTERMINATED_STRING)
+                              : (terminated ? TOK_CHAR : TOK_UNTERMINATED_CHAR);
+        } else {
+            size_t len = punct_length(p, end);
+            kind = (len > 0U) ? TOK_PUNCT : TOK_OTHER;
+            p += (len > 0U) ? len : 1U;
+        }
+
+        if (token_push(tokens, kind, flags, (size_t)(start - source), (size_t)(p - start)) == 0) {
+            return 0;
+        }
+        flags = 0U;
+    }
+
+    return token_push(tokens, TOK_EOF, flags, size, 0U);
+}
+
+TokenKind lexer_keyword(const char *text, size_t len) {
+    if ((text == NULL) || (len < 2U) || (len > KEYWORD_MAX_LEN)) {
+        return TOK_IDENTIFIER;
+    }
+
+    uint32_t key = (uint32_t)(unsigned char)text[0] |
+                   ((uint32_t)(unsigned char)text[1] << 8U) |
+                   ((uint32_t)(unsigned char)text[len - 1U] << 16U) |
+                   ((uint32_t)len << 24U);
+    uint32_t slot = (uint32_t)(key * KEYWORD_HASH_MUL) >> KEYWORD_HASH_SHIFT;
+
+    TokenKind kind = (TokenKind)k_keyword_slots[slot];
+    if (kind < TOK_KW_FIRST) {
+        return TOK_IDENTIFIER;
+    }
+
+    const char *spelling = k_kind_names[kind];
+    return ((strncmp(spelling, text, len) == 0) && (spelling[len] == '\0')) ? kind : TOK_IDENTIFIER;
+}
+
+const char *lexer_kind_name(TokenKind kind) {
+    return ((unsigned)kind < (unsigned)TOK_KIND_COUNT) ? k_kind_names[kind] : "unknown";
+}
+
+void token_buffer_free(TokenBuffer *tokens) {
+    if (tokens == NULL) {
+        return;
+    }
+
+    free(tokens->kinds);
+    free(tokens->flags);
+    free(tokens->offsets);
+    free(tokens->lengths);
+    *tokens = (TokenBuffer){NULL, NULL, NULL, NULL, 0U, 0U};
+}
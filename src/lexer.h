@@ -0,0 +1,134 @@
+/*
+ * FILE: lexer.h
+ * DESC.: this file is the declaration of the native C23 lexer
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_LEXER_H
+#define CPLUS_LEXER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Token kinds. Keywords get one kind each (TOK_KW_*), found through a
+ * perfect hash; punctuators share TOK_PUNCT and are told apart by their text.
+ * The TOK_UNTERMINATED_* kinds mark a literal cut by the end of the line or a
+ * comment cut by the end of the file; lexing goes on after them.
+ */
+typedef enum {
+    TOK_EOF,
+    TOK_IDENTIFIER,
+    TOK_NUMBER,                /* pp-number, C23 digit separators included */
+    TOK_CHAR,                  /* character constant, any prefix */
+    TOK_STRING,                /* string literal, any prefix */
+    TOK_PUNCT,
+    TOK_OTHER,                 /* a byte that starts no token (e.g. '@') */
+    TOK_UNTERMINATED_CHAR,
+    TOK_UNTERMINATED_STRING,
+    TOK_UNTERMINATED_COMMENT,
+    TOK_KW_ALIGNAS,
+    TOK_KW_ALIGNOF,
+    TOK_KW_AUTO,
+    TOK_KW_BOOL,
+    TOK_KW_BREAK,
+    TOK_KW_CASE,
+    TOK_KW_CHAR,
+    TOK_KW_CONST,
+    TOK_KW_CONSTEXPR,
+    TOK_KW_CONTINUE,
+    TOK_KW_DEFAULT,
+    TOK_KW_DO,
+    TOK_KW_DOUBLE,
+    TOK_KW_ELSE,
+    TOK_KW_ENUM,
+    TOK_KW_EXTERN,
+    TOK_KW_FALSE,
+    TOK_KW_FLOAT,
+    TOK_KW_FOR,
+    TOK_KW_GOTO,
+    TOK_KW_IF,
+    TOK_KW_INLINE,
+    TOK_KW_INT,
+    TOK_KW_LONG,
+    TOK_KW_NULLPTR,
+    TOK_KW_REGISTER,
+    TOK_KW_RESTRICT,
+    TOK_KW_RETURN,
+    TOK_KW_SHORT,
+    TOK_KW_SIGNED,
+    TOK_KW_SIZEOF,
+    TOK_KW_STATIC,
+    TOK_KW_STATIC_ASSERT,
+    TOK_KW_STRUCT,
+    TOK_KW_SWITCH,
+    TOK_KW_THREAD_LOCAL,
+    TOK_KW_TRUE,
+    TOK_KW_TYPEDEF,
+    TOK_KW_TYPEOF,
+    TOK_KW_TYPEOF_UNQUAL,
+    TOK_KW_UNION,
+    TOK_KW_UNSIGNED,
+    TOK_KW_VOID,
+    TOK_KW_VOLATILE,
+    TOK_KW_WHILE,
+    TOK_KW__ALIGNAS,
+    TOK_KW__ALIGNOF,
+    TOK_KW__ATOMIC,
+    TOK_KW__BITINT,
+    TOK_KW__BOOL,
+    TOK_KW__COMPLEX,
+    TOK_KW__DECIMAL128,
+    TOK_KW__DECIMAL32,
+    TOK_KW__DECIMAL64,
+    TOK_KW__GENERIC,
+    TOK_KW__IMAGINARY,
+    TOK_KW__NORETURN,
+    TOK_KW__STATIC_ASSERT,
+    TOK_KW__THREAD_LOCAL,
+    TOK_KIND_COUNT
+} TokenKind;
+
+#define TOK_KW_FIRST TOK_KW_ALIGNAS
+#define TOK_KW_LAST  TOK_KW__THREAD_LOCAL
+
+/* Token flags */
+enum {
+    TOKF_LINE_START = 1U << 0, /* first token of a logical line (splices joined) */
+    TOKF_SPACE      = 1U << 1  /* preceded by whitespace or a comment */
+};
+
+/*
+ * Tokens as parallel arrays (struct of arrays): a scan over kinds touches one
+ * byte per token. offsets/lengths index the source the tokens came from,
+ * which must stay alive. The last token is always TOK_EOF. The arrays grow
+ * geometrically and are kept across lexer_tokenize() calls, so a buffer
+ * reused for many files stops allocating once it is large enough.
+ */
+typedef struct {
+    uint8_t*  kinds;
+    uint8_t*  flags;
+    uint32_t* offsets;
+    uint32_t* lengths;
+    size_t    count;
+    size_t    capacity;
+} TokenBuffer;
+
+/*
+ * Tokenize source[0..size) in one pass, replacing the buffer contents.
+ * Comments and whitespace produce no tokens. Returns 1 on success, 0 on
+ * allocation failure or a source of 4 GiB or more.
+ */
+int lexer_tokenize(const char* source, size_t size, TokenBuffer* tokens);
+
+/* TOK_KW_* for a keyword spelling, TOK_IDENTIFIER otherwise */
+TokenKind lexer_keyword(const char* text, size_t len);
+
+/* Spelling of a keyword kind, or a short description of any other kind */
+const char* lexer_kind_name(TokenKind kind);
+
+void token_buffer_free(TokenBuffer* tokens);
+
+#endif // CPLUS_LEXER_H
@@ -6,66 +6,544 @@
  * DATE: March, 2026
  */
 
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "cache_dir.h"
+#include "compiler_probe.h"
+#include "dep_graph.h"
+#include "hash.h"
+#include "input_list.h"
+#include "job_history.h"
+#include "job_pool.h"
+#include "pch.h"
 #include "pipeline.h"
+#include "server.h"
+#include "trace.h"
+#include "validation_cache.h"
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DEFAULT_BATCH_SIZE 16U
+#define MAX_ORACLES 8U
+
+/* Memory assumed per compiler run without --job-memory, to cap -j on small machines */
+#define DEFAULT_JOB_MEMORY (128ULL * 1024ULL * 1024ULL)
+
+/* One input file and its outcome; owned by its batch, filled in by run_batch() */
+typedef struct {
+    char*       input_path; // owned
+    const char* output_path;
+    char*       owned_output;
+    const char* compiler;
+    const char* std_name;
+    ValidationCache* cache;
+    PipelineStats* stats;
+    int         max_errors;
+    DiagnosticFormat diag_format;
+    int         precheck;
+    int         source_map;
+    Pch*        pch;
+    Trace*      trace;
+    const PipelineOracle* oracles;
+    size_t      n_oracles;
+    SubprocessLimits limits;
+    JobHistory* history;
+    unsigned long long size; /* input bytes, known with a history */
+    uint64_t    expected_ns; /* job_history_estimate() */
+    int         compiled;    /* a compiler validated it (not a cache hit) */
+    size_t      index;       /* position in the input list */
+    long        graph_index; /* input index in the incremental graph, or -1 */
+    int         rc;
+} CliJob;
+
+/*
+ * State shared by the reader (main thread) and the batches it submits. At
+ * most max_in_flight batches exist at once, so memory follows the jobs in
+ * flight rather than the length of the input list.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  batch_done;
+    size_t          in_flight;
+    size_t          max_in_flight;
+    int             exit_code;  /* highest-ranked rc, the last in input order (see exit_rank) */
+    size_t          exit_index;
+    DepGraph*       graph;
+    uint64_t*       worker_busy;  /* expected busy time of each worker so far */
+    size_t          n_busy;
+    uint64_t        estimated_ns; /* expected makespan of the batches submitted */
+    size_t          n_batches;
+} CliRun;
+
+/* Inputs validated by one compiler invocation; the unit of work on the pool */
+typedef struct {
+    CliJob*     jobs;       /* owned, like the batch itself, until it has run */
+    size_t      count;
+    int         buffered;   /* collect diagnostics and flush them per file as one block */
+    CliRun*     run;
+} CliBatch;
 
-#define MAX_INPUTS 256
+/* Serialises the per-file diagnostic blocks written to stderr */
+static pthread_mutex_t g_stderr_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static void print_usage(const char *program_name) {
-    fprintf(stderr, "Usage: %s <file.hplus|file.cplus> [...] [-o <output>] [--cc gcc|clang] [--std c23]\n",
-            program_name);
+    fprintf(stderr, "Usage: %s <file.hplus|file.cplus|@LIST> [...] [--files-from LIST|-] [-r DIR]"
+                    " [--ignore GLOB] [-o <output>]"
+                    " [--cc gcc|clang[,...]] [--std c23[,...]]"
+                    " [-j N] [--cache-dir DIR] [--cache-max-size SIZE] [--no-cache]"
+                    " [--incremental] [--manifest FILE] [--batch-size N] [--stats] [--max-errors N]"
+                    " [--diag-format text|json|sarif|auto] [--precheck] [--source-map] [--no-pch]"
+                    " [--time-report] [--trace FILE] [--job-timeout TIME] [--job-memory SIZE]"
+                    " [--client] [--socket PATH]\n"
+                    "       %s --serve [--socket PATH]\n",
+            program_name, program_name);
+    fprintf(stderr, "  @LIST, --files-from LIST  read input paths from LIST (- = stdin), one per\n"
+                    "                newline- or NUL-terminated entry, streamed into the run\n");
+    fprintf(stderr, "  -r, --recursive DIR  transpile every .cplus/.hplus under DIR, found by a\n"
+                    "                parallel walk while the first files already run\n");
+    fprintf(stderr, "  --ignore GLOB skip walked files and directories matching GLOB (a GLOB with\n"
+                    "                a '/' matches the path below DIR); repeatable\n");
     fprintf(stderr, "  -o <output>   output path; only valid with a single input file\n");
-    fprintf(stderr, "  --cc          compiler to use for validation (default: gcc)\n");
-    fprintf(stderr, "  --std         C standard for validation (default: c23)\n");
-}
-
-/* Replace .hplus -> .h and .cplus -> .c in-place.
- * Returns a newly allocated string; caller must free(). */
-static char *build_default_output_path(const char *input_path) {
-    const char *ext_hplus = ".hplus";
-    const char *ext_cplus = ".cplus";
-    const size_t ext_len  = 6U; /* both extensions are 6 chars */
-
-    size_t input_len = strlen(input_path);
-
-    const char *out_ext   = NULL;
-    size_t      out_ext_len = 0U;
-
-    if ((input_len > ext_len) &&
-        (strcmp(input_path + input_len - ext_len, ext_hplus) == 0)) {
-        out_ext     = ".h";
-        out_ext_len = 2U;
-    } else if ((input_len > ext_len) &&
-               (strcmp(input_path + input_len - ext_len, ext_cplus) == 0)) {
-        out_ext     = ".c";
-        out_ext_len = 2U;
-    } else {
-        /* Unknown extension: append .out */
-        out_ext     = ".out";
-        out_ext_len = 4U;
-    }
-
-    size_t stem_len = (out_ext[1] != 'o') ? (input_len - ext_len) : input_len;
-    char *output_path = (char *)malloc(stem_len + out_ext_len + 1U);
-    if (output_path == NULL) {
+    fprintf(stderr, "  --cc          compiler(s) to use for validation, e.g. gcc,clang\n"
+                    "                (default: gcc)\n");
+    fprintf(stderr, "  --std         C standard(s) for validation, e.g. c17,c23 (default: c23);\n"
+                    "                every --cc x --std pair validates each file, concurrently\n");
+    fprintf(stderr, "  -j, --jobs N  files processed concurrently (default: online CPUs)\n");
+    fprintf(stderr, "  --cache-dir   cache root (default: $XDG_CACHE_HOME/cplus or\n"
+                    "                ~/.cache/cplus)\n");
+    fprintf(stderr, "  --cache-max-size  validation cache bound, e.g. 512M (default: 256M)\n");
+    fprintf(stderr, "  --no-cache    always run the compiler, never reuse validation results\n");
+    fprintf(stderr, "  --job-timeout TIME  stop a compiler run after TIME, e.g. 30, 500ms, 2m\n"
+                    "                (SIGTERM, then SIGKILL); the file fails with exit code 3\n");
+    fprintf(stderr, "  --job-memory SIZE  address-space limit of each compiler run, e.g. 2G; also\n"
+                    "                lowers -j to what the available memory holds\n");
+    fprintf(stderr, "  --incremental only transpile inputs whose source or .hplus includes\n"
+                    "                changed\n");
+    fprintf(stderr, "  --manifest    incremental manifest path (implies --incremental)\n");
+    fprintf(stderr, "  --batch-size N  most files validated by one compiler run\n"
+                    "                (default: 16, 1 = off)\n");
+    fprintf(stderr, "  --stats       print a summary of skipped work to stderr\n");
+    fprintf(stderr, "  --max-errors N  stop validating a file after N errors\n"
+                    "                (default: no limit)\n");
+    fprintf(stderr, "  --diag-format F read compiler diagnostics as text, json or sarif;\n"
+                    "                  auto picks the best the compiler supports\n"
+                    "                  (default: text)\n");
+    fprintf(stderr, "  --precheck    reject unterminated literals/comments and unbalanced\n"
+                    "                delimiters without running the compiler\n");
+    fprintf(stderr, "  --source-map  write <output>.map and report positions through it\n");
+    fprintf(stderr, "  --no-pch      never precompile the include block shared by the inputs\n");
+    fprintf(stderr, "  --time-report print per-stage timings (total, mean, p50/p95/max)\n"
+                    "                to stderr\n");
+    fprintf(stderr, "  --trace FILE  write a Chrome trace-event JSON of the run, one track\n"
+                    "                per worker\n");
+    fprintf(stderr, "  --serve       keep caches warm in a daemon listening on a Unix socket\n"
+                    "                (default: <cache root>/serve/socket)\n");
+    fprintf(stderr, "  --client      hand the invocation to that daemon (also when\n"
+                    "                $CPLUS_SERVER names its socket); runs locally when none\n"
+                    "                is listening\n");
+    fprintf(stderr, "  --socket PATH socket of the daemon (implies --client without --serve)\n");
+}
+
+/* One-line summary for --stats; the counters are final once the pool is gone */
+static void print_stats(size_t n_inputs, size_t n_run, PipelineStats *stats, ValidationCache *cache,
+                        const Pch *pch) {
+    fprintf(stderr, "cplus: %zu inputs, %zu up to date, %zu outputs written, %zu unchanged",
+            n_inputs, n_inputs - n_run,
+            atomic_load(&stats->outputs_written), atomic_load(&stats->outputs_unchanged));
+
+    if (cache != NULL) {
+        size_t hits   = 0U;
+        size_t misses = 0U;
+        validation_cache_counters(cache, &hits, &misses);
+        fprintf(stderr, ", validation cache %zu hits / %zu misses", hits, misses);
+    }
+
+    if (pch != NULL) {
+        size_t hits   = 0U;
+        size_t misses = 0U;
+        pch_counters(pch, &hits, &misses);
+        fprintf(stderr, ", pch of %zu headers (%s) %zu hits / %zu misses", pch_block_size(pch),
+                (pch_was_built(pch) != 0) ? "built" : "reused", hits, misses);
+    }
+    fprintf(stderr, "\n");
+}
+
+/* Parse "<n>[ms|s|m]" (seconds without a suffix) into milliseconds; returns 0 on malformed input */
+static unsigned long long parse_duration_ms(const char *text) {
+    char *end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+    if ((end == text) || (value == 0ULL) || (text[0] == '-')) {
+        return 0ULL;
+    }
+
+    if (strcmp(end, "ms") == 0) {
+        return value;
+    }
+    if ((end[0] == '\0') || (strcmp(end, "s") == 0)) {
+        return value * 1000ULL;
+    }
+    if (strcmp(end, "m") == 0) {
+        return value * 60000ULL;
+    }
+    return 0ULL;
+}
+
+/* Parse "<n>[K|M|G]" into bytes; returns 0 on malformed input */
+static unsigned long long parse_byte_size(const char *text) {
+    char *end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+    if ((end == text) || (value == 0ULL)) {
+        return 0ULL;
+    }
+
+    switch (*end) {
+    case '\0':
+        return value;
+    case 'K': case 'k':
+        value <<= 10;
+        break;
+    case 'M': case 'm':
+        value <<= 20;
+        break;
+    case 'G': case 'g':
+        value <<= 30;
+        break;
+    default:
+        return 0ULL;
+    }
+
+    return (end[1] == '\0') ? value : 0ULL;
+}
+
+/* Parse a strictly positive job count; returns 0 on malformed input */
+static size_t parse_job_count(const char *text) {
+    char *end = NULL;
+    long value = strtol(text, &end, 10);
+    if ((end == text) || (*end != '\0') || (value <= 0L)) {
+        return 0U;
+    }
+    return (size_t)value;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Precedence of an input's rc for the exit status: a validation failure beats
+ * a compiler run cut short by the limits, which beats success.
+ */
+static int exit_rank(int rc) {
+    if (rc == 0) {
+        return 0;
+    }
+    return (rc == PIPELINE_LIMIT_EXCEEDED) ? 1 : 2;
+}
+
+/*
+ * Fold a finished batch into the run and release it: the exit status, the
+ * incremental results and a slot for the reader waiting to submit more.
+ */
+static void finish_batch(CliBatch *batch) {
+    CliRun *run = batch->run;
+
+    (void)pthread_mutex_lock(&run->lock);
+    for (size_t i = 0U; i < batch->count; ++i) {
+        const CliJob *job = &batch->jobs[i];
+        int rank = exit_rank(job->rc);
+        int held = exit_rank(run->exit_code);
+        if ((rank > held) || ((rank != 0) && (rank == held) && (job->index > run->exit_index))) {
+            run->exit_code  = job->rc;
+            run->exit_index = job->index;
+        }
+        if (job->graph_index >= 0L) {
+            dep_graph_set_result(run->graph, job->graph_index, (job->rc == 0) ? 1 : 0);
+        }
+    }
+    --run->in_flight;
+    (void)pthread_cond_signal(&run->batch_done);
+    (void)pthread_mutex_unlock(&run->lock);
+
+    for (size_t i = 0U; i < batch->count; ++i) {
+        free(batch->jobs[i].input_path);
+        free(batch->jobs[i].owned_output);
+    }
+    free(batch->jobs);
+    free(batch);
+}
+
+/*
+ * Worker body: run the pipeline for one batch of files. With more than one
+ * worker each file's diagnostics are captured in a memory stream and written
+ * to stderr under g_stderr_lock, so every report stays one unbroken block.
+ */
+static void run_batch(void *arg) {
+    CliBatch *batch = (CliBatch *)arg;
+
+    PipelineOptions *options = (PipelineOptions *)calloc(batch->count, sizeof(PipelineOptions));
+    int             *rcs     = (int *)calloc(batch->count, sizeof(int));
+    char           **blocks  = (char **)calloc(batch->count, sizeof(char *));
+    size_t          *sizes   = (size_t *)calloc(batch->count, sizeof(size_t));
+
+    if ((options == NULL) || (rcs == NULL) || (blocks == NULL) || (sizes == NULL)) {
+        free(options);
+        free(rcs);
+        free(blocks);
+        free(sizes);
+        for (size_t i = 0U; i < batch->count; ++i) {
+            batch->jobs[i].rc = 1;
+        }
+        fprintf(stderr, "internal runtime error: failed to allocate batch\n");
+        finish_batch(batch);
+        return;
+    }
+
+    for (size_t i = 0U; i < batch->count; ++i) {
+        const CliJob *job = &batch->jobs[i];
+        options[i] = (PipelineOptions){
+            .input_path  = job->input_path,
+            .output_path = job->output_path,
+            .compiler    = job->compiler,
+            .std_name    = job->std_name,
+            .diag_stream = (batch->buffered != 0) ? open_memstream(&blocks[i], &sizes[i]) : NULL,
+            .cache       = job->cache,
+            .stats       = job->stats,
+            .max_errors  = job->max_errors,
+            .diag_format = job->diag_format,
+            .precheck    = job->precheck,
+            .source_map  = job->source_map,
+            .pch         = job->pch,
+            .trace       = job->trace,
+            .oracles     = job->oracles,
+            .n_oracles   = job->n_oracles,
+            .limits      = job->limits,
+            .compiled    = &batch->jobs[i].compiled,
+        };
+    }
+
+    uint64_t started = monotonic_ns();
+    pipeline_run_batch(options, batch->count, rcs);
+    uint64_t elapsed = monotonic_ns() - started;
+
+    /*
+     * The compiler run covers the inputs that missed the cache: each gets its
+     * share by size. Cache hits take next to nothing and keep their previous
+     * duration, which is what they cost once they change.
+     */
+    unsigned long long batch_bytes = 0ULL;
+    size_t             n_compiled  = 0U;
+    for (size_t i = 0U; i < batch->count; ++i) {
+        if (batch->jobs[i].compiled != 0) {
+            batch_bytes += batch->jobs[i].size;
+            ++n_compiled;
+        }
+    }
+    for (size_t i = 0U; i < batch->count; ++i) {
+        const CliJob *job = &batch->jobs[i];
+        if (job->compiled == 0) {
+            continue;
+        }
+        double share = (batch_bytes > 0ULL) ? (double)job->size / (double)batch_bytes
+                                            : 1.0 / (double)n_compiled;
+        job_history_record(job->history, job->input_path, job->size,
+                           (uint64_t)((double)elapsed * share));
+    }
+
+    for (size_t i = 0U; i < batch->count; ++i) {
+        batch->jobs[i].rc = rcs[i];
+
+        if (options[i].diag_stream != NULL) {
+            (void)fclose(options[i].diag_stream);
+            if (sizes[i] > 0U) {
+                (void)pthread_mutex_lock(&g_stderr_lock);
+                (void)fwrite(blocks[i], 1U, sizes[i], stderr);
+                (void)fflush(stderr);
+                (void)pthread_mutex_unlock(&g_stderr_lock);
+            }
+        }
+        free(blocks[i]);
+    }
+
+    free(options);
+    free(rcs);
+    free(blocks);
+    free(sizes);
+    finish_batch(batch);
+}
+
+/* An empty batch for up to capacity jobs; NULL on allocation failure */
+static CliBatch *batch_create(CliRun *run, size_t capacity, int buffered) {
+    CliBatch *batch = (CliBatch *)calloc(1U, sizeof(CliBatch));
+    CliJob   *jobs  = (CliJob *)calloc(capacity, sizeof(CliJob));
+    if ((batch == NULL) || (jobs == NULL)) {
+        free(batch);
+        free(jobs);
         return NULL;
     }
+    batch->jobs     = jobs;
+    batch->buffered = buffered;
+    batch->run      = run;
+    return batch;
+}
+
+/*
+ * Hand a batch to the pool once fewer than max_in_flight are pending; it runs
+ * inline without a pool or when the queue cannot take it. The batch is gone
+ * afterwards.
+ */
+static void submit_batch(JobPool *pool, CliBatch *batch) {
+    CliRun *run = batch->run;
+
+    /* The pool starts batches in submission order, each on the first worker to free up */
+    uint64_t expected = 0U;
+    for (size_t i = 0U; i < batch->count; ++i) {
+        expected += batch->jobs[i].expected_ns;
+    }
+    if (run->n_busy > 0U) {
+        size_t first_free = 0U;
+        for (size_t w = 1U; w < run->n_busy; ++w) {
+            first_free = (run->worker_busy[w] < run->worker_busy[first_free]) ? w : first_free;
+        }
+        run->worker_busy[first_free] += expected;
+        if (run->worker_busy[first_free] > run->estimated_ns) {
+            run->estimated_ns = run->worker_busy[first_free];
+        }
+    }
+    ++run->n_batches;
 
-    memcpy(output_path, input_path, stem_len);
-    memcpy(output_path + stem_len, out_ext, out_ext_len + 1U);
+    (void)pthread_mutex_lock(&run->lock);
+    while (run->in_flight >= run->max_in_flight) {
+        (void)pthread_cond_wait(&run->batch_done, &run->lock);
+    }
+    ++run->in_flight;
+    (void)pthread_mutex_unlock(&run->lock);
 
-    return output_path;
+    if ((pool == NULL) || (job_pool_submit(pool, run_batch, batch) == 0)) {
+        batch->buffered = 0;
+        run_batch(batch);
+    }
 }
 
-int main(int argc, char *argv[]) {
-    const char *inputs[MAX_INPUTS];
-    int         n_inputs   = 0;
+/*
+ * Everything besides the sources that decides an output: the binary identity
+ * and the std of every oracle, --source-map and --precheck. A different value
+ * makes every input dirty.
+ */
+static uint64_t incremental_config_hash(const PipelineOracle *oracles, size_t count, int source_map,
+                                        int precheck) {
+    HashState state;
+    hash_init(&state, 0U);
+    hash_update_str(&state, "cplus-incremental 1");
+    for (size_t k = 0U; k < count; ++k) {
+        const CompilerCaps *caps = compiler_probe(oracles[k].compiler);
+        hash_update_str(&state, (caps->resolved_path != NULL) ? caps->resolved_path
+                                                              : oracles[k].compiler);
+        hash_update(&state, &caps->binary_size, sizeof(caps->binary_size));
+        hash_update(&state, &caps->binary_mtime_ns, sizeof(caps->binary_mtime_ns));
+        hash_update_str(&state, oracles[k].std_name);
+    }
+    /* What is written (a .map sidecar) and what is accepted (the pre-check) */
+    hash_update(&state, &source_map, sizeof(source_map));
+    hash_update(&state, &precheck, sizeof(precheck));
+    return hash_final(&state);
+}
+
+/*
+ * Split a comma-separated option value in place (argv strings are writable)
+ * into at most max items; returns the count, or 0 on an empty item or too
+ * many of them.
+ */
+static size_t split_list(char *text, const char *items[], size_t max) {
+    size_t count = 0U;
+    for (char *item = text; item != NULL;) {
+        char *comma = strchr(item, ',');
+        if (comma != NULL) {
+            *comma = '\0';
+        }
+        if ((item[0] == '\0') || (count == max)) {
+            return 0U;
+        }
+        items[count++] = item;
+        item = (comma != NULL) ? comma + 1 : NULL;
+    }
+    return count;
+}
+
+/* Per-directory state: <cache root>/<subdir>/<hash of the working directory> */
+static char *cwd_entry_path(const char *subdir) {
+    char *cwd = getcwd(NULL, 0U);
+    if (cwd == NULL) {
+        return NULL;
+    }
+
+    char name[17];
+    hash_to_hex(hash_bytes(cwd, strlen(cwd), 0U), name);
+    free(cwd);
+
+    return cache_dir_entry_path(subdir, name);
+}
+
+/*
+ * Fill job from the run-wide settings in proto for the input path (taken
+ * over, freed on failure). Returns 0 when the output path cannot be allocated.
+ */
+static int job_init(CliJob *job, const CliJob *proto, char *input_path, size_t index) {
+    *job             = *proto;
+    job->input_path  = input_path;
+    job->index       = index;
+    job->graph_index = -1L;
+    if (job->output_path == NULL) {
+        job->owned_output = pipeline_default_output_path(input_path);
+        if (job->owned_output == NULL) {
+            free(input_path);
+            job->input_path = NULL;
+            fprintf(stderr, "internal runtime error: failed to allocate output path\n");
+            return 0;
+        }
+        job->output_path = job->owned_output;
+    }
+    struct stat st;
+    if ((job->history != NULL) && (stat(input_path, &st) == 0)) {
+        job->size = (unsigned long long)st.st_size;
+    }
+    job->expected_ns = job_history_estimate(job->history, input_path, job->size);
+    return 1;
+}
+
+static int run_cli(int argc, char *argv[], InputList *list) {
+    int         has_inputs = 0;
     const char *output_path = NULL;
-    const char *compiler    = "gcc";
-    const char *std_name    = "c23";
+    char        default_cc[]  = "gcc";
+    char        default_std[] = "c23";
+    char       *cc_list     = default_cc;
+    char       *std_list    = default_std;
+    size_t      n_workers   = 0U; /* 0 = online CPUs */
+    SubprocessLimits limits = {0ULL, 0ULL};
+    size_t      batch_limit = DEFAULT_BATCH_SIZE;
+    int         show_stats  = 0;
+    int         max_errors  = 0;
+    DiagnosticFormat diag_format = DIAG_FORMAT_TEXT;
+    int         precheck    = 0;
+    int         source_map  = 0;
+    int         use_pch     = 1;
+    int         time_report = 0;
+    const char *trace_path  = NULL;
+    int         use_cache   = 1;
+    int         incremental = 0;
+    const char *manifest_path = NULL;
+    unsigned long long cache_max_bytes = VALIDATION_CACHE_DEFAULT_MAX_BYTES;
 
     if (argc < 2) {
         print_usage(argv[0]);
@@ -84,65 +562,635 @@ int main(int argc, char *argv[]) {
                 print_usage(argv[0]);
                 return 1;
             }
-            compiler = argv[++i];
+            cc_list = argv[++i];
         } else if (strcmp(argv[i], "--std") == 0) {
             if ((i + 1) >= argc) {
                 print_usage(argv[0]);
                 return 1;
             }
-            std_name = argv[++i];
+            std_list = argv[++i];
+        } else if ((strcmp(argv[i], "-j") == 0) || (strcmp(argv[i], "--jobs") == 0)) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            n_workers = parse_job_count(argv[++i]);
+            if (n_workers == 0U) {
+                fprintf(stderr, "error: invalid job count '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if ((strncmp(argv[i], "-j", 2U) == 0) && (argv[i][2] != '\0')) {
+            n_workers = parse_job_count(argv[i] + 2);
+            if (n_workers == 0U) {
+                fprintf(stderr, "error: invalid job count '%s'\n", argv[i] + 2);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cache-dir") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            cache_dir_set_root(argv[++i]);
+        } else if (strcmp(argv[i], "--cache-max-size") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            cache_max_bytes = parse_byte_size(argv[++i]);
+            if (cache_max_bytes == 0ULL) {
+                fprintf(stderr, "error: invalid cache size '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--job-timeout") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            limits.timeout_ms = parse_duration_ms(argv[++i]);
+            if (limits.timeout_ms == 0ULL) {
+                fprintf(stderr, "error: invalid job timeout '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--job-memory") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            limits.memory_bytes = parse_byte_size(argv[++i]);
+            if (limits.memory_bytes == 0ULL) {
+                fprintf(stderr, "error: invalid job memory '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            use_cache = 0;
+        } else if (strcmp(argv[i], "--batch-size") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            batch_limit = parse_job_count(argv[++i]);
+            if (batch_limit == 0U) {
+                fprintf(stderr, "error: invalid batch size '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--max-errors") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            size_t limit = parse_job_count(argv[++i]);
+            if ((limit == 0U) || (limit > 1000000U)) {
+                fprintf(stderr, "error: invalid error limit '%s'\n", argv[i]);
+                return 1;
+            }
+            max_errors = (int)limit;
+        } else if (strcmp(argv[i], "--diag-format") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            const char *name = argv[++i];
+            if (strcmp(name, "text") == 0) {
+                diag_format = DIAG_FORMAT_TEXT;
+            } else if (strcmp(name, "json") == 0) {
+                diag_format = DIAG_FORMAT_JSON;
+            } else if (strcmp(name, "sarif") == 0) {
+                diag_format = DIAG_FORMAT_SARIF;
+            } else if (strcmp(name, "auto") == 0) {
+                diag_format = DIAG_FORMAT_AUTO;
+            } else {
+                fprintf(stderr, "error: unknown diagnostics format '%s'\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--precheck") == 0) {
+            precheck = 1;
+        } else if (strcmp(argv[i], "--no-pch") == 0) {
+            use_pch = 0;
+        } else if (strcmp(argv[i], "--source-map") == 0) {
+            source_map = 1;
+        } else if (strcmp(argv[i], "--time-report") == 0) {
+            time_report = 1;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            show_stats = 1;
+        } else if (strcmp(argv[i], "--incremental") == 0) {
+            incremental = 1;
+        } else if (strcmp(argv[i], "--manifest") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            manifest_path = argv[++i];
+            incremental   = 1;
+        } else if ((strcmp(argv[i], "--files-from") == 0) ||
+                   ((argv[i][0] == '@') && (argv[i][1] != '\0'))) {
+            const char *list_path = (argv[i][0] == '@') ? argv[i] + 1 : argv[i + 1];
+            if ((argv[i][0] != '@') && (++i >= argc)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            if (input_list_add_file(list, list_path) == 0) {
+                fprintf(stderr, "error: cannot open input list '%s'\n", list_path);
+                return 1;
+            }
+            has_inputs = 1;
+        } else if ((strcmp(argv[i], "-r") == 0) || (strcmp(argv[i], "--recursive") == 0)) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            if (input_list_add_dir(list, argv[++i]) == 0) {
+                fprintf(stderr, "error: '%s' is not a directory\n", argv[i]);
+                return 1;
+            }
+            has_inputs = 1;
+        } else if (strcmp(argv[i], "--ignore") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            if (input_list_add_ignore(list, argv[++i]) == 0) {
+                fprintf(stderr, "internal runtime error: failed to allocate the input list\n");
+                return 2;
+            }
         } else if (argv[i][0] == '-') {
             fprintf(stderr, "error: unknown option '%s'\n", argv[i]);
             print_usage(argv[0]);
             return 1;
         } else {
-            if (n_inputs >= MAX_INPUTS) {
-                fprintf(stderr, "error: too many input files (max %d)\n", MAX_INPUTS);
-                return 1;
+            if (input_list_add_path(list, argv[i]) == 0) {
+                fprintf(stderr, "internal runtime error: failed to allocate the input list\n");
+                return 2;
             }
-            inputs[n_inputs++] = argv[i];
+            has_inputs = 1;
         }
     }
 
-    if (n_inputs == 0) {
+    if (has_inputs == 0) {
         print_usage(argv[0]);
         return 1;
     }
 
-    if ((output_path != NULL) && (n_inputs > 1)) {
-        fprintf(stderr, "error: -o cannot be used with multiple input files\n");
+    /*
+     * Every --cc x --std pair is an oracle. The first one is the run's own
+     * compiler and std (PCH, probe); several are tagged in the diagnostics by
+     * whatever tells them apart.
+     */
+    const char *ccs[MAX_ORACLES];
+    const char *stds[MAX_ORACLES];
+    size_t      n_cc  = split_list(cc_list, ccs, MAX_ORACLES);
+    size_t      n_std = split_list(std_list, stds, MAX_ORACLES);
+    if ((n_cc == 0U) || (n_std == 0U) || ((n_cc * n_std) > MAX_ORACLES)) {
+        fprintf(stderr, "error: --cc and --std take comma-separated lists of at most %u oracles"
+                        " in all\n",
+                MAX_ORACLES);
         return 1;
     }
 
-    int exit_code = 0;
+    PipelineOracle oracles[MAX_ORACLES];
+    char           tags[MAX_ORACLES][64];
+    size_t         n_oracles = 0U;
+    for (size_t c = 0U; c < n_cc; ++c) {
+        for (size_t k = 0U; k < n_std; ++k) {
+            for (size_t prev = 0U; prev < n_oracles; ++prev) {
+                if ((strcmp(oracles[prev].compiler, ccs[c]) == 0) &&
+                    (strcmp(oracles[prev].std_name, stds[k]) == 0)) {
+                    fprintf(stderr, "error: oracle %s -std=%s is listed twice\n", ccs[c], stds[k]);
+                    return 1;
+                }
+            }
+            if ((n_cc > 1U) && (n_std > 1U)) {
+                (void)snprintf(tags[n_oracles], sizeof(tags[n_oracles]), "%.31s/%.31s", ccs[c],
+                               stds[k]);
+            } else {
+                (void)snprintf(tags[n_oracles], sizeof(tags[n_oracles]), "%.63s",
+                               (n_cc > 1U) ? ccs[c] : stds[k]);
+            }
+            oracles[n_oracles] = (PipelineOracle){ccs[c], stds[k], tags[n_oracles]};
+            ++n_oracles;
+        }
+    }
+    const char *compiler = oracles[0].compiler;
+    const char *std_name = oracles[0].std_name;
+
+    /*
+     * Every worker runs one compiler per oracle at a time. Fewer workers than
+     * asked for is better than the OOM killer, so -j is lowered to what the
+     * available memory holds at --job-memory (or a typical run) each.
+     */
+    size_t requested_workers = n_workers;
+    if (n_workers == 0U) {
+        n_workers = job_pool_default_workers();
+    }
+    unsigned long long per_job    = (limits.memory_bytes > 0ULL) ? limits.memory_bytes
+                                                                 : DEFAULT_JOB_MEMORY;
+    unsigned long long per_worker = per_job * (unsigned long long)n_oracles;
+    size_t fitting = job_pool_memory_workers(n_workers, per_worker);
+    if ((fitting < n_workers) && (requested_workers != 0U)) {
+        fprintf(stderr, "warning: -j %zu lowered to %zu to fit the available memory\n", n_workers,
+                fitting);
+    }
+    n_workers = fitting;
 
-    for (int i = 0; i < n_inputs; ++i) {
-        char *owned_output = NULL;
-        const char *out    = output_path;
+    /* A cache that cannot be opened (no HOME, read-only disk) just means no cache */
+    ValidationCache *cache = (use_cache != 0) ? validation_cache_open(cache_max_bytes) : NULL;
+    PipelineStats    stats = {0U, 0U};
 
-        if (out == NULL) {
-            owned_output = build_default_output_path(inputs[i]);
-            if (owned_output == NULL) {
-                fprintf(stderr, "internal runtime error: failed to allocate output path\n");
-                return 2;
+    /* Timing is only recorded when asked for; a trace that cannot be allocated is just skipped */
+    Trace *trace = ((time_report != 0) || (trace_path != NULL)) ? trace_create() : NULL;
+
+    /* Durations of earlier runs in this directory; without a cache root they last for this run */
+    char       *history_path = cwd_entry_path("history");
+    JobHistory *history      = job_history_open(history_path);
+    free(history_path);
+
+    CliJob proto = {
+        .output_path = output_path,
+        .compiler    = compiler,
+        .std_name    = std_name,
+        .cache       = cache,
+        .stats       = &stats,
+        .max_errors  = max_errors,
+        .diag_format = diag_format,
+        .precheck    = precheck,
+        .source_map  = source_map,
+        .trace       = trace,
+        .oracles     = oracles,
+        .n_oracles   = n_oracles,
+        .limits      = limits,
+        .history     = history,
+    };
+
+    CliRun run = {
+        .lock       = PTHREAD_MUTEX_INITIALIZER,
+        .batch_done = PTHREAD_COND_INITIALIZER,
+    };
+
+    /*
+     * Read ahead enough inputs to give every worker a full batch. When the
+     * list ends within that window (command-line inputs, short lists) the run
+     * is planned as a whole; a longer list is streamed in batches of
+     * batch_limit while the first ones run. Incremental mode plans over the
+     * whole dependency graph, so it reads the list to the end first.
+     */
+    size_t  window    = (incremental != 0) ? SIZE_MAX : n_workers * batch_limit;
+    CliJob *ahead     = NULL;
+    size_t  n_ahead   = 0U;
+    size_t  cap_ahead = 0U;
+    int     got       = 1;
+    int     failed    = 0; /* nothing from the read-ahead runs */
+    int     status    = 0; /* exit status decided here rather than by an input */
+    while ((n_ahead <= window) && (failed == 0)) {
+        char *path = NULL;
+        got = input_list_next(list, &path);
+        if (got <= 0) {
+            break;
+        }
+        if (n_ahead == cap_ahead) {
+            size_t  new_cap = (cap_ahead == 0U) ? 64U : cap_ahead * 2U;
+            CliJob *resized = (CliJob *)realloc(ahead, new_cap * sizeof(CliJob));
+            if (resized == NULL) {
+                free(path);
+                fprintf(stderr, "internal runtime error: failed to allocate jobs\n");
+                failed = 1;
+                break;
             }
-            out = owned_output;
+            ahead     = resized;
+            cap_ahead = new_cap;
         }
+        if (job_init(&ahead[n_ahead], &proto, path, n_ahead) == 0) {
+            failed = 1;
+            break;
+        }
+        ++n_ahead;
+    }
+    int    streaming = ((got > 0) && (failed == 0)) ? 1 : 0;
+    size_t n_inputs  = n_ahead;
 
-        PipelineOptions options = {
-            .input_path  = inputs[i],
-            .output_path = out,
-            .compiler    = compiler,
-            .std_name    = std_name,
-        };
+    if ((output_path != NULL) && (n_ahead > 1U)) {
+        fprintf(stderr, "error: -o cannot be used with multiple input files\n");
+        failed    = 1;
+        streaming = 0;
+        status    = 1;
+    } else if ((n_ahead == 0U) && (got == 0) && (failed == 0)) {
+        fprintf(stderr, "error: no input files\n");
+        status = 1;
+    }
+    if (failed != 0) {
+        for (size_t k = 0U; k < n_ahead; ++k) {
+            free(ahead[k].input_path);
+            free(ahead[k].owned_output);
+        }
+        n_ahead = 0U;
+        status  = (status != 0) ? status : 2;
+    }
+
+    /*
+     * Incremental mode: only dirty inputs are run; clean ones keep rc = 0.
+     * Without a usable manifest location every input simply runs.
+     */
+    unsigned char *dirty = NULL;
+
+    if ((incremental != 0) && (n_ahead > 0U)) {
+        char *default_manifest = (manifest_path == NULL) ? cwd_entry_path("manifest") : NULL;
+        const char *path = (manifest_path != NULL) ? manifest_path : default_manifest;
+
+        uint64_t config = incremental_config_hash(oracles, n_oracles, source_map, precheck);
+        run.graph       = dep_graph_open(path, config);
+        dirty = (unsigned char *)malloc(n_ahead);
+        free(default_manifest);
+
+        for (size_t k = 0U; (run.graph != NULL) && (dirty != NULL) && (k < n_ahead); ++k) {
+            ahead[k].graph_index = dep_graph_add_input(run.graph, ahead[k].input_path,
+                                                       ahead[k].output_path);
+            if (ahead[k].graph_index < 0L) {
+                dep_graph_close(run.graph);
+                run.graph = NULL;
+            }
+        }
+
+        if ((run.graph == NULL) || (dirty == NULL)) {
+            dep_graph_close(run.graph);
+            run.graph = NULL;
+            free(dirty);
+            dirty = NULL;
+            for (size_t k = 0U; k < n_ahead; ++k) {
+                ahead[k].graph_index = -1L;
+            }
+        } else {
+            (void)dep_graph_plan(run.graph, dirty);
+        }
+    }
+
+    /* Up-to-date inputs are done; the rest keep their order */
+    size_t n_run = 0U;
+    for (size_t k = 0U; k < n_ahead; ++k) {
+        if ((dirty == NULL) || (dirty[k] != 0U)) {
+            ahead[n_run++] = ahead[k];
+        } else {
+            free(ahead[k].input_path);
+            free(ahead[k].owned_output);
+        }
+    }
+    free(dirty);
+
+    /*
+     * Enough inputs starting with the same #include <...> lines: precompile
+     * that block once and validate the matching inputs with -include. A
+     * streamed list decides on the inputs read ahead; later ones use the PCH
+     * when their block matches.
+     */
+    Pch *pch = NULL;
+    if ((use_pch != 0) && (n_run >= PCH_MIN_FILES)) {
+        char **prefixes = (char **)calloc(n_run, sizeof(char *));
+        for (size_t k = 0U; (prefixes != NULL) && (k < n_run); ++k) {
+            prefixes[k] = pch_file_prefix(ahead[k].input_path);
+        }
+        uint64_t started = trace_now(trace);
+        pch = (prefixes != NULL)
+                  ? pch_create(compiler, std_name, (const char *const *)prefixes, n_run)
+                  : NULL;
+        trace_end(trace, TRACE_PCH, NULL, (unsigned)n_run, started);
+        for (size_t k = 0U; (prefixes != NULL) && (k < n_run); ++k) {
+            free(prefixes[k]);
+            ahead[k].pch = pch;
+        }
+        free(prefixes);
+        proto.pch = pch;
+    }
+
+    /*
+     * Group the inputs to run into batches of at most batch_limit, but small
+     * enough that every worker gets one: ceil(n_run / n_workers) when the
+     * whole list is known.
+     */
+    if ((streaming == 0) && (n_workers > n_run)) {
+        n_workers = (n_run > 0U) ? n_run : 1U;
+    }
+    size_t batch_size = (streaming != 0) ? batch_limit : (n_run + n_workers - 1U) / n_workers;
+    if (batch_size > batch_limit) {
+        batch_size = batch_limit;
+    }
+    if (batch_size == 0U) {
+        batch_size = 1U; /* nothing to run */
+    }
+    run.max_in_flight = 2U * n_workers;
+
+    /* No threads available: every batch runs inline */
+    JobPool *pool     = ((n_run > 0U) || (streaming != 0)) ? job_pool_create(n_workers) : NULL;
+    int      buffered = ((pool != NULL) && (n_workers > 1U)) ? 1 : 0;
+
+    /*
+     * With several workers, the inputs planned as a whole are dealt into the
+     * batches longest-expected-first and the costliest batch is submitted
+     * first, so no large file is left to finish alone at the end. One worker
+     * keeps the input order.
+     */
+    size_t    n_groups  = (n_run + batch_size - 1U) / batch_size;
+    size_t   *order     = NULL;
+    size_t   *group_len = NULL;
+    uint64_t *costs     = NULL;
+    if ((n_workers > 1U) && (n_run > 1U)) {
+        order     = (size_t *)malloc(n_run * sizeof(size_t));
+        group_len = (size_t *)malloc(n_groups * sizeof(size_t));
+        costs     = (uint64_t *)malloc(n_run * sizeof(uint64_t));
+        for (size_t k = 0U; (costs != NULL) && (k < n_run); ++k) {
+            costs[k] = ahead[k].expected_ns;
+        }
+        if ((order == NULL) || (group_len == NULL) || (costs == NULL) ||
+            (job_history_plan(costs, n_run, n_groups, batch_size, order, group_len) == 0)) {
+            free(order);
+            free(group_len);
+            order     = NULL;
+            group_len = NULL;
+        }
+        free(costs);
+    }
+    run.worker_busy = (uint64_t *)calloc((pool != NULL) ? n_workers : 1U, sizeof(uint64_t));
+    run.n_busy      = (run.worker_busy != NULL) ? ((pool != NULL) ? n_workers : 1U) : 0U;
+    uint64_t started = monotonic_ns();
 
-        int rc = pipeline_run(&options);
-        free(owned_output);
+    for (size_t k = 0U, g = 0U; k < n_run; ++g) {
+        size_t count = ((n_run - k) < batch_size) ? (n_run - k) : batch_size;
+        if (group_len != NULL) {
+            count = group_len[g];
+        }
+        if (count == 0U) {
+            continue;
+        }
+        CliBatch *batch = batch_create(&run, count, buffered);
+        if (batch == NULL) {
+            fprintf(stderr, "internal runtime error: failed to allocate batches\n");
+            for (size_t j = k; j < n_run; ++j) {
+                size_t from = (order != NULL) ? order[j] : j;
+                free(ahead[from].input_path);
+                free(ahead[from].owned_output);
+            }
+            status    = 2;
+            streaming = 0;
+            break;
+        }
+        for (size_t j = 0U; j < count; ++j) {
+            batch->jobs[j] = ahead[(order != NULL) ? order[k + j] : k + j];
+        }
+        batch->count = count;
+        submit_batch(pool, batch);
+        k += count;
+    }
+    free(ahead);
+    free(order);
+    free(group_len);
 
-        if (rc != 0) {
-            exit_code = rc;
+    /* The rest of a long list: one batch fills while the earlier ones run */
+    CliBatch *open = NULL;
+    while (streaming != 0) {
+        char *path = NULL;
+        got = input_list_next(list, &path);
+        if (got <= 0) {
+            break;
         }
+        if (open == NULL) {
+            open = batch_create(&run, batch_size, buffered);
+        }
+        if ((open == NULL) || (job_init(&open->jobs[open->count], &proto, path, n_inputs) == 0)) {
+            if (open == NULL) {
+                free(path);
+                fprintf(stderr, "internal runtime error: failed to allocate batches\n");
+            }
+            status = 2;
+            break;
+        }
+        ++n_inputs;
+        ++n_run;
+        if (++open->count == batch_size) {
+            submit_batch(pool, open);
+            open = NULL;
+        }
+    }
+    if ((open != NULL) && (open->count > 0U)) {
+        submit_batch(pool, open);
+    } else if (open != NULL) {
+        free(open->jobs);
+        free(open);
     }
 
+    job_pool_destroy(pool);
+    uint64_t makespan = monotonic_ns() - started;
+    free(run.worker_busy);
+
+    if ((got < 0) && (input_list_error(list) != NULL)) {
+        fprintf(stderr, "error: failed to read '%s'\n", input_list_error(list));
+        status = (status != 0) ? status : 1;
+    } else if (got < 0) {
+        fprintf(stderr, "internal runtime error: failed to allocate an input path\n");
+        status = 2;
+    }
+    int exit_code = (status != 0) ? status : run.exit_code;
+
+    if ((run.graph != NULL) && (dep_graph_save(run.graph) == 0)) {
+        fprintf(stderr, "warning: failed to write the incremental manifest\n");
+    }
+    dep_graph_close(run.graph);
+
+    if (show_stats != 0) {
+        print_stats(n_inputs, n_run, &stats, cache, pch);
+    }
+
+    if (time_report != 0) {
+        trace_fprint_report(trace, stderr);
+        fprintf(stderr,
+                "cplus: makespan %.3f ms estimated, %.3f ms actual (%zu batch%s, %zu worker%s)\n",
+                (double)run.estimated_ns / 1e6, (double)makespan / 1e6, run.n_batches,
+                (run.n_batches == 1U) ? "" : "es", n_workers, (n_workers == 1U) ? "" : "s");
+    }
+    if ((trace_path != NULL) && (trace_write_chrome(trace, trace_path) == 0)) {
+        fprintf(stderr, "warning: failed to write the trace to '%s'\n", trace_path);
+    }
+
+    (void)job_history_save(history);
+    job_history_close(history);
+    trace_destroy(trace);
+    pch_destroy(pch);
+    validation_cache_close(cache);
+
+    return exit_code;
+}
+
+/* One invocation, run here or on behalf of a client by the server */
+static int run_invocation(int argc, char *argv[]) {
+    InputList *list = input_list_create();
+    if (list == NULL) {
+        fprintf(stderr, "internal runtime error: failed to allocate the input list\n");
+        return 2;
+    }
+
+    int exit_code = run_cli(argc, argv, list);
+    input_list_destroy(list);
     return exit_code;
 }
+
+int main(int argc, char *argv[]) {
+    int         serve       = 0;
+    int         client      = 0;
+    const char *socket_path = NULL;
+
+    /* Server options are consumed here; everything else belongs to run_cli() */
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--serve") == 0) {
+            serve = 1;
+        } else if (strcmp(argv[i], "--client") == 0) {
+            client = 1;
+        } else if (strcmp(argv[i], "--socket") == 0) {
+            if ((i + 1) >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            socket_path = argv[++i];
+            client      = 1;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc       = kept;
+    argv[argc] = NULL;
+
+    if (serve != 0) {
+        if (argc > 1) {
+            fprintf(stderr, "error: --serve takes no other options than --socket\n");
+            return 1;
+        }
+        char *default_socket = (socket_path == NULL) ? server_default_socket() : NULL;
+        if ((socket_path == NULL) && (default_socket == NULL)) {
+            fprintf(stderr, "error: no cache root for the server socket; pass --socket PATH\n");
+            return 1;
+        }
+        int exit_code = server_run((socket_path != NULL) ? socket_path : default_socket,
+                                   run_invocation);
+        free(default_socket);
+        return exit_code;
+    }
+
+    /* A running server takes the invocation; without one it runs here as usual */
+    const char *env_socket = getenv("CPLUS_SERVER");
+    if ((socket_path == NULL) && (env_socket != NULL) && (env_socket[0] != '\0')) {
+        socket_path = env_socket;
+        client      = 1;
+    }
+    if (client != 0) {
+        char *default_socket = (socket_path == NULL) ? server_default_socket() : NULL;
+        int   exit_code = server_forward((socket_path != NULL) ? socket_path : default_socket,
+                                         argc, argv);
+        free(default_socket);
+        if (exit_code >= 0) {
+            return exit_code;
+        }
+    }
+
+    return run_invocation(argc, argv);
+}
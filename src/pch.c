@@ -0,0 +1,429 @@
+/*
+ * FILE: pch.c
+ * DESC.: shared include-block detection and precompiled header builds
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "pch.h"
+
+#include "cache_dir.h"
+#include "compiler_probe.h"
+#include "file_io.h"
+#include "hash.h"
+#include "subprocess.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define PCH_SCAN_BYTES 16384U
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+struct Pch {
+    char*         header;      /* <cache root>/pch/<key>.h, passed with -include */
+    char*         block;       /* the prefix it covers, "a.h\nb.h\n" */
+    size_t        block_len;
+    size_t        n_headers;
+    int           built;
+    atomic_size_t hits;
+    atomic_size_t misses;
+};
+
+/* A candidate block: the first `lines` headers of some input's prefix */
+typedef struct {
+    uint64_t    hash;
+    const char* text;
+    size_t      len;
+    size_t      lines;
+    size_t      files;
+} PchCandidate;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static const char *skip_blank(const char *p, const char *end) {
+    while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n') ||
+                         (*p == '\f') || (*p == '\v'))) {
+        ++p;
+    }
+    return p;
+}
+
+/*
+ * Skip blank space and comments; NULL when the text cannot be read with
+ * certainty (an unterminated comment, a // comment continued by a splice).
+ */
+static const char *skip_space_and_comments(const char *p, const char *end) {
+    for (;;) {
+        p = skip_blank(p, end);
+        if ((end - p >= 2) && (p[0] == '/') && (p[1] == '*')) {
+            const char *close = NULL;
+            for (const char *q = p + 2; (close == NULL) && (end - q >= 2); ++q) {
+                close = ((q[0] == '*') && (q[1] == '/')) ? q : NULL;
+            }
+            if (close == NULL) {
+                return NULL;
+            }
+            p = close + 2;
+        } else if ((end - p >= 2) && (p[0] == '/') && (p[1] == '/')) {
+            const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+            const char *last = (nl != NULL) ? nl : end;
+            if ((last > p) &&
+                ((last[-1] == '\\') ||
+                 ((last[-1] == '\r') && (last - p >= 2) && (last[-2] == '\\')))) {
+                return NULL;
+            }
+            p = last;
+        } else {
+            return p;
+        }
+    }
+}
+
+/*
+ * Parse `# include <name>` at p up to its line end; the name goes to
+ * *name and *name_len. NULL when p is not exactly such a directive.
+ */
+static const char *parse_system_include(const char *p, const char *end, const char **name,
+                                        size_t *name_len) {
+    if ((p >= end) || (*p != '#')) {
+        return NULL;
+    }
+    ++p;
+    while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+        ++p;
+    }
+    if (((size_t)(end - p) < 7U) || (memcmp(p, "include", 7U) != 0)) {
+        return NULL;
+    }
+    p += 7;
+    while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+        ++p;
+    }
+    if ((p >= end) || (*p != '<')) {
+        return NULL;
+    }
+
+    const char *start = ++p;
+    while ((p < end) && (*p != '>') && (*p != '\n') && (*p != '\r') && (*p != '\\')) {
+        ++p;
+    }
+    if ((p >= end) || (*p != '>') || (p == start)) {
+        return NULL;
+    }
+    *name     = start;
+    *name_len = (size_t)(p - start);
+    ++p;
+
+    /* Nothing but blanks may follow on the line */
+    while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r'))) {
+        ++p;
+    }
+    if ((p < end) && (*p != '\n')) {
+        return NULL;
+    }
+    return p;
+}
+
+static size_t count_lines(const char *text, size_t len) {
+    size_t lines = 0U;
+    for (size_t i = 0U; i < len; ++i) {
+        lines += (text[i] == '\n') ? 1U : 0U;
+    }
+    return lines;
+}
+
+/* Insert or count one candidate; table has a power-of-two size with room to spare */
+static void count_candidate(PchCandidate *table, size_t mask, const char *text, size_t len,
+                            size_t lines) {
+    uint64_t hash = hash_bytes(text, len, 0U);
+    for (size_t slot = (size_t)hash & mask;; slot = (slot + 1U) & mask) {
+        PchCandidate *c = &table[slot];
+        if (c->text == NULL) {
+            *c = (PchCandidate){hash, text, len, lines, 1U};
+            return;
+        }
+        if ((c->hash == hash) && (c->len == len) && (memcmp(c->text, text, len) == 0)) {
+            ++c->files;
+            return;
+        }
+    }
+}
+
+/* The block with the best files x headers score, or NULL */
+static const PchCandidate *choose_block(PchCandidate *table, size_t size) {
+    const PchCandidate *best = NULL;
+    for (size_t i = 0U; i < size; ++i) {
+        const PchCandidate *c = &table[i];
+        if ((c->text == NULL) || (c->files < PCH_MIN_FILES)) {
+            continue;
+        }
+        size_t score      = c->files * c->lines;
+        size_t best_score = (best != NULL) ? best->files * best->lines : 0U;
+        if ((score > best_score) ||
+            ((score == best_score) && (best != NULL) && (c->files > best->files))) {
+            best = c;
+        }
+    }
+    return best;
+}
+
+static int file_exists(const char *path) {
+    struct stat st;
+    return (stat(path, &st) == 0) && S_ISREG(st.st_mode);
+}
+
+/* "#include <name>" for every name of block */
+static char *header_text(const char *block, size_t block_len, size_t *out_len) {
+    char  *text = NULL;
+    FILE  *out  = open_memstream(&text, out_len);
+    if (out == NULL) {
+        return NULL;
+    }
+    for (const char *p = block, *end = block + block_len; p < end;) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        fprintf(out, "#include <%.*s>\n", (int)(nl - p), p);
+        p = nl + 1;
+    }
+    if (fclose(out) != 0) {
+        free(text);
+        return NULL;
+    }
+    return text;
+}
+
+/* Compile header into binary through a temp file renamed into place */
+static int build_pch(const char *compiler, const char *std_flag, const char *header,
+                     const char *binary) {
+    size_t len = strlen(binary) + 32U;
+    char  *tmp = (char *)malloc(len);
+    char  *std = (char *)malloc(strlen(std_flag) + 6U);
+    if ((tmp == NULL) || (std == NULL)) {
+        free(tmp);
+        free(std);
+        return 0;
+    }
+    (void)snprintf(tmp, len, "%s.tmp.%ld", binary, (long)getpid());
+    memcpy(std, "-std=", 5U);
+    memcpy(std + 5U, std_flag, strlen(std_flag) + 1U);
+
+    const char *const argv[] = {compiler, "-x", "c-header", std, header, "-o", tmp, NULL};
+    SubprocessResult  run;
+    int ok = (subprocess_run(argv, &run) == 0);
+    if (ok != 0) {
+        ok = (WIFEXITED(run.status) != 0) && (WEXITSTATUS(run.status) == 0);
+        subprocess_free_result(&run);
+    }
+
+    ok = (ok != 0) && (rename(tmp, binary) == 0);
+    if (ok == 0) {
+        (void)unlink(tmp);
+    }
+    free(tmp);
+    free(std);
+    return ok;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+char *pch_include_prefix(const char *source, size_t size) {
+    if (source == NULL) {
+        return NULL;
+    }
+
+    char  *block = NULL;
+    size_t block_len = 0U;
+    FILE  *out = open_memstream(&block, &block_len);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    const char *end = source + size;
+    for (const char *p = source;;) {
+        const char *name = NULL;
+        size_t      name_len = 0U;
+        p = skip_space_and_comments(p, end);
+        p = (p != NULL) ? parse_system_include(p, end, &name, &name_len) : NULL;
+        if (p == NULL) {
+            break;
+        }
+        (void)fwrite(name, 1U, name_len, out);
+        (void)fputc('\n', out);
+    }
+
+    if ((fclose(out) != 0) || (block_len == 0U)) {
+        free(block);
+        return NULL;
+    }
+    return block;
+}
+
+char *pch_file_prefix(const char *path) {
+    FILE *in = (path != NULL) ? fopen(path, "rb") : NULL;
+    if (in == NULL) {
+        return NULL;
+    }
+
+    /* A directive cut at the end of the buffer has no '>' and ends the block */
+    char  *buf = (char *)malloc(PCH_SCAN_BYTES);
+    size_t len = (buf != NULL) ? fread(buf, 1U, PCH_SCAN_BYTES, in) : 0U;
+    (void)fclose(in);
+
+    char *prefix = (buf != NULL) ? pch_include_prefix(buf, len) : NULL;
+    free(buf);
+    return prefix;
+}
+
+Pch *pch_create(const char *compiler, const char *std_name, const char *const prefixes[],
+                size_t count) {
+    if ((compiler == NULL) || (std_name == NULL) || (prefixes == NULL) || (count < PCH_MIN_FILES)) {
+        return NULL;
+    }
+
+    const CompilerCaps *caps = compiler_probe(compiler);
+    if ((caps->resolved_path == NULL) ||
+        ((caps->family != COMPILER_FAMILY_GCC) && (caps->family != COMPILER_FAMILY_CLANG))) {
+        return NULL;
+    }
+
+    /* Every leading run of headers of every input is a candidate */
+    size_t total = 0U;
+    for (size_t i = 0U; i < count; ++i) {
+        total += (prefixes[i] != NULL) ? count_lines(prefixes[i], strlen(prefixes[i])) : 0U;
+    }
+    size_t size = 16U;
+    while (size < total * 2U) {
+        size *= 2U;
+    }
+    PchCandidate *table = (PchCandidate *)calloc(size, sizeof(PchCandidate));
+    if (table == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0U; i < count; ++i) {
+        size_t lines = 0U;
+        for (const char *p = prefixes[i]; (p != NULL) && (*p != '\0'); ++p) {
+            if (*p == '\n') {
+                count_candidate(table, size - 1U, prefixes[i], (size_t)(p - prefixes[i]) + 1U,
+                                ++lines);
+            }
+        }
+    }
+
+    const PchCandidate *best = choose_block(table, size);
+    Pch *pch = (best != NULL) ? (Pch *)calloc(1U, sizeof(Pch)) : NULL;
+    if (pch == NULL) {
+        free(table);
+        return NULL;
+    }
+    pch->block     = (char *)malloc(best->len + 1U);
+    pch->block_len = best->len;
+    pch->n_headers = best->lines;
+    if (pch->block != NULL) {
+        memcpy(pch->block, best->text, best->len);
+        pch->block[best->len] = '\0';
+    }
+    free(table);
+
+    /* Keyed like the validation cache: a new compiler binary means a new PCH */
+    const char *std_flag = compiler_probe_std_flag(caps, std_name);
+    HashState   state;
+    hash_init(&state, 0U);
+    hash_update_str(&state, "cplus-pch 1");
+    hash_update_str(&state, caps->resolved_path);
+    hash_update(&state, &caps->binary_size, sizeof(caps->binary_size));
+    hash_update(&state, &caps->binary_mtime_ns, sizeof(caps->binary_mtime_ns));
+    hash_update_str(&state, std_flag);
+    hash_update_str(&state, (pch->block != NULL) ? pch->block : "");
+
+    char name[19];
+    hash_to_hex(hash_final(&state), name);
+    memcpy(name + 16, ".h", 3U);
+
+    const char *ext    = (caps->family == COMPILER_FAMILY_GCC) ? ".gch" : ".pch";
+    pch->header        = (pch->block != NULL) ? cache_dir_entry_path("pch", name) : NULL;
+    char *binary       = NULL;
+    size_t header_len  = (pch->header != NULL) ? strlen(pch->header) : 0U;
+    if (pch->header != NULL) {
+        binary = (char *)malloc(header_len + 5U);
+    }
+    if (binary == NULL) {
+        pch_destroy(pch);
+        return NULL;
+    }
+    memcpy(binary, pch->header, header_len);
+    memcpy(binary + header_len, ext, 5U);
+
+    int ok = (file_exists(pch->header) != 0) && (file_exists(binary) != 0);
+    if (ok == 0) {
+        size_t text_len = 0U;
+        char  *text     = header_text(pch->block, pch->block_len, &text_len);
+        ok = (text != NULL) && (file_io_write_atomic(pch->header, text, text_len) != 0) &&
+             (build_pch(compiler, std_flag, pch->header, binary) != 0);
+        pch->built = ok;
+        free(text);
+    }
+    free(binary);
+
+    if (ok == 0) {
+        pch_destroy(pch);
+        return NULL;
+    }
+    return pch;
+}
+
+const char *pch_header_for(Pch *pch, const char *prefix) {
+    if (pch == NULL) {
+        return NULL;
+    }
+
+    if ((prefix != NULL) && (strncmp(prefix, pch->block, pch->block_len) == 0)) {
+        atomic_fetch_add(&pch->hits, 1U);
+        return pch->header;
+    }
+    atomic_fetch_add(&pch->misses, 1U);
+    return NULL;
+}
+
+void pch_counters(const Pch *pch, size_t *out_hits, size_t *out_misses) {
+    if (out_hits != NULL) {
+        *out_hits = (pch != NULL) ? atomic_load(&pch->hits) : 0U;
+    }
+    if (out_misses != NULL) {
+        *out_misses = (pch != NULL) ? atomic_load(&pch->misses) : 0U;
+    }
+}
+
+size_t pch_block_size(const Pch *pch) {
+    return (pch != NULL) ? pch->n_headers : 0U;
+}
+
+int pch_was_built(const Pch *pch) {
+    return (pch != NULL) ? pch->built : 0;
+}
+
+void pch_destroy(Pch *pch) {
+    if (pch == NULL) {
+        return;
+    }
+
+    free(pch->header);
+    free(pch->block);
+    free(pch);
+}
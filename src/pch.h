@@ -0,0 +1,60 @@
+/*
+ * FILE: pch.h
+ * DESC.: this file is the declaration of the precompiled system-header cache
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_PCH_H
+#define CPLUS_PCH_H
+
+#include <stddef.h>
+
+/* Fewest inputs sharing an include block for a PCH to pay off */
+#define PCH_MIN_FILES 4U
+
+/*
+ * The leading block of `#include <...>` lines of source, one header name per
+ * line ("stdio.h\nstdlib.h\n"). Only blank lines and comments may precede or
+ * separate them; the block ends at anything else. NULL when there is none.
+ * Caller must free().
+ */
+char* pch_include_prefix(const char* source, size_t size);
+
+/* pch_include_prefix() of the first 16 KiB of the file at path */
+char* pch_file_prefix(const char* path);
+
+/*
+ * A precompiled header for one include block, built for one compiler and std.
+ * Shared by every worker of a run; pch_header_for() is thread-safe.
+ */
+typedef struct Pch Pch;
+
+/*
+ * Pick the block worth precompiling among the prefixes of a run (entries may
+ * be NULL): the leading run of headers shared by at least PCH_MIN_FILES
+ * inputs that maximises files x headers. Its header and GCC .gch / Clang .pch
+ * live under <cache root>/pch, keyed by the compiler binary, std and block,
+ * and are reused when present, so a block is compiled once per compiler+std.
+ * NULL when no block qualifies, the cache is disabled or the build fails.
+ */
+Pch* pch_create(const char* compiler, const char* std_name, const char* const prefixes[],
+                size_t count);
+
+/*
+ * Header to pass with -include to validate an input whose prefix is prefix:
+ * the PCH header when the block is a leading part of prefix, otherwise NULL
+ * (the input is validated as usual). Counts a hit or a miss.
+ */
+const char* pch_header_for(Pch* pch, const char* prefix);
+
+void pch_counters(const Pch* pch, size_t* out_hits, size_t* out_misses);
+
+/* Header names in the block, and whether this run compiled it (0 = reused) */
+size_t pch_block_size(const Pch* pch);
+int pch_was_built(const Pch* pch);
+
+void pch_destroy(Pch* pch);
+
+#endif // CPLUS_PCH_H
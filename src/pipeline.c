@@ -6,117 +6,590 @@
  * DATE: March, 2026
  */
 
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "pipeline.h"
 
 #include "compiler_validator.h"
 #include "diagnostics.h"
+#include "file_io.h"
+#include "pch.h"
+#include "precheck.h"
+#include "source_map.h"
+#include "trace.h"
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-static char *read_entire_file(const char *path, size_t *out_size) {
-    FILE *fp = fopen(path, "rb");
-    if (fp == NULL) {
-        return NULL;
+/* Most oracles one input is validated with; a --cc x --std matrix stays well below */
+#define PIPELINE_MAX_ORACLES 8U
+
+static size_t oracle_count(const PipelineOptions *options) {
+    return (options->n_oracles > 1U) ? options->n_oracles : 1U;
+}
+
+static const char *oracle_compiler(const PipelineOptions *options, size_t oracle) {
+    return (options->n_oracles > 1U) ? options->oracles[oracle].compiler : options->compiler;
+}
+
+static const char *oracle_std(const PipelineOptions *options, size_t oracle) {
+    return (options->n_oracles > 1U) ? options->oracles[oracle].std_name : options->std_name;
+}
+
+/* Hand diag to the options' sink, or print it to their stream */
+static void emit_diagnostic(const PipelineOptions *options, const Diagnostic *diag) {
+    if (options->diag_sink != NULL) {
+        options->diag_sink(options->diag_user, diag);
+    } else {
+        FILE *stream = (options->diag_stream != NULL) ? options->diag_stream : stderr;
+        diagnostics_fprint_one(stream, diag);
     }
+}
 
-    if (fseek(fp, 0L, SEEK_END) != 0) {
-        fclose(fp);
-        return NULL;
+/* Same for text without a location; a sink gets it as an error at no position */
+static void emit_raw(const PipelineOptions *options, const char *text) {
+    if (options->diag_sink == NULL) {
+        FILE *stream = (options->diag_stream != NULL) ? options->diag_stream : stderr;
+        diagnostics_fprint_raw(stream, text);
+        return;
     }
 
-    long file_size = ftell(fp);
-    if (file_size < 0L) {
-        fclose(fp);
-        return NULL;
+    if (strncmp(text, "error: ", 7U) == 0) {
+        text += 7U; /* the severity is the sink's to render */
+    }
+    size_t len = strlen(text);
+    while ((len > 0U) && (text[len - 1U] == '\n')) {
+        --len;
     }
+    char       no_file[1] = {'\0'};
+    char      *message    = strndup(text, len);
+    Diagnostic diag       = {no_file, 0, 0, DIAG_ERROR, (message != NULL) ? message : no_file,
+                             NULL, 0, 0, NULL};
+    options->diag_sink(options->diag_user, &diag);
+    free(message);
+}
 
-    if (fseek(fp, 0L, SEEK_SET) != 0) {
-        fclose(fp);
-        return NULL;
+/*
+ * Print whatever the compilers reported. On failure this is the error list; on
+ * success it is any warnings, so a cache hit replays exactly what a miss shows.
+ * Structured output holds every error, so max_errors is applied here too.
+ * Positions in the validated file go through map (when there is one) first.
+ * The results of several oracles are merged and tagged (tags may be NULL).
+ */
+static void report_validation(const ValidationResult validations[], size_t count,
+                              const char *const tags[], const PipelineOptions *options,
+                              const SourceMap *map) {
+    DiagnosticList lists[PIPELINE_MAX_ORACLES];
+    int            any_output = 0;
+    int            failed     = 0;
+
+    uint64_t started = trace_now(options->trace);
+    for (size_t k = 0U; k < count; ++k) {
+        const char *raw = validations[k].raw_output;
+        lists[k] = (DiagnosticList){NULL, 0U, 0U, NULL};
+        if ((raw != NULL) && (raw[0] != '\0')) {
+            lists[k] = (options->diag_format == DIAG_FORMAT_TEXT)
+                           ? diagnostics_parse(raw)
+                           : diagnostics_parse_structured(raw);
+            (void)source_map_remap_list(map, options->input_path, &lists[k]);
+            any_output = 1;
+        }
+        failed |= (validations[k].success == 0);
     }
 
-    size_t size = (size_t)file_size;
-    char *buffer = (char *)malloc(size + 1U);
-    if (buffer == NULL) {
-        fclose(fp);
-        return NULL;
+    DiagnosticList merged = {NULL, 0U, 0U, NULL};
+    if ((count > 1U) && (any_output != 0)) {
+        merged = diagnostics_merge(lists, tags, count);
+    }
+    const DiagnosticList *diags = (count > 1U) ? &merged : &lists[0];
+    if (any_output != 0) {
+        trace_end(options->trace, TRACE_PARSE, options->input_path, 1U, started);
     }
 
-    size_t read_bytes = fread(buffer, 1U, size, fp);
-    fclose(fp);
+    if (diags->count > 0U) {
+        int errors = 0;
+        for (size_t i = 0U; i < diags->count; ++i) {
+            if ((diags->items[i].severity == DIAG_ERROR) && (options->max_errors > 0) &&
+                (++errors > options->max_errors)) {
+                break;
+            }
+            emit_diagnostic(options, &diags->items[i]);
+        }
+    } else if ((any_output != 0) && (failed != 0)) {
+        /* Fallback: compiler output didn't match expected format */
+        for (size_t k = 0U; k < count; ++k) {
+            if ((validations[k].success == 0) && (validations[k].raw_output != NULL)) {
+                emit_raw(options, validations[k].raw_output);
+            }
+        }
+    }
 
-    if (read_bytes != size) {
-        free(buffer);
-        return NULL;
+    diagnostics_free_list(&merged);
+    for (size_t k = 0U; k < count; ++k) {
+        diagnostics_free_list(&lists[k]);
     }
+}
 
-    buffer[size] = '\0';
-    if (out_size != NULL) {
-        *out_size = size;
+/* Per-input state while a batch moves through the pipeline */
+typedef struct {
+    char*            source;      /* loaded only to key the cache, pre-check or map */
+    size_t           size;
+    SourceMap*       map;         /* validated file -> input, with options->source_map */
+    int              prechecked;  /* rejected by the pre-check: validations[0] is its report */
+    size_t           streamed;    /* diagnostics already printed while validating */
+    ValidationResult validations[PIPELINE_MAX_ORACLES]; /* one per oracle */
+    unsigned char    compiled[PIPELINE_MAX_ORACLES];    /* the oracle missed the cache and ran */
+} PipelineItem;
+
+struct PipelineScratch {
+    PipelineItem* items;
+    char**        sources;      /* read buffer of each item slot, kept across runs */
+    size_t*       source_caps;
+    size_t        capacity;     /* item slots */
+};
+
+/* count zeroed items whose slots keep their read buffers; NULL on allocation failure */
+static PipelineItem *scratch_items(PipelineScratch *scratch, size_t count) {
+    if (count > scratch->capacity) {
+        PipelineItem *items = (PipelineItem *)realloc(scratch->items, count * sizeof(PipelineItem));
+        if (items != NULL) {
+            scratch->items = items;
+        }
+        char **sources = (char **)realloc(scratch->sources, count * sizeof(char *));
+        if (sources != NULL) {
+            scratch->sources = sources;
+        }
+        size_t *caps = (size_t *)realloc(scratch->source_caps, count * sizeof(size_t));
+        if (caps != NULL) {
+            scratch->source_caps = caps;
+        }
+        if ((items == NULL) || (sources == NULL) || (caps == NULL)) {
+            return NULL;
+        }
+        for (size_t i = scratch->capacity; i < count; ++i) {
+            sources[i] = NULL;
+            caps[i]    = 0U;
+        }
+        scratch->capacity = count;
     }
+    memset(scratch->items, 0, count * sizeof(PipelineItem));
+    return scratch->items;
+}
 
-    return buffer;
+/* One oracle's pass over a batch: cache lookups, then the compiler for the misses */
+typedef struct {
+    const PipelineOptions* options;
+    PipelineItem*          items;
+    size_t                 count;
+    size_t                 oracle;  /* index into every item's validations */
+} OracleRun;
+
+/* Per-input state of one oracle's pass */
+typedef struct {
+    uint64_t    key;
+    int         cacheable;
+    int         miss;        /* needs a compiler run */
+    const char* pch_header;  /* -include for that run, NULL without a matching PCH */
+} OracleItem;
+
+/* Sink for diagnostics streamed out of a running compiler */
+typedef struct {
+    const PipelineOptions* options;
+    PipelineItem*          item;
+    const char*            validated_path;
+} StreamSink;
+
+static void print_streamed(void *user, const Diagnostic *diag) {
+    StreamSink *sink = (StreamSink *)user;
+    Diagnostic  shown = *diag;
+    (void)source_map_remap_diagnostic(sink->item->map, sink->validated_path, &shown);
+    emit_diagnostic(sink->options, &shown);
+    ++sink->item->streamed;
 }
 
-static int write_entire_file(const char *path, const char *data, size_t size) {
-    FILE *fp = fopen(path, "wb");
-    if (fp == NULL) {
+/* The map sits next to the output, as "<output>.map" */
+static int write_sidecar(const char *output_path, const SourceMap *map) {
+    size_t len  = strlen(output_path);
+    char  *path = (char *)malloc(len + 5U);
+    if (path == NULL) {
         return 0;
     }
+    memcpy(path, output_path, len);
+    memcpy(path + len, ".map", 5U);
 
-    size_t written = fwrite(data, 1U, size, fp);
-    int close_rc = fclose(fp);
+    int ok = source_map_write(map, path);
+    free(path);
+    return ok;
+}
 
-    if ((written != size) || (close_rc != 0)) {
-        return 0;
+static int options_valid(const PipelineOptions *options) {
+    return (options != NULL) && (options->input_path != NULL) && (options->output_path != NULL) &&
+           (options->compiler != NULL) && (options->std_name != NULL) &&
+           ((options->n_oracles <= 1U) ||
+            ((options->oracles != NULL) && (options->n_oracles <= PIPELINE_MAX_ORACLES)));
+}
+
+/*
+ * Report, then emit the output on success. The v1 transform is the identity,
+ * so the output is a kernel-side copy of the input, and an output that already
+ * holds those bytes is left untouched so build tools do not see it change
+ * (see file_io_emit_copy). Returns the pipeline_run() code.
+ */
+static int finish_item(const PipelineOptions *options, const PipelineItem *item) {
+    size_t n_results   = (item->prechecked != 0) ? 1U : oracle_count(options);
+
+    const char *tags[PIPELINE_MAX_ORACLES];
+    for (size_t k = 0U; k < n_results; ++k) {
+        tags[k] = (options->n_oracles > 1U) ? options->oracles[k].tag : NULL;
+    }
+
+    if (item->streamed == 0U) {
+        report_validation(item->validations, n_results, tags, options, item->map);
+    }
+
+    /* Errors an oracle did find decide the file; a run cut short only leaves it unknown */
+    int cut_short = 0;
+    for (size_t k = 0U; k < n_results; ++k) {
+        int exit_code = item->validations[k].exit_code;
+        if ((exit_code == VALIDATION_TIMED_OUT) || (exit_code == VALIDATION_OUT_OF_MEMORY)) {
+            cut_short = 1;
+        } else if (item->validations[k].success == 0) {
+            return 1;
+        }
+    }
+    if (cut_short != 0) {
+        return PIPELINE_LIMIT_EXCEEDED;
+    }
+
+    uint64_t       started = trace_now(options->trace);
+    FileEmitStatus emitted = file_io_emit_copy(options->input_path, options->output_path);
+    int            mapped  = (emitted == FILE_EMIT_FAILED) || (item->map == NULL) ||
+                             (write_sidecar(options->output_path, item->map) != 0);
+    trace_end(options->trace, TRACE_WRITE, options->input_path, 1U, started);
+
+    if (emitted == FILE_EMIT_FAILED) {
+        emit_raw(options, "error: failed to write output file\n");
+        return 1;
     }
 
-    return 1;
+    if (mapped == 0) {
+        emit_raw(options, "error: failed to write source map\n");
+        return 1;
+    }
+
+    if (options->stats != NULL) {
+        if (emitted == FILE_EMIT_UNCHANGED) {
+            atomic_fetch_add(&options->stats->outputs_unchanged, 1U);
+        } else {
+            atomic_fetch_add(&options->stats->outputs_written, 1U);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * One oracle over the batch. Inputs rejected by the pre-check are skipped.
+ * The PCH only serves the oracle it was built for (the options' own compiler
+ * and std), and only a lone input with a single oracle is streamed.
+ */
+static void *run_oracle(void *arg) {
+    OracleRun             *run      = (OracleRun *)arg;
+    const PipelineOptions *options  = run->options;
+    size_t                 count    = run->count;
+    size_t                 oracle   = run->oracle;
+    const char            *compiler = oracle_compiler(&options[0], oracle);
+    const char            *std_name = oracle_std(&options[0], oracle);
+
+    OracleItem       *state        = (OracleItem *)calloc(count, sizeof(OracleItem));
+    const char      **misses       = (const char **)calloc(count, sizeof(const char *));
+    size_t           *miss_of      = (size_t *)calloc(count, sizeof(size_t));
+    ValidationResult *miss_results = (ValidationResult *)calloc(count, sizeof(ValidationResult));
+
+    if ((state == NULL) || (misses == NULL) || (miss_of == NULL) || (miss_results == NULL)) {
+        free(state);
+        free(misses);
+        free(miss_of);
+        free(miss_results);
+        emit_raw(&options[0], "internal runtime error: failed to allocate pipeline batch\n");
+        return NULL;
+    }
+
+    int own_pch = (strcmp(compiler, options[0].compiler) == 0) &&
+                  (strcmp(std_name, options[0].std_name) == 0);
+
+    size_t n_misses = 0U;
+    for (size_t i = 0U; i < count; ++i) {
+        const PipelineOptions *opt  = &options[i];
+        PipelineItem          *item = &run->items[i];
+        if ((options_valid(opt) == 0) || (item->prechecked != 0)) {
+            continue;
+        }
+
+        uint64_t started = trace_now(opt->trace);
+        state[i].cacheable = (item->source != NULL) &&
+                             (validation_cache_key(compiler, std_name, opt->max_errors,
+                                                   (int)opt->diag_format, opt->input_path,
+                                                   item->source, item->size, &state[i].key) != 0);
+
+        state[i].miss = (state[i].cacheable == 0) ||
+                        (validation_cache_lookup(opt->cache, state[i].key,
+                                                 &item->validations[oracle]) == 0);
+        if (opt->cache != NULL) {
+            trace_end(opt->trace, TRACE_CACHE, opt->input_path, 1U, started);
+        }
+
+        /* Only a compiler run can use the PCH, so only misses count for its hit rate */
+        if ((state[i].miss != 0) && (opt->pch != NULL) && (own_pch != 0)) {
+            char *prefix = (item->source != NULL) ? pch_include_prefix(item->source, item->size)
+                                                  : pch_file_prefix(opt->input_path);
+            state[i].pch_header = pch_header_for(opt->pch, prefix);
+            free(prefix);
+        }
+    }
+
+    /* Misses using the PCH first: they share one -include and one compiler run */
+    size_t n_pch = 0U;
+    for (int with_pch = 1; with_pch >= 0; --with_pch) {
+        for (size_t i = 0U; i < count; ++i) {
+            if ((state[i].miss != 0) && ((state[i].pch_header != NULL) == (with_pch != 0))) {
+                misses[n_misses]  = options[i].input_path;
+                miss_of[n_misses] = i;
+                ++n_misses;
+                n_pch += (size_t)with_pch;
+            }
+        }
+    }
+
+    /*
+     * A lone file streams its diagnostics as the compiler emits them (and can
+     * be cut off by max_errors); otherwise the misses with and without the PCH
+     * each share one compiler run (per-file fallback happens inside) and are
+     * reported afterwards, in order.
+     */
+    if ((count == 1U) && (n_misses == 1U) && (oracle_count(&options[0]) == 1U)) {
+        StreamSink sink = {
+            &options[0],
+            &run->items[0],
+            options[0].input_path,
+        };
+        ValidatorOptions validator_options = {options[0].max_errors, print_streamed, &sink,
+                                              options[0].diag_format, state[0].pch_header,
+                                              options[0].trace, options[0].limits};
+        miss_results[0] = validator_check_syntax_ex(compiler, std_name, options[0].input_path,
+                                                    &validator_options);
+    } else if (n_misses > 0U) {
+        const PipelineOptions *first = &options[miss_of[0]];
+        ValidatorOptions validator_options = {first->max_errors, NULL, NULL, first->diag_format,
+                                              NULL, first->trace, first->limits};
+        if (n_pch > 0U) {
+            validator_options.pch_header = state[miss_of[0]].pch_header;
+            (void)validator_check_syntax_batch(compiler, std_name, &validator_options, misses,
+                                               n_pch, miss_results);
+        }
+        if (n_misses > n_pch) {
+            validator_options.pch_header = NULL;
+            (void)validator_check_syntax_batch(compiler, std_name, &validator_options,
+                                               misses + n_pch, n_misses - n_pch,
+                                               miss_results + n_pch);
+        }
+    }
+
+    for (size_t m = 0U; m < n_misses; ++m) {
+        const PipelineOptions *opt = &options[miss_of[m]];
+        ValidationResult      *validation = &run->items[miss_of[m]].validations[oracle];
+        *validation = miss_results[m];
+        run->items[miss_of[m]].compiled[oracle] = 1U;
+        if ((state[miss_of[m]].cacheable != 0) && (opt->cache != NULL)) {
+            uint64_t started = trace_now(opt->trace);
+            validation_cache_store(opt->cache, state[miss_of[m]].key, validation);
+            trace_end(opt->trace, TRACE_CACHE, opt->input_path, 1U, started);
+        }
+    }
+
+    free(state);
+    free(misses);
+    free(miss_of);
+    free(miss_results);
+    return NULL;
+}
+
+PipelineScratch *pipeline_scratch_create(void) {
+    return (PipelineScratch *)calloc(1U, sizeof(PipelineScratch));
+}
+
+void pipeline_scratch_destroy(PipelineScratch *scratch) {
+    if (scratch == NULL) {
+        return;
+    }
+    for (size_t i = 0U; i < scratch->capacity; ++i) {
+        free(scratch->sources[i]);
+    }
+    free(scratch->sources);
+    free(scratch->source_caps);
+    free(scratch->items);
+    free(scratch);
+}
+
+char *pipeline_default_output_path(const char *input_path) {
+    const char *ext_hplus = ".hplus";
+    const char *ext_cplus = ".cplus";
+    const size_t ext_len  = 6U; /* both extensions are 6 chars */
+
+    size_t input_len = strlen(input_path);
+
+    const char *out_ext   = NULL;
+    size_t      out_ext_len = 0U;
+
+    if ((input_len > ext_len) &&
+        (strcmp(input_path + input_len - ext_len, ext_hplus) == 0)) {
+        out_ext     = ".h";
+        out_ext_len = 2U;
+    } else if ((input_len > ext_len) &&
+               (strcmp(input_path + input_len - ext_len, ext_cplus) == 0)) {
+        out_ext     = ".c";
+        out_ext_len = 2U;
+    } else {
+        /* Unknown extension: append .out */
+        out_ext     = ".out";
+        out_ext_len = 4U;
+    }
+
+    size_t stem_len = (out_ext[1] != 'o') ? (input_len - ext_len) : input_len;
+    char *output_path = (char *)malloc(stem_len + out_ext_len + 1U);
+    if (output_path == NULL) {
+        return NULL;
+    }
+
+    memcpy(output_path, input_path, stem_len);
+    memcpy(output_path + stem_len, out_ext, out_ext_len + 1U);
+
+    return output_path;
 }
 
 int pipeline_run(const PipelineOptions *options) {
-    if ((options == NULL) || (options->input_path == NULL) || (options->output_path == NULL) ||
-        (options->compiler == NULL) || (options->std_name == NULL)) {
+    if (options == NULL) {
         diagnostics_print_raw("error: invalid pipeline options\n");
         return 1;
     }
 
-    ValidationResult validation = validator_check_syntax(
-        options->compiler,
-        options->std_name,
-        options->input_path
-    );
+    int rc = 1;
+    pipeline_run_batch(options, 1U, &rc);
+    return rc;
+}
 
-    if (validation.success == 0) {
-        DiagnosticList diags = diagnostics_parse(validation.raw_output);
-        if (diags.count > 0U) {
-            diagnostics_print_list(&diags);
-        } else {
-            /* Fallback: compiler output didn't match expected format */
-            diagnostics_print_raw(validation.raw_output);
+void pipeline_run_batch(const PipelineOptions *options, size_t count, int rcs[]) {
+    if ((options == NULL) || (rcs == NULL) || (count == 0U)) {
+        return;
+    }
+    for (size_t i = 0U; i < count; ++i) {
+        if (options[i].compiled != NULL) {
+            *options[i].compiled = 0;
         }
-        diagnostics_free_list(&diags);
-        validator_free_result(&validation);
-        return 1;
     }
 
-    validator_free_result(&validation);
+    PipelineScratch *scratch = options[0].scratch;
+    PipelineItem    *items   = (scratch != NULL)
+                                   ? scratch_items(scratch, count)
+                                   : (PipelineItem *)calloc(count, sizeof(PipelineItem));
+    if ((items == NULL) || (options_valid(&options[0]) == 0)) {
+        for (size_t i = 0U; i < count; ++i) {
+            rcs[i] = 1;
+        }
+        emit_raw(&options[0], (items == NULL)
+                                  ? "internal runtime error: failed to allocate pipeline batch\n"
+                                  : "error: invalid pipeline options\n");
+        if (scratch == NULL) {
+            free(items);
+        }
+        return;
+    }
 
-    size_t input_size = 0U;
-    char *source = read_entire_file(options->input_path, &input_size);
-    if (source == NULL) {
-        diagnostics_print_raw("error: failed to read input file\n");
-        return 1;
+    /* The bytes are only needed in user space to build the cache key and to pre-check */
+    for (size_t i = 0U; i < count; ++i) {
+        const PipelineOptions *opt = &options[i];
+        if (options_valid(opt) == 0) {
+            continue;
+        }
+
+        uint64_t started = trace_now(opt->trace);
+        if ((opt->cache != NULL) || (opt->precheck != 0) || (opt->source_map != 0)) {
+            if (scratch == NULL) {
+                items[i].source = file_io_read_all(opt->input_path, &items[i].size);
+            } else if (file_io_read_into(opt->input_path, &scratch->sources[i],
+                                         &scratch->source_caps[i], &items[i].size) != 0) {
+                items[i].source = scratch->sources[i];
+            }
+            trace_end(opt->trace, TRACE_READ, opt->input_path, 1U, started);
+        }
+
+        /* The v1 transform is the identity, and so is its map */
+        if ((opt->source_map != 0) && (items[i].source != NULL)) {
+            items[i].map = source_map_identity(opt->input_path, items[i].source, items[i].size);
+        }
+
+        /* A file the lexer proves broken never reaches a compiler or the cache */
+        char *report = NULL;
+        if ((opt->precheck != 0) && (items[i].source != NULL)) {
+            started = trace_now(opt->trace);
+            int clean = precheck_source(opt->input_path, items[i].source, items[i].size, &report);
+            trace_end(opt->trace, TRACE_PRECHECK, opt->input_path, 1U, started);
+            if (clean == 0) {
+                items[i].validations[0] = (ValidationResult){0, report, 1};
+                items[i].prechecked     = 1;
+            }
+        }
     }
 
-    int write_ok = write_entire_file(options->output_path, source, input_size);
-    free(source);
+    /*
+     * Every oracle but the first gets its own thread; the first runs here.
+     * A thread that cannot be started runs inline, which only costs time.
+     */
+    size_t    n_oracles = oracle_count(&options[0]);
+    OracleRun runs[PIPELINE_MAX_ORACLES];
+    pthread_t threads[PIPELINE_MAX_ORACLES];
+    int       started_thread[PIPELINE_MAX_ORACLES] = {0};
+    for (size_t k = 0U; k < n_oracles; ++k) {
+        runs[k] = (OracleRun){options, items, count, k};
+        if (k > 0U) {
+            started_thread[k] = (pthread_create(&threads[k], NULL, run_oracle, &runs[k]) == 0);
+        }
+    }
+    for (size_t k = 0U; k < n_oracles; ++k) {
+        if ((k == 0U) || (started_thread[k] == 0)) {
+            (void)run_oracle(&runs[k]);
+        }
+    }
+    for (size_t k = 1U; k < n_oracles; ++k) {
+        if (started_thread[k] != 0) {
+            (void)pthread_join(threads[k], NULL);
+        }
+    }
 
-    if (write_ok == 0) {
-        diagnostics_print_raw("error: failed to write output file\n");
-        return 1;
+    for (size_t i = 0U; i < count; ++i) {
+        if (options_valid(&options[i]) == 0) {
+            emit_raw(&options[i], "error: invalid pipeline options\n");
+            rcs[i] = 1;
+        } else {
+            rcs[i] = finish_item(&options[i], &items[i]);
+        }
+        for (size_t k = 0U; k < n_oracles; ++k) {
+            validator_free_result(&items[i].validations[k]);
+            if ((options[i].compiled != NULL) && (items[i].compiled[k] != 0U)) {
+                *options[i].compiled = 1;
+            }
+        }
+        source_map_destroy(items[i].map);
+        if (scratch == NULL) {
+            free(items[i].source);
+        }
     }
 
-    return 0;
+    if (scratch == NULL) {
+        free(items);
+    }
 }
@@ -9,13 +9,98 @@
 #ifndef CPLUS_PIPELINE_H
 #define CPLUS_PIPELINE_H
 
+#include "diagnostics.h"
+#include "pch.h"
+#include "trace.h"
+#include "validation_cache.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Counters shared by every job of a run; updated atomically */
+typedef struct {
+    atomic_size_t outputs_written;
+    atomic_size_t outputs_unchanged;  // identical output already on disk
+} PipelineStats;
+
+/* One compiler/std pair validating every input; tag names it in merged diagnostics */
+typedef struct {
+    const char* compiler;
+    const char* std_name;
+    const char* tag;
+} PipelineOracle;
+
+/*
+ * Memory that successive runs of one caller reuse instead of allocating per
+ * input: the per-input state of a batch and the buffers sources are read
+ * into, each kept at the largest size seen. Used by one run at a time.
+ */
+typedef struct PipelineScratch PipelineScratch;
+
 typedef struct {
     const char* input_path;
     const char* output_path;
     const char* compiler;   // "gcc" or "clang"
     const char* std_name;   // "c23"
+    FILE*       diag_stream; // where diagnostics go; NULL means stderr
+    ValidationCache* cache;  // validation result cache; NULL disables it
+    PipelineStats* stats;    // optional counters; NULL skips them
+    int         max_errors;  // stop the compiler after this many errors; 0 = no limit
+    DiagnosticFormat diag_format; // compiler output format; DIAG_FORMAT_TEXT (0) by default
+    int         precheck;    // reject lexically broken files without the compiler (see precheck.h)
+    int         source_map;  // write "<output>.map" and remap diagnostics through it (source_map.h)
+    Pch*        pch;         // precompiled include block of the run; NULL = none
+    Trace*      trace;       // per-stage spans of the run (see trace.h); NULL = off
+    const PipelineOracle* oracles; // n_oracles > 1: validate with each of them concurrently
+    size_t      n_oracles;   // at most 8; 0 or 1 = compiler and std_name alone
+    DiagnosticFn diag_sink;  // receives each diagnostic instead of diag_stream; NULL = print them
+    void*       diag_user;   // passed to diag_sink
+    PipelineScratch* scratch; // buffers reused across runs; NULL = allocate per run
+    SubprocessLimits limits; // time and memory of each compiler run (see subprocess.h); zero = none
+    int*        compiled;    // optional: 1 when a compiler validated the input, 0 for cache hits
 } PipelineOptions;
 
+/* pipeline_run() code of an input whose compiler run was cut short by limits */
+#define PIPELINE_LIMIT_EXCEEDED 3
+
+/* NULL on allocation failure */
+PipelineScratch* pipeline_scratch_create(void);
+
+void pipeline_scratch_destroy(PipelineScratch* scratch);
+
+/*
+ * The output path of an input when none is given: foo.hplus -> foo.h,
+ * foo.cplus -> foo.c, anything else gets ".out" appended. Caller must free().
+ */
+char* pipeline_default_output_path(const char* input_path);
+
+/*
+ * Returns 0 on success, 1 on validation or I/O failure, and
+ * PIPELINE_LIMIT_EXCEEDED when no oracle found an error but a compiler run
+ * hit the time or memory limit, so the file's validity is unknown.
+ * Diagnostics are printed as the compiler produces them, unless the result
+ * comes from the cache. With a diag_sink each one is passed to it instead; messages that have no
+ * location (unparsed compiler output, I/O errors) arrive as DIAG_ERROR
+ * entries with an empty file and line 0.
+ *
+ * With several oracles, each one validates the input on its own thread (cache
+ * lookups included), so the wall time is that of the slowest. The input
+ * passes only when every oracle passes; their diagnostics are merged with
+ * diagnostics_merge() and printed once the last one is done. The PCH, built
+ * for compiler and std_name, is used by the oracle that matches them.
+ */
 int pipeline_run(const PipelineOptions* options);
 
+/*
+ * Run count inputs, validating every cache miss with one compiler invocation
+ * per oracle (see validator_check_syntax_batch), or two when only some of
+ * them match the PCH. All options must share compiler, std_name, cache,
+ * max_errors, diag_format, precheck, source_map, pch, trace, oracles and
+ * scratch; each keeps its own output, diag_stream and diag_sink. Only a batch of one with a single
+ * oracle streams its diagnostics. rcs[i] is what pipeline_run(&options[i])
+ * would return.
+ */
+void pipeline_run_batch(const PipelineOptions* options, size_t count, int rcs[]);
+
 #endif // CPLUS_PIPELINE_H
@@ -0,0 +1,354 @@
+/*
+ * FILE: precheck.c
+ * DESC.: structural pre-check of C23 sources before a compiler is spawned
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "precheck.h"
+
+#include "lexer.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+/* An open conditional group (#if/#ifdef/#ifndef ... #endif) */
+typedef struct {
+    size_t height;      /* delimiter depth at the #if */
+    size_t first_end;   /* depth at the end of the first branch, SIZE_MAX until then */
+    int    guard;       /* #ifndef opening the file: an include guard, transparent */
+} CondGroup;
+
+typedef struct {
+    const char*  source;
+    size_t       size;
+    TokenBuffer  tokens;
+
+    size_t*      opens;        /* token index of each open delimiter */
+    size_t       depth;
+    size_t       opens_cap;
+
+    CondGroup*   groups;
+    size_t       n_groups;
+    size_t       groups_cap;
+    size_t       n_real_groups; /* open groups that are not include guards */
+
+    int          balance_known; /* 0 once conditionals/macros make it undecidable */
+    size_t       fault;         /* token index of the fault, SIZE_MAX if none */
+    const char*  message;
+    size_t       related;       /* token index named in the message, SIZE_MAX if none */
+} Precheck;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/* '(' '[' '{' for openers, ')' ']' '}' for closers, '\0' otherwise; digraphs mapped */
+static char delimiter_of(const Precheck *pc, size_t i) {
+    if (pc->tokens.kinds[i] != TOK_PUNCT) {
+        return '\0';
+    }
+
+    const char *text = pc->source + pc->tokens.offsets[i];
+    uint32_t    len  = pc->tokens.lengths[i];
+    if (len == 1U) {
+        return (strchr("()[]{}", text[0]) != NULL) ? text[0] : '\0';
+    }
+    if (len == 2U) {
+        if (memcmp(text, "<:", 2U) == 0) { return '['; }
+        if (memcmp(text, ":>", 2U) == 0) { return ']'; }
+        if (memcmp(text, "<%", 2U) == 0) { return '{'; }
+        if (memcmp(text, "%>", 2U) == 0) { return '}'; }
+    }
+    return '\0';
+}
+
+static char closer_for(char open) {
+    return (open == '(') ? ')' : ((open == '[') ? ']' : '}');
+}
+
+static int token_is(const Precheck *pc, size_t i, const char *text) {
+    size_t len = strlen(text);
+    return (pc->tokens.lengths[i] == len) &&
+           (memcmp(pc->source + pc->tokens.offsets[i], text, len) == 0);
+}
+
+static void set_fault(Precheck *pc, size_t i, const char *message, size_t related) {
+    if (pc->fault == SIZE_MAX) {
+        pc->fault   = i;
+        pc->message = message;
+        pc->related = related;
+    }
+}
+
+/* Inside a group that may be skipped, nothing about delimiters is certain */
+static void give_up_balance(Precheck *pc) {
+    pc->balance_known = 0;
+}
+
+static int push_open(Precheck *pc, size_t i) {
+    if (pc->depth >= pc->opens_cap) {
+        size_t new_cap = (pc->opens_cap == 0U) ? 64U : pc->opens_cap * 2U;
+        size_t *opens = (size_t *)realloc(pc->opens, new_cap * sizeof(size_t));
+        if (opens == NULL) {
+            return 0;
+        }
+        pc->opens     = opens;
+        pc->opens_cap = new_cap;
+    }
+    pc->opens[pc->depth++] = i;
+    return 1;
+}
+
+static void close_delimiter(Precheck *pc, size_t i, char close) {
+    size_t floor = (pc->n_groups > 0U) ? pc->groups[pc->n_groups - 1U].height : 0U;
+
+    if (pc->depth <= floor) {
+        /* Closing what was opened before the current #if: legal per branch */
+        if (pc->n_real_groups > 0U) {
+            give_up_balance(pc);
+        } else {
+            set_fault(pc, i, "unmatched closing delimiter", SIZE_MAX);
+        }
+        return;
+    }
+
+    size_t open = pc->opens[pc->depth - 1U];
+    if (closer_for(delimiter_of(pc, open)) != close) {
+        if (pc->n_real_groups > 0U) {
+            give_up_balance(pc);
+        } else {
+            set_fault(pc, i, "mismatched closing delimiter for the one opened at", open);
+        }
+        return;
+    }
+    --pc->depth;
+}
+
+static int push_group(Precheck *pc, int guard) {
+    if (pc->n_groups >= pc->groups_cap) {
+        size_t new_cap = (pc->groups_cap == 0U) ? 16U : pc->groups_cap * 2U;
+        CondGroup *groups = (CondGroup *)realloc(pc->groups, new_cap * sizeof(CondGroup));
+        if (groups == NULL) {
+            return 0;
+        }
+        pc->groups     = groups;
+        pc->groups_cap = new_cap;
+    }
+    pc->groups[pc->n_groups++] = (CondGroup){pc->depth, SIZE_MAX, guard};
+    pc->n_real_groups += (guard == 0) ? 1U : 0U;
+    return 1;
+}
+
+/*
+ * Every branch of a group must leave the delimiter depth where the first one
+ * did, and a group without #else where it found it (it may be skipped);
+ * otherwise the balance depends on which branch is taken.
+ */
+static void end_branch(Precheck *pc, int last) {
+    CondGroup *g = &pc->groups[pc->n_groups - 1U];
+    if (g->guard != 0) {
+        return;
+    }
+
+    if (g->first_end == SIZE_MAX) {
+        g->first_end = pc->depth;
+        if ((last != 0) && (pc->depth != g->height)) {
+            give_up_balance(pc);
+        }
+    } else if (pc->depth != g->first_end) {
+        give_up_balance(pc);
+    }
+
+    /* The next branch starts from the depth at the #if */
+    if (last == 0) {
+        pc->depth = g->height;
+    } else {
+        pc->depth = g->first_end;
+    }
+}
+
+/*
+ * Handle the directive whose '#' is token i; returns the index of the first
+ * token after it. Literals and delimiters on directive lines are not checked
+ * (#error text, #include <...>), but a #define whose body is unbalanced makes
+ * the file's balance undecidable.
+ */
+static size_t handle_directive(Precheck *pc, size_t i) {
+    size_t name = i + 1U;
+    size_t next = name;
+    while ((pc->tokens.kinds[next] != TOK_EOF) &&
+           ((pc->tokens.flags[next] & TOKF_LINE_START) == 0U)) {
+        if (pc->tokens.kinds[next] == TOK_UNTERMINATED_COMMENT) {
+            set_fault(pc, next, "unterminated comment", SIZE_MAX);
+        }
+        ++next;
+    }
+    if (name == next) {
+        return next; /* null directive */
+    }
+
+    if (token_is(pc, name, "if") || token_is(pc, name, "ifdef") || token_is(pc, name, "ifndef")) {
+        int guard = (i == 0U) && token_is(pc, name, "ifndef");
+        if (push_group(pc, guard) == 0) {
+            give_up_balance(pc);
+        }
+    } else if ((pc->n_groups > 0U) &&
+               (token_is(pc, name, "elif") || token_is(pc, name, "else") ||
+                token_is(pc, name, "elifdef") || token_is(pc, name, "elifndef"))) {
+        end_branch(pc, 0);
+    } else if ((pc->n_groups > 0U) && token_is(pc, name, "endif")) {
+        end_branch(pc, 1);
+        pc->n_real_groups -= (pc->groups[pc->n_groups - 1U].guard == 0) ? 1U : 0U;
+        --pc->n_groups;
+    } else if (token_is(pc, name, "define")) {
+        long balance = 0;
+        for (size_t k = name + 1U; k < next; ++k) {
+            char d = delimiter_of(pc, k);
+            balance += ((d == '(') || (d == '[') || (d == '{')) ? 1 : 0;
+            balance -= ((d == ')') || (d == ']') || (d == '}')) ? 1 : 0;
+        }
+        if (balance != 0) {
+            give_up_balance(pc);
+        }
+    }
+    return next;
+}
+
+static void run_checks(Precheck *pc) {
+    for (size_t i = 0U; (pc->tokens.kinds[i] != TOK_EOF) && (pc->fault == SIZE_MAX);) {
+        uint8_t kind = pc->tokens.kinds[i];
+
+        if ((kind == TOK_PUNCT) && ((pc->tokens.flags[i] & TOKF_LINE_START) != 0U) &&
+            (token_is(pc, i, "#") || token_is(pc, i, "%:"))) {
+            i = handle_directive(pc, i);
+            continue;
+        }
+
+        if (kind == TOK_UNTERMINATED_COMMENT) {
+            set_fault(pc, i, "unterminated comment", SIZE_MAX);
+        } else if ((kind == TOK_UNTERMINATED_STRING) || (kind == TOK_UNTERMINATED_CHAR)) {
+            /* A group that may be skipped can hold any text */
+            if (pc->n_real_groups == 0U) {
+                set_fault(pc, i,
+                          (kind == TOK_UNTERMINATED_STRING) ? "missing terminating \" character"
+                                                            : "missing terminating ' character",
+                          SIZE_MAX);
+            }
+        } else if (pc->balance_known != 0) {
+            char d = delimiter_of(pc, i);
+            if ((d == '(') || (d == '[') || (d == '{')) {
+                if (push_open(pc, i) == 0) {
+                    give_up_balance(pc);
+                }
+            } else if (d != '\0') {
+                close_delimiter(pc, i, d);
+            }
+        }
+        ++i;
+    }
+
+    if ((pc->fault == SIZE_MAX) && (pc->balance_known != 0) && (pc->n_groups == 0U) &&
+        (pc->depth > 0U)) {
+        set_fault(pc, pc->opens[pc->depth - 1U], "delimiter is never closed", SIZE_MAX);
+    }
+}
+
+/* 1-based line and column of a source offset */
+static void locate(const char *source, size_t offset, size_t *line, size_t *column,
+                   size_t *line_start) {
+    *line = 1U;
+    *line_start = 0U;
+    for (const char *p = source, *end = source + offset;
+         (p = (const char *)memchr(p, '\n', (size_t)(end - p))) != NULL; ++p) {
+        ++*line;
+        *line_start = (size_t)(p - source) + 1U;
+    }
+    *column = offset - *line_start + 1U;
+}
+
+static char *format_report(const Precheck *pc, const char *path) {
+    size_t offset = pc->tokens.offsets[pc->fault];
+    size_t line = 0U, column = 0U, line_start = 0U;
+    locate(pc->source, offset, &line, &column, &line_start);
+
+    const char *text     = pc->source + line_start;
+    const char *text_end = (const char *)memchr(text, '\n', pc->size - line_start);
+    size_t      text_len = (text_end != NULL) ? (size_t)(text_end - text) : pc->size - line_start;
+
+    char  *report = NULL;
+    size_t report_len = 0U;
+    FILE  *out = open_memstream(&report, &report_len);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    fprintf(out, "%s:%zu:%zu: error: %s", path, line, column, pc->message);
+    if (pc->related != SIZE_MAX) {
+        size_t r_line = 0U, r_column = 0U, r_start = 0U;
+        locate(pc->source, pc->tokens.offsets[pc->related], &r_line, &r_column, &r_start);
+        fprintf(out, " %zu:%zu", r_line, r_column);
+    }
+    fprintf(out, "\n%5zu | ", line);
+    (void)fwrite(pc->source + line_start, 1U, text_len, out);
+    fputs("\n      | ", out);
+    for (size_t k = 0U; k + 1U < column; ++k) {
+        fputc((pc->source[line_start + k] == '\t') ? '\t' : ' ', out);
+    }
+    fputs("^\n", out);
+
+    if (fclose(out) != 0) {
+        free(report);
+        return NULL;
+    }
+    return report;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+int precheck_source(const char *path, const char *source, size_t size, char **out_report) {
+    if (out_report != NULL) {
+        *out_report = NULL;
+    }
+    if ((path == NULL) || (source == NULL)) {
+        return 1;
+    }
+
+    Precheck pc;
+    memset(&pc, 0, sizeof(pc));
+    pc.source        = source;
+    pc.size          = size;
+    pc.balance_known = 1;
+    pc.fault         = SIZE_MAX;
+    pc.related       = SIZE_MAX;
+
+    /* Without tokens nothing is certain: leave the verdict to the compiler */
+    int ok = 1;
+    if (lexer_tokenize(source, size, &pc.tokens) != 0) {
+        run_checks(&pc);
+        if (pc.fault != SIZE_MAX) {
+            ok = 0;
+            if (out_report != NULL) {
+                *out_report = format_report(&pc, path);
+            }
+        }
+    }
+
+    token_buffer_free(&pc.tokens);
+    free(pc.opens);
+    free(pc.groups);
+    return ok;
+}
@@ -0,0 +1,25 @@
+/*
+ * FILE: precheck.h
+ * DESC.: this file is the declaration of the compiler-free structural pre-check
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_PRECHECK_H
+#define CPLUS_PRECHECK_H
+
+#include <stddef.h>
+
+/*
+ * Lex source[0..size) and look for faults no preprocessing can repair: an
+ * unterminated comment, an unterminated string or character literal, and
+ * unbalanced or mismatched (), [] and {}. Anything that depends on a
+ * conditional group or a macro body counts as inconclusive, not as a fault,
+ * so a file this rejects never compiles. Returns 1 when nothing certain is
+ * wrong; otherwise 0 with *out_report set to a malloc'd GCC-style diagnostic
+ * ("path:line:col: error: ...", source line and caret).
+ */
+int precheck_source(const char* path, const char* source, size_t size, char** out_report);
+
+#endif // CPLUS_PRECHECK_H
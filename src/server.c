@@ -0,0 +1,429 @@
+/*
+ * FILE: server.c
+ * DESC.: Unix socket daemon running forwarded cplus invocations in one warm process
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+/* CMSG_SPACE()/CMSG_LEN() are not POSIX */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "server.h"
+
+#include "cache_dir.h"
+#include "compiler_probe.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define SERVER_MAGIC       0x53504C43U /* "CPLS" */
+#define SERVER_VERSION     1U
+#define SERVER_MAX_PAYLOAD (16U * 1024U * 1024U)
+#define SERVER_N_FDS       3
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+/*
+ * A request is this header, carrying the client's fds 0/1/2 as SCM_RIGHTS,
+ * followed by payload_len bytes: the working directory and then every argv
+ * string, each NUL-terminated. The reply is the exit status as an int32_t.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t payload_len;
+} RequestHeader;
+
+static volatile sig_atomic_t g_stop_requested;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static void on_stop_signal(int signo) {
+    (void)signo;
+    g_stop_requested = 1;
+}
+
+static int write_all(int fd, const void *data, size_t size) {
+    const char *p = (const char *)data;
+    while (size > 0U) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        p    += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+static int read_all(int fd, void *data, size_t size) {
+    char *p = (char *)data;
+    while (size > 0U) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        if (n == 0) {
+            return 0;
+        }
+        p    += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+/* Fill a sockaddr_un; 0 when the path does not fit */
+static int socket_address(const char *socket_path, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    size_t len = strlen(socket_path);
+    if (len >= sizeof(addr->sun_path)) {
+        return 0;
+    }
+    memcpy(addr->sun_path, socket_path, len + 1U);
+    return 1;
+}
+
+/* A connected socket to socket_path, or -1 */
+static int connect_to(const char *socket_path) {
+    struct sockaddr_un addr;
+    if (socket_address(socket_path, &addr) == 0) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, (const struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        (void)close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Receive the header and the fds sent with it; 0 on a malformed request */
+static int receive_header(int conn, RequestHeader *header, int fds[SERVER_N_FDS]) {
+    union {
+        char           buffer[CMSG_SPACE(SERVER_N_FDS * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct iovec  iov = {header, sizeof(*header)};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    ssize_t n;
+    do {
+        n = recvmsg(conn, &msg, MSG_CMSG_CLOEXEC);
+    } while ((n < 0) && (errno == EINTR));
+
+    int got_fds = 0;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS) &&
+            (cmsg->cmsg_len == CMSG_LEN(SERVER_N_FDS * sizeof(int)))) {
+            memcpy(fds, CMSG_DATA(cmsg), SERVER_N_FDS * sizeof(int));
+            got_fds = 1;
+        }
+    }
+
+    /* The rest of a short header follows as plain bytes */
+    int ok = (n > 0) && ((size_t)n <= sizeof(*header)) &&
+             (read_all(conn, (char *)header + n, sizeof(*header) - (size_t)n) != 0);
+    ok = ok && (got_fds != 0) && (header->magic == SERVER_MAGIC) &&
+         (header->version == SERVER_VERSION) && (header->payload_len > 0U) &&
+         (header->payload_len <= SERVER_MAX_PAYLOAD);
+    if ((ok == 0) && (got_fds != 0)) {
+        for (int i = 0; i < SERVER_N_FDS; ++i) {
+            (void)close(fds[i]);
+        }
+    }
+    return ok;
+}
+
+/*
+ * Split the payload into cwd and a NULL-terminated argv pointing into it;
+ * returns argc, or -1 when it is not a list of NUL-terminated strings.
+ */
+static int split_payload(char *payload, size_t len, const char **out_cwd, char ***out_argv) {
+    if ((len == 0U) || (payload[len - 1U] != '\0')) {
+        return -1;
+    }
+
+    size_t n_strings = 0U;
+    for (size_t i = 0U; i < len; ++i) {
+        n_strings += (payload[i] == '\0') ? 1U : 0U;
+    }
+    if (n_strings < 2U) {
+        return -1; /* cwd and at least argv[0] */
+    }
+
+    char **argv = (char **)calloc(n_strings, sizeof(char *));
+    if (argv == NULL) {
+        return -1;
+    }
+    *out_cwd = payload;
+    char *p  = payload + strlen(payload) + 1U;
+    int argc = 0;
+    while (p < (payload + len)) {
+        argv[argc++] = p;
+        p += strlen(p) + 1U;
+    }
+    argv[argc] = NULL;
+    *out_argv  = argv;
+    return argc;
+}
+
+/*
+ * Run one request with the client's cwd and fds in place of ours, then put
+ * ours back. Returns the exit status.
+ */
+static int run_request(ServerHandler handler, const char *cwd, int argc, char *argv[],
+                       const int fds[SERVER_N_FDS], const sigset_t *run_mask) {
+    int saved_cwd = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    int saved[SERVER_N_FDS];
+    for (int i = 0; i < SERVER_N_FDS; ++i) {
+        saved[i] = fcntl(i, F_DUPFD_CLOEXEC, SERVER_N_FDS);
+    }
+
+    (void)fflush(stdout);
+    (void)fflush(stderr);
+    for (int i = 0; i < SERVER_N_FDS; ++i) {
+        (void)dup2(fds[i], i);
+    }
+
+    int status = 2;
+    if (chdir(cwd) != 0) {
+        fprintf(stderr, "cplus server: cannot enter '%s'\n", cwd);
+    } else {
+        sigset_t serve_mask;
+        cache_dir_reset();
+        compiler_probe_revalidate();
+        (void)pthread_sigmask(SIG_SETMASK, run_mask, &serve_mask);
+        status = handler(argc, argv);
+        (void)pthread_sigmask(SIG_SETMASK, &serve_mask, NULL);
+    }
+
+    (void)fflush(stdout);
+    (void)fflush(stderr);
+    for (int i = 0; i < SERVER_N_FDS; ++i) {
+        if (saved[i] >= 0) {
+            (void)dup2(saved[i], i);
+            (void)close(saved[i]);
+        }
+    }
+    if (saved_cwd >= 0) {
+        (void)fchdir(saved_cwd);
+        (void)close(saved_cwd);
+    }
+    return status;
+}
+
+static void serve_connection(int conn, ServerHandler handler, const sigset_t *run_mask) {
+    RequestHeader header;
+    int           fds[SERVER_N_FDS] = {-1, -1, -1};
+    if (receive_header(conn, &header, fds) == 0) {
+        return;
+    }
+
+    char *payload = (char *)malloc((size_t)header.payload_len);
+    int   ok      = (payload != NULL) && (read_all(conn, payload, (size_t)header.payload_len) != 0);
+
+    const char *cwd  = NULL;
+    char      **argv = NULL;
+    int         argc = ok ? split_payload(payload, (size_t)header.payload_len, &cwd, &argv) : -1;
+
+    int32_t status = 2;
+    if (argc > 0) {
+        status = (int32_t)run_request(handler, cwd, argc, argv, fds, run_mask);
+    }
+    (void)write_all(conn, &status, sizeof(status));
+
+    free(argv);
+    free(payload);
+    for (int i = 0; i < SERVER_N_FDS; ++i) {
+        (void)close(fds[i]);
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+char *server_default_socket(void) {
+    return cache_dir_entry_path("serve", "socket");
+}
+
+int server_run(const char *socket_path, ServerHandler handler) {
+    struct sockaddr_un addr;
+    if (socket_address(socket_path, &addr) == 0) {
+        fprintf(stderr, "error: socket path '%s' is too long\n", socket_path);
+        return 1;
+    }
+
+    int probe = connect_to(socket_path);
+    if (probe >= 0) {
+        (void)close(probe);
+        fprintf(stderr, "error: a cplus server already listens on '%s'\n", socket_path);
+        return 1;
+    }
+    (void)unlink(socket_path); /* stale socket of a server that is gone */
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    mode_t old_umask = umask(0077);
+    int bound = (listener >= 0) &&
+                (bind(listener, (const struct sockaddr *)&addr, sizeof(addr)) == 0);
+    (void)umask(old_umask);
+    if ((bound == 0) || (listen(listener, 16) != 0)) {
+        fprintf(stderr, "error: cannot listen on '%s'\n", socket_path);
+        if (listener >= 0) {
+            (void)close(listener);
+        }
+        return 1;
+    }
+
+    /*
+     * SIGINT/SIGTERM stay blocked except while waiting in pselect() — so a
+     * stop request is seen either there or right after the current request —
+     * and while a request runs, so its children get the usual mask.
+     */
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_stop_signal;
+    (void)sigemptyset(&action.sa_mask);
+    (void)sigaction(SIGINT, &action, NULL);
+    (void)sigaction(SIGTERM, &action, NULL);
+    (void)signal(SIGPIPE, SIG_IGN); /* a client that went away must not kill the server */
+
+    sigset_t stop_signals;
+    sigset_t run_mask;
+    (void)sigemptyset(&stop_signals);
+    (void)sigaddset(&stop_signals, SIGINT);
+    (void)sigaddset(&stop_signals, SIGTERM);
+    (void)pthread_sigmask(SIG_BLOCK, &stop_signals, &run_mask);
+
+    while (g_stop_requested == 0) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(listener, &readable);
+        if (pselect(listener + 1, &readable, NULL, NULL, NULL, &run_mask) <= 0) {
+            continue;
+        }
+        int conn = accept(listener, NULL, NULL);
+        if (conn < 0) {
+            continue;
+        }
+        /* Reads past the timeout fail, so a stalled client cannot hold the loop */
+        struct timeval read_timeout = {SERVER_READ_TIMEOUT_S, 0};
+        if (setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &read_timeout, sizeof(read_timeout)) == 0) {
+            serve_connection(conn, handler, &run_mask);
+        }
+        (void)close(conn);
+    }
+
+    (void)close(listener);
+    (void)unlink(socket_path);
+    (void)pthread_sigmask(SIG_SETMASK, &run_mask, NULL);
+    return 0;
+}
+
+int server_forward(const char *socket_path, int argc, char *const argv[]) {
+    int conn = (socket_path != NULL) ? connect_to(socket_path) : -1;
+    if (conn < 0) {
+        return -1;
+    }
+
+    char  *cwd         = getcwd(NULL, 0U);
+    size_t payload_len = (cwd != NULL) ? strlen(cwd) + 1U : 0U;
+    for (int i = 0; i < argc; ++i) {
+        payload_len += strlen(argv[i]) + 1U;
+    }
+    char *payload = ((cwd != NULL) && (payload_len <= SERVER_MAX_PAYLOAD))
+                        ? (char *)malloc(payload_len)
+                        : NULL;
+    if (payload == NULL) {
+        free(cwd);
+        (void)close(conn);
+        return -1;
+    }
+    size_t used = 0U;
+    memcpy(payload, cwd, strlen(cwd) + 1U);
+    used += strlen(cwd) + 1U;
+    for (int i = 0; i < argc; ++i) {
+        size_t len = strlen(argv[i]) + 1U;
+        memcpy(payload + used, argv[i], len);
+        used += len;
+    }
+    free(cwd);
+
+    RequestHeader header = {SERVER_MAGIC, SERVER_VERSION, (uint64_t)payload_len};
+    int           fds[SERVER_N_FDS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    union {
+        char           buffer[CMSG_SPACE(SERVER_N_FDS * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct iovec  iov = {&header, sizeof(header)};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(SERVER_N_FDS * sizeof(int));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(conn, &msg, MSG_NOSIGNAL);
+    } while ((sent < 0) && (errno == EINTR));
+    int ok = (sent == (ssize_t)sizeof(header)) && (write_all(conn, payload, payload_len) != 0);
+    free(payload);
+
+    /* Once the request is out the server owns it: a lost reply is an error, not a fallback */
+    int32_t status = 0;
+    if ((ok == 0) || (read_all(conn, &status, sizeof(status)) == 0)) {
+        (void)close(conn);
+        if (ok == 0) {
+            return -1;
+        }
+        fprintf(stderr, "error: the cplus server at '%s' went away\n", socket_path);
+        return 2;
+    }
+    (void)close(conn);
+    return (int)status;
+}
@@ -0,0 +1,43 @@
+/*
+ * FILE: server.h
+ * DESC.: this file is the declaration of the cplus --serve daemon and its client
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_SERVER_H
+#define CPLUS_SERVER_H
+
+/* Seconds the server waits on a silent client before dropping its connection */
+#define SERVER_READ_TIMEOUT_S 2
+
+/*
+ * Runs one forwarded invocation: argv as the client received it, in the
+ * client's working directory, with the client's stdin/stdout/stderr as
+ * fds 0/1/2. Returns the exit status to send back.
+ */
+typedef int (*ServerHandler)(int argc, char* argv[]);
+
+/* <cache root>/serve/socket, or NULL without a cache root. Caller must free(). */
+char* server_default_socket(void);
+
+/*
+ * Listen on the Unix socket at socket_path (mode 0600) and run each request
+ * with handler, one at a time, in this process — so whatever the handler
+ * memoizes stays warm for the next one. Before each request the cache root
+ * override is dropped and changed compiler binaries are probed again; a client
+ * that stalls for SERVER_READ_TIMEOUT_S while sending it is dropped unserved.
+ * Returns 0 after SIGINT/SIGTERM (the current request finishes first), or 1
+ * when the socket cannot be set up or another server already listens on it.
+ */
+int server_run(const char* socket_path, ServerHandler handler);
+
+/*
+ * Client side: send argv, the working directory and fds 0/1/2 to the server
+ * at socket_path, which writes to them directly, and wait for the exit status.
+ * Returns it, or -1 when no server accepted the request (nothing ran).
+ */
+int server_forward(const char* socket_path, int argc, char* const argv[]);
+
+#endif // CPLUS_SERVER_H
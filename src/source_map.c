@@ -0,0 +1,537 @@
+/*
+ * FILE: source_map.c
+ * DESC.: varint/delta-encoded source maps and diagnostic remapping
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "source_map.h"
+
+#include "arena.h"
+#include "file_io.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SOURCE_MAP_MAGIC   "CPSM"
+#define SOURCE_MAP_VERSION 1U
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+struct SourceMap {
+    uint32_t  size;          /* generated bytes */
+
+    uint32_t* line_starts;   /* offset of each generated line */
+    uint32_t  n_lines;
+    uint32_t  lines_cap;
+
+    /* Segments, one array per field */
+    uint32_t* seg_offset;
+    uint32_t* seg_file;
+    int32_t*  seg_line;
+    int32_t*  seg_column;
+    size_t    n_segments;
+    size_t    segments_cap;
+
+    const char** files;
+    uint32_t     n_files;
+    uint32_t     files_cap;
+    Arena*       names;      /* backing store of files[] */
+};
+
+/* Growable byte buffer for encoding */
+typedef struct {
+    unsigned char* data;
+    size_t         size;
+    size_t         capacity;
+    int            failed;
+} ByteSink;
+
+/* Cursor over an encoded map */
+typedef struct {
+    const unsigned char* p;
+    const unsigned char* end;
+} ByteSource;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static void sink_bytes(ByteSink *sink, const void *data, size_t len) {
+    if (sink->failed != 0) {
+        return;
+    }
+    if (sink->size + len > sink->capacity) {
+        size_t new_cap = (sink->capacity == 0U) ? 256U : sink->capacity;
+        while (new_cap < sink->size + len) {
+            new_cap *= 2U;
+        }
+        unsigned char *data_new = (unsigned char *)realloc(sink->data, new_cap);
+        if (data_new == NULL) {
+            sink->failed = 1;
+            return;
+        }
+        sink->data     = data_new;
+        sink->capacity = new_cap;
+    }
+    memcpy(sink->data + sink->size, data, len);
+    sink->size += len;
+}
+
+static void sink_varint(ByteSink *sink, uint64_t value) {
+    unsigned char buf[10];
+    size_t        len = 0U;
+    do {
+        unsigned char byte = (unsigned char)(value & 0x7FU);
+        value >>= 7U;
+        buf[len++] = (unsigned char)(byte | ((value != 0U) ? 0x80U : 0U));
+    } while (value != 0U);
+    sink_bytes(sink, buf, len);
+}
+
+static void sink_signed(ByteSink *sink, int64_t value) {
+    sink_varint(sink, ((uint64_t)value << 1U) ^ (uint64_t)(value >> 63));
+}
+
+static int source_varint(ByteSource *src, uint64_t *out) {
+    uint64_t value = 0U;
+    for (unsigned shift = 0U; shift < 64U; shift += 7U) {
+        if (src->p >= src->end) {
+            return 0;
+        }
+        unsigned char byte = *src->p++;
+        value |= (uint64_t)(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0U) {
+            *out = value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int source_signed(ByteSource *src, int64_t *out) {
+    uint64_t raw = 0U;
+    if (source_varint(src, &raw) == 0) {
+        return 0;
+    }
+    *out = (int64_t)(raw >> 1U) ^ -(int64_t)(raw & 1U);
+    return 1;
+}
+
+static int push_line(SourceMap *map, uint32_t start) {
+    if (map->n_lines >= map->lines_cap) {
+        uint32_t new_cap = (map->lines_cap == 0U) ? 256U : map->lines_cap * 2U;
+        uint32_t *starts = (uint32_t *)realloc(map->line_starts, new_cap * sizeof(uint32_t));
+        if (starts == NULL) {
+            return 0;
+        }
+        map->line_starts = starts;
+        map->lines_cap   = new_cap;
+    }
+    map->line_starts[map->n_lines++] = start;
+    return 1;
+}
+
+static int grow_segments(SourceMap *map) {
+    size_t new_cap = (map->segments_cap == 0U) ? 256U : map->segments_cap * 2U;
+
+    uint32_t *offset = (uint32_t *)realloc(map->seg_offset, new_cap * sizeof(uint32_t));
+    if (offset == NULL) {
+        return 0;
+    }
+    map->seg_offset = offset;
+    uint32_t *file = (uint32_t *)realloc(map->seg_file, new_cap * sizeof(uint32_t));
+    if (file == NULL) {
+        return 0;
+    }
+    map->seg_file = file;
+    int32_t *line = (int32_t *)realloc(map->seg_line, new_cap * sizeof(int32_t));
+    if (line == NULL) {
+        return 0;
+    }
+    map->seg_line = line;
+    int32_t *column = (int32_t *)realloc(map->seg_column, new_cap * sizeof(int32_t));
+    if (column == NULL) {
+        return 0;
+    }
+    map->seg_column   = column;
+    map->segments_cap = new_cap;
+    return 1;
+}
+
+/* Index of file in files[], adding it when new; UINT32_MAX on failure */
+static uint32_t intern_file(SourceMap *map, const char *file, size_t len) {
+    /* Segments come in runs of the same file: try the last one first */
+    for (uint32_t k = map->n_files; k > 0U; --k) {
+        const char *name = map->files[k - 1U];
+        if ((strncmp(name, file, len) == 0) && (name[len] == '\0')) {
+            return k - 1U;
+        }
+    }
+
+    if (map->n_files >= map->files_cap) {
+        uint32_t new_cap = (map->files_cap == 0U) ? 4U : map->files_cap * 2U;
+        const char **files =
+            (const char **)realloc((void *)map->files, new_cap * sizeof(const char *));
+        if (files == NULL) {
+            return UINT32_MAX;
+        }
+        map->files     = files;
+        map->files_cap = new_cap;
+    }
+
+    char *copy = arena_strndup(map->names, file, len);
+    if (copy == NULL) {
+        return UINT32_MAX;
+    }
+    map->files[map->n_files] = copy;
+    return map->n_files++;
+}
+
+static int append_segment(SourceMap *map, uint32_t offset, uint32_t file, int line, int column) {
+    if ((map->n_segments >= map->segments_cap) && (grow_segments(map) == 0)) {
+        return 0;
+    }
+    map->seg_offset[map->n_segments] = offset;
+    map->seg_file[map->n_segments]   = file;
+    map->seg_line[map->n_segments]   = line;
+    map->seg_column[map->n_segments] = column;
+    ++map->n_segments;
+    return 1;
+}
+
+static SourceMap *map_new(uint32_t size) {
+    SourceMap *map = (SourceMap *)calloc(1U, sizeof(SourceMap));
+    if (map == NULL) {
+        return NULL;
+    }
+    map->size  = size;
+    map->names = arena_create(256U);
+    if (map->names == NULL) {
+        free(map);
+        return NULL;
+    }
+    return map;
+}
+
+/* Offset of a 1-based generated line/column, clamped to the line; 0 if no such line */
+static int position_offset(const SourceMap *map, int line, int column, uint32_t *out) {
+    if ((line < 1) || ((uint32_t)line > map->n_lines)) {
+        return 0;
+    }
+
+    uint32_t start = map->line_starts[line - 1];
+    uint32_t end   = ((uint32_t)line < map->n_lines) ? map->line_starts[line] : map->size;
+    uint32_t col   = (column > 1) ? (uint32_t)(column - 1) : 0U;
+    *out = (col < end - start) ? start + col : ((end > start) ? end - 1U : start);
+    return 1;
+}
+
+/* Last segment whose offset is <= offset, or SIZE_MAX */
+static size_t find_segment(const SourceMap *map, uint32_t offset) {
+    size_t lo = 0U;
+    size_t hi = map->n_segments;
+    while (lo < hi) {
+        size_t mid = lo + ((hi - lo) / 2U);
+        if (map->seg_offset[mid] <= offset) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo > 0U) ? lo - 1U : SIZE_MAX;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+SourceMap *source_map_create(const char *generated, size_t size) {
+    if (((generated == NULL) && (size > 0U)) || (size >= (size_t)UINT32_MAX)) {
+        return NULL;
+    }
+
+    SourceMap *map = map_new((uint32_t)size);
+    if (map == NULL) {
+        return NULL;
+    }
+
+    int ok = push_line(map, 0U);
+    const char *end = generated + size;
+    const char *p   = generated;
+    while ((ok != 0) && (p != NULL) &&
+           ((p = (const char *)memchr(p, '\n', (size_t)(end - p))) != NULL)) {
+        ++p;
+        ok = push_line(map, (uint32_t)(p - generated));
+    }
+    if (ok == 0) {
+        source_map_destroy(map);
+        return NULL;
+    }
+    return map;
+}
+
+int source_map_add(SourceMap *map, uint32_t offset, const char *file, int line, int column) {
+    if ((map == NULL) || (file == NULL) || (line < 1) || (column < 1) || (offset > map->size) ||
+        ((map->n_segments > 0U) && (offset < map->seg_offset[map->n_segments - 1U]))) {
+        return 0;
+    }
+
+    uint32_t id = intern_file(map, file, strlen(file));
+    return (id != UINT32_MAX) && (append_segment(map, offset, id, line, column) != 0);
+}
+
+SourceMap *source_map_identity(const char *file, const char *source, size_t size) {
+    if (file == NULL) {
+        return NULL;
+    }
+
+    SourceMap *map = source_map_create(source, size);
+    if (map == NULL) {
+        return NULL;
+    }
+
+    uint32_t id = intern_file(map, file, strlen(file));
+    int      ok = (id != UINT32_MAX);
+    for (uint32_t k = 0U; (ok != 0) && (k < map->n_lines) && (k < (uint32_t)INT_MAX); ++k) {
+        ok = append_segment(map, map->line_starts[k], id, (int)k + 1, 1);
+    }
+    if (ok == 0) {
+        source_map_destroy(map);
+        return NULL;
+    }
+    return map;
+}
+
+int source_map_lookup_offset(const SourceMap *map, uint32_t offset, SourcePosition *out) {
+    if ((map == NULL) || (out == NULL)) {
+        return 0;
+    }
+
+    size_t seg = find_segment(map, offset);
+    if (seg == SIZE_MAX) {
+        return 0;
+    }
+
+    uint32_t delta = offset - map->seg_offset[seg];
+    if (delta > (uint32_t)(INT_MAX - map->seg_column[seg])) {
+        return 0;
+    }
+    out->file   = map->files[map->seg_file[seg]];
+    out->line   = map->seg_line[seg];
+    out->column = map->seg_column[seg] + (int)delta;
+    return 1;
+}
+
+int source_map_lookup(const SourceMap *map, int line, int column, SourcePosition *out) {
+    uint32_t offset = 0U;
+    return (map != NULL) && (position_offset(map, line, column, &offset) != 0) &&
+           (source_map_lookup_offset(map, offset, out) != 0);
+}
+
+int source_map_encode(const SourceMap *map, unsigned char **out_data, size_t *out_size) {
+    if ((map == NULL) || (out_data == NULL) || (out_size == NULL)) {
+        return 0;
+    }
+
+    ByteSink sink = {NULL, 0U, 0U, 0};
+    sink_bytes(&sink, SOURCE_MAP_MAGIC, 4U);
+    unsigned char version = SOURCE_MAP_VERSION;
+    sink_bytes(&sink, &version, 1U);
+
+    sink_varint(&sink, map->size);
+    sink_varint(&sink, map->n_lines);
+    for (uint32_t k = 1U; k < map->n_lines; ++k) {
+        sink_varint(&sink, map->line_starts[k] - map->line_starts[k - 1U]);
+    }
+
+    sink_varint(&sink, map->n_files);
+    for (uint32_t k = 0U; k < map->n_files; ++k) {
+        size_t len = strlen(map->files[k]);
+        sink_varint(&sink, len);
+        sink_bytes(&sink, map->files[k], len);
+    }
+
+    sink_varint(&sink, map->n_segments);
+    uint32_t offset = 0U, file = 0U;
+    int32_t  line = 0, column = 0;
+    for (size_t k = 0U; k < map->n_segments; ++k) {
+        sink_varint(&sink, map->seg_offset[k] - offset);
+        sink_signed(&sink, (int64_t)map->seg_file[k] - (int64_t)file);
+        sink_signed(&sink, (int64_t)map->seg_line[k] - (int64_t)line);
+        sink_signed(&sink, (int64_t)map->seg_column[k] - (int64_t)column);
+        offset = map->seg_offset[k];
+        file   = map->seg_file[k];
+        line   = map->seg_line[k];
+        column = map->seg_column[k];
+    }
+
+    if (sink.failed != 0) {
+        free(sink.data);
+        return 0;
+    }
+    *out_data = sink.data;
+    *out_size = sink.size;
+    return 1;
+}
+
+SourceMap *source_map_decode(const unsigned char *data, size_t size) {
+    if ((data == NULL) || (size < 5U) || (memcmp(data, SOURCE_MAP_MAGIC, 4U) != 0) ||
+        (data[4] != SOURCE_MAP_VERSION)) {
+        return NULL;
+    }
+
+    ByteSource src = {data + 5, data + size};
+    uint64_t   gen_size = 0U, n_lines = 0U;
+    if ((source_varint(&src, &gen_size) == 0) || (gen_size >= UINT32_MAX) ||
+        (source_varint(&src, &n_lines) == 0) || (n_lines == 0U) || (n_lines > gen_size + 1U)) {
+        return NULL;
+    }
+
+    SourceMap *map = map_new((uint32_t)gen_size);
+    if (map == NULL) {
+        return NULL;
+    }
+
+    int      ok    = push_line(map, 0U);
+    uint64_t start = 0U;
+    for (uint64_t k = 1U; (ok != 0) && (k < n_lines); ++k) {
+        uint64_t len = 0U;
+        ok = (source_varint(&src, &len) != 0) && (len > 0U) && (start + len <= gen_size);
+        start += len;
+        ok = (ok != 0) && (push_line(map, (uint32_t)start) != 0);
+    }
+
+    uint64_t n_files = 0U;
+    ok = (ok != 0) && (source_varint(&src, &n_files) != 0) && (n_files < UINT32_MAX);
+    for (uint64_t k = 0U; (ok != 0) && (k < n_files); ++k) {
+        uint64_t len = 0U;
+        ok = (source_varint(&src, &len) != 0) && (len <= (uint64_t)(src.end - src.p)) &&
+             (memchr(src.p, '\0', (size_t)len) == NULL);
+        if (ok != 0) {
+            /* Names are unique, so interning appends */
+            ok = (intern_file(map, (const char *)src.p, (size_t)len) == (uint32_t)k);
+            src.p += len;
+        }
+    }
+
+    uint64_t n_segments = 0U;
+    ok = (ok != 0) && (source_varint(&src, &n_segments) != 0) &&
+         (n_segments <= (uint64_t)(src.end - src.p));
+    int64_t offset = 0, file = 0, line = 0, column = 0;
+    for (uint64_t k = 0U; (ok != 0) && (k < n_segments); ++k) {
+        uint64_t d_offset = 0U;
+        int64_t  d_file = 0, d_line = 0, d_column = 0;
+        ok = (source_varint(&src, &d_offset) != 0) && (source_signed(&src, &d_file) != 0) &&
+             (source_signed(&src, &d_line) != 0) && (source_signed(&src, &d_column) != 0) &&
+             (d_offset <= gen_size);
+        if (ok == 0) {
+            break;
+        }
+        offset += (int64_t)d_offset;
+        file   += d_file;
+        line   += d_line;
+        column += d_column;
+        ok = (offset <= (int64_t)gen_size) && (file >= 0) && (file < (int64_t)n_files) &&
+             (line >= 1) && (line <= INT_MAX) && (column >= 1) && (column <= INT_MAX) &&
+             (append_segment(map, (uint32_t)offset, (uint32_t)file, (int)line, (int)column) != 0);
+    }
+
+    if ((ok == 0) || (src.p != src.end)) {
+        source_map_destroy(map);
+        return NULL;
+    }
+    return map;
+}
+
+int source_map_write(const SourceMap *map, const char *path) {
+    unsigned char *data = NULL;
+    size_t         size = 0U;
+    if ((path == NULL) || (source_map_encode(map, &data, &size) == 0)) {
+        return 0;
+    }
+
+    int ok = file_io_write_atomic(path, data, size);
+    free(data);
+    return ok;
+}
+
+SourceMap *source_map_load(const char *path) {
+    size_t size = 0U;
+    char  *data = file_io_read_all(path, &size);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    SourceMap *map = source_map_decode((const unsigned char *)data, size);
+    free(data);
+    return map;
+}
+
+int source_map_remap_diagnostic(const SourceMap *map, const char *generated_file,
+                                Diagnostic *diag) {
+    if ((map == NULL) || (generated_file == NULL) || (diag == NULL) || (diag->file == NULL) ||
+        (strcmp(diag->file, generated_file) != 0)) {
+        return 0;
+    }
+
+    SourcePosition at;
+    if (source_map_lookup(map, diag->line, diag->column, &at) == 0) {
+        return 0;
+    }
+
+    SourcePosition end;
+    if ((diag->end_line > 0) &&
+        (source_map_lookup(map, diag->end_line, diag->end_column, &end) != 0) &&
+        (end.file == at.file)) {
+        diag->end_line   = end.line;
+        diag->end_column = end.column;
+    } else {
+        diag->end_line   = 0;
+        diag->end_column = 0;
+    }
+
+    if ((strcmp(at.file, diag->file) != 0) || (at.line != diag->line)) {
+        diag->context = NULL;
+    }
+    diag->file   = (char *)at.file;
+    diag->line   = at.line;
+    diag->column = at.column;
+    return 1;
+}
+
+size_t source_map_remap_list(const SourceMap *map, const char *generated_file,
+                             DiagnosticList *list) {
+    if (list == NULL) {
+        return 0U;
+    }
+
+    size_t remapped = 0U;
+    for (size_t i = 0U; i < list->count; ++i) {
+        remapped += (size_t)source_map_remap_diagnostic(map, generated_file, &list->items[i]);
+    }
+    return remapped;
+}
+
+size_t source_map_segment_count(const SourceMap *map) {
+    return (map != NULL) ? map->n_segments : 0U;
+}
+
+void source_map_destroy(SourceMap *map) {
+    if (map == NULL) {
+        return;
+    }
+
+    free(map->line_starts);
+    free(map->seg_offset);
+    free(map->seg_file);
+    free(map->seg_line);
+    free(map->seg_column);
+    free((void *)map->files);
+    arena_destroy(map->names);
+    free(map);
+}
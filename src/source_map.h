@@ -0,0 +1,85 @@
+/*
+ * FILE: source_map.h
+ * DESC.: this file is the declaration of the generated-to-original source map
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_SOURCE_MAP_H
+#define CPLUS_SOURCE_MAP_H
+
+#include "diagnostics.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Maps byte offsets of a generated file back to original file/line/column.
+ * A segment says that the generated bytes from its offset up to the next
+ * segment were copied from one original line starting at (line, column), so
+ * a generator emits one segment per line at most, plus one wherever it
+ * rewrites. The generated file's line starts are kept too, so compiler
+ * positions (line:column) can be converted to offsets. Lookups are a binary
+ * search over the segment offsets.
+ *
+ * Serialized form (sidecar "<output>.map"): "CPSM", version byte 1, then
+ * LEB128 varints: generated size; line count and the length of every line
+ * but the last; file count and each name as length + bytes; segment count
+ * and per segment the offset delta and zigzag deltas of file, line and column
+ * against the previous segment.
+ */
+typedef struct SourceMap SourceMap;
+
+typedef struct {
+    const char* file;   // owned by the map
+    int         line;   // 1-based
+    int         column; // 1-based, in bytes
+} SourcePosition;
+
+/* Empty map for generated[0..size); NULL on allocation failure or size >= 4 GiB */
+SourceMap* source_map_create(const char* generated, size_t size);
+
+/*
+ * Append a segment. Offsets must not decrease and must be within the
+ * generated size; line and column are 1-based. Returns 1 on success.
+ */
+int source_map_add(SourceMap* map, uint32_t offset, const char* file, int line, int column);
+
+/* Map of an identity transform of file: one segment per line */
+SourceMap* source_map_identity(const char* file, const char* source, size_t size);
+
+/* Original position of a generated offset; 0 when no segment covers it */
+int source_map_lookup_offset(const SourceMap* map, uint32_t offset, SourcePosition* out);
+
+/* Same for a 1-based generated line and column; columns past the line end are clamped */
+int source_map_lookup(const SourceMap* map, int line, int column, SourcePosition* out);
+
+/* Serialize into a malloc'd buffer; returns 1 on success */
+int source_map_encode(const SourceMap* map, unsigned char** out_data, size_t* out_size);
+
+/* NULL when data is not a well-formed map or on allocation failure */
+SourceMap* source_map_decode(const unsigned char* data, size_t size);
+
+/* Write / read a sidecar file (written atomically) */
+int source_map_write(const SourceMap* map, const char* path);
+SourceMap* source_map_load(const char* path);
+
+/*
+ * If diag is located in generated_file, move its position (and its range end,
+ * when that maps to the same file) to the original one. file then points into
+ * the map, so the map must outlive the diagnostic; the context snippet is
+ * dropped when the location changes, since it shows generated text. Returns 1
+ * when diag was remapped.
+ */
+int source_map_remap_diagnostic(const SourceMap* map, const char* generated_file, Diagnostic* diag);
+
+/* Remap every entry of list; returns how many were remapped */
+size_t source_map_remap_list(const SourceMap* map, const char* generated_file,
+                             DiagnosticList* list);
+
+size_t source_map_segment_count(const SourceMap* map);
+
+void source_map_destroy(SourceMap* map);
+
+#endif // CPLUS_SOURCE_MAP_H
@@ -0,0 +1,437 @@
+/*
+ * FILE: subprocess.c
+ * DESC.: posix_spawn based child process runner with pipe capture
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* pipe2() */
+#endif
+
+#include "subprocess.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+/* Timeout escalation for one child; inactive when term_at is 0 */
+typedef struct {
+    pid_t    pid;
+    uint64_t term_at;   /* monotonic ns at which SIGTERM is due */
+    uint64_t kill_at;   /* monotonic ns at which SIGKILL is due, once SIGTERM was sent */
+    int      timed_out;
+} Watchdog;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/*
+ * Both pipe ends are close-on-exec: a child spawned concurrently by another
+ * thread must never inherit them, or this pipe would not see EOF until that
+ * unrelated child exits. The write end is re-exposed to our own child via dup2
+ * in the spawn file actions, which clears the flag on the duplicate.
+ *
+ * Descriptors 0..2 are avoided so dup2 onto stdout/stderr is never a no-op.
+ */
+static int open_capture_pipe(int fds[2]) {
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        if (fds[i] > 2) {
+            continue;
+        }
+        int moved = fcntl(fds[i], F_DUPFD_CLOEXEC, 3);
+        if (moved < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return 0;
+        }
+        close(fds[i]);
+        fds[i] = moved;
+    }
+
+    return 1;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+/* Milliseconds from now until at, rounded up so a poll() never wakes early */
+static int ms_until(uint64_t now, uint64_t at) {
+    uint64_t ms = ((at - now) + 999999ULL) / 1000000ULL;
+    return (ms > (uint64_t)INT32_MAX) ? INT32_MAX : (int)ms;
+}
+
+/*
+ * Send whatever signal is due, then return how long poll() may wait before
+ * the next one (-1 = no deadline left). The child leads its process group,
+ * so the signals reach the compiler driver and the programs it started.
+ */
+static int watchdog_step(Watchdog *dog) {
+    if (dog->term_at == 0U) {
+        return -1;
+    }
+    uint64_t now = monotonic_ns();
+    if (dog->timed_out == 0) {
+        if (now < dog->term_at) {
+            return ms_until(now, dog->term_at);
+        }
+        (void)kill(-dog->pid, SIGTERM);
+        dog->timed_out = 1;
+        dog->kill_at   = now + ((uint64_t)SUBPROCESS_KILL_GRACE_MS * 1000000ULL);
+    }
+    if (dog->kill_at != 0U) {
+        if (now < dog->kill_at) {
+            return ms_until(now, dog->kill_at);
+        }
+        (void)kill(-dog->pid, SIGKILL);
+        dog->kill_at = 0U;
+    }
+    return -1;
+}
+
+/* waitpid() that keeps the watchdog running for a child that closed its output early */
+static int reap_child(Watchdog *dog, int *status) {
+    for (;;) {
+        pid_t reaped = waitpid(dog->pid, status, (dog->term_at != 0U) ? WNOHANG : 0);
+        if (reaped == dog->pid) {
+            return 1;
+        }
+        if ((reaped < 0) && (errno != EINTR)) {
+            return 0;
+        }
+        if (reaped == 0) {
+            int wait_ms = watchdog_step(dog);
+            struct timespec pause = {0, 5000000L};
+            if ((wait_ms >= 0) && (wait_ms < 5)) {
+                pause.tv_nsec = (long)wait_ms * 1000000L;
+            }
+            (void)nanosleep(&pause, NULL);
+        }
+    }
+}
+
+/*
+ * PATH lookup as execvp() does it, done before fork() so the child only has
+ * to call async-signal-safe functions. Returns a malloc'd path or NULL.
+ */
+static char *resolve_in_path(const char *name) {
+    if (strchr(name, '/') != NULL) {
+        return strdup(name);
+    }
+    const char *path = getenv("PATH");
+    if (path == NULL) {
+        path = "/bin:/usr/bin";
+    }
+
+    size_t name_len = strlen(name);
+    while (*path != '\0') {
+        const char *sep     = strchr(path, ':');
+        size_t      dir_len = (sep != NULL) ? (size_t)(sep - path) : strlen(path);
+        char       *full    = (char *)malloc(dir_len + name_len + 3U);
+        if (full == NULL) {
+            return NULL;
+        }
+        if (dir_len == 0U) {
+            full[0] = '.'; /* an empty PATH entry is the current directory */
+            dir_len = 1U;
+        } else {
+            memcpy(full, path, dir_len);
+        }
+        full[dir_len] = '/';
+        memcpy(full + dir_len + 1U, name, name_len + 1U);
+        if (access(full, X_OK) == 0) {
+            return full;
+        }
+        free(full);
+        path += (sep != NULL) ? (size_t)(sep - path) + 1U : strlen(path);
+    }
+    return NULL;
+}
+
+/*
+ * fork() + execve() for a child that needs a memory limit, which
+ * posix_spawn() cannot apply. Between the two only async-signal-safe calls
+ * are made. The child gets SIGPIPE back at its default, as in spawn_child().
+ * Returns the pid, or -1 (errno set) when nothing was started.
+ */
+static pid_t fork_limited(const char *path, const char *const argv[], int out_fd,
+                          unsigned long long memory_bytes) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        if (pid > 0) {
+            (void)setpgid(pid, pid); /* also done by the child: whoever runs first wins */
+        }
+        return pid;
+    }
+
+    (void)setpgid(0, 0);
+    (void)signal(SIGPIPE, SIG_DFL);
+    struct rlimit limit = {(rlim_t)memory_bytes, (rlim_t)memory_bytes};
+    int null_fd = open("/dev/null", O_RDONLY);
+    if ((setrlimit(RLIMIT_AS, &limit) != 0) || (null_fd < 0) || (dup2(null_fd, STDIN_FILENO) < 0) ||
+        (dup2(out_fd, STDOUT_FILENO) < 0) || (dup2(out_fd, STDERR_FILENO) < 0)) {
+        _exit(127);
+    }
+    if (null_fd > STDERR_FILENO) {
+        (void)close(null_fd);
+    }
+    (void)execve(path, (char *const *)argv, environ);
+    _exit(127);
+}
+
+/*
+ * posix_spawnp() argv with stdin on /dev/null and stdout/stderr on out_fd.
+ * With own_group the child leads a new process group, so one kill() reaches
+ * everything it starts (e.g. gcc and its cc1). SIGPIPE is always reset to its
+ * default: a caller that ignores it (cplus --serve) must not pass that on.
+ * Returns 0 or an errno value.
+ */
+static int spawn_child(const char *const argv[], int out_fd, int own_group, pid_t *out_pid) {
+    posix_spawn_file_actions_t actions;
+    int setup_rc = posix_spawn_file_actions_init(&actions);
+    if (setup_rc != 0) {
+        return setup_rc;
+    }
+
+    setup_rc = posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    if (setup_rc == 0) {
+        setup_rc = posix_spawn_file_actions_adddup2(&actions, out_fd, STDOUT_FILENO);
+    }
+    if (setup_rc == 0) {
+        setup_rc = posix_spawn_file_actions_adddup2(&actions, out_fd, STDERR_FILENO);
+    }
+
+    posix_spawnattr_t attr;
+    int have_attr = 0;
+    if (setup_rc == 0) {
+        setup_rc  = posix_spawnattr_init(&attr);
+        have_attr = (setup_rc == 0);
+    }
+    if (setup_rc == 0) {
+        int flags = POSIX_SPAWN_SETSIGDEF | ((own_group != 0) ? POSIX_SPAWN_SETPGROUP : 0);
+        setup_rc  = posix_spawnattr_setflags(&attr, (short)flags);
+    }
+    if (setup_rc == 0) {
+        sigset_t defaults;
+        (void)sigemptyset(&defaults);
+        (void)sigaddset(&defaults, SIGPIPE);
+        setup_rc = posix_spawnattr_setsigdefault(&attr, &defaults);
+    }
+    if ((setup_rc == 0) && (own_group != 0)) {
+        setup_rc = posix_spawnattr_setpgroup(&attr, 0);
+    }
+
+    int spawn_rc = (setup_rc == 0)
+        ? posix_spawnp(out_pid, argv[0], &actions, &attr, (char *const *)argv, environ)
+        : setup_rc;
+
+    if (have_attr != 0) {
+        (void)posix_spawnattr_destroy(&attr);
+    }
+    (void)posix_spawn_file_actions_destroy(&actions);
+    return spawn_rc;
+}
+
+/*
+ * Read everything from fd until EOF, waiting with poll(). Each chunk is also
+ * passed to on_chunk (if any); when it returns 0 the child's process group is
+ * killed and reading stops there, with *out_stopped set. The watchdog is
+ * stepped whenever poll() times out.
+ */
+static int drain_pipe(int fd, Watchdog *dog, SubprocessChunkFn on_chunk, void *user,
+                      char **out_buffer, size_t *out_len, int *out_stopped) {
+    size_t capacity = 4096U;
+    size_t length   = 0U;
+    char  *buffer   = (char *)malloc(capacity);
+    if (buffer == NULL) {
+        return 0;
+    }
+
+    struct pollfd pfd = {.fd = fd, .events = POLLIN, .revents = 0};
+
+    for (;;) {
+        int ready = poll(&pfd, 1U, watchdog_step(dog));
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(buffer);
+            return 0;
+        }
+        if (ready == 0) {
+            continue; /* a deadline passed: the next step sends its signal */
+        }
+
+        if (length + 1024U + 1U > capacity) {
+            size_t new_capacity = capacity * 2U;
+            char *resized = (char *)realloc(buffer, new_capacity);
+            if (resized == NULL) {
+                free(buffer);
+                return 0;
+            }
+            buffer   = resized;
+            capacity = new_capacity;
+        }
+
+        ssize_t n = read(fd, buffer + length, capacity - length - 1U);
+        if (n > 0) {
+            if ((on_chunk != NULL) && (on_chunk(user, buffer + length, (size_t)n) == 0)) {
+                length += (size_t)n;
+                (void)kill(-dog->pid, SIGKILL);
+                *out_stopped = 1;
+                break;
+            }
+            length += (size_t)n;
+        } else if (n == 0) {
+            break; /* EOF: every writer has exited */
+        } else if ((errno != EINTR) && (errno != EAGAIN)) {
+            free(buffer);
+            return 0;
+        }
+    }
+
+    buffer[length] = '\0';
+    *out_buffer = buffer;
+    *out_len    = length;
+    return 1;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+int subprocess_run(const char *const argv[], SubprocessResult *result) {
+    return subprocess_run_streaming(argv, NULL, NULL, result);
+}
+
+int subprocess_run_streaming(
+    const char *const argv[],
+    SubprocessChunkFn on_chunk,
+    void             *user,
+    SubprocessResult *result
+) {
+    return subprocess_run_limited(argv, on_chunk, user, NULL, result);
+}
+
+int subprocess_run_limited(
+    const char *const       argv[],
+    SubprocessChunkFn       on_chunk,
+    void                   *user,
+    const SubprocessLimits *limits,
+    SubprocessResult       *result
+) {
+    if ((argv == NULL) || (argv[0] == NULL) || (result == NULL)) {
+        return -1;
+    }
+
+    *result = (SubprocessResult){NULL, 0U, 0, 0, 0ULL, 0};
+
+    unsigned long long timeout_ms   = (limits != NULL) ? limits->timeout_ms : 0ULL;
+    unsigned long long memory_bytes = (limits != NULL) ? limits->memory_bytes : 0ULL;
+    char              *exec_path    = NULL;
+    if (memory_bytes > 0ULL) {
+        exec_path = resolve_in_path(argv[0]);
+        if (exec_path == NULL) {
+            return -1;
+        }
+    }
+
+    int fds[2];
+    if (open_capture_pipe(fds) == 0) {
+        free(exec_path);
+        return -1;
+    }
+
+    /* glibc's posix_spawnp() returns once the child has exec'd (or failed to) */
+    struct timespec spawn_start;
+    struct timespec spawn_end;
+    (void)clock_gettime(CLOCK_MONOTONIC, &spawn_start);
+
+    pid_t pid      = -1;
+    int   spawn_rc = 0;
+    if (exec_path != NULL) {
+        pid      = fork_limited(exec_path, argv, fds[1], memory_bytes);
+        spawn_rc = (pid < 0) ? errno : 0;
+        free(exec_path);
+    } else {
+        spawn_rc = spawn_child(argv, fds[1], (on_chunk != NULL) || (timeout_ms > 0ULL), &pid);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &spawn_end);
+    close(fds[1]); /* only the child writes from here on */
+
+    if (spawn_rc != 0) {
+        close(fds[0]);
+        return -1;
+    }
+
+    Watchdog dog = {pid, 0U, 0U, 0};
+    if (timeout_ms > 0ULL) {
+        dog.term_at = ((uint64_t)spawn_start.tv_sec * 1000000000ULL) +
+                      (uint64_t)spawn_start.tv_nsec + ((uint64_t)timeout_ms * 1000000ULL);
+    }
+
+    char  *captured     = NULL;
+    size_t captured_len = 0U;
+    int    stopped      = 0;
+    int    drained      = drain_pipe(fds[0], &dog, on_chunk, user, &captured, &captured_len,
+                                     &stopped);
+    close(fds[0]);
+
+    int status = 0;
+    if (reap_child(&dog, &status) == 0) {
+        free(captured);
+        return -1;
+    }
+
+    if (drained == 0) {
+        return -1;
+    }
+
+    long long spawn_s  = (long long)(spawn_end.tv_sec - spawn_start.tv_sec);
+    result->output     = captured;
+    result->output_len = captured_len;
+    result->status     = status;
+    result->stopped    = stopped;
+    result->timed_out  = dog.timed_out;
+    result->spawn_ns   = (unsigned long long)((spawn_s * 1000000000LL) +
+                                              (spawn_end.tv_nsec - spawn_start.tv_nsec));
+    return 0;
+}
+
+void subprocess_free_result(SubprocessResult *result) {
+    if (result == NULL) {
+        return;
+    }
+
+    free(result->output);
+    result->output     = NULL;
+    result->output_len = 0U;
+    result->status     = 0;
+    result->stopped    = 0;
+    result->timed_out  = 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * FILE: subprocess.h
+ * DESC.: this file is the declaration of the shell-free child process runner
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_SUBPROCESS_H
+#define CPLUS_SUBPROCESS_H
+
+#include <stddef.h>
+
+typedef struct {
+    char*  output;     // combined stdout + stderr, NUL-terminated; owned
+    size_t output_len;
+    int    status;     // raw wait status, inspect with WIFEXITED & co.
+    int    stopped;    // 1 if the chunk callback stopped the child early
+    unsigned long long spawn_ns; // time posix_spawnp() took, up to the child's exec
+    int    timed_out;  // 1 if the timeout limit fired and the child was terminated
+} SubprocessResult;
+
+/* Time a timed-out child has between SIGTERM and SIGKILL */
+#define SUBPROCESS_KILL_GRACE_MS 1000U
+
+/* Resource limits of one child; zero fields are no limit */
+typedef struct {
+    unsigned long long timeout_ms;   // wall time before SIGTERM, then SIGKILL after a grace period
+    unsigned long long memory_bytes; // RLIMIT_AS of the child and everything it starts
+} SubprocessLimits;
+
+/*
+ * Receives each chunk of child output as soon as it is read (chunks do not
+ * follow line boundaries). Return 1 to continue, 0 to kill the child.
+ */
+typedef int (*SubprocessChunkFn)(void* user, const char* data, size_t len);
+
+/*
+ * Run argv[0] (looked up in PATH) with argv, no shell involved.
+ * stdin is /dev/null; stdout and stderr share one pipe so their relative
+ * order is preserved. Blocks until the child exits.
+ * Returns 0 when the child was spawned and reaped, -1 otherwise.
+ */
+int subprocess_run(const char* const argv[], SubprocessResult* result);
+
+/*
+ * subprocess_run() that also hands every chunk to on_chunk while the child
+ * runs. The child gets its own process group; when on_chunk returns 0 the
+ * whole group (e.g. gcc and its cc1) is killed with SIGKILL, reading stops,
+ * and result->output holds what had arrived until then.
+ */
+int subprocess_run_streaming(
+    const char* const argv[],
+    SubprocessChunkFn on_chunk,
+    void*             user,
+    SubprocessResult* result
+);
+
+/*
+ * subprocess_run_streaming() under limits (NULL = none). A timeout is
+ * measured on the monotonic clock from the spawn; when it passes, the
+ * child's process group gets SIGTERM, then SIGKILL if it is still running
+ * SUBPROCESS_KILL_GRACE_MS later, and result->timed_out is set. A memory
+ * limit is applied with setrlimit(RLIMIT_AS) between fork() and execve(),
+ * so the child is started with fork() instead of posix_spawnp(); a child
+ * over its limit sees allocations fail and typically exits with an error.
+ */
+int subprocess_run_limited(
+    const char* const       argv[],
+    SubprocessChunkFn       on_chunk,
+    void*                   user,
+    const SubprocessLimits* limits,
+    SubprocessResult*       result
+);
+
+void subprocess_free_result(SubprocessResult* result);
+
+#endif // CPLUS_SUBPROCESS_H
@@ -0,0 +1,299 @@
+/*
+ * FILE: trace.c
+ * DESC.: per-stage timing report and Chrome trace-event export
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "trace.h"
+
+#include "arena.h"
+#include "file_io.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+typedef struct {
+    uint64_t    start_ns;  /* since the trace was created */
+    uint64_t    dur_ns;
+    const char* file;      /* in the arena; NULL = none */
+    unsigned    files;
+    unsigned    track;
+    TraceStage  stage;
+} TraceSpan;
+
+struct Trace {
+    pthread_mutex_t lock;
+    pthread_t       creator;
+    uint64_t        origin_ns;
+    Arena*          names;
+    TraceSpan*      spans;
+    size_t          count;
+    size_t          capacity;
+    unsigned        tracks;    /* tracks handed out so far */
+    unsigned        generation;
+};
+
+/*
+ * The track of the calling thread, valid while its trace is the one that
+ * handed it out. A generation counter (not the pointer, which malloc may
+ * reuse) tells traces apart.
+ */
+static _Thread_local unsigned tls_generation;
+static _Thread_local unsigned tls_track;
+
+static unsigned g_generation;
+static pthread_mutex_t g_generation_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *const k_stage_names[TRACE_STAGE_COUNT] = {
+    [TRACE_READ]     = "read",
+    [TRACE_PRECHECK] = "precheck",
+    [TRACE_CACHE]    = "cache",
+    [TRACE_PCH]      = "pch",
+    [TRACE_SPAWN]    = "spawn",
+    [TRACE_COMPILE]  = "compile",
+    [TRACE_PARSE]    = "parse",
+    [TRACE_WRITE]    = "write",
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/* Track of the calling thread; trace->lock must be held */
+static unsigned track_of_caller(Trace *trace) {
+    if (tls_generation != trace->generation) {
+        tls_generation = trace->generation;
+        tls_track      = (pthread_equal(pthread_self(), trace->creator) != 0) ? 0U
+                                                                               : ++trace->tracks;
+    }
+    return tls_track;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted[0..n), n > 0 */
+static uint64_t percentile(const uint64_t *sorted, size_t n, unsigned pct) {
+    size_t rank = ((n * pct) + 99U) / 100U;
+    return sorted[(rank > 0U) ? rank - 1U : 0U];
+}
+
+static double ms(uint64_t ns) {
+    return (double)ns / 1e6;
+}
+
+static void fprint_json_string(FILE *out, const char *text) {
+    (void)fputc('"', out);
+    for (const unsigned char *p = (const unsigned char *)text; *p != '\0'; ++p) {
+        if ((*p == '"') || (*p == '\\')) {
+            (void)fprintf(out, "\\%c", *p);
+        } else if (*p < 0x20U) {
+            (void)fprintf(out, "\\u%04x", (unsigned)*p);
+        } else {
+            (void)fputc(*p, out);
+        }
+    }
+    (void)fputc('"', out);
+}
+
+/* Microseconds with nanosecond precision, as Chrome expects for ts and dur */
+static void fprint_us(FILE *out, uint64_t ns) {
+    (void)fprintf(out, "%llu.%03llu", (unsigned long long)(ns / 1000U),
+                  (unsigned long long)(ns % 1000U));
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+Trace *trace_create(void) {
+    Trace *trace = (Trace *)calloc(1U, sizeof(Trace));
+    if (trace == NULL) {
+        return NULL;
+    }
+
+    trace->names = arena_create(16384U);
+    if ((trace->names == NULL) || (pthread_mutex_init(&trace->lock, NULL) != 0)) {
+        arena_destroy(trace->names);
+        free(trace);
+        return NULL;
+    }
+
+    (void)pthread_mutex_lock(&g_generation_lock);
+    trace->generation = ++g_generation;
+    (void)pthread_mutex_unlock(&g_generation_lock);
+
+    trace->creator   = pthread_self();
+    trace->origin_ns = monotonic_ns();
+    return trace;
+}
+
+uint64_t trace_now(const Trace *trace) {
+    return (trace != NULL) ? monotonic_ns() : 0U;
+}
+
+void trace_end(Trace *trace, TraceStage stage, const char *file, unsigned files,
+               uint64_t start_ns) {
+    if (trace != NULL) {
+        trace_span(trace, stage, file, files, start_ns, monotonic_ns());
+    }
+}
+
+void trace_span(Trace *trace, TraceStage stage, const char *file, unsigned files, uint64_t start_ns,
+                uint64_t end_ns) {
+    if ((trace == NULL) || ((unsigned)stage >= (unsigned)TRACE_STAGE_COUNT)) {
+        return;
+    }
+
+    (void)pthread_mutex_lock(&trace->lock);
+    if (trace->count == trace->capacity) {
+        size_t     capacity = (trace->capacity > 0U) ? trace->capacity * 2U : 256U;
+        TraceSpan *grown    = (TraceSpan *)realloc(trace->spans, capacity * sizeof(TraceSpan));
+        if (grown == NULL) {
+            (void)pthread_mutex_unlock(&trace->lock);
+            return;
+        }
+        trace->spans    = grown;
+        trace->capacity = capacity;
+    }
+
+    /* A span that started before the trace (or a bogus start) is clamped to it */
+    uint64_t start = (start_ns > trace->origin_ns) ? start_ns : trace->origin_ns;
+    TraceSpan *span = &trace->spans[trace->count++];
+    span->start_ns = start - trace->origin_ns;
+    span->dur_ns   = (end_ns > start) ? end_ns - start : 0U;
+    span->file     = (file != NULL) ? arena_strndup(trace->names, file, strlen(file)) : NULL;
+    span->files    = files;
+    span->track    = track_of_caller(trace);
+    span->stage    = stage;
+    (void)pthread_mutex_unlock(&trace->lock);
+}
+
+const char *trace_stage_name(TraceStage stage) {
+    return ((unsigned)stage < (unsigned)TRACE_STAGE_COUNT) ? k_stage_names[stage] : "unknown";
+}
+
+void trace_fprint_report(const Trace *trace, FILE *stream) {
+    if ((trace == NULL) || (stream == NULL)) {
+        return;
+    }
+
+    Trace *locked = (Trace *)trace;
+    (void)pthread_mutex_lock(&locked->lock);
+
+    uint64_t wall = monotonic_ns() - trace->origin_ns;
+    (void)fprintf(stream, "cplus: time report, %.3f ms wall, %u worker track%s\n", ms(wall),
+                  trace->tracks, (trace->tracks == 1U) ? "" : "s");
+    (void)fprintf(stream, "  %-9s %7s %12s %10s %10s %10s %10s\n", "stage", "spans", "total ms",
+                  "mean ms", "p50 ms", "p95 ms", "max ms");
+
+    uint64_t *durations = (uint64_t *)malloc((trace->count + 1U) * sizeof(uint64_t));
+    for (int stage = 0; (durations != NULL) && (stage < (int)TRACE_STAGE_COUNT); ++stage) {
+        size_t   n     = 0U;
+        uint64_t total = 0U;
+        for (size_t i = 0U; i < trace->count; ++i) {
+            if (trace->spans[i].stage == (TraceStage)stage) {
+                durations[n++] = trace->spans[i].dur_ns;
+                total += trace->spans[i].dur_ns;
+            }
+        }
+        if (n == 0U) {
+            continue;
+        }
+
+        qsort(durations, n, sizeof(uint64_t), compare_u64);
+        (void)fprintf(stream, "  %-9s %7zu %12.3f %10.3f %10.3f %10.3f %10.3f\n",
+                      k_stage_names[stage], n, ms(total), ms(total) / (double)n,
+                      ms(percentile(durations, n, 50U)), ms(percentile(durations, n, 95U)),
+                      ms(durations[n - 1U]));
+    }
+    free(durations);
+
+    (void)pthread_mutex_unlock(&locked->lock);
+}
+
+int trace_write_chrome(const Trace *trace, const char *path) {
+    if ((trace == NULL) || (path == NULL)) {
+        return 0;
+    }
+
+    char  *data = NULL;
+    size_t size = 0U;
+    FILE  *out  = open_memstream(&data, &size);
+    if (out == NULL) {
+        return 0;
+    }
+
+    Trace *locked = (Trace *)trace;
+    (void)pthread_mutex_lock(&locked->lock);
+
+    (void)fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    (void)fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+                       "\"args\":{\"name\":\"cplus\"}}");
+    for (unsigned track = 0U; track <= trace->tracks; ++track) {
+        (void)fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"name\":",
+                      track);
+        if (track == 0U) {
+            (void)fprintf(out, "\"main\"}}");
+        } else {
+            (void)fprintf(out, "\"worker %u\"}}", track);
+        }
+    }
+
+    for (size_t i = 0U; i < trace->count; ++i) {
+        const TraceSpan *span = &trace->spans[i];
+        (void)fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"cplus\",\"ph\":\"X\",\"pid\":1,"
+                           "\"tid\":%u,\"ts\":",
+                      k_stage_names[span->stage], span->track);
+        fprint_us(out, span->start_ns);
+        (void)fprintf(out, ",\"dur\":");
+        fprint_us(out, span->dur_ns);
+        (void)fprintf(out, ",\"args\":{");
+        if (span->file != NULL) {
+            (void)fprintf(out, "\"file\":");
+            fprint_json_string(out, span->file);
+            (void)fputc(',', out);
+        }
+        (void)fprintf(out, "\"files\":%u}}", span->files);
+    }
+    (void)fprintf(out, "\n]}\n");
+
+    (void)pthread_mutex_unlock(&locked->lock);
+
+    int ok = (fclose(out) == 0) && (file_io_write_atomic(path, data, size) != 0);
+    free(data);
+    return ok;
+}
+
+void trace_destroy(Trace *trace) {
+    if (trace == NULL) {
+        return;
+    }
+
+    (void)pthread_mutex_destroy(&trace->lock);
+    arena_destroy(trace->names);
+    free(trace->spans);
+    free(trace);
+}
@@ -0,0 +1,75 @@
+/*
+ * FILE: trace.h
+ * DESC.: this file is the declaration of the per-stage timing recorder
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_TRACE_H
+#define CPLUS_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Pipeline stages a run spends its time in */
+typedef enum {
+    TRACE_READ,     // loading an input into memory
+    TRACE_PRECHECK, // lexical pre-check
+    TRACE_CACHE,    // validation cache key, lookup and store
+    TRACE_PCH,      // picking and compiling the shared include block
+    TRACE_SPAWN,    // posix_spawnp() of the compiler, up to its exec
+    TRACE_COMPILE,  // compiler running, output drained, child reaped
+    TRACE_PARSE,    // parsing the compiler's diagnostics
+    TRACE_WRITE,    // emitting the output and its source map
+    TRACE_STAGE_COUNT
+} TraceStage;
+
+/*
+ * Timed spans of a run, recorded by any thread. Each thread gets its own
+ * track, numbered in the order it first records (the creating thread is
+ * "main", the others "worker N"), so a trace shows what every worker was
+ * doing and where it sat idle. Recording takes a mutex; spans are few (a
+ * handful per file), so it never shows up next to a compiler run.
+ */
+typedef struct Trace Trace;
+
+/* NULL on allocation failure */
+Trace* trace_create(void);
+
+/*
+ * Monotonic clock in nanoseconds, or 0 when trace is NULL, so call sites can
+ * time unconditionally and pay nothing when tracing is off.
+ */
+uint64_t trace_now(const Trace* trace);
+
+/*
+ * Record a span of stage from start_ns (a trace_now() value) until now. file
+ * is copied; files > 1 marks a span shared by a batch whose first input is
+ * file. No-op when trace is NULL.
+ */
+void trace_end(Trace* trace, TraceStage stage, const char* file, unsigned files, uint64_t start_ns);
+
+/* Same with an explicit end, for spans measured elsewhere */
+void trace_span(Trace* trace, TraceStage stage, const char* file, unsigned files, uint64_t start_ns,
+                uint64_t end_ns);
+
+const char* trace_stage_name(TraceStage stage);
+
+/*
+ * Per stage: spans, total, mean, p50, p95 and max, plus the wall time since
+ * trace_create(). A span is one file, except for batched compiler runs (and
+ * the PCH), which count once.
+ */
+void trace_fprint_report(const Trace* trace, FILE* stream);
+
+/*
+ * Chrome trace-event JSON ("X" complete events, microseconds, one tid per
+ * track with its thread_name), for chrome://tracing or Perfetto. Written
+ * atomically; returns 1 on success.
+ */
+int trace_write_chrome(const Trace* trace, const char* path);
+
+void trace_destroy(Trace* trace);
+
+#endif // CPLUS_TRACE_H
@@ -0,0 +1,466 @@
+/*
+ * FILE: validation_cache.c
+ * DESC.: content-addressed on-disk cache of compiler validation results
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "validation_cache.h"
+
+#include "cache_dir.h"
+#include "compiler_probe.h"
+#include "file_io.h"
+#include "file_memo.h"
+#include "hash.h"
+#include "include_scan.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------
+ * Internal data structures
+ * ---------------------------------------------------------------------- */
+
+#define ENTRY_FORMAT_TAG  "cplus-vcache 1"
+#define KEY_FORMAT_TAG    "cplus-vkey 2"
+#define MAX_CLOSURE_FILES 4096U
+#define STALE_TEMP_NS     (3600LL * 1000000000LL) /* abandoned temp files: 1 hour */
+
+struct ValidationCache {
+    char*              dir;          /* <cache root>/validation */
+    unsigned long long max_bytes;
+    atomic_size_t      hits;
+    atomic_size_t      misses;
+    atomic_size_t      stores;
+};
+
+/* Work list for the transitive .hplus closure */
+typedef struct {
+    char**      paths;
+    size_t      count;
+    size_t      capacity;
+    const char* includer;    /* file currently being scanned */
+    int         overflow;    /* allocation failure or too many files */
+} IncludeClosure;
+
+typedef struct {
+    char*     path;
+    long long mtime_ns;
+    long long size;
+} TrimEntry;
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+static long long stat_mtime_ns(const struct stat *st) {
+    return (long long)st->st_mtim.tv_sec * 1000000000LL + (long long)st->st_mtim.tv_nsec;
+}
+
+/* Queue a resolved header path (taken over) unless it is queued already */
+static int closure_add(IncludeClosure *closure, char *resolved) {
+    for (size_t i = 0U; i < closure->count; ++i) {
+        if (strcmp(closure->paths[i], resolved) == 0) {
+            free(resolved);
+            return 1; /* already queued: include cycles and diamonds end here */
+        }
+    }
+
+    if (closure->count == closure->capacity) {
+        size_t new_cap = (closure->capacity == 0U) ? 16U : closure->capacity * 2U;
+        char **resized = (new_cap <= MAX_CLOSURE_FILES)
+            ? (char **)realloc(closure->paths, new_cap * sizeof(char *))
+            : NULL;
+        if (resized == NULL) {
+            free(resolved);
+            closure->overflow = 1;
+            return 0;
+        }
+        closure->paths    = resized;
+        closure->capacity = new_cap;
+    }
+
+    closure->paths[closure->count++] = resolved;
+    return 1;
+}
+
+static int closure_push(void *user, const char *name, size_t name_len) {
+    IncludeClosure *closure = (IncludeClosure *)user;
+
+    char *resolved = include_resolve(closure->includer, name, name_len);
+    if (resolved == NULL) {
+        closure->overflow = 1;
+        return 0;
+    }
+    return closure_add(closure, resolved);
+}
+
+/*
+ * Hash path + size + content hash of every quoted include reachable from the
+ * input ("*.hplus" and plain "*.h" alike), in a deterministic breadth-first
+ * order. Missing headers — including quoted names the compiler finds on its
+ * own search path — hash as a marker, so creating one later changes the key. Headers come from the
+ * file_memo, so each is read once per process while it does not change.
+ */
+static int hash_include_closure(HashState *state, const char *input_path,
+                                const char *source, size_t size) {
+    IncludeClosure closure = {NULL, 0U, 0U, input_path, 0};
+    (void)include_scan_quoted(source, size, closure_push, &closure);
+
+    for (size_t i = 0U; (i < closure.count) && (closure.overflow == 0); ++i) {
+        FileFacts facts;
+        hash_update_str(state, closure.paths[i]);
+        if (file_memo_get(closure.paths[i], &facts) == 0) {
+            hash_update_str(state, "<missing>");
+            continue;
+        }
+
+        hash_update(state, &facts.size, sizeof(facts.size));
+        hash_update(state, &facts.hash, sizeof(facts.hash));
+
+        for (size_t at = 0U; (at < facts.includes_len) && (closure.overflow == 0);) {
+            const char *name = facts.includes + at;
+            size_t      len  = strlen(name);
+            char       *copy = strdup(name);
+            if ((copy == NULL) || (closure_add(&closure, copy) == 0)) {
+                closure.overflow = 1;
+            }
+            at += len + 1U;
+        }
+        free(facts.includes);
+    }
+
+    int ok = (closure.overflow == 0);
+    for (size_t i = 0U; i < closure.count; ++i) {
+        free(closure.paths[i]);
+    }
+    free(closure.paths);
+    return ok;
+}
+
+/* "<dir>/<first 2 hex>/<remaining 14 hex>"; creates the shard dir if asked */
+static char *entry_path(const ValidationCache *cache, uint64_t key, int create_shard) {
+    char hex[17];
+    hash_to_hex(key, hex);
+
+    size_t dir_len = strlen(cache->dir);
+    char *path = (char *)malloc(dir_len + 20U);
+    if (path == NULL) {
+        return NULL;
+    }
+
+    memcpy(path, cache->dir, dir_len);
+    path[dir_len]      = '/';
+    path[dir_len + 1U] = hex[0];
+    path[dir_len + 2U] = hex[1];
+    path[dir_len + 3U] = '\0';
+
+    if ((create_shard != 0) && (mkdir(path, 0777) != 0) && (errno != EEXIST)) {
+        free(path);
+        return NULL;
+    }
+
+    path[dir_len + 3U] = '/';
+    memcpy(path + dir_len + 4U, hex + 2, 15U); /* 14 digits + NUL */
+    return path;
+}
+
+static int compare_trim_entries(const void *a, const void *b) {
+    const TrimEntry *ea = (const TrimEntry *)a;
+    const TrimEntry *eb = (const TrimEntry *)b;
+    return (ea->mtime_ns > eb->mtime_ns) - (ea->mtime_ns < eb->mtime_ns);
+}
+
+static int trim_push(TrimEntry **entries, size_t *count, size_t *capacity,
+                     char *path, const struct stat *st) {
+    if (*count == *capacity) {
+        size_t new_cap = (*capacity == 0U) ? 256U : *capacity * 2U;
+        TrimEntry *resized = (TrimEntry *)realloc(*entries, new_cap * sizeof(TrimEntry));
+        if (resized == NULL) {
+            return 0;
+        }
+        *entries  = resized;
+        *capacity = new_cap;
+    }
+
+    (*entries)[(*count)++] = (TrimEntry){path, stat_mtime_ns(st), (long long)st->st_size};
+    return 1;
+}
+
+/*
+ * LRU eviction: list every entry, drop abandoned temp files, and if the total
+ * exceeds max_bytes remove the oldest (by mtime) until 90% of the bound.
+ */
+static void trim_cache(const ValidationCache *cache) {
+    DIR *top = opendir(cache->dir);
+    if (top == NULL) {
+        return;
+    }
+
+    TrimEntry *entries  = NULL;
+    size_t     count    = 0U;
+    size_t     capacity = 0U;
+    long long  total    = 0;
+
+    struct timespec now;
+    (void)clock_gettime(CLOCK_REALTIME, &now);
+    long long now_ns = (long long)now.tv_sec * 1000000000LL + (long long)now.tv_nsec;
+
+    for (struct dirent *shard = readdir(top); shard != NULL; shard = readdir(top)) {
+        if ((shard->d_name[0] == '.') || (strlen(shard->d_name) != 2U)) {
+            continue;
+        }
+
+        char shard_path[4096];
+        if ((size_t)snprintf(shard_path, sizeof(shard_path), "%s/%s", cache->dir, shard->d_name) >=
+            sizeof(shard_path)) {
+            continue;
+        }
+
+        DIR *sub = opendir(shard_path);
+        if (sub == NULL) {
+            continue;
+        }
+        size_t shard_len = strlen(shard_path);
+
+        for (struct dirent *e = readdir(sub); e != NULL; e = readdir(sub)) {
+            if (e->d_name[0] == '.') {
+                continue;
+            }
+
+            size_t name_len = strlen(e->d_name);
+            char *path = (char *)malloc(shard_len + name_len + 2U);
+            if (path == NULL) {
+                continue;
+            }
+            memcpy(path, shard_path, shard_len);
+            path[shard_len] = '/';
+            memcpy(path + shard_len + 1U, e->d_name, name_len + 1U);
+
+            struct stat st;
+            if ((stat(path, &st) != 0) || !S_ISREG(st.st_mode)) {
+                free(path);
+                continue;
+            }
+
+            int is_temp = (name_len > 4U) && (strcmp(e->d_name + name_len - 4U, ".tmp") == 0);
+            if (is_temp) {
+                if (now_ns - stat_mtime_ns(&st) > STALE_TEMP_NS) {
+                    (void)unlink(path);
+                }
+                free(path);
+                continue;
+            }
+
+            total += (long long)st.st_size;
+            if (trim_push(&entries, &count, &capacity, path, &st) == 0) {
+                free(path);
+            }
+        }
+        closedir(sub);
+    }
+    closedir(top);
+
+    if ((unsigned long long)total > cache->max_bytes) {
+        long long target = (long long)(cache->max_bytes / 10ULL * 9ULL);
+        qsort(entries, count, sizeof(TrimEntry), compare_trim_entries);
+        for (size_t i = 0U; (i < count) && (total > target); ++i) {
+            if (unlink(entries[i].path) == 0) {
+                total -= entries[i].size;
+            }
+        }
+    }
+
+    for (size_t i = 0U; i < count; ++i) {
+        free(entries[i].path);
+    }
+    free(entries);
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+ValidationCache *validation_cache_open(unsigned long long max_bytes) {
+    char *dir = cache_dir_subdir("validation");
+    if (dir == NULL) {
+        return NULL;
+    }
+
+    ValidationCache *cache = (ValidationCache *)calloc(1U, sizeof(ValidationCache));
+    if (cache == NULL) {
+        free(dir);
+        return NULL;
+    }
+
+    cache->dir       = dir;
+    cache->max_bytes = (max_bytes > 0ULL) ? max_bytes : VALIDATION_CACHE_DEFAULT_MAX_BYTES;
+    atomic_init(&cache->hits, 0U);
+    atomic_init(&cache->misses, 0U);
+    atomic_init(&cache->stores, 0U);
+    return cache;
+}
+
+void validation_cache_close(ValidationCache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    if (atomic_load(&cache->stores) > 0U) {
+        trim_cache(cache);
+    }
+
+    free(cache->dir);
+    free(cache);
+}
+
+int validation_cache_key(
+    const char *compiler,
+    const char *std_name,
+    int         max_errors,
+    int         format,
+    const char *input_path,
+    const char *source,
+    size_t      size,
+    uint64_t   *out_key
+) {
+    if ((compiler == NULL) || (std_name == NULL) || (input_path == NULL) ||
+        (source == NULL) || (out_key == NULL)) {
+        return 0;
+    }
+
+    const CompilerCaps *caps = compiler_probe(compiler);
+    if (caps->resolved_path == NULL) {
+        return 0;
+    }
+
+    HashState state;
+    hash_init(&state, 0U);
+    hash_update_str(&state, KEY_FORMAT_TAG);
+
+    hash_update_str(&state, caps->resolved_path);
+    hash_update(&state, &caps->binary_size, sizeof(caps->binary_size));
+    hash_update(&state, &caps->binary_mtime_ns, sizeof(caps->binary_mtime_ns));
+    hash_update_str(&state, std_name);
+    hash_update(&state, &max_errors, sizeof(max_errors));
+    hash_update(&state, &format, sizeof(format));
+
+    /* Diagnostics quote the path as given, so it is part of the key */
+    hash_update_str(&state, input_path);
+    hash_update(&state, &size, sizeof(size));
+    hash_update(&state, source, size);
+
+    if (hash_include_closure(&state, input_path, source, size) == 0) {
+        return 0;
+    }
+
+    *out_key = hash_final(&state);
+    return 1;
+}
+
+int validation_cache_lookup(ValidationCache *cache, uint64_t key, ValidationResult *out) {
+    if ((cache == NULL) || (out == NULL)) {
+        return 0;
+    }
+
+    char *path = entry_path(cache, key, 0);
+    if (path == NULL) {
+        return 0;
+    }
+
+    size_t size = 0U;
+    char *data = file_io_read_all(path, &size);
+    if (data == NULL) {
+        free(path);
+        atomic_fetch_add(&cache->misses, 1U);
+        return 0;
+    }
+
+    int    success   = 0;
+    int    exit_code = 0;
+    size_t raw_len   = 0U;
+    int    header_len = 0;
+
+    int fields = sscanf(data, ENTRY_FORMAT_TAG "\n%d %d %zu\n%n", &success, &exit_code, &raw_len,
+                        &header_len);
+    if ((fields != 3) || (header_len <= 0) || ((size_t)header_len + raw_len != size)) {
+        free(data);
+        (void)unlink(path); /* corrupt or foreign entry */
+        free(path);
+        atomic_fetch_add(&cache->misses, 1U);
+        return 0;
+    }
+
+    /* Recency for LRU eviction */
+    (void)utimensat(AT_FDCWD, path, NULL, 0);
+    free(path);
+
+    memmove(data, data + header_len, raw_len + 1U); /* keeps the trailing NUL */
+
+    out->success    = (success != 0) ? 1 : 0;
+    out->exit_code  = exit_code;
+    out->raw_output = data;
+
+    atomic_fetch_add(&cache->hits, 1U);
+    return 1;
+}
+
+void validation_cache_store(ValidationCache *cache, uint64_t key, const ValidationResult *result) {
+    if ((cache == NULL) || (result == NULL) || (result->exit_code < 0) ||
+        (result->raw_output == NULL)) {
+        return;
+    }
+
+    char *path = entry_path(cache, key, 1);
+    if (path == NULL) {
+        return;
+    }
+
+    size_t raw_len = strlen(result->raw_output);
+    char header[64];
+    int header_len = snprintf(header, sizeof(header), ENTRY_FORMAT_TAG "\n%d %d %zu\n",
+                              result->success, result->exit_code, raw_len);
+
+    char *data = (char *)malloc((size_t)header_len + raw_len);
+    if (data != NULL) {
+        memcpy(data, header, (size_t)header_len);
+        memcpy(data + header_len, result->raw_output, raw_len);
+        if (file_io_write_atomic(path, data, (size_t)header_len + raw_len) != 0) {
+            atomic_fetch_add(&cache->stores, 1U);
+        }
+        free(data);
+    }
+
+    free(path);
+}
+
+void validation_cache_counters(ValidationCache *cache, size_t *out_hits, size_t *out_misses) {
+    size_t hits   = 0U;
+    size_t misses = 0U;
+
+    if (cache != NULL) {
+        hits   = atomic_load(&cache->hits);
+        misses = atomic_load(&cache->misses);
+    }
+
+    if (out_hits != NULL) {
+        *out_hits = hits;
+    }
+    if (out_misses != NULL) {
+        *out_misses = misses;
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * FILE: validation_cache.h
+ * DESC.: this file is the declaration of the content-addressed validation cache
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#ifndef CPLUS_VALIDATION_CACHE_H
+#define CPLUS_VALIDATION_CACHE_H
+
+#include "compiler_validator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Default bound for the entries under <cache root>/validation */
+#define VALIDATION_CACHE_DEFAULT_MAX_BYTES (256ULL * 1024ULL * 1024ULL)
+
+/*
+ * On-disk cache of ValidationResult, one file per key under
+ * <cache root>/validation/<2 hex>/<14 hex>. Entries are written with
+ * temp-file + rename(), so any number of threads and processes can share it.
+ * A hit bumps the entry mtime; validation_cache_close() evicts the least
+ * recently used entries once the directory grows beyond max_bytes.
+ */
+typedef struct ValidationCache ValidationCache;
+
+/* Open (creating) the cache under the current cache root; NULL if disabled */
+ValidationCache* validation_cache_open(unsigned long long max_bytes);
+
+/* Trim to max_bytes if anything was stored, then free the handle */
+void validation_cache_close(ValidationCache* cache);
+
+/*
+ * Key for validating input_path (whose bytes are source[0..size)) with
+ * compiler/std_name/max_errors/format. Covers the source, the path and content
+ * of every transitively included "*.hplus", the compiler binary identity,
+ * std_name, the error limit (which truncates the compiler output) and the
+ * diagnostics format (a DiagnosticFormat; it decides what raw_output holds).
+ * Returns 1 on success, 0 when no stable key exists (e.g. compiler not found).
+ */
+int validation_cache_key(
+    const char* compiler,
+    const char* std_name,
+    int         max_errors,
+    int         format,
+    const char* input_path,
+    const char* source,
+    size_t      size,
+    uint64_t*   out_key
+);
+
+/* Returns 1 and fills *out (caller frees with validator_free_result) on a hit */
+int validation_cache_lookup(ValidationCache* cache, uint64_t key, ValidationResult* out);
+
+/* Store a result; results of compilers that could not be run are ignored */
+void validation_cache_store(ValidationCache* cache, uint64_t key, const ValidationResult* result);
+
+void validation_cache_counters(ValidationCache* cache, size_t* out_hits, size_t* out_misses);
+
+#endif // CPLUS_VALIDATION_CACHE_H
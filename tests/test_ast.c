@@ -0,0 +1,174 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_ast.c
+ * DESC.: validates the arena-backed AST builder and the token tree
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "ast.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Nodes reachable from index; every child must precede its parent */
+static size_t count_reachable(const Ast *ast, AstIndex index) {
+    uint32_t        n    = 0U;
+    const AstIndex *kids = ast_children(ast, index, &n);
+    size_t          total = 1U;
+    for (uint32_t k = 0U; k < n; ++k) {
+        if (kids[k] >= index) {
+            return 0U;
+        }
+        total += count_reachable(ast, kids[k]);
+    }
+    return total;
+}
+
+/* Kinds of the children of index, one letter each: T U D I P K B t */
+static void shape(const Ast *ast, AstIndex index, char *out) {
+    static const char letters[] = "UDIPKBt";
+    uint32_t        n    = 0U;
+    const AstIndex *kids = ast_children(ast, index, &n);
+    for (uint32_t k = 0U; k < n; ++k) {
+        out[k] = letters[ast_node(ast, kids[k])->kind];
+    }
+    out[n] = '\0';
+}
+
+static AstIndex build(Ast *ast, TokenBuffer *tokens, const char *source) {
+    if (lexer_tokenize(source, strlen(source), tokens) == 0) {
+        return AST_NONE;
+    }
+    return ast_build_token_tree(ast, source, tokens);
+}
+
+int main(void) {
+    Ast *ast = ast_create(1024U);
+    if (ast == NULL) {
+        fprintf(stderr, "ast_create failed\n");
+        return 1;
+    }
+
+    /* Builder: post-order numbering, contiguous children, token spans */
+    ast_begin(ast, AST_TRANSLATION_UNIT, 0U);
+    AstIndex a = ast_leaf(ast, AST_TOKEN, 0U);
+    ast_begin(ast, AST_PARENS, 1U);
+    AstIndex b = ast_leaf(ast, AST_TOKEN, 2U);
+    AstIndex p = ast_end(ast, 4U);
+    AstIndex u = ast_end(ast, 4U);
+    if ((ast_finish(ast) != u) || (a != 0U) || (b != 1U) || (p != 2U) || (u != 3U) ||
+        (ast_node_count(ast) != 4U) || (ast_node(ast, p)->token != 1U) ||
+        (ast_node(ast, p)->token_end != 4U) || (ast_node(ast, b)->token_end != 3U)) {
+        fprintf(stderr, "builder: unexpected numbering\n");
+        return 1;
+    }
+    uint32_t        n    = 0U;
+    const AstIndex *kids = ast_children(ast, u, &n);
+    if ((n != 2U) || (kids[0] != a) || (kids[1] != p) || (ast_children(ast, a, &n) != NULL) ||
+        (n != 0U)) {
+        fprintf(stderr, "builder: unexpected children\n");
+        return 1;
+    }
+
+    /* Unbalanced building is reported once, at the end */
+    ast_reset(ast);
+    ast_begin(ast, AST_TRANSLATION_UNIT, 0U);
+    (void)ast_leaf(ast, AST_TOKEN, 0U);
+    if ((ast_finish(ast) != AST_NONE) || (ast_root(ast) != AST_NONE)) {
+        fprintf(stderr, "builder: open node accepted\n");
+        return 1;
+    }
+
+    /* Token tree: directives, items, groups */
+    TokenBuffer tokens = {NULL, NULL, NULL, NULL, 0U, 0U};
+    const char *source = "#include <stdio.h>\n"
+                         "struct s { int x; } v;\n"
+                         "int f(int a<:2:>) { return (a[0]); }\n"
+                         "int g(void);\n";
+    AstIndex root = build(ast, &tokens, source);
+    char     buf[64];
+    if (root == AST_NONE) {
+        fprintf(stderr, "token tree: rejected\n");
+        return 1;
+    }
+    shape(ast, root, buf);
+    if (strcmp(buf, "DIII") != 0) {
+        fprintf(stderr, "token tree: top level is '%s'\n", buf);
+        return 1;
+    }
+    kids = ast_children(ast, root, &n);
+    shape(ast, kids[1], buf);
+    if (strcmp(buf, "ttBtt") != 0) {
+        fprintf(stderr, "token tree: struct item is '%s'\n", buf);
+        return 1;
+    }
+    shape(ast, kids[2], buf);
+    if (strcmp(buf, "ttPB") != 0) {
+        fprintf(stderr, "token tree: function item is '%s'\n", buf);
+        return 1;
+    }
+    uint32_t        n_fn = 0U;
+    const AstIndex *fn   = ast_children(ast, kids[2], &n_fn);
+    shape(ast, fn[2], buf);
+    if ((strcmp(buf, "ttK") != 0) ||
+        (ast_node(ast, fn[3])->token_end != ast_node(ast, kids[2])->token_end)) {
+        fprintf(stderr, "token tree: parameters are '%s'\n", buf);
+        return 1;
+    }
+    if (count_reachable(ast, root) != ast_node_count(ast) ||
+        (ast_node(ast, root)->token_end != tokens.count - 1U)) {
+        fprintf(stderr, "token tree: not every node is reachable\n");
+        return 1;
+    }
+
+    /* Unbalanced sources have no token tree */
+    if ((build(ast, &tokens, "int f(void) { (]; }") != AST_NONE) ||
+        (build(ast, &tokens, "int x; }") != AST_NONE) ||
+        (build(ast, &tokens, "int f(void) {") != AST_NONE)) {
+        fprintf(stderr, "token tree: unbalanced source accepted\n");
+        return 1;
+    }
+
+    /*
+     * A large file: node and child-list runs spill over many pages, and the
+     * translation unit's own list is longer than a page.
+     */
+    const char *item  = "static int v(int x) { return x[0] + (1); }\n";
+    size_t      items = 20000U;
+    size_t      len   = strlen(item);
+    char       *big   = (char *)malloc(items * len + 1U);
+    if (big == NULL) {
+        return 1;
+    }
+    for (size_t k = 0U; k < items; ++k) {
+        memcpy(big + k * len, item, len);
+    }
+    big[items * len] = '\0';
+
+    for (int round = 0; round < 2; ++round) {
+        root = build(ast, &tokens, big);
+        kids = (root != AST_NONE) ? ast_children(ast, root, &n) : NULL;
+        if ((kids == NULL) || (n != items) || (count_reachable(ast, root) != ast_node_count(ast))) {
+            fprintf(stderr, "large tree: round %d failed\n", round);
+            return 1;
+        }
+        for (uint32_t k = 0U; k < n; ++k) {
+            const AstNode *node = ast_node(ast, kids[k]);
+            if ((node->kind != AST_ITEM) || (node->token_end - node->token != 19U)) {
+                fprintf(stderr, "large tree: item %u is wrong\n", k);
+                return 1;
+            }
+        }
+    }
+    free(big);
+
+    token_buffer_free(&tokens);
+    ast_destroy(ast);
+    return 0;
+}
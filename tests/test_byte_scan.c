@@ -0,0 +1,56 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_byte_scan.c
+ * DESC.: validates the vectorised two-byte scanner against a plain loop
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "byte_scan.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *naive(const char *p, const char *end, char a, char b) {
+    while ((p < end) && (*p != a) && (*p != b)) {
+        ++p;
+    }
+    return p;
+}
+
+int main(void) {
+    char buf[80];
+
+    /* Every start offset, length and match position, across the 16/8-byte steps */
+    for (size_t len = 0U; len <= 64U; ++len) {
+        for (size_t hit = 0U; hit <= len; ++hit) {
+            memset(buf, 'x', sizeof(buf));
+            if (hit < len) {
+                buf[1U + hit] = ((hit % 2U) == 0U) ? ':' : '\n';
+            }
+            buf[1U + len] = ':'; /* just past the end: must not be found */
+
+            const char *start = buf + 1;
+            const char *end   = start + len;
+            const char *got   = byte_scan_either(start, end, ':', '\n');
+            if (got != naive(start, end, ':', '\n')) {
+                fprintf(stderr, "len %zu, hit %zu: got offset %td\n", len, hit, got - start);
+                return 1;
+            }
+        }
+    }
+
+    /* High bytes must not be taken for matches (or the other way round) */
+    memset(buf, 0xBA, sizeof(buf));
+    buf[37] = (char)0xFF;
+    if (byte_scan_either(buf, buf + sizeof(buf), (char)0xFF, '\0') != buf + 37) {
+        fprintf(stderr, "high byte not found\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_cli.c
+ * DESC.: runs the cplus executable on invocations that leave nothing to transpile
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "file_io.h"
+#include "subprocess.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/wait.h>
+
+/* Run the executable with argv[1..]; the exit code, or -1 when it did not exit normally */
+static int run_cplus(const char *const argv[]) {
+    SubprocessResult result;
+    if (subprocess_run(argv, &result) != 0) {
+        return -1;
+    }
+    int code = WIFEXITED(result.status) ? WEXITSTATUS(result.status) : -1;
+    if (code == -1) {
+        fprintf(stderr, "%s", (result.output != NULL) ? result.output : "");
+    }
+    subprocess_free_result(&result);
+    return code;
+}
+
+int main(void) {
+    char root[] = "/tmp/cplus_cli_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        return 1;
+    }
+
+    char cache[512];
+    char empty[512];
+    char input[512];
+    char manifest[512];
+    (void)snprintf(cache, sizeof(cache), "%s/cache", root);
+    (void)snprintf(empty, sizeof(empty), "%s/empty", root);
+    (void)snprintf(input, sizeof(input), "%s/a.cplus", root);
+    (void)snprintf(manifest, sizeof(manifest), "%s/manifest", root);
+    int ok = (setenv("CPLUS_CACHE_DIR", cache, 1) == 0) && (file_io_make_dirs(empty) != 0) &&
+             (file_io_write_all(input, "int a;\n", 7U) != 0);
+
+    /* An incremental re-run with every input up to date */
+    const char *incremental[] = {CPLUS_EXECUTABLE, input, "--manifest", manifest, "-j", "2", NULL};
+    ok = ok && (run_cplus(incremental) == 0) && (run_cplus(incremental) == 0);
+
+    /* ...which still writes the source map of a clean input once --source-map is added */
+    char        map[512];
+    size_t      size       = 0U;
+    const char *with_map[] = {CPLUS_EXECUTABLE, input, "--manifest", manifest, "--source-map",
+                              NULL};
+    (void)snprintf(map, sizeof(map), "%s/a.c.map", root);
+    ok = ok && (run_cplus(with_map) == 0);
+    char *map_text = file_io_read_all(map, &size);
+    ok = ok && (map_text != NULL);
+    free(map_text);
+
+    /* Nothing to run at all */
+    const char *walk_empty[] = {CPLUS_EXECUTABLE, "-r", empty, NULL};
+    const char *list_empty[] = {CPLUS_EXECUTABLE, "--files-from", "/dev/null", NULL};
+    const char *no_inputs[]  = {CPLUS_EXECUTABLE, "--stats", NULL};
+    const char *two_with_o[] = {CPLUS_EXECUTABLE, "-o", "out.c", input, input, NULL};
+    ok = ok && (run_cplus(walk_empty) == 1) && (run_cplus(list_empty) == 1) &&
+         (run_cplus(no_inputs) == 1) && (run_cplus(two_with_o) == 1);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
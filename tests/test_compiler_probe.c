@@ -0,0 +1,112 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_compiler_probe.c
+ * DESC.: validates the memoized compiler probe and its on-disk record
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "cache_dir.h"
+#include "compiler_probe.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dirent.h>
+#include <unistd.h>
+
+/* Count regular entries in dir (the probe records); -1 if it cannot be opened */
+static int count_entries(const char *dir) {
+    DIR *d = opendir(dir);
+    if (d == NULL) {
+        return -1;
+    }
+
+    int n = 0;
+    for (struct dirent *e = readdir(d); e != NULL; e = readdir(d)) {
+        if (e->d_name[0] != '.') {
+            ++n;
+        }
+    }
+    closedir(d);
+    return n;
+}
+
+static void remove_cache(const char *root) {
+    char probe_dir[256];
+    (void)snprintf(probe_dir, sizeof(probe_dir), "%s/probe", root);
+
+    DIR *d = opendir(probe_dir);
+    if (d != NULL) {
+        for (struct dirent *e = readdir(d); e != NULL; e = readdir(d)) {
+            if (e->d_name[0] != '.') {
+                char entry[512];
+                (void)snprintf(entry, sizeof(entry), "%s/%s", probe_dir, e->d_name);
+                unlink(entry);
+            }
+        }
+        closedir(d);
+    }
+    rmdir(probe_dir);
+    rmdir(root);
+}
+
+int main(void) {
+    char cache_root[] = "/tmp/cplus_probe_cache_XXXXXX";
+    if (mkdtemp(cache_root) == NULL) {
+        fprintf(stderr, "failed to create temp cache dir\n");
+        return 1;
+    }
+    cache_dir_set_root(cache_root);
+
+    int failed = 0;
+
+    const CompilerCaps *caps = compiler_probe("gcc");
+    if ((caps->family != COMPILER_FAMILY_GCC) || (caps->major_version <= 0) ||
+        (caps->resolved_path == NULL)) {
+        fprintf(stderr, "gcc probe failed: family=%d major=%d\n", (int)caps->family,
+                caps->major_version);
+        failed = 1;
+    }
+
+    if (compiler_probe("gcc") != caps) {
+        fprintf(stderr, "second probe of the same compiler must be memoized\n");
+        failed = 1;
+    }
+
+    /* Whatever spelling comes back must be one the compiler accepted */
+    const char *c23 = compiler_probe_std_flag(caps, "c23");
+    if ((strcmp(c23, "c23") != 0) && (strcmp(c23, "c2x") != 0)) {
+        fprintf(stderr, "unexpected std flag for c23: %s\n", c23);
+        failed = 1;
+    }
+    if ((caps->major_version < 14) && (strcmp(c23, "c2x") != 0)) {
+        fprintf(stderr, "gcc %d must map c23 to c2x, got %s\n", caps->major_version, c23);
+        failed = 1;
+    }
+
+    char probe_dir[256];
+    (void)snprintf(probe_dir, sizeof(probe_dir), "%s/probe", cache_root);
+    if (count_entries(probe_dir) != 1) {
+        fprintf(stderr, "expected exactly one on-disk probe record\n");
+        failed = 1;
+    }
+
+    const CompilerCaps *missing = compiler_probe("cplus-no-such-compiler");
+    if ((missing->family != COMPILER_FAMILY_UNKNOWN) || (missing->resolved_path != NULL)) {
+        fprintf(stderr, "missing compiler must yield an unknown record\n");
+        failed = 1;
+    }
+    if (strcmp(compiler_probe_std_flag(missing, "c23"), "c23") != 0) {
+        fprintf(stderr, "unknown compiler must keep the requested std\n");
+        failed = 1;
+    }
+
+    remove_cache(cache_root);
+    return failed;
+}
@@ -0,0 +1,166 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_cplus_context.c
+ * DESC.: validates the embeddable context API: sink, results, concurrent calls
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "cplus_context.h"
+#include "file_io.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_THREADS 4
+#define N_ROUNDS  6
+
+/* Diagnostics the sink saw; each job's user points at its own counter */
+typedef struct {
+    pthread_mutex_t lock;
+    size_t          errors;
+    size_t          foreign; /* diagnostics whose job was not the one being run */
+} SinkLog;
+
+static SinkLog g_log = {PTHREAD_MUTEX_INITIALIZER, 0U, 0U};
+
+static void record(void *user, const CplusJob *job, const Diagnostic *diag) {
+    SinkLog *log = (SinkLog *)user;
+    (void)pthread_mutex_lock(&log->lock);
+    log->errors += (diag->severity == DIAG_ERROR) ? 1U : 0U;
+    int foreign = (job->user == NULL) || (*(const pthread_t *)job->user != pthread_self());
+    log->foreign += (foreign != 0) ? 1U : 0U;
+    (void)pthread_mutex_unlock(&log->lock);
+}
+
+typedef struct {
+    CplusContext* ctx;
+    const char*   root;
+    int           ok;
+} Worker;
+
+/*
+ * Every round: one valid file alone, then a batch of a long valid file and a
+ * broken one, so reused scratch buffers go from short to long sources and back.
+ */
+static void *run_worker(void *arg) {
+    Worker   *worker = (Worker *)arg;
+    pthread_t self   = pthread_self();
+    char      good[512];
+    char      big[512];
+    char      bad[512];
+    char      out[3][512];
+    (void)snprintf(good, sizeof(good), "%s/good.cplus", worker->root);
+    (void)snprintf(big, sizeof(big), "%s/big.cplus", worker->root);
+    (void)snprintf(bad, sizeof(bad), "%s/bad.cplus", worker->root);
+    for (int k = 0; k < 3; ++k) {
+        (void)snprintf(out[k], sizeof(out[k]), "%s/out%lu_%d.c", worker->root, (unsigned long)self,
+                       k);
+    }
+
+    worker->ok = 1;
+    for (int round = 0; (worker->ok != 0) && (round < N_ROUNDS); ++round) {
+        CplusJob    job = {good, out[0], &self};
+        CplusResult result;
+        worker->ok = (cplus_transpile(worker->ctx, &job, &result) == 0) && (result.rc == 0) &&
+                     (result.errors == 0U) && (result.output_unchanged == (round > 0));
+
+        CplusJob    jobs[2] = {{big, out[1], &self}, {bad, out[2], &self}};
+        CplusResult results[2];
+        cplus_transpile_batch(worker->ctx, jobs, 2U, results);
+        worker->ok = worker->ok && (results[0].rc == 0) && (results[0].errors == 0U) &&
+                     (results[1].rc == 1) && (results[1].errors == 1U);
+    }
+
+    size_t size = 0U;
+    char  *copy = file_io_read_all(out[1], &size);
+    worker->ok  = worker->ok && (copy != NULL) && (size > 4096U);
+    free(copy);
+    return NULL;
+}
+
+int main(void) {
+    char root[] = "/tmp/cplus_context_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        return 1;
+    }
+
+    char path[512];
+    (void)snprintf(path, sizeof(path), "%s/good.cplus", root);
+    int ok = file_io_write_all(path, "int f(void) { return 1; }\n", 26U);
+    (void)snprintf(path, sizeof(path), "%s/bad.cplus", root);
+    ok = ok && file_io_write_all(path, "int g(void) { return }\n", 23U);
+
+    char  *big_source = (char *)malloc(200U * 32U + 1U);
+    size_t big_size   = 0U;
+    for (unsigned i = 0U; (big_source != NULL) && (i < 200U); ++i) {
+        big_size += (size_t)snprintf(big_source + big_size, 32U, "static int v%u = %u;\n", i, i);
+    }
+    (void)snprintf(path, sizeof(path), "%s/big.cplus", root);
+    ok = ok && (big_source != NULL) && file_io_write_all(path, big_source, big_size);
+    free(big_source);
+
+    /* Without the cache every call runs the compiler, so every error reaches the sink */
+    CplusContextOptions options = {
+        .compiler    = "gcc",
+        .std_name    = "c17",
+        .diag_sink   = record,
+        .diag_user   = &g_log,
+    };
+    CplusContext *ctx = cplus_context_create(&options);
+    ok = ok && (ctx != NULL);
+
+    Worker    workers[N_THREADS];
+    pthread_t threads[N_THREADS];
+    int       started[N_THREADS] = {0};
+    for (int i = 0; (ok != 0) && (i < N_THREADS); ++i) {
+        workers[i] = (Worker){ctx, root, 0};
+        started[i] = (pthread_create(&threads[i], NULL, run_worker, &workers[i]) == 0);
+        ok         = started[i];
+    }
+    for (int i = 0; i < N_THREADS; ++i) {
+        if (started[i] != 0) {
+            (void)pthread_join(threads[i], NULL);
+            ok = ok && (workers[i].ok != 0);
+        }
+    }
+    ok = ok && (g_log.errors == (size_t)(N_THREADS * N_ROUNDS)) && (g_log.foreign == 0U);
+
+    /* A missing input fails through the sink like any other error */
+    size_t   before  = g_log.errors;
+    CplusJob missing = {"/nonexistent/x.cplus", NULL, NULL};
+    ok = ok && (ctx != NULL) && (cplus_transpile(ctx, &missing, NULL) == 1) &&
+         (g_log.errors > before);
+    cplus_context_destroy(ctx);
+
+    /* With the cache, a second context answers from disk */
+    (void)snprintf(path, sizeof(path), "%s/cache", root);
+    CplusContextOptions cached = {
+        .use_cache = 1, .cache_dir = path, .diag_sink = record, .diag_user = &g_log};
+    for (int pass = 0; (ok != 0) && (pass < 2); ++pass) {
+        pthread_t self = pthread_self();
+        char      input[512];
+        (void)snprintf(input, sizeof(input), "%s/bad.cplus", root);
+        CplusJob    job = {input, NULL, &self};
+        CplusResult result;
+        size_t      hits   = 0U;
+        size_t      misses = 0U;
+        ctx = cplus_context_create(&cached);
+        ok  = (ctx != NULL) && (cplus_transpile(ctx, &job, &result) == 1) && (result.errors == 1U);
+        cplus_context_counters(ctx, &hits, &misses);
+        ok = ok && (hits == (size_t)pass) && (misses == (size_t)(1 - pass));
+        cplus_context_destroy(ctx);
+    }
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_dep_graph.c
+ * DESC.: validates incremental planning over the .hplus include graph
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "dep_graph.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CONFIG_A 0x1111ULL
+#define CONFIG_B 0x2222ULL
+
+static char g_dir[] = "/tmp/cplus_depgraph_XXXXXX";
+
+static void path_of(char *out, size_t out_size, const char *name) {
+    (void)snprintf(out, out_size, "%s/%s", g_dir, name);
+}
+
+static int write_text_file(const char *name, const char *content) {
+    char path[256];
+    path_of(path, sizeof(path), name);
+
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    size_t len = strlen(content);
+    size_t written = fwrite(content, 1U, len, fp);
+    int close_rc = fclose(fp);
+
+    return (written == len) && (close_rc == 0);
+}
+
+/*
+ * One incremental run over a.cplus (includes x.hplus -> y.hplus) and b.cplus.
+ * Writes the planned dirty flags to dirty[2]; every dirty input gets fail_a /
+ * success as its result, then the manifest is saved.
+ */
+static int run_plan(uint64_t config, unsigned char dirty[2], int fail_a) {
+    char manifest[256];
+    char in_a[256];
+    char in_b[256];
+    char out_a[256];
+    char out_b[256];
+    path_of(manifest, sizeof(manifest), "manifest");
+    path_of(in_a, sizeof(in_a), "a.cplus");
+    path_of(in_b, sizeof(in_b), "b.cplus");
+    path_of(out_a, sizeof(out_a), "a.c");
+    path_of(out_b, sizeof(out_b), "b.c");
+
+    DepGraph *graph = dep_graph_open(manifest, config);
+    if (graph == NULL) {
+        return 0;
+    }
+
+    long ia = dep_graph_add_input(graph, in_a, out_a);
+    long ib = dep_graph_add_input(graph, in_b, out_b);
+    (void)dep_graph_plan(graph, dirty);
+
+    if (dirty[0] != 0U) {
+        dep_graph_set_result(graph, ia, (fail_a != 0) ? 0 : 1);
+    }
+    if (dirty[1] != 0U) {
+        dep_graph_set_result(graph, ib, 1);
+    }
+
+    int ok = (ia == 0L) && (ib == 1L) && (dep_graph_save(graph) != 0);
+    dep_graph_close(graph);
+    return ok;
+}
+
+static int expect(const char *step, uint64_t config, int fail_a, int want_a, int want_b) {
+    unsigned char dirty[2] = {0U, 0U};
+    if (run_plan(config, dirty, fail_a) == 0) {
+        fprintf(stderr, "%s: run failed\n", step);
+        return 0;
+    }
+    if ((dirty[0] != (unsigned char)want_a) || (dirty[1] != (unsigned char)want_b)) {
+        fprintf(stderr, "%s: dirty = {%u, %u}, expected {%d, %d}\n",
+                step, dirty[0], dirty[1], want_a, want_b);
+        return 0;
+    }
+    return 1;
+}
+
+int main(void) {
+    if (mkdtemp(g_dir) == NULL) {
+        fprintf(stderr, "failed to create temp dir\n");
+        return 1;
+    }
+
+    if ((write_text_file("y.hplus", "#define Y 1\n") == 0) ||
+        (write_text_file("x.hplus", "#include \"./y.hplus\"\n#define X Y\n") == 0) ||
+        (write_text_file("a.cplus", "#include \"x.hplus\"\nint a(void) { return X; }\n") == 0) ||
+        (write_text_file("b.cplus", "int b(void) { return 2; }\n") == 0) ||
+        (write_text_file("a.c", "") == 0) ||
+        (write_text_file("b.c", "") == 0)) {
+        fprintf(stderr, "failed to write fixtures\n");
+        return 1;
+    }
+
+    int ok = 1;
+
+    ok = ok && expect("first run", CONFIG_A, 0, 1, 1);
+    ok = ok && expect("no-op run", CONFIG_A, 0, 0, 0);
+
+    /* A transitive header edit dirties only its reverse dependents */
+    ok = ok && write_text_file("y.hplus", "#define Y 100\n");
+    ok = ok && expect("header edit", CONFIG_A, 0, 1, 0);
+    ok = ok && expect("after header edit", CONFIG_A, 0, 0, 0);
+
+    /* A failed input stays dirty until it succeeds */
+    ok = ok && write_text_file("a.cplus", "#include \"x.hplus\"\nint a(void) { return X + 1; }\n");
+    ok = ok && expect("source edit", CONFIG_A, 1, 1, 0);
+    ok = ok && expect("retry failed", CONFIG_A, 0, 1, 0);
+    ok = ok && expect("after retry", CONFIG_A, 0, 0, 0);
+
+    /* A same-size edit that keeps the mtime, right after the manifest was written */
+    char in_b[256];
+    struct stat before;
+    path_of(in_b, sizeof(in_b), "b.cplus");
+    ok = ok && (stat(in_b, &before) == 0) &&
+         write_text_file("b.cplus", "int b(void) { return 3; }\n");
+    struct timespec times[2] = {before.st_atim, before.st_mtim};
+    ok = ok && (utimensat(AT_FDCWD, in_b, times, 0) == 0);
+    ok = ok && expect("racy edit", CONFIG_A, 0, 0, 1);
+
+    /* A missing output and a config change both force work */
+    char out_b[256];
+    path_of(out_b, sizeof(out_b), "b.c");
+    (void)unlink(out_b);
+    ok = ok && expect("missing output", CONFIG_A, 0, 0, 1);
+    ok = ok && write_text_file("b.c", "");
+    ok = ok && expect("config change", CONFIG_B, 0, 1, 1);
+    ok = ok && expect("after config change", CONFIG_B, 0, 0, 0);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", g_dir);
+    (void)system(cmd);
+
+    return (ok != 0) ? 0 : 1;
+}
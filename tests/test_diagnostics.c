@@ -0,0 +1,98 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_diagnostics.c
+ * DESC.: validates the arena-backed diagnostics parser and its printed form
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const k_raw =
+    "cc1: some driver noise\n"
+    "main.cplus: In function 'f':\n"
+    "main.cplus:3:9: error: expected ';' before '}' token\n"
+    "    3 |   return 1\n"
+    "\n"
+    "      |         ^\n"
+    "util.hplus:7:1: warning: unused: 'x'\n"
+    "main.cplus:4:2: note: declared here";
+
+static const char *const k_printed =
+    "main.cplus:3:9: error: expected ';' before '}' token\n"
+    "    3 |   return 1\n"
+    "      |         ^\n"
+    "util.hplus:7:1: warning: unused: 'x'\n"
+    "main.cplus:4:2: note: declared here\n";
+
+int main(void) {
+    int failed = 0;
+
+    DiagnosticList list = diagnostics_parse(k_raw);
+
+    if (list.count != 3U) {
+        fprintf(stderr, "expected 3 diagnostics, got %zu\n", list.count);
+        diagnostics_free_list(&list);
+        return 1;
+    }
+
+    if ((list.items[0].line != 3) || (list.items[0].column != 9) ||
+        (list.items[0].severity != DIAG_ERROR) || (list.items[1].severity != DIAG_WARNING) ||
+        (list.items[2].severity != DIAG_NOTE) ||
+        (strcmp(list.items[1].message, "unused: 'x'") != 0)) {
+        fprintf(stderr, "primary fields parsed incorrectly\n");
+        failed = 1;
+    }
+
+    /* File names are interned: equal names share one string */
+    if ((list.items[0].file != list.items[2].file) ||
+        (strcmp(list.items[1].file, "util.hplus") != 0)) {
+        fprintf(stderr, "file names are not interned\n");
+        failed = 1;
+    }
+
+    if ((list.items[1].context != NULL) || (list.items[2].context != NULL)) {
+        fprintf(stderr, "unexpected context on diagnostics without one\n");
+        failed = 1;
+    }
+
+    /* The printed form is what the strndup-based parser produced */
+    char  *printed = NULL;
+    size_t printed_size = 0U;
+    FILE  *stream = open_memstream(&printed, &printed_size);
+    if (stream == NULL) {
+        diagnostics_free_list(&list);
+        return 1;
+    }
+    diagnostics_fprint_list(stream, &list);
+    (void)fclose(stream);
+
+    if (strcmp(printed, k_printed) != 0) {
+        fprintf(stderr, "printed output differs:\n%s", printed);
+        failed = 1;
+    }
+    free(printed);
+
+    diagnostics_free_list(&list);
+    if ((list.items != NULL) || (list.arena != NULL) || (list.count != 0U)) {
+        fprintf(stderr, "list not reset by free\n");
+        failed = 1;
+    }
+
+    DiagnosticList empty = diagnostics_parse("no diagnostics here\n");
+    if (empty.count != 0U) {
+        fprintf(stderr, "expected no diagnostics\n");
+        failed = 1;
+    }
+    diagnostics_free_list(&empty);
+
+    return failed;
+}
@@ -0,0 +1,135 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_diagnostics_stream.c
+ * DESC.: validates the chunked diagnostics parser and the --max-errors cut-off
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "compiler_validator.h"
+#include "diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+static const char *const k_raw =
+    "cc1: some driver noise\n"
+    "main.cplus: In function 'f':\n"
+    "main.cplus:3:9: error: expected ';' before '}' token\n"
+    "    3 |   return 1\n"
+    "\n"
+    "      |         ^\n"
+    "util.hplus:7:1: warning: unused: 'x'\n"
+    "main.cplus:4:2: note: declared here";
+
+typedef struct {
+    FILE  *stream;
+    size_t count;
+    size_t errors;
+} Collector;
+
+static void collect(void *user, const Diagnostic *diag) {
+    Collector *c = (Collector *)user;
+    c->count++;
+    if (diag->severity == DIAG_ERROR) {
+        c->errors++;
+    }
+    if (c->stream != NULL) {
+        diagnostics_fprint_one(c->stream, diag);
+    }
+}
+
+static char *print_list(const DiagnosticList *list) {
+    char  *text = NULL;
+    size_t size = 0U;
+    FILE  *stream = open_memstream(&text, &size);
+    if (stream == NULL) {
+        return NULL;
+    }
+    diagnostics_fprint_list(stream, list);
+    (void)fclose(stream);
+    return text;
+}
+
+/* Feeding one byte at a time must yield what the one-shot parser prints */
+static int check_chunked_parse(void) {
+    char     *streamed = NULL;
+    size_t    streamed_size = 0U;
+    Collector c = {open_memstream(&streamed, &streamed_size), 0U, 0U};
+    if (c.stream == NULL) {
+        return 0;
+    }
+
+    DiagnosticParser *parser = diagnostics_parser_create(collect, &c);
+    if (parser == NULL) {
+        (void)fclose(c.stream);
+        free(streamed);
+        return 0;
+    }
+    size_t len = strlen(k_raw);
+    for (size_t i = 0U; i < len; ++i) {
+        diagnostics_parser_feed(parser, k_raw + i, 1U);
+    }
+    diagnostics_parser_finish(parser);
+    diagnostics_parser_destroy(parser);
+    (void)fclose(c.stream);
+
+    DiagnosticList list = diagnostics_parse(k_raw);
+    char *expected = print_list(&list);
+    int ok = (expected != NULL) && (c.count == list.count) && (strcmp(streamed, expected) == 0);
+    if (ok == 0) {
+        fprintf(stderr, "chunked parse differs (%zu diagnostics):\n%s", c.count, streamed);
+    }
+    free(expected);
+    diagnostics_free_list(&list);
+    free(streamed);
+    return ok;
+}
+
+/* A file with many errors stops after max_errors and is reported invalid */
+static int check_error_limit(void) {
+    char dir[] = "/tmp/cplus_stream_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        return 0;
+    }
+
+    char path[256];
+    (void)snprintf(path, sizeof(path), "%s/many.cplus", dir);
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return 0;
+    }
+    for (int i = 0; i < 200; ++i) {
+        fprintf(fp, "int f%d(void) { int x = ; return x; }\n", i);
+    }
+    (void)fclose(fp);
+
+    Collector        c = {NULL, 0U, 0U};
+    ValidatorOptions options = {.max_errors = 2, .on_diagnostic = collect, .user = &c};
+    ValidationResult result = validator_check_syntax_ex("gcc", "c23", path, &options);
+
+    int ok = (result.success == 0) && (c.errors == 2U);
+    if (ok == 0) {
+        fprintf(stderr, "error limit: success = %d, %zu errors delivered\n", result.success,
+                c.errors);
+    }
+    validator_free_result(&result);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", dir);
+    (void)system(cmd);
+    return ok;
+}
+
+int main(void) {
+    int ok = check_chunked_parse();
+    ok = check_error_limit() && ok;
+    return (ok != 0) ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_diagnostics_structured.c
+ * DESC.: validates JSON/SARIF diagnostics decoding and JSON batch validation
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "compiler_probe.h"
+#include "compiler_validator.h"
+#include "diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+static char g_dir[] = "/tmp/cplus_structured_XXXXXX";
+
+static int write_text_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    size_t len = strlen(content);
+    size_t written = fwrite(content, 1U, len, fp);
+    int close_rc = fclose(fp);
+
+    return (written == len) && (close_rc == 0);
+}
+
+static char *print_list(const DiagnosticList *list) {
+    char  *text = NULL;
+    size_t size = 0U;
+    FILE  *stream = open_memstream(&text, &size);
+    if (stream == NULL) {
+        return NULL;
+    }
+    diagnostics_fprint_list(stream, list);
+    (void)fclose(stream);
+    return text;
+}
+
+static int check_printed(const char *name, const char *raw, const char *expected) {
+    DiagnosticList list = diagnostics_parse_structured(raw);
+    char *printed = print_list(&list);
+    int ok = (printed != NULL) && (strcmp(printed, expected) == 0);
+    if (ok == 0) {
+        fprintf(stderr, "%s: printed output differs:\n%s", name, (printed != NULL) ? printed : "");
+    }
+    free(printed);
+    diagnostics_free_list(&list);
+    return ok;
+}
+
+/* GCC JSON: ranges, fix-its, options, children and location-less diagnostics */
+static int check_gcc_json(const char *source) {
+    char raw[2048];
+    (void)snprintf(raw, sizeof(raw),
+        "[{\"kind\": \"error\", \"message\": \"expected ';' before '}' token\","
+        " \"locations\": [{\"caret\": {\"file\": \"%s\", \"line\": 2, \"column\": 11,"
+        " \"byte-column\": 11}}],"
+        " \"fixits\": [{\"start\": {\"file\": \"%s\", \"line\": 2, \"column\": 11,"
+        " \"byte-column\": 11},"
+        " \"next\": {\"file\": \"%s\", \"line\": 2, \"column\": 11, \"byte-column\": 11},"
+        " \"string\": \";\"}],"
+        " \"children\": [{\"kind\": \"note\", \"message\": \"here\", \"locations\": []}]},"
+        " {\"kind\": \"warning\", \"message\": \"unused variable 'x'\","
+        " \"option\": \"-Wunused-variable\","
+        " \"locations\": [{\"caret\": {\"file\": \"%s\", \"line\": 1, \"column\": 7,"
+        " \"byte-column\": 7},"
+        " \"finish\": {\"file\": \"%s\", \"line\": 1, \"column\": 8}}], \"children\": []}]\n"
+        "compilation terminated.\n",
+        source, source, source, source, source);
+
+    char expected[1024];
+    (void)snprintf(expected, sizeof(expected),
+        "%s:2:11: error: expected ';' before '}' token\n"
+        "    2 |   return 1\n"
+        "      |           ^\n"
+        "      |           ;\n"
+        "note: here\n"
+        "%s:1:7: warning: unused variable 'x' [-Wunused-variable]\n"
+        "    1 | \tint x;\n"
+        "      | \t     ^~\n",
+        source, source);
+
+    DiagnosticList list = diagnostics_parse_structured(raw);
+    int ok = (list.count == 3U) && (list.items[0].fixit != NULL) &&
+             (strcmp(list.items[0].fixit, ";") == 0) &&
+             (list.items[1].severity == DIAG_NOTE) && (list.items[1].line == 0) &&
+             (list.items[2].end_line == 1) && (list.items[2].end_column == 8) &&
+             (list.items[0].file == list.items[2].file);
+    if (ok == 0) {
+        fprintf(stderr, "gcc json: fields decoded incorrectly (%zu diagnostics)\n", list.count);
+    }
+    diagnostics_free_list(&list);
+
+    return check_printed("gcc json", raw, expected) && ok;
+}
+
+/* SARIF 2.1 as GCC 13+ and Clang emit it; the source is not readable here */
+static int check_sarif(void) {
+    static const char *const k_sarif =
+        "clang: warning: diagnostic formatting in SARIF mode is currently unstable\n"
+        "{\"version\": \"2.1.0\", \"runs\": [{\"results\": [{\"level\": \"error\","
+        " \"message\": {\"text\": \"use of undeclared identifier 'y'\"},"
+        " \"locations\": [{\"physicalLocation\":"
+        " {\"artifactLocation\": {\"uri\": \"file:///no/such/m.cplus\"},"
+        " \"region\": {\"startLine\": 4, \"startColumn\": 3, \"endColumn\": 5}}}],"
+        " \"relatedLocations\": [{\"message\": {\"text\": \"declared here\"},"
+        " \"physicalLocation\": {\"artifactLocation\": {\"uri\": \"u.hplus\"},"
+        " \"region\": {\"startLine\": 1, \"startColumn\": 1}}}]},"
+        " {\"level\": \"warning\", \"ruleId\": \"-Wunused\","
+        " \"message\": {\"text\": \"unused\"}}]}]}\n";
+
+    static const char *const k_expected =
+        "/no/such/m.cplus:4:3: error: use of undeclared identifier 'y'\n"
+        "u.hplus:1:1: note: declared here\n"
+        "warning: unused [-Wunused]\n";
+
+    return check_printed("sarif", k_sarif, k_expected);
+}
+
+/* Plain text goes through diagnostics_parse() unchanged */
+static int check_text_fallback(void) {
+    static const char *const k_text =
+        "m.cplus:3:9: error: expected ';'\n"
+        "    3 |   return 1\n";
+    return check_printed("text", k_text, k_text);
+}
+
+/* A real GCC JSON batch is split per translation unit in one run */
+static int check_json_batch(void) {
+    char good[256];
+    char bad[256];
+    (void)snprintf(good, sizeof(good), "%s/good.cplus", g_dir);
+    (void)snprintf(bad, sizeof(bad), "%s/bad.cplus", g_dir);
+    if ((write_text_file(good, "int good(void) { return 1; }\n") == 0) ||
+        (write_text_file(bad, "int bad(void) { int x = ; return x; }\n") == 0)) {
+        return 0;
+    }
+
+    const CompilerCaps *caps = compiler_probe("gcc");
+    ValidatorOptions options = {0, NULL, NULL, DIAG_FORMAT_JSON, NULL, NULL, {0ULL, 0ULL}};
+    const char *const inputs[] = {bad, good};
+    ValidationResult results[2];
+    size_t runs = validator_check_syntax_batch("gcc", "c23", &options, inputs, 2U, results);
+
+    int ok = (results[0].success == 0) && (results[1].success == 1);
+    if ((caps->diag_formats & PROBE_DIAG_JSON) != 0U) {
+        ok = ok && (runs == 1U) && (results[0].raw_output != NULL) &&
+             (results[0].raw_output[0] == '[');
+    }
+
+    DiagnosticList diags = diagnostics_parse_structured(results[0].raw_output);
+    ok = ok && (diags.count == 1U) && (strcmp(diags.items[0].file, bad) == 0) &&
+         (diags.items[0].line == 1);
+    diagnostics_free_list(&diags);
+
+    if (ok == 0) {
+        fprintf(stderr, "json batch: %zu runs, verdicts %d/%d\n", runs, results[0].success,
+                results[1].success);
+    }
+    validator_free_result(&results[0]);
+    validator_free_result(&results[1]);
+    return ok;
+}
+
+int main(void) {
+    if (mkdtemp(g_dir) == NULL) {
+        fprintf(stderr, "failed to create temp dir\n");
+        return 1;
+    }
+
+    char source[256];
+    (void)snprintf(source, sizeof(source), "%s/src.cplus", g_dir);
+    if (write_text_file(source, "\tint x;\n  return 1\n") == 0) {
+        fprintf(stderr, "failed to write fixtures\n");
+        return 1;
+    }
+
+    int ok = check_gcc_json(source);
+    ok = check_sarif() && ok;
+    ok = check_text_fallback() && ok;
+    ok = check_json_batch() && ok;
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", g_dir);
+    (void)system(cmd);
+
+    return (ok != 0) ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_dir_walk.c
+ * DESC.: validates the parallel source tree walk and its ignore globs
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "dir_walk.h"
+#include "file_io.h"
+#include "input_list.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define N_DIRS  40U
+#define N_FILES 30U
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/* Every path of a finished walk, sorted; *out_count of them */
+static char **collect(DirWalk *walk, size_t *out_count) {
+    size_t count = 0U;
+    size_t cap   = 64U;
+    char **paths = (char **)malloc(cap * sizeof(char *));
+    char  *path  = NULL;
+    while ((paths != NULL) && (dir_walk_next(walk, &path) != 0)) {
+        if (count == cap) {
+            cap *= 2U;
+            char **resized = (char **)realloc(paths, cap * sizeof(char *));
+            if (resized == NULL) {
+                free(path);
+                break;
+            }
+            paths = resized;
+        }
+        paths[count++] = path;
+    }
+    if (paths != NULL) {
+        qsort(paths, count, sizeof(char *), compare_paths);
+    }
+    *out_count = count;
+    return paths;
+}
+
+static void free_paths(char **paths, size_t count) {
+    for (size_t i = 0U; (paths != NULL) && (i < count); ++i) {
+        free(paths[i]);
+    }
+    free(paths);
+}
+
+static int write_file(const char *root, const char *name) {
+    char path[512];
+    (void)snprintf(path, sizeof(path), "%s/%s", root, name);
+    return file_io_write_all(path, "int x;\n", 7U);
+}
+
+int main(void) {
+    char root[] = "/tmp/cplus_dir_walk_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        return 1;
+    }
+
+    /*
+     * root/d<i>/e<i>/ hold N_FILES sources each plus noise; root/vendor and
+     * root/d0/gen must be skipped by the globs below.
+     */
+    char path[512];
+    int  ok = 1;
+    for (unsigned d = 0U; (ok != 0) && (d < N_DIRS); ++d) {
+        (void)snprintf(path, sizeof(path), "%s/d%u/e%u", root, d, d);
+        ok = file_io_make_dirs(path);
+        for (unsigned f = 0U; (ok != 0) && (f < N_FILES); ++f) {
+            char name[64];
+            (void)snprintf(name, sizeof(name), "d%u/e%u/f%u.%s", d, d, f,
+                           ((f % 2U) == 0U) ? "cplus" : "hplus");
+            ok = write_file(root, name);
+        }
+        char name[64];
+        (void)snprintf(name, sizeof(name), "d%u/notes.txt", d);
+        ok = ok && write_file(root, name);
+    }
+    (void)snprintf(path, sizeof(path), "%s/vendor/lib", root);
+    ok = ok && file_io_make_dirs(path);
+    (void)snprintf(path, sizeof(path), "%s/d0/gen", root);
+    ok = ok && file_io_make_dirs(path);
+    ok = ok && write_file(root, "vendor/lib/v.cplus") && write_file(root, "d0/gen/g.cplus") &&
+         write_file(root, "top.cplus") && write_file(root, ".cplus") &&
+         write_file(root, "d1/skip.tmp.cplus");
+
+    /* A symlinked directory is not followed */
+    char link_path[512];
+    (void)snprintf(link_path, sizeof(link_path), "%s/d2/loop", root);
+    ok = ok && (symlink("..", link_path) == 0);
+
+    /* Everything: N_DIRS x N_FILES + vendor + gen + top + skip.tmp */
+    const char *roots[1] = {root};
+    DirWalk    *walk     = dir_walk_start(roots, 1U, NULL, 0U, 3U);
+    size_t      count    = 0U;
+    char      **paths    = (walk != NULL) ? collect(walk, &count) : NULL;
+    ok = ok && (walk != NULL) && (count == (N_DIRS * N_FILES) + 4U) &&
+         (dir_walk_failures(walk, NULL) == 0U);
+    (void)snprintf(path, sizeof(path), "%s/top.cplus", root);
+    ok = ok &&
+         (bsearch(&(const char *){path}, paths, count, sizeof(char *), compare_paths) != NULL);
+    (void)snprintf(path, sizeof(path), "%s/d7/e7/f3.hplus", root);
+    ok = ok &&
+         (bsearch(&(const char *){path}, paths, count, sizeof(char *), compare_paths) != NULL);
+    free_paths(paths, count);
+    dir_walk_destroy(walk);
+
+    /* Name globs prune whole directories; globs with a '/' match below the root */
+    const char *ignores[3] = {"vendor", "d0/gen", "*.tmp.cplus"};
+    walk  = dir_walk_start(roots, 1U, ignores, 3U, 2U);
+    paths = (walk != NULL) ? collect(walk, &count) : NULL;
+    ok = ok && (walk != NULL) && (count == (N_DIRS * N_FILES) + 1U);
+    for (size_t i = 0U; (ok != 0) && (i < count); ++i) {
+        ok = (strstr(paths[i], "vendor") == NULL) && (strstr(paths[i], "/gen/") == NULL) &&
+             (strstr(paths[i], "skip") == NULL);
+    }
+    free_paths(paths, count);
+    dir_walk_destroy(walk);
+
+    /* Abandoning a walk that is still producing stops its threads */
+    walk = dir_walk_start(roots, 1U, NULL, 0U, 4U);
+    char *first = NULL;
+    ok = ok && (walk != NULL) && (dir_walk_next(walk, &first) == 1);
+    free(first);
+    dir_walk_destroy(walk);
+
+    /* Through an input list: a literal path, then two trees in one walk */
+    char sub_a[512];
+    char sub_b[512];
+    (void)snprintf(sub_a, sizeof(sub_a), "%s/d3", root);
+    (void)snprintf(sub_b, sizeof(sub_b), "%s/d4/", root);
+    InputList *list = input_list_create();
+    ok = ok && (list != NULL) && (input_list_add_path(list, "first.cplus") != 0) &&
+         (input_list_add_dir(list, sub_a) != 0) && (input_list_add_dir(list, sub_b) != 0) &&
+         (input_list_add_dir(list, "/nonexistent/dir") == 0);
+    char  *next = NULL;
+    size_t seen = 0U;
+    ok = ok && (input_list_next(list, &next) == 1) && (strcmp(next, "first.cplus") == 0);
+    free(next);
+    while ((ok != 0) && (input_list_next(list, &next) == 1)) {
+        ok = (strncmp(next, root, strlen(root)) == 0) && (strstr(next, "//") == NULL);
+        free(next);
+        ++seen;
+    }
+    ok = ok && (seen == 2U * N_FILES) && (input_list_error(list) == NULL);
+    input_list_destroy(list);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_file_io.c
+ * DESC.: validates zero-copy and write-if-changed file emission
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "file_io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static char g_dir[] = "/tmp/cplus_file_io_XXXXXX";
+
+/* Copy src -> dst and compare dst with the expected bytes */
+static int check_copy(const char *name, const char *src, const char *dst,
+                      const char *expected, size_t expected_size) {
+    if (file_io_copy_file(src, dst) == 0) {
+        fprintf(stderr, "%s: copy failed\n", name);
+        return 0;
+    }
+
+    size_t size = 0U;
+    char *copied = file_io_read_all(dst, &size);
+    int ok = (copied != NULL) && (size == expected_size) &&
+             ((expected_size == 0U) || (memcmp(copied, expected, expected_size) == 0));
+    if (ok == 0) {
+        fprintf(stderr, "%s: copied bytes differ (%zu vs %zu)\n", name, size, expected_size);
+    }
+    free(copied);
+    return ok;
+}
+
+/* Number of directory entries, "." and ".." excluded */
+static int count_entries(const char *dir) {
+    DIR *d = opendir(dir);
+    if (d == NULL) {
+        return -1;
+    }
+    int n = 0;
+    for (struct dirent *e = readdir(d); e != NULL; e = readdir(d)) {
+        if ((strcmp(e->d_name, ".") != 0) && (strcmp(e->d_name, "..") != 0)) {
+            ++n;
+        }
+    }
+    (void)closedir(d);
+    return n;
+}
+
+/* Write-if-changed: identical outputs keep their inode and mtime */
+static int check_emit(const char *src, const char *dst) {
+    const char *old_bytes = "int f(void) { return 1; }\n";
+    const char *new_bytes = "int f(void) { return 2; }\n"; /* same size, one byte differs */
+
+    if ((file_io_write_all(src, old_bytes, strlen(old_bytes)) == 0) ||
+        (file_io_emit_copy(src, dst) != FILE_EMIT_WRITTEN)) {
+        fprintf(stderr, "emit: first write failed\n");
+        return 0;
+    }
+
+    struct timespec past[2] = {{1000, 0}, {1000, 0}};
+    struct stat before;
+    struct stat after;
+    if ((utimensat(AT_FDCWD, dst, past, 0) != 0) || (stat(dst, &before) != 0)) {
+        return 0;
+    }
+
+    if (file_io_emit_copy(src, dst) != FILE_EMIT_UNCHANGED) {
+        fprintf(stderr, "emit: identical output was rewritten\n");
+        return 0;
+    }
+    if ((stat(dst, &after) != 0) || (after.st_mtime != before.st_mtime) ||
+        (after.st_ino != before.st_ino)) {
+        fprintf(stderr, "emit: identical output was touched\n");
+        return 0;
+    }
+
+    if ((file_io_write_all(src, new_bytes, strlen(new_bytes)) == 0) ||
+        (file_io_emit_copy(src, dst) != FILE_EMIT_WRITTEN)) {
+        fprintf(stderr, "emit: changed output was not written\n");
+        return 0;
+    }
+
+    size_t size = 0U;
+    char *written = file_io_read_all(dst, &size);
+    int ok = (written != NULL) && (strcmp(written, new_bytes) == 0);
+    free(written);
+    if (ok == 0) {
+        fprintf(stderr, "emit: output holds the wrong bytes\n");
+    }
+    return ok;
+}
+
+/* Replacing an output keeps what points at it and its permissions */
+static int check_emit_links(const char *src) {
+    char target[256];
+    char link_path[256];
+    char hard[256];
+    char dangling[256];
+    (void)snprintf(target, sizeof(target), "%s/target.c", g_dir);
+    (void)snprintf(link_path, sizeof(link_path), "%s/link.c", g_dir);
+    (void)snprintf(hard, sizeof(hard), "%s/hard.c", g_dir);
+    (void)snprintf(dangling, sizeof(dangling), "%s/dangling.c", g_dir);
+
+    struct stat st;
+    size_t      size = 0U;
+    int ok = (file_io_write_all(src, "int v = 1;\n", 11U) != 0) &&
+             (file_io_write_all(target, "old\n", 4U) != 0) && (chmod(target, 0640) == 0) &&
+             (symlink("target.c", link_path) == 0);
+    ok = ok && (file_io_emit_copy(src, link_path) == FILE_EMIT_WRITTEN) &&
+         (lstat(link_path, &st) == 0) && S_ISLNK(st.st_mode) && (stat(target, &st) == 0) &&
+         ((st.st_mode & 07777) == 0640) && (st.st_size == 11);
+    if (ok == 0) {
+        fprintf(stderr, "emit: symlinked output was replaced or lost its mode\n");
+        return 0;
+    }
+
+    ok = (file_io_write_all(src, "int v = 22;\n", 12U) != 0) && (link(target, hard) == 0);
+    ok = ok && (file_io_emit_copy(src, target) == FILE_EMIT_WRITTEN) && (stat(hard, &st) == 0) &&
+         (st.st_nlink == 2U) && (st.st_size == 12);
+    if (ok == 0) {
+        fprintf(stderr, "emit: hard link to the output was broken\n");
+        return 0;
+    }
+
+    ok = (symlink("created.c", dangling) == 0) &&
+         (file_io_emit_copy(src, dangling) == FILE_EMIT_WRITTEN);
+    (void)snprintf(target, sizeof(target), "%s/created.c", g_dir);
+    char *created = ok ? file_io_read_all(target, &size) : NULL;
+    ok = (created != NULL) && (size == 12U);
+    free(created);
+    if (ok == 0) {
+        fprintf(stderr, "emit: dangling symlink was not written through\n");
+        return 0;
+    }
+
+    (void)unlink(link_path);
+    (void)unlink(hard);
+    (void)unlink(dangling);
+    (void)unlink(target);
+    (void)snprintf(target, sizeof(target), "%s/target.c", g_dir);
+    (void)unlink(target);
+    return 1;
+}
+
+int main(void) {
+    if (mkdtemp(g_dir) == NULL) {
+        fprintf(stderr, "failed to create temp dir\n");
+        return 1;
+    }
+
+    char src[256];
+    char dst[256];
+    char missing[256];
+    (void)snprintf(src, sizeof(src), "%s/in.cplus", g_dir);
+    (void)snprintf(dst, sizeof(dst), "%s/out.c", g_dir);
+    (void)snprintf(missing, sizeof(missing), "%s/missing.cplus", g_dir);
+
+    /* Larger than one copy_file_range()/sendfile() chunk */
+    size_t big_size = (3U << 20) + 123U;
+    char *big = (char *)malloc(big_size);
+    if (big == NULL) {
+        return 1;
+    }
+    for (size_t i = 0U; i < big_size; ++i) {
+        big[i] = (char)('a' + (char)(i % 26U));
+    }
+
+    const char *small = "int main(void) { return 0; }\n";
+    int ok = 1;
+
+    ok = ok && file_io_write_all(src, "", 0U) && check_copy("empty", src, dst, "", 0U);
+    ok = ok && file_io_write_all(src, big, big_size) && check_copy("big", src, dst, big, big_size);
+
+    /* A shorter source must not leave the tail of the previous output behind */
+    ok = ok && file_io_write_all(src, small, strlen(small)) &&
+         check_copy("shrink", src, dst, small, strlen(small));
+
+    /* Copying a file onto itself keeps its content */
+    ok = ok && check_copy("self", src, src, small, strlen(small));
+
+    if ((ok != 0) && (file_io_copy_file(missing, dst) != 0)) {
+        fprintf(stderr, "copy of a missing file succeeded\n");
+        ok = 0;
+    }
+
+    ok = ok && check_emit(src, dst);
+    ok = ok && check_emit_links(src);
+    if ((ok != 0) && (file_io_emit_copy(missing, dst) != FILE_EMIT_FAILED)) {
+        fprintf(stderr, "emit of a missing file succeeded\n");
+        ok = 0;
+    }
+
+    /* No temp files are left behind next to the outputs */
+    if ((ok != 0) && (count_entries(g_dir) != 2)) {
+        fprintf(stderr, "unexpected files left in %s\n", g_dir);
+        ok = 0;
+    }
+
+    free(big);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", g_dir);
+    (void)system(cmd);
+
+    return (ok != 0) ? 0 : 1;
+}
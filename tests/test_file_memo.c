@@ -0,0 +1,108 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_file_memo.c
+ * DESC.: validates the in-memory header memo and its stat-based invalidation
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "file_io.h"
+#include "file_memo.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/stat.h>
+
+/* Write content to path and date it seconds_ago in the past */
+static int write_dated(const char *path, const char *content, long seconds_ago) {
+    if (file_io_write_all(path, content, strlen(content)) == 0) {
+        return 0;
+    }
+    struct timespec times[2];
+    (void)clock_gettime(CLOCK_REALTIME, &times[0]);
+    times[0].tv_sec -= seconds_ago;
+    times[1]         = times[0];
+    return utimensat(AT_FDCWD, path, times, 0) == 0;
+}
+
+/* Lookups since the previous call: *hits and *misses */
+static void counter_delta(size_t *hits, size_t *misses) {
+    static size_t last_hits;
+    static size_t last_misses;
+    size_t        h = 0U;
+    size_t        m = 0U;
+    file_memo_counters(&h, &m);
+    *hits       = h - last_hits;
+    *misses     = m - last_misses;
+    last_hits   = h;
+    last_misses = m;
+}
+
+int main(void) {
+    char root[] = "/tmp/cplus_file_memo_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        return 1;
+    }
+
+    char header[512];
+    char fresh[512];
+    char expected[512];
+    (void)snprintf(header, sizeof(header), "%s/a.hplus", root);
+    (void)snprintf(fresh, sizeof(fresh), "%s/fresh.hplus", root);
+    (void)snprintf(expected, sizeof(expected), "%s/b.hplus", root);
+
+    int    ok     = write_dated(header, "#include \"b.hplus\"\nint a;\n", 60);
+    size_t hits   = 0U;
+    size_t misses = 0U;
+    counter_delta(&hits, &misses);
+
+    /* First lookup reads the file, the second one is answered from memory */
+    FileFacts first;
+    FileFacts second;
+    ok = ok && (file_memo_get(header, &first) != 0) && (file_memo_get(header, &second) != 0);
+    counter_delta(&hits, &misses);
+    ok = ok && (hits == 1U) && (misses == 1U);
+    ok = ok && (first.size == second.size) && (first.hash == second.hash) &&
+         (first.includes_len == strlen(expected) + 1U) && (strcmp(first.includes, expected) == 0) &&
+         (strcmp(second.includes, expected) == 0);
+    free(second.includes);
+
+    /* Same size, new timestamp: read again, and the new content is seen */
+    ok = ok && write_dated(header, "#include \"b.hplus\"\nint z;\n", 30);
+    ok = ok && (file_memo_get(header, &second) != 0);
+    counter_delta(&hits, &misses);
+    ok = ok && (hits == 0U) && (misses == 1U) && (second.size == first.size) &&
+         (second.hash != first.hash);
+    free(first.includes);
+    free(second.includes);
+
+    /* A file written just now is not memoized: its next change may keep the mtime */
+    ok = ok && (file_io_write_all(fresh, "int f;\n", 7U) != 0);
+    ok = ok && (file_memo_get(fresh, &first) != 0) && (file_memo_get(fresh, &second) != 0);
+    counter_delta(&hits, &misses);
+    ok = ok && (hits == 0U) && (misses == 2U) && (first.includes_len == 0U);
+    free(first.includes);
+    free(second.includes);
+
+    /* Missing files fail; clearing drops what was memoized and the counters */
+    ok = ok && (file_memo_get(expected, &first) == 0);
+    file_memo_clear();
+    ok = ok && (file_memo_get(header, &first) != 0);
+    file_memo_counters(&hits, &misses);
+    ok = ok && (hits == 0U) && (misses == 1U);
+    free(first.includes);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
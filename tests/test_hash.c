@@ -0,0 +1,56 @@
+/*
+ * FILE: test_hash.c
+ * DESC.: validates XXH64 against reference vectors and streaming consistency
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "hash.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int main(void) {
+    static const struct {
+        const char* text;
+        uint64_t    expected;
+    } vectors[] = {
+        {"",                                        0xEF46DB3751D8E999ULL},
+        {"a",                                       0xD24EC4F1A98C6E5BULL},
+        {"abc",                                     0x44BC2CF5AD770999ULL},
+        {"Nobody inspects the spammish repetition", 0xFBCEA83C8A378BF1ULL},
+    };
+
+    int failed = 0;
+
+    for (size_t i = 0U; i < sizeof(vectors) / sizeof(vectors[0]); ++i) {
+        const char *text = vectors[i].text;
+        size_t len = strlen(text);
+
+        uint64_t one_shot = hash_bytes(text, len, 0U);
+
+        /* Byte-at-a-time streaming must agree with the one-shot hash */
+        HashState state;
+        hash_init(&state, 0U);
+        for (size_t k = 0U; k < len; ++k) {
+            hash_update(&state, text + k, 1U);
+        }
+        uint64_t streamed = hash_final(&state);
+
+        if ((one_shot != vectors[i].expected) || (streamed != vectors[i].expected)) {
+            fprintf(stderr, "hash mismatch for \"%s\": one-shot %016llx, streamed %016llx\n",
+                    text, (unsigned long long)one_shot, (unsigned long long)streamed);
+            failed = 1;
+        }
+    }
+
+    char hex[17];
+    hash_to_hex(0x0123456789ABCDEFULL, hex);
+    if (strcmp(hex, "0123456789abcdef") != 0) {
+        fprintf(stderr, "hash_to_hex produced %s\n", hex);
+        failed = 1;
+    }
+
+    return failed;
+}
@@ -0,0 +1,107 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_input_list.c
+ * DESC.: validates command-line inputs and NUL/newline-delimited input lists
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "file_io.h"
+#include "input_list.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Read the next path and compare it with expected (NULL = end of inputs) */
+static int expect_next(InputList *list, const char *expected) {
+    char *path = NULL;
+    int   got  = input_list_next(list, &path);
+    int   ok   = (expected == NULL) ? (got == 0) : ((got == 1) && (strcmp(path, expected) == 0));
+    if (ok == 0) {
+        fprintf(stderr, "expected '%s', got %d '%s'\n", (expected != NULL) ? expected : "(end)",
+                got, (path != NULL) ? path : "");
+    }
+    free(path);
+    return ok;
+}
+
+int main(void) {
+    char work_dir[] = "/tmp/cplus_input_list_XXXXXX";
+    if (mkdtemp(work_dir) == NULL) {
+        return 1;
+    }
+
+    char nul_list[256];
+    char line_list[256];
+    char long_list[256];
+    (void)snprintf(nul_list, sizeof(nul_list), "%s/nul.lst", work_dir);
+    (void)snprintf(line_list, sizeof(line_list), "%s/line.lst", work_dir);
+    (void)snprintf(long_list, sizeof(long_list), "%s/long.lst", work_dir);
+
+    /* NUL-delimited: a newline is part of a name */
+    static const char nul_text[] = "a.cplus\0with\nnewline.cplus\0\0b.cplus";
+    /* Newline-delimited: CRLF, blank lines and a last line without its newline */
+    static const char line_text[] = "c.cplus\r\n\nd e.cplus\nf.cplus";
+    int ok = (file_io_write_all(nul_list, nul_text, sizeof(nul_text) - 1U) != 0) &&
+             (file_io_write_all(line_list, line_text, sizeof(line_text) - 1U) != 0);
+
+    /* Entries spanning the 64 KiB read chunks, one of them longer than a chunk */
+    size_t n_long    = 20000U;
+    size_t long_size = 0U;
+    char  *long_text = (char *)malloc(n_long * 24U + 70000U);
+    ok = ok && (long_text != NULL);
+    for (size_t i = 0U; (long_text != NULL) && (i < n_long); ++i) {
+        long_size += (size_t)snprintf(long_text + long_size, 24U, "dir/%zu.cplus\n", i);
+    }
+    if (long_text != NULL) {
+        memset(long_text + long_size, 'x', 69999U);
+        long_size += 69999U;
+        long_text[long_size++] = '\n';
+    }
+    ok = ok && (file_io_write_all(long_list, long_text, long_size) != 0);
+
+    /* Sources are read in command-line order */
+    InputList *list = input_list_create();
+    ok = ok && (list != NULL) && (input_list_add_path(list, "first.cplus") != 0) &&
+         (input_list_add_file(list, nul_list) != 0) &&
+         (input_list_add_path(list, "middle.cplus") != 0) &&
+         (input_list_add_file(list, line_list) != 0) && (input_list_add_file(list, long_list) != 0);
+    ok = ok && expect_next(list, "first.cplus") && expect_next(list, "a.cplus") &&
+         expect_next(list, "with\nnewline.cplus") && expect_next(list, "b.cplus") &&
+         expect_next(list, "middle.cplus") && expect_next(list, "c.cplus") &&
+         expect_next(list, "d e.cplus") && expect_next(list, "f.cplus");
+
+    char name[32];
+    for (size_t i = 0U; (ok != 0) && (i < n_long); ++i) {
+        (void)snprintf(name, sizeof(name), "dir/%zu.cplus", i);
+        ok = expect_next(list, name);
+    }
+    char *path = NULL;
+    ok = ok && (input_list_next(list, &path) == 1) && (strlen(path) == 69999U) &&
+         (path[69998] == 'x');
+    free(path);
+    ok = ok && expect_next(list, NULL) && expect_next(list, NULL) &&
+         (input_list_error(list) == NULL);
+    input_list_destroy(list);
+
+    /* A missing list is refused when it is added */
+    char missing[300];
+    (void)snprintf(missing, sizeof(missing), "%s/missing.lst", work_dir);
+    list = input_list_create();
+    ok = ok && (list != NULL) && (input_list_add_file(list, missing) == 0) &&
+         expect_next(list, NULL);
+    input_list_destroy(list);
+
+    free(long_text);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", work_dir);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_job_history.c
+ * DESC.: validates the duration history and the longest-first batch plan
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "file_io.h"
+#include "job_history.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Sum of the costs of each planned group, and whether every item appears once */
+static int check_plan(const uint64_t cost[], size_t count, size_t n_groups, size_t cap,
+                      const size_t order[], const size_t group_len[], uint64_t loads[]) {
+    unsigned char seen[64] = {0};
+    size_t        k        = 0U;
+    for (size_t g = 0U; g < n_groups; ++g) {
+        if (group_len[g] > cap) {
+            return 0;
+        }
+        loads[g] = 0U;
+        for (size_t j = 0U; j < group_len[g]; ++j, ++k) {
+            if ((k >= count) || (order[k] >= count) || (seen[order[k]] != 0U)) {
+                return 0;
+            }
+            seen[order[k]] = 1U;
+            loads[g] += cost[order[k]];
+        }
+        if ((g > 0U) && (loads[g] > loads[g - 1U])) {
+            return 0;
+        }
+    }
+    return k == count;
+}
+
+int main(void) {
+    char root[] = "/tmp/cplus_job_history_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        return 1;
+    }
+    char path[512];
+    (void)snprintf(path, sizeof(path), "%s/history", root);
+
+    /* Nothing recorded: the size is the prior, at the default rate */
+    JobHistory *history = job_history_open(path);
+    const uint64_t rate = JOB_HISTORY_DEFAULT_NS_PER_BYTE;
+    int ok = (history != NULL) && (job_history_estimate(history, "a.cplus", 10U) == 10U * rate) &&
+             (job_history_estimate(NULL, "a.cplus", 3U) == 3U * rate);
+
+    job_history_record(history, "a.cplus", 100U, 5000U);
+    job_history_record(history, "dir/b c.cplus", 300U, 9000U);
+    job_history_record(history, "a.cplus", 100U, 7000U);
+    ok = ok && (job_history_estimate(history, "a.cplus", 100U) == 7000U) &&
+         (job_history_save(history) != 0);
+    job_history_close(history);
+
+    /* The next run knows both, and prices unseen inputs at the rate seen so far (16000 ns / 400) */
+    history = job_history_open(path);
+    ok = ok && (history != NULL) && (job_history_estimate(history, "a.cplus", 1U) == 7000U) &&
+         (job_history_estimate(history, "dir/b c.cplus", 1U) == 9000U) &&
+         (job_history_estimate(history, "new.cplus", 50U) == 2000U);
+    job_history_close(history);
+
+    /* A damaged file is an empty history */
+    ok = ok && (file_io_write_all(path, "cplus-history 1\nD 12 x\n", 23U) != 0);
+    history = job_history_open(path);
+    ok = ok && (history != NULL) &&
+         (job_history_estimate(history, "a.cplus", 2U) == 2U * JOB_HISTORY_DEFAULT_NS_PER_BYTE);
+    job_history_close(history);
+
+    /* In memory only: saving is a no-op that succeeds */
+    history = job_history_open(NULL);
+    job_history_record(history, "a.cplus", 1U, 1U);
+    ok = ok && (history != NULL) && (job_history_save(history) != 0);
+    job_history_close(history);
+
+    /* One huge input among small ones gets a group of its own, dealt first */
+    const uint64_t skewed[] = {1U, 1U, 1U, 1U, 1U, 1U, 100U};
+    size_t         order[64];
+    size_t         group_len[8];
+    uint64_t       loads[8];
+    ok = ok && (job_history_plan(skewed, 7U, 2U, 4U, order, group_len) != 0) &&
+         (check_plan(skewed, 7U, 2U, 4U, order, group_len, loads) != 0) && (order[0] == 6U) &&
+         (loads[0] <= 103U) && (loads[1] == 4U);
+
+    /* Balanced where the input order is not: 8 7 6 5 4 3 2 1 into 4 groups of 2 */
+    const uint64_t ramp[] = {1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U};
+    ok = ok && (job_history_plan(ramp, 8U, 4U, 2U, order, group_len) != 0) &&
+         (check_plan(ramp, 8U, 4U, 2U, order, group_len, loads) != 0) && (loads[0] == 9U) &&
+         (loads[3] == 9U);
+
+    /* More groups than items leaves the extra ones empty, at the end */
+    ok = ok && (job_history_plan(ramp, 3U, 5U, 16U, order, group_len) != 0) &&
+         (check_plan(ramp, 3U, 5U, 16U, order, group_len, loads) != 0) && (group_len[0] == 1U) &&
+         (order[0] == 2U) && (group_len[3] == 0U) && (group_len[4] == 0U);
+
+    /* Items that cannot fit are refused */
+    ok = ok && (job_history_plan(ramp, 8U, 2U, 3U, order, group_len) == 0);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
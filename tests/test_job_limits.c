@@ -0,0 +1,155 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_job_limits.c
+ * DESC.: validates per-run timeouts, memory limits and the memory-based worker cap
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "compiler_validator.h"
+#include "file_io.h"
+#include "job_pool.h"
+#include "pipeline.h"
+#include "subprocess.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/wait.h>
+
+static double seconds_since(const struct timespec *start) {
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + ((double)(now.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* Run argv under limits; returns the elapsed seconds, or -1 if it did not run */
+static double run_timed(const char *const argv[], const SubprocessLimits *limits,
+                        SubprocessResult *result) {
+    struct timespec start;
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    if (subprocess_run_limited(argv, NULL, NULL, limits, result) != 0) {
+        return -1.0;
+    }
+    return seconds_since(&start);
+}
+
+static size_t g_errors;
+
+static void count_errors(void *user, const Diagnostic *diag) {
+    (void)user;
+    g_errors += (diag->severity == DIAG_ERROR) ? 1U : 0U;
+}
+
+int main(void) {
+    char root[] = "/tmp/cplus_job_limits_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        return 1;
+    }
+
+    /* A child past its timeout gets SIGTERM, and the whole group goes with it */
+    SubprocessLimits limits  = {200ULL, 0ULL};
+    SubprocessResult result;
+    const char      *sleeper[] = {"sh", "-c", "sleep 5 & sleep 5", NULL};
+    double           elapsed   = run_timed(sleeper, &limits, &result);
+    int ok = (elapsed >= 0.15) && (elapsed < 1.0) && (result.timed_out == 1) &&
+             WIFSIGNALED(result.status) && (WTERMSIG(result.status) == SIGTERM);
+    subprocess_free_result(&result);
+
+    /* One that ignores SIGTERM is killed once the grace period is over */
+    const char *stubborn[] = {"sh", "-c", "trap '' TERM; sleep 5; sleep 5", NULL};
+    elapsed = run_timed(stubborn, &limits, &result);
+    ok = ok && (elapsed >= 1.0) && (elapsed < 3.0) && (result.timed_out == 1) &&
+         WIFSIGNALED(result.status) && (WTERMSIG(result.status) == SIGKILL);
+    subprocess_free_result(&result);
+
+    /* Finishing in time, under a memory limit (the fork() path), is untouched */
+    limits = (SubprocessLimits){5000ULL, 256ULL * 1024ULL * 1024ULL};
+    const char *echo[] = {"sh", "-c", "echo fine", NULL};
+    ok = ok && (run_timed(echo, &limits, &result) >= 0.0) && (result.timed_out == 0) &&
+         WIFEXITED(result.status) && (WEXITSTATUS(result.status) == 0) &&
+         (strcmp(result.output, "fine\n") == 0);
+    subprocess_free_result(&result);
+    const char *missing[] = {"cplus-no-such-program", NULL};
+    ok = ok && (subprocess_run_limited(missing, NULL, NULL, &limits, &result) == -1);
+
+    /* An ignored SIGPIPE (cplus --serve) is not passed on, on any path: `yes` dies of it */
+    (void)signal(SIGPIPE, SIG_IGN);
+    const char *piped[] = {"sh", "-c", "yes | head -n 1 >/dev/null", NULL};
+    SubprocessLimits paths[3] = {{0ULL, 0ULL}, {5000ULL, 0ULL}, limits};
+    for (int i = 0; i < 3; ++i) {
+        ok = ok && (run_timed(piped, &paths[i], &result) >= 0.0) && WIFEXITED(result.status) &&
+             (WEXITSTATUS(result.status) == 0) && (result.output != NULL) &&
+             (strstr(result.output, "Broken pipe") == NULL);
+        subprocess_free_result(&result);
+    }
+    (void)signal(SIGPIPE, SIG_DFL);
+
+    /* A macro expanding to 2^24 declarations blows both budgets of the compiler */
+    char path[512];
+    (void)snprintf(path, sizeof(path), "%s/explode.cplus", root);
+    char   source[2048];
+    size_t size = (size_t)snprintf(source, sizeof(source), "#define A0 int x;\n");
+    for (int i = 1; i <= 24; ++i) {
+        size += (size_t)snprintf(source + size, sizeof(source) - size, "#define A%d A%d A%d\n", i,
+                                 i - 1, i - 1);
+    }
+    size += (size_t)snprintf(source + size, sizeof(source) - size, "A24\n");
+    ok = ok && (file_io_write_all(path, source, size) != 0);
+
+    ValidatorOptions options = {0, count_errors, NULL, DIAG_FORMAT_TEXT, NULL,
+                                NULL, {300ULL, 0ULL}};
+    ValidationResult verdict = validator_check_syntax_ex("gcc", "c17", path, &options);
+    ok = ok && (verdict.success == 0) && (verdict.exit_code == VALIDATION_TIMED_OUT) &&
+         (g_errors == 1U) && (verdict.raw_output != NULL) &&
+         (strstr(verdict.raw_output, "explode.cplus:1:1: error:") != NULL);
+    validator_free_result(&verdict);
+
+    options.limits = (SubprocessLimits){0ULL, 48ULL * 1024ULL * 1024ULL};
+    verdict = validator_check_syntax_ex("gcc", "c17", path, &options);
+    ok = ok && (verdict.success == 0) && (verdict.exit_code == VALIDATION_OUT_OF_MEMORY) &&
+         (g_errors == 2U);
+    validator_free_result(&verdict);
+
+    /* The pipeline gives such a file its own code, and writes nothing */
+    char output[512];
+    (void)snprintf(output, sizeof(output), "%s/explode.c", root);
+    PipelineOptions run = {
+        .input_path  = path,
+        .output_path = output,
+        .compiler    = "gcc",
+        .std_name    = "c17",
+        .diag_sink   = count_errors,
+        .limits      = {300ULL, 0ULL},
+    };
+    ok = ok && (pipeline_run(&run) == PIPELINE_LIMIT_EXCEEDED) && (g_errors == 3U) &&
+         (file_io_read_all(output, &size) == NULL);
+
+    /* A validation failure outranks a later input cut short by the limits */
+    char bad[512];
+    (void)snprintf(bad, sizeof(bad), "%s/a_bad.cplus", root);
+    ok = ok && (file_io_write_all(bad, "int f(void) { return y; }\n", 26U) != 0);
+    const char *const cli[] = {CPLUS_EXECUTABLE, "--no-cache", "--job-timeout", "300ms", bad, path,
+                               NULL};
+    ok = ok && (run_timed(cli, &(SubprocessLimits){0ULL, 0ULL}, &result) >= 0.0) &&
+         WIFEXITED(result.status) && (WEXITSTATUS(result.status) == 1);
+    subprocess_free_result(&result);
+
+    /* Workers are only ever lowered, never below one */
+    ok = ok && (job_pool_available_memory() > 0ULL) && (job_pool_memory_workers(8U, 0ULL) == 8U) &&
+         (job_pool_memory_workers(8U, 1ULL) == 8U) &&
+         (job_pool_memory_workers(8U, 1ULL << 60) == 1U);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_job_pool.c
+ * DESC.: validates that the worker pool runs every submitted job exactly once
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "job_pool.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N_JOBS 1000
+
+static atomic_int g_runs[N_JOBS];
+
+static void count_job(void *arg) {
+    int index = *(const int *)arg;
+    atomic_fetch_add(&g_runs[index], 1);
+}
+
+int main(void) {
+    static int indices[N_JOBS];
+
+    if (job_pool_default_workers() < 1U) {
+        fprintf(stderr, "default worker count must be at least 1\n");
+        return 1;
+    }
+
+    JobPool *pool = job_pool_create(4U);
+    if (pool == NULL) {
+        fprintf(stderr, "failed to create job pool\n");
+        return 1;
+    }
+
+    for (int i = 0; i < N_JOBS; ++i) {
+        indices[i] = i;
+        if (job_pool_submit(pool, count_job, &indices[i]) == 0) {
+            fprintf(stderr, "failed to submit job %d\n", i);
+            job_pool_destroy(pool);
+            return 1;
+        }
+    }
+
+    job_pool_wait(pool);
+
+    /* The pool stays usable after a wait */
+    int extra = 0;
+    if (job_pool_submit(pool, count_job, &extra) == 0) {
+        fprintf(stderr, "failed to submit job after wait\n");
+        job_pool_destroy(pool);
+        return 1;
+    }
+
+    job_pool_destroy(pool);
+
+    for (int i = 0; i < N_JOBS; ++i) {
+        int expected = (i == 0) ? 2 : 1;
+        if (atomic_load(&g_runs[i]) != expected) {
+            fprintf(stderr, "job %d ran %d times, expected %d\n", i, atomic_load(&g_runs[i]),
+                    expected);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_json.c
+ * DESC.: validates the arena-backed JSON reader
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "json.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *const k_doc =
+    " {\"name\": \"a\\\"b\\u00e9\\ud83d\\ude00\", \"n\": -12.5e1, \"ok\": true,"
+    " \"list\": [1, [], {}, null], \"empty\": \"\"}\n[2]";
+
+int main(void) {
+    int failed = 0;
+    Arena *arena = arena_create(256U);
+    if (arena == NULL) {
+        return 1;
+    }
+
+    size_t consumed = 0U;
+    const JsonValue *doc = json_parse(arena, k_doc, strlen(k_doc), &consumed);
+    if ((doc == NULL) || (doc->type != JSON_OBJECT) || (doc->count != 5U)) {
+        fprintf(stderr, "object not parsed\n");
+        arena_destroy(arena);
+        return 1;
+    }
+
+    const char *name = json_string(json_get(doc, "name"));
+    if ((name == NULL) || (strcmp(name, "a\"b\xc3\xa9\xf0\x9f\x98\x80") != 0)) {
+        fprintf(stderr, "string escapes decoded incorrectly\n");
+        failed = 1;
+    }
+
+    const JsonValue *list = json_get(doc, "list");
+    if ((json_int(json_get(doc, "n"), 0) != -125) || (json_get(doc, "ok")->type != JSON_BOOL) ||
+        (list == NULL) || (list->count != 4U) || (list->items[1].type != JSON_ARRAY) ||
+        (list->items[3].type != JSON_NULL) || (json_get(doc, "missing") != NULL) ||
+        (json_int(json_get(doc, "name"), 7) != 7)) {
+        fprintf(stderr, "scalar or nested values parsed incorrectly\n");
+        failed = 1;
+    }
+
+    /* Documents can be read back to back */
+    const JsonValue *second = json_parse(arena, k_doc + consumed, strlen(k_doc) - consumed, NULL);
+    if ((second == NULL) || (second->type != JSON_ARRAY) || (json_int(&second->items[0], 0) != 2)) {
+        fprintf(stderr, "second document not parsed\n");
+        failed = 1;
+    }
+
+    static const char *const k_bad[] = {"[1,]", "{\"a\" 1}", "\"open", "[01x", "tru", "{\"a\":1,}"};
+    for (size_t i = 0U; i < sizeof(k_bad) / sizeof(k_bad[0]); ++i) {
+        size_t used = 0U;
+        const JsonValue *v = json_parse(arena, k_bad[i], strlen(k_bad[i]), &used);
+        if ((v != NULL) && (used == strlen(k_bad[i]))) {
+            fprintf(stderr, "accepted malformed input '%s'\n", k_bad[i]);
+            failed = 1;
+        }
+    }
+
+    char deep[200];
+    memset(deep, '[', sizeof(deep));
+    if (json_parse(arena, deep, sizeof(deep), NULL) != NULL) {
+        fprintf(stderr, "nesting limit not enforced\n");
+        failed = 1;
+    }
+
+    arena_destroy(arena);
+    return failed;
+}
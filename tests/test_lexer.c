@@ -0,0 +1,161 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_lexer.c
+ * DESC.: validates the C23 lexer: keywords, literals, punctuators and flags
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "lexer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    TokenKind   kind;
+    const char* text;
+} Expected;
+
+/* Tokenize source and compare kinds and spellings with expected[], EOF excluded */
+static int expect_tokens(const char *name, const char *source, const Expected *expected,
+                         size_t count) {
+    TokenBuffer tokens = {NULL, NULL, NULL, NULL, 0U, 0U};
+    int ok = (lexer_tokenize(source, strlen(source), &tokens) != 0) &&
+             (tokens.count == count + 1U) && (tokens.kinds[count] == TOK_EOF) &&
+             (tokens.offsets[count] == strlen(source));
+
+    for (size_t i = 0U; (ok != 0) && (i < count); ++i) {
+        size_t len = strlen(expected[i].text);
+        ok = (tokens.kinds[i] == (uint8_t)expected[i].kind) && (tokens.lengths[i] == len) &&
+             (memcmp(source + tokens.offsets[i], expected[i].text, len) == 0);
+        if (ok == 0) {
+            fprintf(stderr, "%s: token %zu is %s '%.*s', expected %s '%s'\n", name, i,
+                    lexer_kind_name((TokenKind)tokens.kinds[i]), (int)tokens.lengths[i],
+                    source + tokens.offsets[i], lexer_kind_name(expected[i].kind),
+                    expected[i].text);
+        }
+    }
+    if ((ok == 0) && (tokens.count != count + 1U)) {
+        fprintf(stderr, "%s: %zu tokens, expected %zu\n", name, tokens.count, count + 1U);
+    }
+
+    token_buffer_free(&tokens);
+    return ok;
+}
+
+int main(void) {
+    /* Every keyword round-trips through the perfect hash; near misses do not */
+    for (int kind = TOK_KW_FIRST; kind <= TOK_KW_LAST; ++kind) {
+        const char *spelling = lexer_kind_name((TokenKind)kind);
+        size_t      len      = strlen(spelling);
+        if (lexer_keyword(spelling, len) != (TokenKind)kind) {
+            fprintf(stderr, "keyword '%s' not found\n", spelling);
+            return 1;
+        }
+        if ((lexer_keyword(spelling, len - 1U) != TOK_IDENTIFIER) && (len > 2U) &&
+            (lexer_keyword(spelling, len - 1U) == (TokenKind)kind)) {
+            fprintf(stderr, "prefix of '%s' taken for it\n", spelling);
+            return 1;
+        }
+    }
+    const char *non_keywords[] = {"", "i", "Int", "intx", "whilee", "_Bool_", "typeof_unqualx",
+                                  "__func__"};
+    for (size_t i = 0U; i < sizeof(non_keywords) / sizeof(non_keywords[0]); ++i) {
+        if (lexer_keyword(non_keywords[i], strlen(non_keywords[i])) != TOK_IDENTIFIER) {
+            fprintf(stderr, "'%s' taken for a keyword\n", non_keywords[i]);
+            return 1;
+        }
+    }
+
+    const Expected decl[] = {
+        {TOK_KW_STATIC, "static"}, {TOK_KW_CONSTEXPR, "constexpr"}, {TOK_KW_UNSIGNED, "unsigned"},
+        {TOK_IDENTIFIER, "n"}, {TOK_PUNCT, "="}, {TOK_NUMBER, "0x1'000u"}, {TOK_PUNCT, ";"},
+    };
+    if (expect_tokens("decl", "static constexpr unsigned n = 0x1'000u;", decl, 7U) == 0) {
+        return 1;
+    }
+
+    /* pp-numbers keep exponent signs and swallow dots; longest-match punctuators */
+    const Expected numbers[] = {
+        {TOK_NUMBER, "1e+5"}, {TOK_PUNCT, "+"}, {TOK_NUMBER, "0x1p-3"}, {TOK_PUNCT, "-"},
+        {TOK_NUMBER, ".5f.."}, {TOK_PUNCT, "..."}, {TOK_PUNCT, "<<="}, {TOK_PUNCT, "->"},
+        {TOK_PUNCT, "##"}, {TOK_PUNCT, "::"},
+    };
+    if (expect_tokens("numbers", "1e+5+0x1p-3-.5f.. ...<<=->##::", numbers, 10U) == 0) {
+        return 1;
+    }
+
+    const Expected digraphs[] = {
+        {TOK_PUNCT, "%:%:"}, {TOK_PUNCT, "<:"}, {TOK_PUNCT, ":>"}, {TOK_PUNCT, "<%"},
+        {TOK_PUNCT, "%>"}, {TOK_PUNCT, "%:"},
+    };
+    if (expect_tokens("digraphs", "%:%: <::> <%%> %:", digraphs, 6U) == 0) {
+        return 1;
+    }
+
+    /* Encoding prefixes belong to the literal, other identifiers do not */
+    const Expected literals[] = {
+        {TOK_STRING, "u8\"a\\\"b\""}, {TOK_CHAR, "U'x'"}, {TOK_STRING, "L\"\""},
+        {TOK_IDENTIFIER, "x"}, {TOK_STRING, "\"y\""}, {TOK_CHAR, "'\\''"},
+    };
+    if (expect_tokens("literals", "u8\"a\\\"b\" U'x' L\"\" x\"y\" '\\''", literals, 6U) == 0) {
+        return 1;
+    }
+
+    /* Comments vanish, including a // comment continued by a splice */
+    const Expected comments[] = {
+        {TOK_IDENTIFIER, "a"}, {TOK_IDENTIFIER, "b"}, {TOK_IDENTIFIER, "c"},
+    };
+    if (expect_tokens("comments", "a /* x\n*/ // y \\\n z\nb // w\nc", comments, 3U) == 0) {
+        return 1;
+    }
+
+    /* Broken input still lexes, with the fault as its own token */
+    const Expected broken[] = {
+        {TOK_UNTERMINATED_STRING, "\"abc"}, {TOK_IDENTIFIER, "x"}, {TOK_UNTERMINATED_CHAR, "'y"},
+        {TOK_OTHER, "@"}, {TOK_UNTERMINATED_COMMENT, "/* z"},
+    };
+    if (expect_tokens("broken", "\"abc\nx 'y\n@ /* z", broken, 5U) == 0) {
+        return 1;
+    }
+
+    /* A splice inside a literal keeps it open; $ and UTF-8 are identifier bytes */
+    const Expected spliced[] = {
+        {TOK_STRING, "\"a\\\nb\""}, {TOK_IDENTIFIER, "$x\xC3\xA9"},
+    };
+    if (expect_tokens("spliced", "\"a\\\nb\" $x\xC3\xA9", spliced, 2U) == 0) {
+        return 1;
+    }
+
+    /* Flags and offsets: the SoA arrays stay in step */
+    const char *source = "#define X 1\n  int\ty;";
+    TokenBuffer tokens = {NULL, NULL, NULL, NULL, 0U, 0U};
+    if ((lexer_tokenize(source, strlen(source), &tokens) == 0) || (tokens.count != 8U)) {
+        fprintf(stderr, "flags: %zu tokens\n", tokens.count);
+        return 1;
+    }
+    const uint8_t  flags[]   = {TOKF_LINE_START, 0U, TOKF_SPACE, TOKF_SPACE,
+                                TOKF_LINE_START | TOKF_SPACE, TOKF_SPACE, 0U, 0U};
+    const uint32_t offsets[] = {0U, 1U, 8U, 10U, 14U, 18U, 19U, 20U};
+    for (size_t i = 0U; i < tokens.count; ++i) {
+        if ((tokens.flags[i] != flags[i]) || (tokens.offsets[i] != offsets[i])) {
+            fprintf(stderr, "flags: token %zu has flags %u at %u\n", i, tokens.flags[i],
+                    tokens.offsets[i]);
+            return 1;
+        }
+    }
+
+    /* The buffer is reused across calls */
+    if ((lexer_tokenize("", 0U, &tokens) == 0) || (tokens.count != 1U) ||
+        (tokens.kinds[0] != TOK_EOF)) {
+        fprintf(stderr, "empty source\n");
+        return 1;
+    }
+    token_buffer_free(&tokens);
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_oracles.c
+ * DESC.: validates merged multi-oracle diagnostics and the all-must-pass rule
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "diagnostics.h"
+#include "file_io.h"
+#include "pipeline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Run input through gcc as c17 and c23 at once; the diagnostics land in *out_text */
+static int run_two_stds(const char *input, const char *output, char **out_text) {
+    static const PipelineOracle oracles[2] = {
+        {"gcc", "c17", "c17"},
+        {"gcc", "c23", "c23"},
+    };
+
+    size_t text_size = 0U;
+    FILE  *stream = open_memstream(out_text, &text_size);
+    if (stream == NULL) {
+        return -1;
+    }
+    PipelineOptions options = {
+        .input_path  = input,
+        .output_path = output,
+        .compiler    = "gcc",
+        .std_name    = "c17",
+        .diag_stream = stream,
+        .oracles     = oracles,
+        .n_oracles   = 2U,
+    };
+    int rc = pipeline_run(&options);
+    (void)fclose(stream);
+    return rc;
+}
+
+static size_t count_occurrences(const char *text, const char *needle) {
+    size_t n = 0U;
+    for (const char *at = strstr(text, needle); at != NULL; at = strstr(at + 1, needle)) {
+        ++n;
+    }
+    return n;
+}
+
+int main(void) {
+    int ok = 1;
+
+    /* Equal groups (a diagnostic and its notes) collapse into one, tagged by every list */
+    const char *both = "a.c:3:5: error: 'x' undeclared\n"
+                       "a.c:3:5: note: each undeclared identifier is reported only once\n";
+    const char *more = "a.c:3:5: error: 'x' undeclared\n"
+                       "a.c:3:5: note: each undeclared identifier is reported only once\n"
+                       "a.c:7:1: warning: unused variable 'y'\n";
+    DiagnosticList lists[2] = {diagnostics_parse(both), diagnostics_parse(more)};
+    const char    *tags[2]  = {"gcc", "clang"};
+    DiagnosticList merged   = diagnostics_merge(lists, tags, 2U);
+    ok = ok && (merged.count == 3U) && (merged.items[0].severity == DIAG_ERROR) &&
+         (strcmp(merged.items[0].message, "'x' undeclared [gcc, clang]") == 0) &&
+         (merged.items[1].severity == DIAG_NOTE) &&
+         (strcmp(merged.items[2].message, "unused variable 'y' [clang]") == 0) &&
+         (merged.items[2].line == 7);
+    diagnostics_free_list(&merged);
+    diagnostics_free_list(&lists[0]);
+    diagnostics_free_list(&lists[1]);
+
+    char work_dir[] = "/tmp/cplus_oracles_XXXXXX";
+    if (mkdtemp(work_dir) == NULL) {
+        return 1;
+    }
+    char input[256];
+    char output[256];
+    (void)snprintf(input, sizeof(input), "%s/x.cplus", work_dir);
+    (void)snprintf(output, sizeof(output), "%s/x.c", work_dir);
+
+    /* An error every std reports is printed once, with both tags */
+    const char *undeclared = "int main(void) {\n    return x;\n}\n";
+    char       *text = NULL;
+    ok = ok && (file_io_write_all(input, undeclared, strlen(undeclared)) != 0);
+    ok = ok && (run_two_stds(input, output, &text) == 1) && (text != NULL) &&
+         (count_occurrences(text, "error:") == 1U) && (strstr(text, "[c17, c23]") != NULL) &&
+         (strstr(text, "x.cplus:2:") != NULL);
+    if (ok == 0) {
+        fprintf(stderr, "unexpected merged output:\n%s", (text != NULL) ? text : "(none)");
+    }
+    free(text);
+    text = NULL;
+
+    /* Valid in c23 but not in c17: one failing oracle fails the file */
+    const char *c23_only = "int main(void) {\n    return 1'000 - 1000;\n}\n";
+    ok = ok && (file_io_write_all(input, c23_only, strlen(c23_only)) != 0);
+    ok = ok && (run_two_stds(input, output, &text) == 1) && (text != NULL) &&
+         (strstr(text, "[c17]") != NULL) && (strstr(text, "c23]") == NULL);
+    if (ok == 0) {
+        fprintf(stderr, "unexpected c17-only output:\n%s", (text != NULL) ? text : "(none)");
+    }
+    free(text);
+    text = NULL;
+
+    /* Valid everywhere: passes and writes the output */
+    const char *valid = "int main(void) {\n    return 0;\n}\n";
+    (void)remove(output);
+    ok = ok && (file_io_write_all(input, valid, strlen(valid)) != 0);
+    ok = ok && (run_two_stds(input, output, &text) == 0) && (access(output, F_OK) == 0);
+    free(text);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", work_dir);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
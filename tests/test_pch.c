@@ -0,0 +1,170 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_pch.c
+ * DESC.: validates include-block detection and validation through a PCH
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "cache_dir.h"
+#include "pch.h"
+#include "pipeline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int write_text_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    size_t len = strlen(content);
+    size_t written = fwrite(content, 1U, len, fp);
+    int close_rc = fclose(fp);
+
+    return (written == len) && (close_rc == 0);
+}
+
+/* pch_include_prefix(source) must be expected (NULL for none) */
+static int expect_prefix(const char *source, const char *expected) {
+    char *prefix = pch_include_prefix(source, strlen(source));
+    int   ok = (expected == NULL) ? (prefix == NULL)
+                                  : ((prefix != NULL) && (strcmp(prefix, expected) == 0));
+    if (ok == 0) {
+        fprintf(stderr, "prefix of:\n%s\nis '%s', expected '%s'\n", source,
+                (prefix != NULL) ? prefix : "(none)", (expected != NULL) ? expected : "(none)");
+    }
+    free(prefix);
+    return ok;
+}
+
+int main(void) {
+    if ((expect_prefix("#include <stdio.h>\n#include <stdlib.h>\nint x;\n",
+                       "stdio.h\nstdlib.h\n") == 0) ||
+        (expect_prefix("/* license\n */\n\n// note\n#  include  <sys/types.h>  \r\n"
+                       "# include<string.h>",
+                       "sys/types.h\nstring.h\n") == 0) ||
+        (expect_prefix("#include <stdio.h>\n#define X 1\n#include <stdlib.h>\n",
+                       "stdio.h\n") == 0) ||
+        (expect_prefix("#include <stdio.h> /* c */\n", NULL) == 0) ||
+        (expect_prefix("#include \"local.h\"\n#include <stdio.h>\n", NULL) == 0) ||
+        (expect_prefix("#define _GNU_SOURCE\n#include <stdio.h>\n", NULL) == 0) ||
+        (expect_prefix("// spliced \\\n#include <stdio.h>\n", NULL) == 0) ||
+        (expect_prefix("#include <stdio.h", NULL) == 0) || (expect_prefix("", NULL) == 0)) {
+        return 1;
+    }
+
+    char work_dir[] = "/tmp/cplus_pch_XXXXXX";
+    if (mkdtemp(work_dir) == NULL) {
+        fprintf(stderr, "failed to create temp dir\n");
+        return 1;
+    }
+    char cache_root[256];
+    (void)snprintf(cache_root, sizeof(cache_root), "%s/cache", work_dir);
+    cache_dir_set_root(cache_root);
+
+    /* Too few inputs share a block: nothing is built */
+    const char *few[] = {"stdio.h\nstdlib.h\n", "stdio.h\n", "stdio.h\nstdlib.h\nstring.h\n", NULL};
+    if (pch_create("gcc", "c23", few, 4U) != NULL) {
+        fprintf(stderr, "PCH built for three files\n");
+        return 1;
+    }
+
+    /* stdio+stdlib (4 files x 2 headers) beats stdio alone (5 x 1) */
+    const char *prefixes[] = {"stdio.h\nstdlib.h\n", "stdio.h\nstdlib.h\nstring.h\n",
+                              "stdio.h\nstdlib.h\n", "stdio.h\nstdlib.h\nmath.h\n",
+                              "stdio.h\n", NULL};
+    Pch *pch = pch_create("gcc", "c23", prefixes, 6U);
+    if ((pch == NULL) || (pch_block_size(pch) != 2U) || (pch_was_built(pch) == 0)) {
+        fprintf(stderr, "PCH not built for the shared block\n");
+        return 1;
+    }
+
+    const char *header = pch_header_for(pch, "stdio.h\nstdlib.h\nstring.h\n");
+    char        binary[512];
+    (void)snprintf(binary, sizeof(binary), "%s.gch", (header != NULL) ? header : "");
+    FILE *gch = fopen(binary, "rb");
+    if ((header == NULL) || (gch == NULL) || (pch_header_for(pch, "stdio.h\n") != NULL) ||
+        (pch_header_for(pch, NULL) != NULL) ||
+        (pch_header_for(pch, "stdlib.h\nstdio.h\n") != NULL)) {
+        fprintf(stderr, "wrong PCH match\n");
+        return 1;
+    }
+    (void)fclose(gch);
+    size_t hits = 0U, misses = 0U;
+    pch_counters(pch, &hits, &misses);
+    if ((hits != 1U) || (misses != 3U)) {
+        fprintf(stderr, "counters: %zu hits / %zu misses\n", hits, misses);
+        return 1;
+    }
+
+    /* A second run reuses it */
+    Pch *again = pch_create("gcc", "c23", prefixes, 6U);
+    if ((again == NULL) || (pch_was_built(again) != 0) ||
+        (strcmp(pch_header_for(again, "stdio.h\nstdlib.h\n"), header) != 0)) {
+        fprintf(stderr, "PCH not reused\n");
+        return 1;
+    }
+    pch_destroy(again);
+
+    /* Through the pipeline: same verdicts and diagnostics as without the PCH */
+    char good[256], bad[256], out[256], log_pch[256], log_plain[256];
+    (void)snprintf(good, sizeof(good), "%s/good.cplus", work_dir);
+    (void)snprintf(bad, sizeof(bad), "%s/bad.cplus", work_dir);
+    (void)snprintf(out, sizeof(out), "%s/out.c", work_dir);
+    (void)snprintf(log_pch, sizeof(log_pch), "%s/pch.log", work_dir);
+    (void)snprintf(log_plain, sizeof(log_plain), "%s/plain.log", work_dir);
+    if ((write_text_file(good, "#include <stdio.h>\n#include <stdlib.h>\n"
+                               "int main(void) { puts(\"x\"); return EXIT_SUCCESS; }\n") == 0) ||
+        (write_text_file(bad, "#include <stdio.h>\n#include <stdlib.h>\n"
+                              "int main(void) { return missing; }\n") == 0)) {
+        return 1;
+    }
+
+    const char *logs[] = {log_pch, log_plain};
+    for (int k = 0; k < 2; ++k) {
+        FILE *log = fopen(logs[k], "wb");
+        PipelineOptions base = {
+            .output_path = out,
+            .compiler    = "gcc",
+            .std_name    = "c23",
+            .diag_stream = log,
+            .pch         = (k == 0) ? pch : NULL,
+        };
+        PipelineOptions batch[2] = {base, base};
+        batch[0].input_path = good;
+        batch[1].input_path = bad;
+        int rcs[2] = {-1, -1};
+        pipeline_run_batch(batch, 2U, rcs);
+        (void)fclose(log);
+        if ((rcs[0] != 0) || (rcs[1] != 1)) {
+            fprintf(stderr, "pipeline %s PCH: rcs %d %d\n", (k == 0) ? "with" : "without", rcs[0],
+                    rcs[1]);
+            return 1;
+        }
+    }
+    pch_counters(pch, &hits, &misses);
+    if (hits != 3U) {
+        fprintf(stderr, "pipeline did not use the PCH (%zu hits)\n", hits);
+        return 1;
+    }
+
+    char cmd[600];
+    (void)snprintf(cmd, sizeof(cmd), "cmp -s %s %s", log_pch, log_plain);
+    if (system(cmd) != 0) {
+        fprintf(stderr, "diagnostics differ with the PCH\n");
+        return 1;
+    }
+
+    pch_destroy(pch);
+    cache_dir_set_root(NULL);
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf %s", work_dir);
+    (void)system(cmd);
+    return 0;
+}
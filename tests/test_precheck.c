@@ -0,0 +1,96 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_precheck.c
+ * DESC.: validates that the pre-check rejects only files that cannot compile
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "precheck.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int accepts(const char *source) {
+    char *report = NULL;
+    int   ok     = precheck_source("t.cplus", source, strlen(source), &report);
+    if ((ok == 0) || (report != NULL)) {
+        fprintf(stderr, "rejected:\n%s\n--- report:\n%s", source,
+                (report != NULL) ? report : "(none)\n");
+        free(report);
+        return 0;
+    }
+    return 1;
+}
+
+/* Rejected with a report that starts with `prefix` */
+static int rejects(const char *source, const char *prefix) {
+    char *report = NULL;
+    int   ok     = precheck_source("t.cplus", source, strlen(source), &report);
+    int   good   = (ok == 0) && (report != NULL) && (strncmp(report, prefix, strlen(prefix)) == 0);
+    if (good == 0) {
+        fprintf(stderr, "not rejected as '%s':\n%s\n--- report:\n%s", prefix, source,
+                (report != NULL) ? report : "(none)\n");
+    }
+    free(report);
+    return good;
+}
+
+int main(void) {
+    /* Valid code, including the cases only a careless checker would reject */
+    const char *valid[] = {
+        "int main(void) { int a[2] = {1, 2}; return a[0]; }\n",
+        "#ifndef X_H\n#define X_H\nstruct s { int x; };\n#endif\n",
+        "#ifdef __cplusplus\nextern \"C\" {\n#endif\nvoid f(void);\n"
+        "#ifdef __cplusplus\n}\n#endif\n",
+        "#if A\nint f(void) {\n#else\nint g(void) {\n#endif\n  return 0;\n}\n",
+        "#define BEGIN {\n#define END }\nvoid f(void) BEGIN END\n",
+        "#error don't do this\n",
+        "#if 0\nit's a note\n#endif\n",
+        "#include <stdio.h>\nconst char *s = \"(\"; char c = '}';\n",
+        "void f(void) <% int a<:1:> = <%0%>; %>\n",
+        "/* { */ // (\nint x;\n",
+        "const char *s = \"a\\\nb\";\n",
+        "",
+    };
+    for (size_t i = 0U; i < sizeof(valid) / sizeof(valid[0]); ++i) {
+        if (accepts(valid[i]) == 0) {
+            return 1;
+        }
+    }
+
+    if ((rejects("int x; /* never closed\n", "t.cplus:1:8: error: unterminated comment") == 0) ||
+        (rejects("const char *s = \"abc;\n",
+                 "t.cplus:1:17: error: missing terminating \" character") == 0) ||
+        (rejects("char c = 'x;\n", "t.cplus:1:10: error: missing terminating ' character") == 0) ||
+        (rejects("void f(void) {\n  g(1];\n}\n",
+                 "t.cplus:2:6: error: mismatched closing delimiter"
+                 " for the one opened at 2:4") == 0) ||
+        (rejects("int x; }\n", "t.cplus:1:8: error: unmatched closing delimiter") == 0) ||
+        (rejects("void f(void) {\n  if (1) {\n}\n",
+                 "t.cplus:1:14: error: delimiter is never closed") == 0) ||
+        (rejects("#ifndef G\n#define G\nint f(void) { return 0;\n#endif\n",
+                 "t.cplus:3:13: error: delimiter is never closed") == 0)) {
+        return 1;
+    }
+
+    /* The report carries the source line and a caret */
+    char *report = NULL;
+    const char *tabbed = "int y;\n\tint z = (1;\n";
+    if ((precheck_source("t.cplus", tabbed, strlen(tabbed), &report) != 0) || (report == NULL) ||
+        (strcmp(report, "t.cplus:2:10: error: delimiter is never closed\n"
+                        "    2 | \tint z = (1;\n"
+                        "      | \t        ^\n") != 0)) {
+        fprintf(stderr, "report:\n%s", (report != NULL) ? report : "(none)\n");
+        free(report);
+        return 1;
+    }
+    free(report);
+
+    return 0;
+}
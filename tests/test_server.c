@@ -0,0 +1,141 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_server.c
+ * DESC.: validates the --serve daemon protocol: argv, cwd, fds and exit status
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "file_io.h"
+#include "server.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Requests served by this process; state that must survive between them */
+static int g_requests;
+
+static int report_request(int argc, char *argv[]) {
+    char *cwd = getcwd(NULL, 0U);
+    ++g_requests;
+    printf("request %d: argc=%d arg=%s cwd=%s\n", g_requests, argc, (argc > 1) ? argv[1] : "-",
+           (cwd != NULL) ? cwd : "?");
+    free(cwd);
+    return 10 + g_requests;
+}
+
+/* Forward argv with stdout captured in capture_path; returns the status */
+static int forward_captured(const char *socket_path, const char *capture_path, int argc,
+                            char *argv[]) {
+    int saved   = dup(STDOUT_FILENO);
+    int capture = open(capture_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if ((saved < 0) || (capture < 0)) {
+        return -2;
+    }
+    (void)fflush(stdout);
+    (void)dup2(capture, STDOUT_FILENO);
+    (void)close(capture);
+
+    int status = server_forward(socket_path, argc, argv);
+
+    (void)dup2(saved, STDOUT_FILENO);
+    (void)close(saved);
+    return status;
+}
+
+int main(void) {
+    char root[] = "/tmp/cplus_server_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        return 1;
+    }
+
+    char socket_path[512];
+    char capture_path[512];
+    char work[512];
+    (void)snprintf(socket_path, sizeof(socket_path), "%s/s.sock", root);
+    (void)snprintf(capture_path, sizeof(capture_path), "%s/out.txt", root);
+    (void)snprintf(work, sizeof(work), "%s/work", root);
+    int ok = file_io_make_dirs(work);
+
+    /* Nobody listens yet: the caller runs the invocation itself */
+    char *argv[3] = {"cplus", "hello", "world"};
+    ok = ok && (server_forward(socket_path, 3, argv) == -1);
+
+    pid_t server = fork();
+    if (server < 0) {
+        return 1;
+    }
+    if (server == 0) {
+        _exit(server_run(socket_path, report_request));
+    }
+
+    struct timespec pause = {0, 10000000L};
+    for (int i = 0; (i < 500) && (access(socket_path, F_OK) != 0); ++i) {
+        (void)nanosleep(&pause, NULL);
+    }
+
+    /* Requests run in the client's cwd, write to its stdout, and share the server's state */
+    char *original = getcwd(NULL, 0U);
+    ok = ok && (original != NULL) && (chdir(work) == 0);
+    int first  = forward_captured(socket_path, capture_path, 3, argv);
+    size_t size = 0U;
+    char  *text = file_io_read_all(capture_path, &size);
+    char   expected[640];
+    (void)snprintf(expected, sizeof(expected), "request 1: argc=3 arg=hello cwd=%s\n", work);
+    ok = ok && (first == 11) && (text != NULL) && (strcmp(text, expected) == 0);
+    free(text);
+
+    int second = forward_captured(socket_path, capture_path, 1, argv);
+    text = file_io_read_all(capture_path, &size);
+    (void)snprintf(expected, sizeof(expected), "request 2: argc=1 arg=- cwd=%s\n", work);
+    ok = ok && (second == 12) && (text != NULL) && (strcmp(text, expected) == 0);
+    free(text);
+
+    /* A client that connects and sends nothing is dropped, and the next one is served */
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    size_t path_len = strlen(socket_path);
+    ok = ok && (path_len < sizeof(addr.sun_path));
+    memcpy(addr.sun_path, socket_path, ok ? path_len : 0U);
+    int stalled = socket(AF_UNIX, SOCK_STREAM, 0);
+    ok = ok && (stalled >= 0) &&
+         (connect(stalled, (const struct sockaddr *)&addr, sizeof(addr)) == 0);
+    int  third = forward_captured(socket_path, capture_path, 3, argv);
+    char byte  = 0;
+    ok = ok && (third == 13) && (stalled >= 0) && (read(stalled, &byte, 1U) == 0);
+    if (stalled >= 0) {
+        (void)close(stalled);
+    }
+    ok = ok && (original != NULL) && (chdir(original) == 0);
+    free(original);
+
+    /* A second server on the same socket refuses to start */
+    ok = ok && (server_run(socket_path, report_request) == 1);
+
+    /* SIGTERM stops the server cleanly and removes its socket */
+    int wstatus = 0;
+    (void)kill(server, SIGTERM);
+    ok = ok && (waitpid(server, &wstatus, 0) == server) && WIFEXITED(wstatus) &&
+         (WEXITSTATUS(wstatus) == 0);
+    ok = ok && (access(socket_path, F_OK) != 0) && (server_forward(socket_path, 3, argv) == -1);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", root);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
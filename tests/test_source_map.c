@@ -0,0 +1,164 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_source_map.c
+ * DESC.: validates source map lookups, the encoded form and diagnostic remapping
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "source_map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int expect_at(const SourceMap *map, int line, int column, const char *file, int o_line,
+                     int o_column) {
+    SourcePosition at;
+    if ((source_map_lookup(map, line, column, &at) == 0) || (strcmp(at.file, file) != 0) ||
+        (at.line != o_line) || (at.column != o_column)) {
+        fprintf(stderr, "%d:%d did not map to %s:%d:%d\n", line, column, file, o_line, o_column);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Generated:            from:
+ *   1 "int a;\n"        a.cplus:1
+ *   2 "int b = f(x);\n" a.cplus:7, "f(x)" lowered from m.hplus:3:5
+ *   3 "int c;"          a.cplus:8
+ */
+static SourceMap *lowered_map(void) {
+    const char *gen = "int a;\nint b = f(x);\nint c;";
+    SourceMap  *map = source_map_create(gen, strlen(gen));
+    if ((map == NULL) || (source_map_add(map, 0U, "a.cplus", 1, 1) == 0) ||
+        (source_map_add(map, 7U, "a.cplus", 7, 1) == 0) ||
+        (source_map_add(map, 15U, "m.hplus", 3, 5) == 0) ||
+        (source_map_add(map, 19U, "a.cplus", 7, 12) == 0) ||
+        (source_map_add(map, 21U, "a.cplus", 8, 1) == 0)) {
+        source_map_destroy(map);
+        return NULL;
+    }
+    return map;
+}
+
+static int check_lowered(const SourceMap *map) {
+    return expect_at(map, 1, 5, "a.cplus", 1, 5) && expect_at(map, 2, 1, "a.cplus", 7, 1) &&
+           expect_at(map, 2, 10, "m.hplus", 3, 6) && expect_at(map, 2, 13, "a.cplus", 7, 12) &&
+           expect_at(map, 3, 3, "a.cplus", 8, 3) && expect_at(map, 3, 99, "a.cplus", 8, 6);
+}
+
+int main(void) {
+    /* Identity map: every position maps to itself */
+    const char *source = "int main(void) {\n\n    return 0;\n}\n";
+    SourceMap  *id     = source_map_identity("x.cplus", source, strlen(source));
+    if ((id == NULL) || (source_map_segment_count(id) != 5U) ||
+        (expect_at(id, 3, 5, "x.cplus", 3, 5) == 0) ||
+        (expect_at(id, 2, 1, "x.cplus", 2, 1) == 0)) {
+        return 1;
+    }
+    SourcePosition at;
+    if ((source_map_lookup(id, 0, 1, &at) != 0) || (source_map_lookup(id, 6, 1, &at) != 0)) {
+        fprintf(stderr, "identity: line outside the file mapped\n");
+        return 1;
+    }
+
+    /* Segments from several files, and out-of-order segments refused */
+    SourceMap *map = lowered_map();
+    if ((map == NULL) || (check_lowered(map) == 0) ||
+        (source_map_add(map, 3U, "a.cplus", 1, 1) != 0) ||
+        (source_map_add(map, 999U, "a.cplus", 1, 1) != 0)) {
+        fprintf(stderr, "lowered map is wrong\n");
+        return 1;
+    }
+
+    /* Round trip through the encoded form and a sidecar file */
+    unsigned char *data = NULL;
+    size_t         size = 0U;
+    if (source_map_encode(map, &data, &size) == 0) {
+        return 1;
+    }
+    SourceMap *decoded = source_map_decode(data, size);
+    if ((decoded == NULL) || (source_map_segment_count(decoded) != 5U) ||
+        (check_lowered(decoded) == 0)) {
+        fprintf(stderr, "decoded map is wrong\n");
+        return 1;
+    }
+    source_map_destroy(decoded);
+
+    /* Every truncation and a flipped magic byte are rejected */
+    for (size_t len = 0U; len < size; ++len) {
+        decoded = source_map_decode(data, len);
+        if (decoded != NULL) {
+            fprintf(stderr, "truncated map of %zu bytes accepted\n", len);
+            return 1;
+        }
+    }
+    data[0] = 'X';
+    if (source_map_decode(data, size) != NULL) {
+        fprintf(stderr, "bad magic accepted\n");
+        return 1;
+    }
+    free(data);
+
+    char dir[] = "/tmp/cplus_test_source_map_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        return 1;
+    }
+    char path[256];
+    (void)snprintf(path, sizeof(path), "%s/out.c.map", dir);
+    SourceMap *loaded = (source_map_write(map, path) != 0) ? source_map_load(path) : NULL;
+    if ((loaded == NULL) || (check_lowered(loaded) == 0)) {
+        fprintf(stderr, "sidecar round trip failed\n");
+        return 1;
+    }
+    source_map_destroy(loaded);
+
+    char cmd[300];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+    (void)system(cmd);
+
+    /* Remapping a list: only diagnostics located in the generated file move */
+    DiagnosticList list = diagnostics_parse("out.c:2:10: error: bad call\n"
+                                            "    2 | int b = f(x);\n"
+                                            "      |          ^\n"
+                                            "other.h:2:1: note: declared here\n"
+                                            "out.c:1:5: warning: unused 'a'\n"
+                                            "    1 | int a;\n"
+                                            "      |     ^\n");
+    if ((list.count != 3U) || (source_map_remap_list(map, "out.c", &list) != 2U)) {
+        fprintf(stderr, "remap: %zu diagnostics\n", list.count);
+        return 1;
+    }
+    const Diagnostic *d = list.items;
+    if ((strcmp(d[0].file, "m.hplus") != 0) || (d[0].line != 3) || (d[0].column != 6) ||
+        (d[0].context != NULL) ||
+        (strcmp(d[1].file, "other.h") != 0) || (d[1].line != 2) ||
+        (strcmp(d[2].file, "a.cplus") != 0) || (d[2].line != 1) || (d[2].column != 5) ||
+        (d[2].context != NULL)) {
+        fprintf(stderr, "remap: wrong positions\n");
+        return 1;
+    }
+    diagnostics_free_list(&list);
+
+    /* Through the identity map nothing moves and the context stays */
+    list = diagnostics_parse("x.cplus:3:5: error: bad return\n"
+                             "    3 |     return 0;\n"
+                             "      |     ^\n");
+    if ((list.count != 1U) || (source_map_remap_list(id, "x.cplus", &list) != 1U) ||
+        (strcmp(list.items[0].file, "x.cplus") != 0) || (list.items[0].line != 3) ||
+        (list.items[0].column != 5) || (list.items[0].context == NULL)) {
+        fprintf(stderr, "remap: identity map moved a diagnostic\n");
+        return 1;
+    }
+    diagnostics_free_list(&list);
+
+    source_map_destroy(map);
+    source_map_destroy(id);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_trace.c
+ * DESC.: validates the stage timing report and the Chrome trace export
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "arena.h"
+#include "file_io.h"
+#include "json.h"
+#include "pipeline.h"
+#include "trace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static Trace *g_trace;
+
+static void *record_from_worker(void *arg) {
+    const char *file = (const char *)arg;
+    uint64_t    started = trace_now(g_trace);
+    trace_end(g_trace, TRACE_READ, file, 1U, started);
+    trace_end(g_trace, TRACE_WRITE, file, 1U, started);
+    return NULL;
+}
+
+/* Count "X" events named stage in a parsed trace, and the tids they use */
+static size_t count_events(const JsonValue *events, const char *stage, unsigned *out_tid_mask) {
+    size_t n = 0U;
+    for (size_t i = 0U; i < events->count; ++i) {
+        const JsonValue *event = &events->items[i];
+        const char      *ph    = json_string(json_get(event, "ph"));
+        const char      *name  = json_string(json_get(event, "name"));
+        if ((ph != NULL) && (strcmp(ph, "X") == 0) && (name != NULL) &&
+            (strcmp(name, stage) == 0)) {
+            ++n;
+            if (out_tid_mask != NULL) {
+                *out_tid_mask |= 1U << (unsigned)json_int(json_get(event, "tid"), 31);
+            }
+        }
+    }
+    return n;
+}
+
+int main(void) {
+    char work_dir[] = "/tmp/cplus_trace_XXXXXX";
+    if (mkdtemp(work_dir) == NULL) {
+        return 1;
+    }
+
+    char trace_path[256];
+    char input[256];
+    char output[256];
+    (void)snprintf(trace_path, sizeof(trace_path), "%s/run.json", work_dir);
+    (void)snprintf(input, sizeof(input), "%s/ok.cplus", work_dir);
+    (void)snprintf(output, sizeof(output), "%s/ok.c", work_dir);
+
+    const char *source = "int main(void) { return 0; }\n";
+    int ok = (file_io_write_all(input, source, strlen(source)) != 0);
+
+    /* Disabled tracing costs nothing and records nothing */
+    ok = ok && (trace_now(NULL) == 0U);
+    trace_end(NULL, TRACE_READ, "x", 1U, 0U);
+
+    /* Two worker threads plus the creating one give three tracks */
+    g_trace = trace_create();
+    ok = ok && (g_trace != NULL);
+    pthread_t workers[2];
+    const char *names[2] = {"a \"quoted\"\\path.cplus", "b.cplus"};
+    for (int k = 0; (ok != 0) && (k < 2); ++k) {
+        ok = (pthread_create(&workers[k], NULL, record_from_worker, (void *)names[k]) == 0);
+    }
+    for (int k = 0; (ok != 0) && (k < 2); ++k) {
+        (void)pthread_join(workers[k], NULL);
+    }
+
+    /* A real pipeline run on the creating thread */
+    PipelineOptions options = {
+        .input_path  = input,
+        .output_path = output,
+        .compiler    = "gcc",
+        .std_name    = "c23",
+        .precheck    = 1,
+        .trace       = g_trace,
+    };
+    ok = ok && (pipeline_run(&options) == 0);
+
+    char  *report = NULL;
+    size_t report_size = 0U;
+    FILE  *stream = open_memstream(&report, &report_size);
+    ok = ok && (stream != NULL);
+    if (stream != NULL) {
+        trace_fprint_report(g_trace, stream);
+        (void)fclose(stream);
+    }
+    ok = ok && (strstr(report, "2 worker tracks") != NULL) &&
+         (strstr(report, "\n  read            3 ") != NULL) &&
+         (strstr(report, "\n  spawn           1 ") != NULL) &&
+         (strstr(report, "\n  compile         1 ") != NULL) &&
+         (strstr(report, "\n  write           3 ") != NULL) &&
+         (strstr(report, "\n  cache ") == NULL);
+    if (ok == 0) {
+        fprintf(stderr, "unexpected report:\n%s", (report != NULL) ? report : "(none)");
+    }
+    free(report);
+
+    ok = ok && (trace_write_chrome(g_trace, trace_path) != 0);
+    trace_destroy(g_trace);
+
+    /* The export is valid JSON, with the spans of each thread on its own track */
+    size_t size = 0U;
+    char  *text = ok ? file_io_read_all(trace_path, &size) : NULL;
+    Arena *arena = arena_create(4096U);
+    const JsonValue *doc =
+        ((text != NULL) && (arena != NULL)) ? json_parse(arena, text, size, NULL) : NULL;
+    const JsonValue *events = json_get(doc, "traceEvents");
+    ok = ok && (events != NULL);
+
+    unsigned read_tids = 0U;
+    ok = ok && (count_events(events, "read", &read_tids) == 3U) && (read_tids == 0x7U) &&
+         (count_events(events, "compile", NULL) == 1U) &&
+         (count_events(events, "precheck", NULL) == 1U);
+
+    int quoted = 0;
+    for (size_t i = 0U; (events != NULL) && (i < events->count); ++i) {
+        const char *file = json_string(json_get(json_get(&events->items[i], "args"), "file"));
+        quoted |= (file != NULL) && (strcmp(file, names[0]) == 0);
+    }
+    ok = ok && quoted;
+    if (ok == 0) {
+        fprintf(stderr, "unexpected trace:\n%s\n", (text != NULL) ? text : "(none)");
+    }
+
+    arena_destroy(arena);
+    free(text);
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", work_dir);
+    (void)system(cmd);
+
+    return ok ? 0 : 1;
+}
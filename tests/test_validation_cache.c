@@ -0,0 +1,173 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_validation_cache.c
+ * DESC.: validates cache hits, .hplus and .h invalidation and LRU trimming
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "cache_dir.h"
+#include "pipeline.h"
+#include "validation_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+static int write_text_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    size_t len = strlen(content);
+    size_t written = fwrite(content, 1U, len, fp);
+    int close_rc = fclose(fp);
+
+    return (written == len) && (close_rc == 0);
+}
+
+static int g_compiled;
+
+static int run_once(ValidationCache *cache, const char *input, const char *output) {
+    PipelineOptions options = {
+        .input_path  = input,
+        .output_path = output,
+        .compiler    = "gcc",
+        .std_name    = "c23",
+        .cache       = cache,
+        .compiled    = &g_compiled,
+    };
+    return pipeline_run(&options);
+}
+
+int main(void) {
+    char work_dir[] = "/tmp/cplus_vcache_XXXXXX";
+    if (mkdtemp(work_dir) == NULL) {
+        fprintf(stderr, "failed to create temp dir\n");
+        return 1;
+    }
+
+    char cache_root[256];
+    char input[256];
+    char header[256];
+    char output[256];
+    (void)snprintf(cache_root, sizeof(cache_root), "%s/cache", work_dir);
+    (void)snprintf(input, sizeof(input), "%s/main.cplus", work_dir);
+    (void)snprintf(header, sizeof(header), "%s/limits.hplus", work_dir);
+    (void)snprintf(output, sizeof(output), "%s/main.c", work_dir);
+
+    cache_dir_set_root(cache_root);
+
+    int failed = 0;
+
+    if ((write_text_file(header, "#define LIMIT 4\n") == 0) ||
+        (write_text_file(input,
+                         "#include \"limits.hplus\"\nint limit(void) { return LIMIT; }\n") == 0)) {
+        fprintf(stderr, "failed to write fixtures\n");
+        return 1;
+    }
+
+    ValidationCache *cache = validation_cache_open(0ULL);
+    if (cache == NULL) {
+        fprintf(stderr, "failed to open cache\n");
+        return 1;
+    }
+
+    size_t hits = 0U;
+    size_t misses = 0U;
+
+    if ((run_once(cache, input, output) != 0) || (g_compiled != 1) ||
+        (run_once(cache, input, output) != 0)) {
+        fprintf(stderr, "valid input must pass with and without cache\n");
+        failed = 1;
+    }
+    if (g_compiled != 0) {
+        fprintf(stderr, "a cache hit must not report a compiler run\n");
+        failed = 1;
+    }
+    validation_cache_counters(cache, &hits, &misses);
+    if ((hits != 1U) || (misses != 1U)) {
+        fprintf(stderr, "expected 1 hit / 1 miss, got %zu / %zu\n", hits, misses);
+        failed = 1;
+    }
+
+    /* Changing an included .hplus must invalidate the cached success */
+    if (write_text_file(header, "#define OTHER 4\n") == 0) {
+        fprintf(stderr, "failed to rewrite header\n");
+        failed = 1;
+    }
+    if (run_once(cache, input, output) != 1) {
+        fprintf(stderr, "stale cache entry reused after header change\n");
+        failed = 1;
+    }
+    if (run_once(cache, input, output) != 1) {
+        fprintf(stderr, "cached failure must replay as failure\n");
+        failed = 1;
+    }
+    validation_cache_counters(cache, &hits, &misses);
+    if ((hits != 2U) || (misses != 2U)) {
+        fprintf(stderr, "expected 2 hits / 2 misses, got %zu / %zu\n", hits, misses);
+        failed = 1;
+    }
+
+    /* So must changing a plain C header pulled in with a quoted include */
+    char vendor[256];
+    char vendor_input[256];
+    char vendor_output[256];
+    (void)snprintf(vendor, sizeof(vendor), "%s/vendor.h", work_dir);
+    (void)snprintf(vendor_input, sizeof(vendor_input), "%s/vendor.cplus", work_dir);
+    (void)snprintf(vendor_output, sizeof(vendor_output), "%s/vendor.c", work_dir);
+    if ((write_text_file(vendor, "#define VENDOR 2\n") == 0) ||
+        (write_text_file(vendor_input,
+                         "#include \"vendor.h\"\nint vendor(void) { return VENDOR; }\n") == 0)) {
+        fprintf(stderr, "failed to write vendor fixtures\n");
+        failed = 1;
+    }
+    if ((run_once(cache, vendor_input, vendor_output) != 0) ||
+        (run_once(cache, vendor_input, vendor_output) != 0) || (g_compiled != 0)) {
+        fprintf(stderr, "vendor input must pass, then hit the cache\n");
+        failed = 1;
+    }
+    if (write_text_file(vendor, "#define OTHER 2\n") == 0) {
+        fprintf(stderr, "failed to rewrite vendor header\n");
+        failed = 1;
+    }
+    if ((run_once(cache, vendor_input, vendor_output) != 1) || (g_compiled != 1)) {
+        fprintf(stderr, "stale cache entry reused after .h header change\n");
+        failed = 1;
+    }
+    validation_cache_counters(cache, &hits, &misses);
+    if ((hits != 3U) || (misses != 4U)) {
+        fprintf(stderr, "expected 3 hits / 4 misses, got %zu / %zu\n", hits, misses);
+        failed = 1;
+    }
+    validation_cache_close(cache);
+
+    /* A 1-byte bound evicts every entry when the handle is closed */
+    cache = validation_cache_open(1ULL);
+    ValidationResult fake = {1, "", 0};
+    validation_cache_store(cache, 0x1234ULL, &fake);
+    validation_cache_close(cache);
+
+    cache = validation_cache_open(1ULL);
+    ValidationResult replay;
+    if (validation_cache_lookup(cache, 0x1234ULL, &replay) != 0) {
+        fprintf(stderr, "entry survived LRU trimming\n");
+        validator_free_result(&replay);
+        failed = 1;
+    }
+    validation_cache_close(cache);
+
+    char cleanup[512];
+    (void)snprintf(cleanup, sizeof(cleanup), "rm -rf '%s'", work_dir);
+    (void)system(cleanup);
+
+    return failed;
+}
@@ -0,0 +1,106 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*
+ * FILE: test_validator_batch_clang.c
+ * DESC.: validates that a Clang batch with diagnostics is split in one run
+ * AUTHOR: Andre Cavalcante and Claude Sonnet 4.6 as pair programmer
+ * LICENSE: GPL-v3
+ * DATE: March, 2026
+ */
+
+#include "compiler_validator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+static char g_dir[] = "/tmp/cplus_batch_clang_XXXXXX";
+
+static int write_text_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    size_t len = strlen(content);
+    size_t written = fwrite(content, 1U, len, fp);
+    int close_rc = fclose(fp);
+
+    return (written == len) && (close_rc == 0);
+}
+
+static int check_result(const char *name, const ValidationResult *result, int want_success,
+                        const char *want_text, const char *unwanted_text) {
+    if (result->success != want_success) {
+        fprintf(stderr, "%s: success = %d, expected %d\n", name, result->success, want_success);
+        return 0;
+    }
+    if (result->raw_output == NULL) {
+        fprintf(stderr, "%s: missing raw output\n", name);
+        return 0;
+    }
+    if ((want_text != NULL) && (strstr(result->raw_output, want_text) == NULL)) {
+        fprintf(stderr, "%s: output lacks '%s':\n%s\n", name, want_text, result->raw_output);
+        return 0;
+    }
+    if ((unwanted_text != NULL) && (strstr(result->raw_output, unwanted_text) != NULL)) {
+        fprintf(stderr, "%s: output leaks '%s':\n%s\n", name, unwanted_text, result->raw_output);
+        return 0;
+    }
+    return 1;
+}
+
+int main(void) {
+    if (mkdtemp(g_dir) == NULL) {
+        fprintf(stderr, "failed to create temp dir\n");
+        return 1;
+    }
+
+    char good[256];
+    char bad[256];
+    char warned[256];
+    char other[256];
+    (void)snprintf(good, sizeof(good), "%s/good.cplus", g_dir);
+    (void)snprintf(bad, sizeof(bad), "%s/bad.cplus", g_dir);
+    (void)snprintf(warned, sizeof(warned), "%s/warned.cplus", g_dir);
+    (void)snprintf(other, sizeof(other), "%s/other.cplus", g_dir);
+
+    if ((write_text_file(good, "int good(void) { return 1; }\n") == 0) ||
+        (write_text_file(bad, "int bad(void) { int x = ; return x; }\n") == 0) ||
+        (write_text_file(warned, "int warned(int x) { if (x) { return 1; } }\n") == 0) ||
+        (write_text_file(other, "int other(void) { return 2 }\n") == 0)) {
+        fprintf(stderr, "failed to write fixtures\n");
+        return 1;
+    }
+
+    /*
+     * Clang ends each file's report with "N errors generated." and older
+     * versions print the source line unindented; neither may force the
+     * per-file fallback.
+     */
+    const char *const batch[] = {good, bad, warned, other};
+    ValidationResult results[4];
+    size_t runs = validator_check_syntax_batch("clang", "c17", NULL, batch, 4U, results);
+    int    ok   = 1;
+    if (runs != 1U) {
+        fprintf(stderr, "expected 1 compiler run, got %zu\n", runs);
+        ok = 0;
+    }
+    ok = check_result("good", &results[0], 1, NULL, "error") && ok;
+    ok = check_result("bad", &results[1], 0, "bad.cplus:1:", "other.cplus") && ok;
+    ok = check_result("warned", &results[2], 1, "warned.cplus:1:", "bad.cplus") && ok;
+    ok = check_result("other", &results[3], 0, "other.cplus:1:", "warned.cplus") && ok;
+    for (size_t i = 0U; i < 4U; ++i) {
+        validator_free_result(&results[i]);
+    }
+
+    char cmd[320];
+    (void)snprintf(cmd, sizeof(cmd), "rm -rf '%s'", g_dir);
+    (void)system(cmd);
+
+    return (ok != 0) ? 0 : 1;
+}